@@ -13,6 +13,15 @@ export WORKSPACE="$PWD"
 export PACKAGES_PATH=$PWD/edk2:$PWD/edk2-platforms:$PWD/edk2-non-osi:$PWD/edk2-rockchip
 export GCC5_AARCH64_PREFIX=aarch64-linux-gnu-
 
+# LZMA or LZ4, see FV_COMPRESSION in the platform DSCs
+FV_COMPRESSION=${FV_COMPRESSION:-LZMA}
+
+# Console baud rate, up to 1500000, see UART_BAUD_RATE in the platform DSCs
+UART_BAUD_RATE=${UART_BAUD_RATE:-115200}
+
+# TRUE to include AhciNcqDxe, see AHCI_NCQ_ENABLE in the platform DSCs
+AHCI_NCQ_ENABLE=${AHCI_NCQ_ENABLE:-FALSE}
+
 TRUST_INI=RK3568TRUST.ini
 MINIALL_INI=RK3568MINIALL.ini
 
@@ -35,6 +44,9 @@ build_uefi() {
 	echo " => Building UEFI"
 	build -n $(getconf _NPROCESSORS_ONLN) -b ${RKUEFIBUILDTYPE} -a AARCH64 -t GCC5 \
 	    -D FIRMWARE_VER="${FIRMWARE_VER}" \
+	    -D FV_COMPRESSION=${FV_COMPRESSION} \
+	    -D UART_BAUD_RATE=${UART_BAUD_RATE} \
+	    -D AHCI_NCQ_ENABLE=${AHCI_NCQ_ENABLE} \
 	    -p Platform/${vendor}/${board}/${board}.dsc
 }
 
@@ -43,9 +55,9 @@ build_idblock() {
 	FLASHFILES="FlashHead.bin FlashData.bin FlashBoot.bin"
 	rm -f idblock.bin rk35*_ddr_*.bin rk356x_usbplug*.bin UsbHead.bin ${FLASHFILES}
 
-	# Default DDR image uses 1.5M baud. Patch it to use 115200 to match UEFI first.
+	# Patch the DDR image baud rate (1.5M by default) to match UEFI.
 	cat `pwd`/${RKBIN}/tools/ddrbin_param.txt					 		\
-		| sed 's/^uart baudrate=.*$/uart baudrate=115200/'  		\
+		| sed "s/^uart baudrate=.*$/uart baudrate=${UART_BAUD_RATE}/"	\
 		| sed 's/^dis_printf_training=.*$/dis_printf_training=1/' 	\
 		> `pwd`/Build/ddrbin_param.txt
 	./${RKBIN}/tools/ddrbin_tool `pwd`/Build/ddrbin_param.txt ${RKBIN}/${DDR}
@@ -67,6 +79,11 @@ build_fit() {
 	type=$2
 	board_upper=`echo $board | tr '[:lower:]' '[:upper:]'`
 	echo " => Building FIT"
+	dtb_size=$(stat -c %s dtb/${type}.dtb)
+	if [ ${dtb_size} -gt $((FDT_SIZE)) ]; then
+		echo "dtb/${type}.dtb (${dtb_size} bytes) is larger than PcdFdtSize (${FDT_SIZE})"
+		exit 1
+	fi
 	./scripts/extractbl31.py ${RKBIN}/${BL31}
 	cat uefi.its | sed "s,@BOARDTYPE@,${type},g" > ${board_upper}_EFI.its
 	./${RKBIN}/tools/mkimage -f ${board_upper}_EFI.its -E ${board_upper}_EFI.itb
@@ -78,6 +95,7 @@ fetch_deps
 
 BL31=$(grep '^PATH=.*_bl31_' ${RKBIN}/RKTRUST/${TRUST_INI} | cut -d = -f 2-)
 DDR=$(grep '^Path1=.*_ddr_' ${RKBIN}/RKBOOT/${MINIALL_INI} | cut -d = -f 2-)
+FDT_SIZE=$(grep -o 'PcdFdtSize|[^|]*' edk2-rockchip/Platform/Rockchip/Rk356x/Rk356x.dec | cut -d '|' -f 2)
 
 test -r ${RKBIN}/${BL31} || (echo "${RKBIN}/${BL31} not found"; false)
 . edk2/edksetup.sh
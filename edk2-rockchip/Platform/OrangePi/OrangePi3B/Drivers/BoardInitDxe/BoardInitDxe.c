@@ -312,6 +312,9 @@ BoardInitDriverEntryPoint (
   GpioPinSetDirection (0, GPIO_PIN_PA6, GPIO_PIN_OUTPUT);
   GpioPinWrite (0, GPIO_PIN_PA6, TRUE);
 
+  /* Mux GPIO0 PC6 to PWM7 (FAN_PWM); ConfigDxe drives the duty cycle */
+  GpioPinSetFunction (0, GPIO_PIN_PC6, 1);
+
   /* GMAC setup */
   BoardInitGmac ();
 
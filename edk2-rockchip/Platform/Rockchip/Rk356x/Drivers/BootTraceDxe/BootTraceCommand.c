@@ -0,0 +1,178 @@
+/** @file
+ *
+ *  "boottrace" shell command.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BootTraceLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/ShellDynamicCommand.h>
+
+#include "BootTraceDxe.h"
+
+STATIC CONST CHAR16 mBootTraceCommandHelp[] =
+  L".TH boottrace 0 \"Show or save the boot trace.\"\r\n"
+  L".SH NAME\r\n"
+  L"Show or save the boot trace.\r\n"
+  L".SH SYNOPSIS\r\n"
+  L"\r\n"
+  L"BOOTTRACE [-c | file]\r\n"
+  L".SH OPTIONS\r\n"
+  L"\r\n"
+  L"  -c   - Clear the trace\r\n"
+  L"  file - Save the raw trace, for scripts/decodeboottrace.py\r\n"
+  L".SH DESCRIPTION\r\n"
+  L"\r\n"
+  L"Without arguments, lists the recorded events of this and previous\r\n"
+  L"boots. Times are in milliseconds since the system counter started.\r\n";
+
+STATIC CONST CHAR16 *mBootTraceNames[BootTraceIdMax] = {
+  NULL,
+  L"Reset",
+  L"MmuEnabled",
+  L"DxeStart",
+  L"DriverStart",
+  L"DriverEnd",
+  L"StatusCode",
+  L"ReadyToBoot",
+  L"ExitBootServices",
+  L"MemoryTestStart",
+  L"MemoryTestEnd",
+};
+
+STATIC
+VOID
+BootTracePrint (
+  IN BOOT_TRACE_HEADER *Header
+  )
+{
+  BOOT_TRACE_ENTRY  *Entries;
+  BOOT_TRACE_ENTRY  *Entry;
+  UINT64            Count;
+  UINT64            Index;
+  UINT32            TicksPerUs;
+  UINT64            Us;
+  EFI_GUID          FileGuid;
+
+  Entries = (BOOT_TRACE_ENTRY *)(Header + 1);
+  Count = MIN (Header->Head, Header->NumEntries);
+  TicksPerUs = MAX ((UINT32)(Header->Frequency / 1000000), 1);
+
+  Print (L"Boot      Time (ms)  Event\n");
+  for (Index = Header->Head - Count; Index < Header->Head; Index++) {
+    Entry = &Entries[ModU64x32 (Index, Header->NumEntries)];
+    Us = DivU64x32 (Entry->Timestamp, TicksPerUs);
+    Print (L"%4u %10lu.%03lu  ", Entry->Boot, Us / 1000, Us % 1000);
+
+    if (Entry->Id >= BootTraceIdMax || mBootTraceNames[Entry->Id] == NULL) {
+      Print (L"%u 0x%lx 0x%lx\n", Entry->Id, Entry->Arg[0], Entry->Arg[1]);
+    } else if (Entry->Id == BootTraceIdDriverStart || Entry->Id == BootTraceIdDriverEnd) {
+      WriteUnaligned64 ((UINT64 *)&FileGuid, Entry->Arg[0]);
+      WriteUnaligned64 ((UINT64 *)&FileGuid + 1, Entry->Arg[1]);
+      Print (L"%-16s %g\n", mBootTraceNames[Entry->Id], &FileGuid);
+    } else {
+      Print (L"%-16s 0x%lx 0x%lx\n", mBootTraceNames[Entry->Id], Entry->Arg[0], Entry->Arg[1]);
+    }
+  }
+}
+
+STATIC
+EFI_STATUS
+BootTraceSave (
+  IN BOOT_TRACE_HEADER  *Header,
+  IN EFI_SHELL_PROTOCOL *Shell,
+  IN CONST CHAR16       *FileName
+  )
+{
+  EFI_STATUS          Status;
+  SHELL_FILE_HANDLE   File;
+  UINTN               Size;
+
+  Status = Shell->CreateFile (FileName, 0, &File);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Size = sizeof (*Header) + (UINTN)Header->NumEntries * Header->EntrySize;
+  Status = Shell->WriteFile (File, &Size, Header);
+  Shell->CloseFile (File);
+
+  return Status;
+}
+
+STATIC
+SHELL_STATUS
+EFIAPI
+BootTraceCommandHandler (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN EFI_SYSTEM_TABLE                     *SystemTable,
+  IN EFI_SHELL_PARAMETERS_PROTOCOL        *ShellParameters,
+  IN EFI_SHELL_PROTOCOL                   *Shell
+  )
+{
+  EFI_STATUS          Status;
+  BOOT_TRACE_HEADER   *Header;
+
+  if (ShellParameters->Argc > 2) {
+    Print (L"usage: boottrace [-c | file]\n");
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  Header = BootTraceGetHeader ();
+  if (Header == NULL) {
+    Print (L"boottrace: no trace\n");
+    return SHELL_NOT_FOUND;
+  }
+
+  if (ShellParameters->Argc == 1) {
+    BootTracePrint (Header);
+  } else if (StrCmp (ShellParameters->Argv[1], L"-c") == 0) {
+    BootTraceClear ();
+  } else {
+    Status = BootTraceSave (Header, Shell, ShellParameters->Argv[1]);
+    if (EFI_ERROR (Status)) {
+      Print (L"boottrace: %s: %r\n", ShellParameters->Argv[1], Status);
+      return SHELL_DEVICE_ERROR;
+    }
+    Print (L"Saved %lu events\n", MIN (Header->Head, Header->NumEntries));
+  }
+
+  return SHELL_SUCCESS;
+}
+
+STATIC
+CHAR16 *
+EFIAPI
+BootTraceCommandGetHelp (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN CONST CHAR8                          *Language
+  )
+{
+  return AllocateCopyPool (sizeof (mBootTraceCommandHelp), mBootTraceCommandHelp);
+}
+
+STATIC EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL mBootTraceCommand = {
+  L"boottrace",
+  BootTraceCommandHandler,
+  BootTraceCommandGetHelp
+};
+
+EFI_STATUS
+BootTraceCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  )
+{
+  return gBS->InstallMultipleProtocolInterfaces (&ImageHandle,
+                                                 &gEfiShellDynamicCommandProtocolGuid,
+                                                 &mBootTraceCommand,
+                                                 NULL);
+}
@@ -0,0 +1,168 @@
+/** @file
+ *
+ *  Boot trace export.
+ *
+ *  Driver dispatch and boot progress are traced from the status codes
+ *  reported by the DXE core and BDS, so that every driver shows up in the
+ *  trace without being modified.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <PiDxe.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BootTraceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/LoadedImage.h>
+#include <Protocol/ReportStatusCodeHandler.h>
+
+#include "BootTraceDxe.h"
+
+STATIC EFI_RSC_HANDLER_PROTOCOL *mRscHandler;
+STATIC EFI_EVENT                mReadyToBootEvent;
+STATIC EFI_EVENT                mExitBootServicesEvent;
+
+/*
+ * Returns the FFS file name of a loaded image.
+ */
+STATIC
+CONST EFI_GUID *
+BootTraceGetImageGuid (
+  IN EFI_HANDLE ImageHandle
+  )
+{
+  EFI_STATUS                  Status;
+  EFI_LOADED_IMAGE_PROTOCOL   *LoadedImage;
+
+  //
+  // Status codes may be reported at any TPL.
+  //
+  if (EfiGetCurrentTpl () > TPL_NOTIFY) {
+    return NULL;
+  }
+
+  Status = gBS->HandleProtocol (ImageHandle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage);
+  if (EFI_ERROR (Status) || LoadedImage->FilePath == NULL) {
+    return NULL;
+  }
+
+  return EfiGetNameGuidFromFwVolDevicePathNode (
+           (CONST MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)LoadedImage->FilePath);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+BootTraceStatusCodeHandler (
+  IN EFI_STATUS_CODE_TYPE   CodeType,
+  IN EFI_STATUS_CODE_VALUE  Value,
+  IN UINT32                 Instance,
+  IN EFI_GUID               *CallerId,
+  IN EFI_STATUS_CODE_DATA   *Data
+  )
+{
+  CONST EFI_GUID  *FileGuid;
+
+  if ((CodeType & EFI_STATUS_CODE_TYPE_MASK) != EFI_PROGRESS_CODE) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The DXE core brackets each driver entry point with these, passing the
+  // image handle as extended data.
+  //
+  if ((Value == (EFI_SOFTWARE_DXE_CORE | EFI_SW_PC_INIT_BEGIN) ||
+       Value == (EFI_SOFTWARE_DXE_CORE | EFI_SW_PC_INIT_END)) &&
+      Data != NULL && Data->Size == sizeof (EFI_HANDLE)) {
+    FileGuid = BootTraceGetImageGuid (*(EFI_HANDLE *)((UINT8 *)Data + Data->HeaderSize));
+    if (FileGuid != NULL) {
+      BootTrace (Value == (EFI_SOFTWARE_DXE_CORE | EFI_SW_PC_INIT_BEGIN) ?
+                 BootTraceIdDriverStart : BootTraceIdDriverEnd,
+                 ReadUnaligned64 ((CONST UINT64 *)FileGuid),
+                 ReadUnaligned64 ((CONST UINT64 *)FileGuid + 1));
+      return EFI_SUCCESS;
+    }
+  }
+
+  BootTrace (BootTraceIdStatusCode, CodeType, Value);
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+EFIAPI
+BootTraceOnReadyToBoot (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  BootTrace (BootTraceIdReadyToBoot, 0, 0);
+}
+
+STATIC
+VOID
+EFIAPI
+BootTraceOnExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  BootTrace (BootTraceIdExitBootServices, 0, 0);
+
+  //
+  // The handler uses boot services.
+  //
+  mRscHandler->Unregister (BootTraceStatusCodeHandler);
+}
+
+EFI_STATUS
+EFIAPI
+BootTraceDxeInitialize (
+  IN EFI_HANDLE         ImageHandle,
+  IN EFI_SYSTEM_TABLE   *SystemTable
+  )
+{
+  EFI_STATUS          Status;
+  BOOT_TRACE_HEADER   *Header;
+
+  BootTrace (BootTraceIdDxeStart, 0, 0);
+
+  Header = BootTraceGetHeader ();
+  if (Header == NULL) {
+    DEBUG ((DEBUG_WARN, "BootTrace: Ring not initialized\n"));
+    return EFI_NOT_READY;
+  }
+
+  DEBUG ((DEBUG_INFO, "BootTrace: Boot %u, %lu events at 0x%p\n",
+          Header->Boot, Header->Head, Header));
+
+  //
+  // For OS side tools. The ring is in reserved memory, so it stays valid
+  // after ExitBootServices.
+  //
+  Status = gBS->InstallConfigurationTable (&gRk356xBootTraceTableGuid, Header);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "BootTrace: Failed to install configuration table: %r\n", Status));
+  }
+
+  Status = gBS->LocateProtocol (&gEfiRscHandlerProtocolGuid, NULL, (VOID **)&mRscHandler);
+  ASSERT_EFI_ERROR (Status);
+  Status = mRscHandler->Register (BootTraceStatusCodeHandler, TPL_HIGH_LEVEL);
+  ASSERT_EFI_ERROR (Status);
+
+  Status = EfiCreateEventReadyToBootEx (TPL_CALLBACK, BootTraceOnReadyToBoot,
+                                        NULL, &mReadyToBootEvent);
+  ASSERT_EFI_ERROR (Status);
+  Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_NOTIFY,
+                             BootTraceOnExitBootServices, NULL, &mExitBootServicesEvent);
+  ASSERT_EFI_ERROR (Status);
+
+  return BootTraceCommandInstall (ImageHandle);
+}
@@ -0,0 +1,19 @@
+/** @file
+ *
+ *  Boot trace export.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef BOOT_TRACE_DXE_H_
+#define BOOT_TRACE_DXE_H_
+
+EFI_STATUS
+BootTraceCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  );
+
+#endif /* BOOT_TRACE_DXE_H_ */
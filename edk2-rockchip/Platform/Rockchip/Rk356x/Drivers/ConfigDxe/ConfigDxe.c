@@ -21,6 +21,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PlatformConfigLib.h>
 #include <Library/CpuVoltageLib.h>
 #include <Library/GpioLib.h>
 #include <Protocol/ArmScmi.h>
@@ -34,6 +35,7 @@
 #define FAN_GPIO_BANK             FixedPcdGet8 (PcdFanGpioBank)
 #define FAN_GPIO_PIN              FixedPcdGet8 (PcdFanGpioPin)
 #define FAN_GPIO_ENABLE_VALUE     FixedPcdGetBool (PcdFanGpioActiveHigh)
+#define FAN_PWM_CONTROLLER        FixedPcdGet8 (PcdFanPwmController)
 
 extern UINT8 ConfigDxeHiiBin[];
 extern UINT8 ConfigDxeStrings[];
@@ -96,6 +98,8 @@ InstallHiiPages (
            NULL);
     return EFI_OUT_OF_RESOURCES;
   }
+
+  DmcUpdateHiiRates (HiiHandle);
   return EFI_SUCCESS;
 }
 
@@ -261,8 +265,11 @@ SetupVariables (
 {
   UINTN      Size;
   UINT32     Var32;
-#if FAN_GPIO_BANK != 0xFF
+#if FAN_GPIO_BANK != 0xFF || FAN_PWM_CONTROLLER != 0xFF
   BOOLEAN    VarBool;
+#endif
+#if FAN_PWM_CONTROLLER != 0xFF
+  FAN_CURVE_VARSTORE_DATA FanCurve;
 #endif
   EFI_STATUS Status;
 
@@ -280,6 +287,15 @@ SetupVariables (
     ASSERT_EFI_ERROR (Status);
   }
 
+  Size = sizeof (UINT32);
+  Status = gRT->GetVariable (L"PerformanceProfile",
+                  &gConfigDxeFormSetGuid,
+                  NULL, &Size, &Var32);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet32S (PcdPerformanceProfile, PcdGet32 (PcdPerformanceProfile));
+    ASSERT_EFI_ERROR (Status);
+  }
+
   Size = sizeof (UINT32);
   Status = gRT->GetVariable (L"CpuClock",
                   &gConfigDxeFormSetGuid,
@@ -289,6 +305,42 @@ SetupVariables (
     ASSERT_EFI_ERROR (Status);
   }
 
+  Size = sizeof (UINT32);
+  Status = gRT->GetVariable (L"DmcClock",
+                  &gConfigDxeFormSetGuid,
+                  NULL, &Size, &Var32);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet32S (PcdDmcClock, PcdGet32 (PcdDmcClock));
+    ASSERT_EFI_ERROR (Status);
+  }
+
+  Size = sizeof (UINT32);
+  Status = gRT->GetVariable (L"CustomDmcClock",
+                  &gConfigDxeFormSetGuid,
+                  NULL, &Size, &Var32);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet32S (PcdCustomDmcClock, PcdGet32 (PcdCustomDmcClock));
+    ASSERT_EFI_ERROR (Status);
+  }
+
+  Size = sizeof (UINT32);
+  Status = gRT->GetVariable (L"MemoryTest",
+                  &gConfigDxeFormSetGuid,
+                  NULL, &Size, &Var32);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet32S (PcdMemoryTest, PcdGet32 (PcdMemoryTest));
+    ASSERT_EFI_ERROR (Status);
+  }
+
+  Size = sizeof (UINT32);
+  Status = gRT->GetVariable (L"FastBoot",
+                  &gConfigDxeFormSetGuid,
+                  NULL, &Size, &Var32);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet32S (PcdFastBoot, PcdGet32 (PcdFastBoot));
+    ASSERT_EFI_ERROR (Status);
+  }
+
   Size = sizeof (UINT32);
   Status = gRT->GetVariable (L"CustomCpuClock",
                              &gConfigDxeFormSetGuid,
@@ -298,6 +350,15 @@ SetupVariables (
     ASSERT_EFI_ERROR (Status);
   }
 
+  Size = sizeof (UINT32);
+  Status = gRT->GetVariable (L"ThermalCriticalTrip",
+                             &gConfigDxeFormSetGuid,
+                             NULL, &Size, &Var32);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet32S (PcdThermalCriticalTrip, PcdGet32 (PcdThermalCriticalTrip));
+    ASSERT_EFI_ERROR (Status);
+  }
+
 #ifdef QUARTZ64
   Size = sizeof (UINT32);
   Status = gRT->GetVariable (L"MultiPhy1Mode",
@@ -309,8 +370,7 @@ SetupVariables (
   }
 #endif
 
-#if FAN_GPIO_BANK != 0xFF
-  ASSERT (FAN_GPIO_PIN != 0xFF);
+#if FAN_GPIO_BANK != 0xFF || FAN_PWM_CONTROLLER != 0xFF
   Size = sizeof (BOOLEAN);
   Status = gRT->GetVariable (L"FanMode",
                              &gConfigDxeFormSetGuid,
@@ -321,6 +381,41 @@ SetupVariables (
   }
 #endif
 
+#if FAN_PWM_CONTROLLER != 0xFF
+  Size = sizeof (FanCurve);
+  Status = gRT->GetVariable (L"FanCurve",
+                             &gConfigDxeFormSetGuid,
+                             NULL, &Size, &FanCurve);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet8S (PcdFanCurveTemp0, PcdGet8 (PcdFanCurveTemp0));
+    ASSERT_EFI_ERROR (Status);
+    Status = PcdSet8S (PcdFanCurveTemp1, PcdGet8 (PcdFanCurveTemp1));
+    ASSERT_EFI_ERROR (Status);
+    Status = PcdSet8S (PcdFanCurveTemp2, PcdGet8 (PcdFanCurveTemp2));
+    ASSERT_EFI_ERROR (Status);
+    Status = PcdSet8S (PcdFanCurveTemp3, PcdGet8 (PcdFanCurveTemp3));
+    ASSERT_EFI_ERROR (Status);
+    Status = PcdSet8S (PcdFanCurveDuty0, PcdGet8 (PcdFanCurveDuty0));
+    ASSERT_EFI_ERROR (Status);
+    Status = PcdSet8S (PcdFanCurveDuty1, PcdGet8 (PcdFanCurveDuty1));
+    ASSERT_EFI_ERROR (Status);
+    Status = PcdSet8S (PcdFanCurveDuty2, PcdGet8 (PcdFanCurveDuty2));
+    ASSERT_EFI_ERROR (Status);
+    Status = PcdSet8S (PcdFanCurveDuty3, PcdGet8 (PcdFanCurveDuty3));
+    ASSERT_EFI_ERROR (Status);
+  }
+#elif FAN_GPIO_BANK != 0xFF
+  ASSERT (FAN_GPIO_PIN != 0xFF);
+  Size = sizeof (UINT32);
+  Status = gRT->GetVariable (L"ThermalFanTrip",
+                             &gConfigDxeFormSetGuid,
+                             NULL, &Size, &Var32);
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet32S (PcdThermalFanTrip, PcdGet32 (PcdThermalFanTrip));
+    ASSERT_EFI_ERROR (Status);
+  }
+#endif
+
   return EFI_SUCCESS;
 }
 
@@ -331,15 +426,20 @@ ApplyVariables (
   )
 {
   EFI_STATUS Status;
-  UINT32     CpuClock = PcdGet32 (PcdCpuClock);
+  UINT32     CpuClock = PlatformConfigGetCpuClock ();
   UINT32     CustomCpuClock = PcdGet32 (PcdCustomCpuClock);
   UINT64     SpeedHz;
   UINT64     CurSpeedHz;
 
-#if FAN_GPIO_BANK != 0xFF
   /*
    * Fan settings
    */
+#if FAN_PWM_CONTROLLER != 0xFF
+  Status = FanControlInit (PcdGetBool (PcdFanMode));
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Couldn't set up PWM fan: %r\n", Status));
+  }
+#elif FAN_GPIO_BANK != 0xFF
   if (PcdGetBool (PcdFanMode)) {
     GpioPinSetDirection (FAN_GPIO_BANK, FAN_GPIO_PIN, GPIO_PIN_OUTPUT);
     GpioPinWrite (FAN_GPIO_BANK, FAN_GPIO_PIN, FAN_GPIO_ENABLE_VALUE);
@@ -379,6 +479,11 @@ ApplyVariables (
       Status = CpuVoltageSet (SpeedHz);
     }
   }
+
+  /*
+   * DDR clock settings
+   */
+  ApplyDmcClock ();
 }
 
 
@@ -425,6 +530,16 @@ ConfigInitialize (
     DEBUG ((DEBUG_ERROR, "Couldn't install ConfigDxe configuration pages: %r\n", Status));
   }
 
+  Status = DmcCommandInstall (ImageHandle);
+  if (Status != EFI_SUCCESS) {
+    DEBUG ((DEBUG_ERROR, "Couldn't install dmc shell command: %r\n", Status));
+  }
+
+  Status = SataCommandInstall ();
+  if (Status != EFI_SUCCESS) {
+    DEBUG ((DEBUG_ERROR, "Couldn't install sata shell command: %r\n", Status));
+  }
+
   Status = gBS->CreateEventEx (EVT_NOTIFY_SIGNAL, TPL_NOTIFY, RemoveTables,
                                NULL, &gEfiEndOfDxeEventGroupGuid, &EndOfDxeEvent);
   ASSERT_EFI_ERROR (Status);
@@ -12,4 +12,50 @@
 
 #include <Uefi.h>
 
+EFI_STATUS
+FanControlInit (
+  IN BOOLEAN Enable
+  );
+
+VOID
+ApplyDmcClock (
+  VOID
+  );
+
+EFI_STATUS
+DmcGetRate (
+  OUT UINT64 *Rate
+  );
+
+EFI_STATUS
+DmcSetRate (
+  IN UINT64 Rate
+  );
+
+EFI_STATUS
+DmcGetTrainedRate (
+  OUT UINT64 *Rate
+  );
+
+EFI_STATUS
+DmcGetRates (
+  OUT UINT64 **Rates,
+  OUT UINT32 *NumRates
+  );
+
+VOID
+DmcUpdateHiiRates (
+  IN EFI_HII_HANDLE HiiHandle
+  );
+
+EFI_STATUS
+DmcCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  );
+
+EFI_STATUS
+SataCommandInstall (
+  VOID
+  );
+
 #endif /* _CONFIG_DXE_H_ */
@@ -0,0 +1,325 @@
+/** @file
+ *
+ *  DDR memory controller (DMC) frequency selection. The DMC clock is
+ *  exposed by the secure firmware as an SCMI clock.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/DebugLib.h>
+#include <Library/HiiLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PlatformConfigLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Protocol/ArmScmi.h>
+#include <Protocol/ArmScmiClockProtocol.h>
+#include <ConfigVars.h>
+#include "ConfigDxe.h"
+
+#define CLOCK_ID_CLK_SCMI_DDR     3
+#define FREQ_1_MHZ                1000000
+
+//
+// Rate the DRAM was trained at by the DDR loader. Higher rates are never
+// used, as the logic rail voltage is not adjusted here.
+//
+STATIC UINT64 mDmcTrainedRate;
+
+//
+// Custom rate (MHz) from setup that the firmware doesn't support, if any.
+// Reported on the setup page instead of silently using a different rate.
+//
+STATIC UINT32 mDmcRejectedRate;
+
+//
+// These are also used by the dmc shell command, after EndOfDxe, while the
+// TsadcDxe thermal governor may issue SCMI requests from a TPL_CALLBACK
+// timer. Keep the timer out for the whole of each request, from filling
+// in the mailbox payload to reading the response.
+//
+#define DMC_SCMI_TPL              TPL_CALLBACK
+
+STATIC
+SCMI_CLOCK_PROTOCOL *
+DmcGetClockProtocol (
+  VOID
+  )
+{
+  EFI_STATUS             Status;
+  SCMI_CLOCK_PROTOCOL    *ClockProtocol;
+  EFI_GUID               ClockProtocolGuid = ARM_SCMI_CLOCK_PROTOCOL_GUID;
+
+  Status = gBS->LocateProtocol (&ClockProtocolGuid, NULL, (VOID **)&ClockProtocol);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+  return ClockProtocol;
+}
+
+EFI_STATUS
+DmcGetRate (
+  OUT UINT64 *Rate
+  )
+{
+  EFI_STATUS             Status;
+  EFI_TPL                OldTpl;
+  SCMI_CLOCK_PROTOCOL    *ClockProtocol;
+
+  ClockProtocol = DmcGetClockProtocol ();
+  if (ClockProtocol == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  OldTpl = gBS->RaiseTPL (DMC_SCMI_TPL);
+  Status = ClockProtocol->RateGet (ClockProtocol, CLOCK_ID_CLK_SCMI_DDR, Rate);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+EFI_STATUS
+DmcSetRate (
+  IN UINT64 Rate
+  )
+{
+  EFI_STATUS             Status;
+  EFI_TPL                OldTpl;
+  SCMI_CLOCK_PROTOCOL    *ClockProtocol;
+  UINT64                 CurRate;
+
+  if (mDmcTrainedRate != 0 && Rate > mDmcTrainedRate) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ClockProtocol = DmcGetClockProtocol ();
+  if (ClockProtocol == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  OldTpl = gBS->RaiseTPL (DMC_SCMI_TPL);
+  Status = ClockProtocol->RateSet (ClockProtocol, CLOCK_ID_CLK_SCMI_DDR, Rate);
+  gBS->RestoreTPL (OldTpl);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "SCMI: clock %u: Couldn't set rate to %luHz: %r\n",
+            CLOCK_ID_CLK_SCMI_DDR, Rate, Status));
+    return Status;
+  }
+
+  OldTpl = gBS->RaiseTPL (DMC_SCMI_TPL);
+  Status = ClockProtocol->RateGet (ClockProtocol, CLOCK_ID_CLK_SCMI_DDR, &CurRate);
+  gBS->RestoreTPL (OldTpl);
+  if (!EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "SCMI: clock %u: Current rate is %luHz\n",
+            CLOCK_ID_CLK_SCMI_DDR, CurRate));
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+DmcGetTrainedRate (
+  OUT UINT64 *Rate
+  )
+{
+  if (mDmcTrainedRate == 0) {
+    return EFI_NOT_READY;
+  }
+
+  *Rate = mDmcTrainedRate;
+  return EFI_SUCCESS;
+}
+
+/*
+ * Returns the supported DMC rates, in ascending order, up to the trained
+ * rate. The caller must free the returned array.
+ */
+EFI_STATUS
+DmcGetRates (
+  OUT UINT64 **Rates,
+  OUT UINT32 *NumRates
+  )
+{
+  EFI_STATUS             Status;
+  EFI_TPL                OldTpl;
+  SCMI_CLOCK_PROTOCOL    *ClockProtocol;
+  UINT32                 TotalRates;
+  UINT32                 ClockRateSize;
+  SCMI_CLOCK_RATE        *ClockRate;
+  SCMI_CLOCK_RATE_FORMAT ClockRateFormat;
+  UINT64                 Rate;
+  UINT32                 Index;
+  UINT32                 Count;
+  UINT32                 Pos;
+
+  ClockProtocol = DmcGetClockProtocol ();
+  if (ClockProtocol == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  TotalRates = 0;
+  ClockRateSize = 0;
+  OldTpl = gBS->RaiseTPL (DMC_SCMI_TPL);
+  Status = ClockProtocol->DescribeRates (ClockProtocol, CLOCK_ID_CLK_SCMI_DDR,
+                                         &ClockRateFormat, &TotalRates,
+                                         &ClockRateSize, NULL);
+  gBS->RestoreTPL (OldTpl);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return EFI_ERROR (Status) ? Status : EFI_DEVICE_ERROR;
+  }
+  if (TotalRates == 0 || ClockRateFormat != ScmiClockRateFormatDiscrete) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ClockRateSize = sizeof (*ClockRate) * TotalRates;
+  ClockRate = AllocatePool (ClockRateSize);
+  if (ClockRate == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  OldTpl = gBS->RaiseTPL (DMC_SCMI_TPL);
+  Status = ClockProtocol->DescribeRates (ClockProtocol, CLOCK_ID_CLK_SCMI_DDR,
+                                         &ClockRateFormat, &TotalRates,
+                                         &ClockRateSize, ClockRate);
+  gBS->RestoreTPL (OldTpl);
+  if (EFI_ERROR (Status)) {
+    FreePool (ClockRate);
+    return Status;
+  }
+
+  *Rates = AllocatePool (sizeof (UINT64) * TotalRates);
+  if (*Rates == NULL) {
+    FreePool (ClockRate);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Insertion sort, skipping rates above the trained rate.
+  //
+  Count = 0;
+  for (Index = 0; Index < TotalRates; Index++) {
+    Rate = ClockRate[Index].DiscreteRate.Rate;
+    if (Rate == 0 || (mDmcTrainedRate != 0 && Rate > mDmcTrainedRate)) {
+      continue;
+    }
+    for (Pos = Count; Pos > 0 && (*Rates)[Pos - 1] > Rate; Pos--) {
+      (*Rates)[Pos] = (*Rates)[Pos - 1];
+    }
+    (*Rates)[Pos] = Rate;
+    Count++;
+  }
+  FreePool (ClockRate);
+
+  if (Count == 0) {
+    FreePool (*Rates);
+    return EFI_UNSUPPORTED;
+  }
+
+  *NumRates = Count;
+  return EFI_SUCCESS;
+}
+
+VOID
+ApplyDmcClock (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      *Rates;
+  UINT32      NumRates;
+  UINT32      Index;
+  UINT64      Target;
+  UINT64      Rate;
+  BOOLEAN     Found;
+
+  Status = DmcGetRate (&mDmcTrainedRate);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "DMC: Couldn't get DDR clock rate: %r\n", Status));
+    mDmcTrainedRate = 0;
+    return;
+  }
+  DEBUG ((DEBUG_INFO, "DMC: Trained rate is %luHz\n", mDmcTrainedRate));
+
+  switch (PlatformConfigGetDmcClock ()) {
+  case DMCCLOCK_LOW:
+  case DMCCLOCK_CUSTOM:
+    break;
+  default:
+    return;
+  }
+
+  Status = DmcGetRates (&Rates, &NumRates);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "DMC: Couldn't get DDR clock rates: %r\n", Status));
+    return;
+  }
+
+  if (PlatformConfigGetDmcClock () == DMCCLOCK_LOW) {
+    Rate = Rates[0];
+  } else {
+    //
+    // Only use the custom rate if the firmware offers it exactly. Not all
+    // of the rates in the setup form are available with every DDR loader,
+    // and silently running at another rate would skew any measurement
+    // made at the "selected" one.
+    //
+    Target = (UINT64)PcdGet32 (PcdCustomDmcClock) * FREQ_1_MHZ;
+    Found = FALSE;
+    for (Index = 0; Index < NumRates; Index++) {
+      if (Rates[Index] == Target) {
+        Found = TRUE;
+        break;
+      }
+    }
+    if (!Found) {
+      DEBUG ((DEBUG_ERROR, "DMC: %u MHz is not a supported DDR clock rate, keeping %lu MHz\n",
+              PcdGet32 (PcdCustomDmcClock), mDmcTrainedRate / FREQ_1_MHZ));
+      mDmcRejectedRate = PcdGet32 (PcdCustomDmcClock);
+      FreePool (Rates);
+      return;
+    }
+    Rate = Target;
+  }
+  FreePool (Rates);
+
+  if (Rate != mDmcTrainedRate) {
+    DmcSetRate (Rate);
+  }
+}
+
+VOID
+DmcUpdateHiiRates (
+  IN EFI_HII_HANDLE HiiHandle
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      *Rates;
+  UINT32      NumRates;
+  UINT32      Index;
+  CHAR16      Buffer[128];
+  UINTN       Length;
+
+  Status = DmcGetRates (&Rates, &NumRates);
+  if (EFI_ERROR (Status)) {
+    UnicodeSPrint (Buffer, sizeof (Buffer), L"Not supported by firmware");
+  } else {
+    Length = 0;
+    for (Index = 0; Index < NumRates && Length < ARRAY_SIZE (Buffer); Index++) {
+      Length += UnicodeSPrint (Buffer + Length, sizeof (Buffer) - Length * sizeof (CHAR16),
+                               Index == 0 ? L"%lu" : L", %lu", Rates[Index] / FREQ_1_MHZ);
+    }
+    Length += UnicodeSPrint (Buffer + Length, sizeof (Buffer) - Length * sizeof (CHAR16), L" MHz");
+    if (mDmcRejectedRate != 0) {
+      UnicodeSPrint (Buffer + Length, sizeof (Buffer) - Length * sizeof (CHAR16),
+                     L" (error: %u MHz not supported, custom rate ignored)", mDmcRejectedRate);
+    }
+    FreePool (Rates);
+  }
+
+  HiiSetString (HiiHandle, STRING_TOKEN (STR_SYSCONFIG_DMCCLOCK_RATES), Buffer, NULL);
+}
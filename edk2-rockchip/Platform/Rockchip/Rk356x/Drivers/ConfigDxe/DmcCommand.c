@@ -0,0 +1,163 @@
+/** @file
+ *
+ *  "dmc" shell command. Shows the DDR clock rates and switches between
+ *  them, so that membench can be run at each rate.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/ShellDynamicCommand.h>
+#include "ConfigDxe.h"
+
+#define FREQ_1_MHZ                1000000
+
+STATIC CONST CHAR16 mDmcCommandHelp[] =
+  L".TH dmc 0 \"Display or change the DDR clock rate.\"\r\n"
+  L".SH NAME\r\n"
+  L"Display or change the DDR clock rate.\r\n"
+  L".SH SYNOPSIS\r\n"
+  L"\r\n"
+  L"DMC [set <MHz>]\r\n"
+  L".SH OPTIONS\r\n"
+  L"\r\n"
+  L"  set - Switch to one of the supported DDR clock rates until reset\r\n"
+  L".SH DESCRIPTION\r\n"
+  L"\r\n"
+  L"Shows the current DDR clock rate and the rates supported by the firmware.\r\n"
+  L"To compare memory performance across rates, run membench after each\r\n"
+  L"dmc set. The rate selected in setup is applied again on the next boot.\r\n";
+
+STATIC
+SHELL_STATUS
+DmcCommandSet (
+  IN UINT64       *Rates,
+  IN UINT32       NumRates,
+  IN CONST CHAR16 *Arg
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      Rate;
+  UINT32      Index;
+
+  Rate = MultU64x32 (StrDecimalToUint64 (Arg), FREQ_1_MHZ);
+  for (Index = 0; Index < NumRates; Index++) {
+    if (Rates[Index] == Rate) {
+      break;
+    }
+  }
+  if (Index == NumRates) {
+    Print (L"dmc: %s MHz is not a supported DDR clock rate\n", Arg);
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  Status = DmcSetRate (Rate);
+  if (EFI_ERROR (Status)) {
+    Print (L"dmc: couldn't set DDR clock rate: %r\n", Status);
+    return SHELL_DEVICE_ERROR;
+  }
+
+  Status = DmcGetRate (&Rate);
+  if (!EFI_ERROR (Status)) {
+    Print (L"DDR clock:            %lu MHz\n", Rate / FREQ_1_MHZ);
+  }
+
+  return SHELL_SUCCESS;
+}
+
+STATIC
+SHELL_STATUS
+EFIAPI
+DmcCommandHandler (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN EFI_SYSTEM_TABLE                     *SystemTable,
+  IN EFI_SHELL_PARAMETERS_PROTOCOL        *ShellParameters,
+  IN EFI_SHELL_PROTOCOL                   *Shell
+  )
+{
+  EFI_STATUS    Status;
+  SHELL_STATUS  ShellStatus;
+  UINT64        CurRate;
+  UINT64        TrainedRate;
+  UINT64        *Rates;
+  UINT32        NumRates;
+  UINT32        Index;
+  BOOLEAN       Set;
+
+  Set = FALSE;
+  if (ShellParameters->Argc == 3 && StrCmp (ShellParameters->Argv[1], L"set") == 0) {
+    Set = TRUE;
+  } else if (ShellParameters->Argc != 1) {
+    Print (L"usage: dmc [set <MHz>]\n");
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  Status = DmcGetRate (&CurRate);
+  if (EFI_ERROR (Status)) {
+    Print (L"dmc: couldn't get DDR clock rate: %r\n", Status);
+    return SHELL_DEVICE_ERROR;
+  }
+  if (!Set) {
+    Print (L"DDR clock:            %lu MHz\n", CurRate / FREQ_1_MHZ);
+    if (!EFI_ERROR (DmcGetTrainedRate (&TrainedRate))) {
+      Print (L"Trained DDR clock:    %lu MHz\n", TrainedRate / FREQ_1_MHZ);
+    }
+  }
+
+  Status = DmcGetRates (&Rates, &NumRates);
+  if (EFI_ERROR (Status)) {
+    Print (L"Supported DDR clocks: %r\n", Status);
+    return Set ? SHELL_UNSUPPORTED : SHELL_SUCCESS;
+  }
+
+  ShellStatus = SHELL_SUCCESS;
+  if (Set) {
+    ShellStatus = DmcCommandSet (Rates, NumRates, ShellParameters->Argv[2]);
+  } else {
+    Print (L"Supported DDR clocks:");
+    for (Index = 0; Index < NumRates; Index++) {
+      Print (L" %lu", Rates[Index] / FREQ_1_MHZ);
+    }
+    Print (L" MHz\n");
+  }
+  FreePool (Rates);
+
+  return ShellStatus;
+}
+
+STATIC
+CHAR16 *
+EFIAPI
+DmcCommandGetHelp (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN CONST CHAR8                          *Language
+  )
+{
+  return AllocateCopyPool (sizeof (mDmcCommandHelp), mDmcCommandHelp);
+}
+
+STATIC EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL mDmcCommand = {
+  L"dmc",
+  DmcCommandHandler,
+  DmcCommandGetHelp
+};
+
+EFI_STATUS
+DmcCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  )
+{
+  return gBS->InstallMultipleProtocolInterfaces (&ImageHandle,
+                                                 &gEfiShellDynamicCommandProtocolGuid,
+                                                 &mDmcCommand,
+                                                 NULL);
+}
@@ -0,0 +1,199 @@
+/** @file
+ *
+ *  PWM fan control. Drives the fan duty cycle from the TS-ADC temperature
+ *  using the fan curve configured in setup, until the OS takes over.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PlatformConfigLib.h>
+#include <Library/PwmLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Protocol/Rk356xThermal.h>
+#include <ConfigVars.h>
+#include "ConfigDxe.h"
+
+#define FAN_PWM_CONTROLLER        FixedPcdGet8 (PcdFanPwmController)
+#define FAN_PWM_CHANNEL           FixedPcdGet8 (PcdFanPwmChannel)
+#define FAN_PWM_PERIOD_NS         FixedPcdGet32 (PcdFanPwmPeriodNs)
+#define FAN_PWM_INVERTED          FixedPcdGetBool (PcdFanPwmInverted)
+
+#define FAN_CONTROL_PERIOD        EFI_TIMER_PERIOD_SECONDS (2)
+// Only slow the fan down once the temperature has dropped this far (mC)
+#define FAN_CONTROL_HYSTERESIS    2000
+
+#if FAN_PWM_CONTROLLER != 0xFF
+
+STATIC FAN_CURVE_VARSTORE_DATA    mFanCurve;
+STATIC RK356X_THERMAL_PROTOCOL    *mThermal;
+STATIC EFI_EVENT                  mFanTimer;
+STATIC UINT8                      mFanDuty;
+
+/*
+ * Map a temperature (in millidegrees C) to a duty cycle (in percent).
+ * The fan is off below the first point, runs at the last point's duty
+ * cycle above the last point, and is interpolated in between.
+ */
+STATIC
+UINT8
+FanCurveGetDuty (
+  IN INT32 Temperature
+  )
+{
+  UINTN  Index;
+  INT32  T0, T1;
+  INT32  D0, D1;
+
+  if (Temperature < mFanCurve.Temp[0] * 1000) {
+    return 0;
+  }
+
+  for (Index = 1; Index < FAN_CURVE_POINTS; Index++) {
+    T1 = mFanCurve.Temp[Index] * 1000;
+    if (Temperature < T1) {
+      T0 = mFanCurve.Temp[Index - 1] * 1000;
+      D0 = mFanCurve.Duty[Index - 1];
+      D1 = mFanCurve.Duty[Index];
+      return (UINT8)(D0 + (D1 - D0) * (Temperature - T0) / (T1 - T0));
+    }
+  }
+
+  return mFanCurve.Duty[FAN_CURVE_POINTS - 1];
+}
+
+STATIC
+VOID
+FanSetDuty (
+  IN UINT8 Duty
+  )
+{
+  EFI_STATUS Status;
+
+  if (Duty == mFanDuty) {
+    return;
+  }
+
+  Status = PwmSetDuty (FAN_PWM_CONTROLLER, FAN_PWM_CHANNEL,
+                       FAN_PWM_PERIOD_NS / 100 * Duty);
+  if (!EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_VERBOSE, "Fan: duty %u%% -> %u%%\n", mFanDuty, Duty));
+    mFanDuty = Duty;
+  }
+}
+
+STATIC
+VOID
+EFIAPI
+FanControlTick (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  INT32       CpuTemp;
+  INT32       GpuTemp;
+  UINT8       Duty;
+
+  if (mThermal == NULL) {
+    Status = gBS->LocateProtocol (&gRk356xThermalProtocolGuid, NULL, (VOID **)&mThermal);
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+  }
+
+  Status = mThermal->GetTemperature (mThermal, Rk356xThermalSensorCpu, &CpuTemp);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+  Status = mThermal->GetTemperature (mThermal, Rk356xThermalSensorGpu, &GpuTemp);
+  if (!EFI_ERROR (Status) && GpuTemp > CpuTemp) {
+    CpuTemp = GpuTemp;
+  }
+
+  Duty = FanCurveGetDuty (CpuTemp);
+  if (Duty < mFanDuty) {
+    Duty = FanCurveGetDuty (CpuTemp + FAN_CONTROL_HYSTERESIS);
+    if (Duty > mFanDuty) {
+      Duty = mFanDuty;
+    }
+  }
+
+  FanSetDuty (Duty);
+}
+
+STATIC
+VOID
+EFIAPI
+FanControlStop (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  //
+  // Leave the fan running at its current speed. An ACPI OS takes over
+  // through the fan device's _FSL method.
+  //
+  gBS->SetTimer (mFanTimer, TimerCancel, 0);
+}
+
+EFI_STATUS
+FanControlInit (
+  IN BOOLEAN Enable
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   Event;
+
+  //
+  // Always program the PWM so that ACPI can adjust the duty cycle later,
+  // even if the fan is left off during boot.
+  //
+  mFanDuty = Enable ? 100 : 0;
+  Status = PwmConfigure (FAN_PWM_CONTROLLER, FAN_PWM_CHANNEL,
+                         FAN_PWM_PERIOD_NS, FAN_PWM_PERIOD_NS / 100 * mFanDuty,
+                         FAN_PWM_INVERTED);
+  if (EFI_ERROR (Status) || !Enable) {
+    return Status;
+  }
+
+  if (!PlatformConfigGetFanCurve (&mFanCurve)) {
+    DEBUG ((DEBUG_WARN, "Fan: invalid fan curve, running at full speed\n"));
+    return EFI_SUCCESS;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_CALLBACK,
+                             FanControlTick, NULL, &mFanTimer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->SetTimer (mFanTimer, TimerPeriodic, FAN_CONTROL_PERIOD);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_CALLBACK,
+                             FanControlStop, NULL, &Event);
+  ASSERT_EFI_ERROR (Status);
+
+  return EFI_SUCCESS;
+}
+
+#else
+
+EFI_STATUS
+FanControlInit (
+  IN BOOLEAN Enable
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+#endif
@@ -0,0 +1,233 @@
+/** @file
+ *
+ *  "sata" shell command. Shows the negotiated link speed, power state and
+ *  PHY error bits of each enabled SATA controller.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/ShellDynamicCommand.h>
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xSata.h>
+#include "ConfigDxe.h"
+
+STATIC CONST CHAR16 mSataCommandHelp[] =
+  L".TH sata 0 \"Display SATA link status.\"\r\n"
+  L".SH NAME\r\n"
+  L"Display SATA link status.\r\n"
+  L".SH SYNOPSIS\r\n"
+  L"\r\n"
+  L"SATA [clear]\r\n"
+  L".SH OPTIONS\r\n"
+  L"\r\n"
+  L"  clear - Clear the SError bits after displaying them\r\n"
+  L".SH DESCRIPTION\r\n"
+  L"\r\n"
+  L"Shows, for each enabled SATA controller, the negotiated link speed and\r\n"
+  L"speed limit, the interface power state, the link power states offered\r\n"
+  L"to the OS and the port SError register. SError bits are sticky; clear\r\n"
+  L"them and run the command again to see which errors are still occurring.\r\n";
+
+STATIC CONST struct {
+  UINT32        Mask;
+  CONST CHAR16  *Name;
+} mSataSErrorBits[] = {
+  { BIT0,  L"recovered data integrity" },
+  { BIT1,  L"recovered communication" },
+  { BIT8,  L"transient data integrity" },
+  { BIT9,  L"persistent communication" },
+  { BIT10, L"protocol" },
+  { BIT11, L"internal" },
+  { BIT16, L"PhyRdy change" },
+  { BIT17, L"PHY internal" },
+  { BIT18, L"COMWAKE" },
+  { BIT19, L"10b to 8b decode" },
+  { BIT20, L"disparity" },
+  { BIT21, L"CRC" },
+  { BIT22, L"handshake" },
+  { BIT23, L"link sequence" },
+  { BIT24, L"transport state" },
+  { BIT25, L"unknown FIS" },
+  { BIT26, L"exchanged" },
+};
+
+STATIC
+CONST CHAR16 *
+SataSpeedName (
+  IN UINT32 Speed
+  )
+{
+  switch (Speed) {
+  case SATA_SPEED_GEN1:  return L"Gen1 (1.5 Gb/s)";
+  case SATA_SPEED_GEN2:  return L"Gen2 (3.0 Gb/s)";
+  case SATA_SPEED_GEN3:  return L"Gen3 (6.0 Gb/s)";
+  default:               return L"unknown";
+  }
+}
+
+STATIC
+CONST CHAR16 *
+SataPowerStateName (
+  IN UINT32 Ipm
+  )
+{
+  switch (Ipm) {
+  case SATA_SSTS_IPM_ACTIVE:    return L"active";
+  case SATA_SSTS_IPM_PARTIAL:   return L"partial";
+  case SATA_SSTS_IPM_SLUMBER:   return L"slumber";
+  case SATA_SSTS_IPM_DEVSLEEP:  return L"devsleep";
+  default:                      return L"none";
+  }
+}
+
+STATIC
+VOID
+SataShowController (
+  IN UINT32               Index,
+  IN EFI_PHYSICAL_ADDRESS Base,
+  IN BOOLEAN              Clear
+  )
+{
+  UINT32  Cap;
+  UINT32  Ssts;
+  UINT32  Sctl;
+  UINT32  Serr;
+  UINT32  Det;
+  UINT32  Limit;
+  UINTN   Bit;
+  UINT32  Known;
+
+  Cap  = MmioRead32 (Base + SATA_CAP);
+  Ssts = MmioRead32 (Base + SATA_SSTS);
+  Sctl = MmioRead32 (Base + SATA_SCTL);
+  Serr = MmioRead32 (Base + SATA_SERR);
+
+  Print (L"SATA%u at 0x%08lx\n", Index, Base);
+
+  Det = Ssts & SATA_SSTS_DET_MASK;
+  if (Det == SATA_SSTS_DET_PHY) {
+    Print (L"  Link:        up, %s, power state %s\n",
+           SataSpeedName ((Ssts & SATA_SSTS_SPD_MASK) >> SATA_SSTS_SPD_SHIFT),
+           SataPowerStateName ((Ssts & SATA_SSTS_IPM_MASK) >> SATA_SSTS_IPM_SHIFT));
+  } else if (Det == SATA_SSTS_DET_PRESENT) {
+    Print (L"  Link:        device detected, no PHY communication\n");
+  } else if (Det == SATA_SSTS_DET_OFFLINE) {
+    Print (L"  Link:        offline\n");
+  } else {
+    Print (L"  Link:        no device\n");
+  }
+
+  Limit = (Sctl & SATA_SCTL_SPD_MASK) >> SATA_SCTL_SPD_SHIFT;
+  Print (L"  Speed limit: %s\n",
+         Limit == SATA_SPEED_NO_LIMIT ? L"none" : SataSpeedName (Limit));
+  Print (L"  Link PM:     %s%s%s%s\n",
+         (Cap & SATA_CAP_SALP) != 0 ? L"HIPM " : L"",
+         (Cap & SATA_CAP_PSC) != 0 ? L"partial " : L"",
+         (Cap & SATA_CAP_SSC) != 0 ? L"slumber " : L"",
+         (Cap & (SATA_CAP_SALP | SATA_CAP_PSC | SATA_CAP_SSC)) == 0 ? L"disabled" : L"");
+
+  Print (L"  SError:      0x%08x\n", Serr);
+  Known = 0;
+  for (Bit = 0; Bit < ARRAY_SIZE (mSataSErrorBits); Bit++) {
+    if ((Serr & mSataSErrorBits[Bit].Mask) != 0) {
+      Print (L"               %s\n", mSataSErrorBits[Bit].Name);
+    }
+    Known |= mSataSErrorBits[Bit].Mask;
+  }
+  if ((Serr & ~Known) != 0) {
+    Print (L"               reserved (0x%08x)\n", Serr & ~Known);
+  }
+
+  if (Clear && Serr != 0) {
+    MmioWrite32 (Base + SATA_SERR, Serr);
+  }
+}
+
+STATIC
+SHELL_STATUS
+EFIAPI
+SataCommandHandler (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN EFI_SYSTEM_TABLE                     *SystemTable,
+  IN EFI_SHELL_PARAMETERS_PROTOCOL        *ShellParameters,
+  IN EFI_SHELL_PROTOCOL                   *Shell
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Base;
+  UINT32                Index;
+  BOOLEAN               Clear;
+  BOOLEAN               Found;
+
+  Clear = FALSE;
+  if (ShellParameters->Argc == 2 && StrCmp (ShellParameters->Argv[1], L"clear") == 0) {
+    Clear = TRUE;
+  } else if (ShellParameters->Argc != 1) {
+    Print (L"usage: sata [clear]\n");
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  Found = FALSE;
+  for (Index = 0; Index < FixedPcdGet32 (PcdSataNumController); Index++) {
+    // Disabled controllers may be unclocked, don't touch them
+    if ((Index == 0 && FixedPcdGet8 (PcdSata0Status) == 0x0) ||
+        (Index == 1 && FixedPcdGet8 (PcdSata1Status) == 0x0) ||
+        (Index == 2 && FixedPcdGet8 (PcdSata2Status) == 0x0) ||
+        Index > 2) {
+      continue;
+    }
+
+    Base = FixedPcdGet64 (PcdSataBaseAddr) + Index * FixedPcdGet64 (PcdSataSize);
+    SataShowController (Index, Base, Clear);
+    Found = TRUE;
+  }
+
+  if (!Found) {
+    Print (L"sata: no SATA controllers enabled\n");
+    return SHELL_NOT_FOUND;
+  }
+
+  return SHELL_SUCCESS;
+}
+
+STATIC
+CHAR16 *
+EFIAPI
+SataCommandGetHelp (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN CONST CHAR8                          *Language
+  )
+{
+  return AllocateCopyPool (sizeof (mSataCommandHelp), mSataCommandHelp);
+}
+
+STATIC EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL mSataCommand = {
+  L"sata",
+  SataCommandHandler,
+  SataCommandGetHelp
+};
+
+EFI_STATUS
+SataCommandInstall (
+  VOID
+  )
+{
+  EFI_HANDLE  Handle;
+
+  // The dmc command already occupies the image handle
+  Handle = NULL;
+  return gBS->InstallMultipleProtocolInterfaces (&Handle,
+                                                 &gEfiShellDynamicCommandProtocolGuid,
+                                                 &mSataCommand,
+                                                 NULL);
+}
@@ -0,0 +1,568 @@
+/** @file
+ *
+ *  "membench" shell command. STREAM style bandwidth kernels and a pointer
+ *  chasing latency test, on one and on all cores, with the buffers mapped
+ *  write-back, write-combining and uncached.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DxeServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Protocol/ArmScmi.h>
+#include <Protocol/ArmScmiClockProtocol.h>
+#include <Protocol/MpService.h>
+#include <Protocol/ShellDynamicCommand.h>
+
+#include "MemoryTestDxe.h"
+
+#define CLOCK_ID_CLK_SCMI_DDR     3
+#define FREQ_1_MHZ                1000000
+
+// Each STREAM array is much larger than the 512KB L3
+#define BENCH_ARRAY_SIZE          SIZE_16MB
+#define BENCH_ITERATIONS          5
+#define BENCH_SCALAR              3
+
+#define BENCH_CHASE_SIZE          SIZE_64MB
+#define BENCH_CHASE_STRIDE        64
+#define BENCH_CHASE_STEPS         1000000
+
+#define BENCH_RESULTS_VARIABLE    L"MemoryBenchResults"
+#define BENCH_RESULTS_SIZE        SIZE_4KB
+
+typedef enum {
+  BenchKernelCopy,
+  BenchKernelScale,
+  BenchKernelAdd,
+  BenchKernelTriad,
+  BenchKernelMax
+} BENCH_KERNEL;
+
+typedef struct {
+  CONST CHAR8   *Name;
+  UINT32        BytesPerElement;
+} BENCH_KERNEL_INFO;
+
+STATIC CONST BENCH_KERNEL_INFO mBenchKernels[BenchKernelMax] = {
+  { "copy",   2 * sizeof (UINT64) },
+  { "scale",  2 * sizeof (UINT64) },
+  { "add",    3 * sizeof (UINT64) },
+  { "triad",  3 * sizeof (UINT64) },
+};
+
+typedef struct {
+  CONST CHAR8   *Name;
+  UINT64        Attributes;
+  UINT32        Iterations;
+  UINT32        ChaseSteps;
+} BENCH_MAPPING;
+
+//
+// Uncached runs are far slower, so they do less work.
+//
+STATIC CONST BENCH_MAPPING mBenchMappings[] = {
+  { "wb", EFI_MEMORY_WB, BENCH_ITERATIONS, BENCH_CHASE_STEPS },
+  { "wc", EFI_MEMORY_WC, BENCH_ITERATIONS, BENCH_CHASE_STEPS / 10 },
+  { "uc", EFI_MEMORY_UC, 1,                BENCH_CHASE_STEPS / 10 },
+};
+
+typedef struct {
+  BENCH_KERNEL      Kernel;
+  UINT64            *A;
+  UINT64            *B;
+  UINT64            *C;
+  UINTN             Count;
+  UINT32            NumSlices;
+  volatile UINT32   NextSlice;
+  volatile UINT32   DoneSlices;
+} BENCH_CONTEXT;
+
+STATIC CONST CHAR16 mMemoryBenchCommandHelp[] =
+  L".TH membench 0 \"Measure memory bandwidth and latency.\"\r\n"
+  L".SH NAME\r\n"
+  L"Measure memory bandwidth and latency.\r\n"
+  L".SH SYNOPSIS\r\n"
+  L"\r\n"
+  L"MEMBENCH\r\n"
+  L".SH DESCRIPTION\r\n"
+  L"\r\n"
+  L"Runs the STREAM copy, scale, add and triad kernels on one core and on\r\n"
+  L"all cores, and a pointer chasing latency test on one core. Each test\r\n"
+  L"is run with the buffers mapped write-back, write-combining and\r\n"
+  L"uncached.\r\n"
+  L"\r\n"
+  L"The results are also saved as CSV in the MemoryBenchResults variable,\r\n"
+  L"under the vendor GUID printed at the end of the run.\r\n"
+  L"\r\n"
+  L"The DDR clock is reported with the results. Use dmc set to run the\r\n"
+  L"benchmark at another DDR clock rate.\r\n";
+
+STATIC
+VOID
+EFIAPI
+BenchWorker (
+  IN OUT VOID *Buffer
+  )
+{
+  BENCH_CONTEXT   *Ctx;
+  UINT32          Slice;
+  UINTN           Index;
+  UINTN           End;
+  UINT64          *A;
+  UINT64          *B;
+  UINT64          *C;
+
+  Ctx = Buffer;
+  A = Ctx->A;
+  B = Ctx->B;
+  C = Ctx->C;
+
+  for (;;) {
+    Slice = InterlockedIncrement (&Ctx->NextSlice) - 1;
+    if (Slice >= Ctx->NumSlices) {
+      break;
+    }
+    Index = Ctx->Count * Slice / Ctx->NumSlices;
+    End = Ctx->Count * (Slice + 1) / Ctx->NumSlices;
+
+    switch (Ctx->Kernel) {
+    case BenchKernelCopy:
+      for (; Index < End; Index++) {
+        C[Index] = A[Index];
+      }
+      break;
+    case BenchKernelScale:
+      for (; Index < End; Index++) {
+        B[Index] = BENCH_SCALAR * C[Index];
+      }
+      break;
+    case BenchKernelAdd:
+      for (; Index < End; Index++) {
+        C[Index] = A[Index] + B[Index];
+      }
+      break;
+    case BenchKernelTriad:
+      for (; Index < End; Index++) {
+        A[Index] = B[Index] + BENCH_SCALAR * C[Index];
+      }
+      break;
+    default:
+      break;
+    }
+
+    InterlockedIncrement (&Ctx->DoneSlices);
+  }
+}
+
+/*
+ * Returns the best bandwidth of the given kernel in MB/s.
+ */
+STATIC
+UINT64
+BenchRunKernel (
+  IN OUT BENCH_CONTEXT            *Ctx,
+  IN     BENCH_KERNEL             Kernel,
+  IN     EFI_MP_SERVICES_PROTOCOL *MpServices,
+  IN     UINTN                    NumCpus,
+  IN     UINT32                   Iterations
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   ApDoneEvent;
+  UINTN       EventIndex;
+  UINT32      Iteration;
+  UINT64      Start;
+  UINT64      Ns;
+  UINT64      BestNs;
+  BOOLEAN     ApsStarted;
+
+  ApDoneEvent = NULL;
+  if (NumCpus > 1) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &ApDoneEvent);
+    if (EFI_ERROR (Status)) {
+      NumCpus = 1;
+    }
+  }
+
+  Ctx->Kernel = Kernel;
+  Ctx->NumSlices = (UINT32)NumCpus;
+  BestNs = MAX_UINT64;
+
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    Ctx->NextSlice = 0;
+    Ctx->DoneSlices = 0;
+    ApsStarted = FALSE;
+
+    Start = GetPerformanceCounter ();
+    if (NumCpus > 1) {
+      Status = MpServices->StartupAllAPs (MpServices, BenchWorker, FALSE,
+                                          ApDoneEvent, 0, Ctx, NULL);
+      ApsStarted = !EFI_ERROR (Status);
+    }
+    BenchWorker (Ctx);
+    //
+    // The MP service only notices that the APs are done on its next poll,
+    // so stop the clock when the last slice is, and wait for it after.
+    //
+    while (Ctx->DoneSlices < Ctx->NumSlices) {
+      CpuPause ();
+    }
+    Ns = GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+    if (ApsStarted) {
+      gBS->WaitForEvent (1, &ApDoneEvent, &EventIndex);
+    }
+
+    BestNs = MIN (BestNs, Ns);
+  }
+
+  if (ApDoneEvent != NULL) {
+    gBS->CloseEvent (ApDoneEvent);
+  }
+
+  if (BestNs == 0) {
+    return 0;
+  }
+  return DivU64x64Remainder (MultU64x32 ((UINT64)Ctx->Count * mBenchKernels[Kernel].BytesPerElement, 1000),
+                             BestNs, NULL);
+}
+
+/*
+ * Link every cache line of the buffer into a single random cycle
+ * (Sattolo's algorithm), so that each load depends on the previous one
+ * and the prefetchers can't guess the next address.
+ */
+STATIC
+VOID
+BenchChaseInit (
+  IN UINT8 *Buffer
+  )
+{
+  UINTN   NumLines;
+  UINTN   *Order;
+  UINTN   Index;
+  UINT64  Swap;
+  UINTN   Tmp;
+  UINT64  Seed;
+
+  NumLines = BENCH_CHASE_SIZE / BENCH_CHASE_STRIDE;
+
+  //
+  // Use the tail of the buffer as scratch space for the permutation.
+  //
+  Order = (UINTN *)(Buffer + BENCH_CHASE_SIZE);
+  for (Index = 0; Index < NumLines; Index++) {
+    Order[Index] = Index;
+  }
+
+  Seed = 0x9E3779B97F4A7C15ULL;
+  for (Index = NumLines - 1; Index > 0; Index--) {
+    // xorshift64
+    Seed ^= LShiftU64 (Seed, 13);
+    Seed ^= RShiftU64 (Seed, 7);
+    Seed ^= LShiftU64 (Seed, 17);
+    DivU64x64Remainder (Seed, Index, &Swap);
+    Tmp = Order[Index];
+    Order[Index] = Order[Swap];
+    Order[Swap] = Tmp;
+  }
+
+  for (Index = 0; Index < NumLines; Index++) {
+    *(VOID **)(Buffer + Order[Index] * BENCH_CHASE_STRIDE) =
+      Buffer + Order[(Index + 1) % NumLines] * BENCH_CHASE_STRIDE;
+  }
+}
+
+/*
+ * Returns the average load-to-use latency in picoseconds.
+ */
+STATIC
+UINT64
+BenchChase (
+  IN UINT8    *Buffer,
+  IN UINT32   Steps
+  )
+{
+  VOID * volatile   *Ptr;
+  UINT32            Step;
+  UINT64            Start;
+  UINT64            Ns;
+
+  Ptr = (VOID **)Buffer;
+  Start = GetPerformanceCounter ();
+  for (Step = 0; Step < Steps; Step++) {
+    Ptr = *Ptr;
+  }
+  Ns = GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+
+  // Keep the chase from being optimised away
+  if (Ptr == NULL) {
+    Print (L"membench: broken chain\n");
+  }
+
+  return DivU64x32 (MultU64x32 (Ns, 1000), Steps);
+}
+
+STATIC
+EFI_STATUS
+BenchGetAttributes (
+  IN  VOID    *Buffer,
+  OUT UINT64  *Attributes
+  )
+{
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR Desc;
+  EFI_STATUS                      Status;
+
+  Status = gDS->GetMemorySpaceDescriptor ((EFI_PHYSICAL_ADDRESS)(UINTN)Buffer, &Desc);
+  if (!EFI_ERROR (Status)) {
+    *Attributes = Desc.Attributes;
+  }
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+BenchSetMapping (
+  IN VOID     *Buffer,
+  IN UINTN    Size,
+  IN UINT64   Attributes
+  )
+{
+  //
+  // Write back any dirty lines before the range stops being cacheable.
+  //
+  WriteBackInvalidateDataCacheRange (Buffer, Size);
+  return gDS->SetMemorySpaceAttributes ((EFI_PHYSICAL_ADDRESS)(UINTN)Buffer, Size, Attributes);
+}
+
+STATIC
+UINT32
+BenchGetDdrClock (
+  VOID
+  )
+{
+  EFI_STATUS            Status;
+  SCMI_CLOCK_PROTOCOL   *ClockProtocol;
+  EFI_GUID              ClockProtocolGuid = ARM_SCMI_CLOCK_PROTOCOL_GUID;
+  EFI_TPL               OldTpl;
+  UINT64                Rate;
+
+  Status = gBS->LocateProtocol (&ClockProtocolGuid, NULL, (VOID **)&ClockProtocol);
+  if (EFI_ERROR (Status)) {
+    return 0;
+  }
+  //
+  // Keep the TsadcDxe thermal governor timer from issuing its own SCMI
+  // request on the shared mailbox in the middle of this one.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  Status = ClockProtocol->RateGet (ClockProtocol, CLOCK_ID_CLK_SCMI_DDR, &Rate);
+  gBS->RestoreTPL (OldTpl);
+  if (EFI_ERROR (Status)) {
+    return 0;
+  }
+  return (UINT32)(Rate / FREQ_1_MHZ);
+}
+
+STATIC
+SHELL_STATUS
+EFIAPI
+MemoryBenchCommandHandler (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN EFI_SYSTEM_TABLE                     *SystemTable,
+  IN EFI_SHELL_PARAMETERS_PROTOCOL        *ShellParameters,
+  IN EFI_SHELL_PROTOCOL                   *Shell
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumCpus;
+  UINTN                     NumEnabledCpus;
+  UINTN                     ArraysSize;
+  UINTN                     ChaseSize;
+  UINT8                     *Arrays;
+  UINT8                     *Chase;
+  BENCH_CONTEXT             Ctx;
+  CHAR8                     *Results;
+  UINTN                     ResultsLen;
+  UINT32                    DdrClock;
+  UINTN                     Mapping;
+  UINTN                     Run;
+  UINTN                     Cpus;
+  BENCH_KERNEL              Kernel;
+  UINT64                    Bandwidth;
+  UINT64                    Latency;
+  UINT64                    ArraysAttributes;
+  UINT64                    ChaseAttributes;
+
+  if (ShellParameters->Argc != 1) {
+    Print (L"usage: membench\n");
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  NumEnabledCpus = 1;
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status) ||
+      EFI_ERROR (MpServices->GetNumberOfProcessors (MpServices, &NumCpus, &NumEnabledCpus))) {
+    MpServices = NULL;
+    NumEnabledCpus = 1;
+  }
+
+  ArraysSize = 3 * BENCH_ARRAY_SIZE;
+  // The permutation used to build the chain needs one UINTN per line
+  ChaseSize = BENCH_CHASE_SIZE + (BENCH_CHASE_SIZE / BENCH_CHASE_STRIDE) * sizeof (UINTN);
+  Arrays = AllocateAlignedPages (EFI_SIZE_TO_PAGES (ArraysSize), SIZE_2MB);
+  Chase = AllocateAlignedPages (EFI_SIZE_TO_PAGES (ChaseSize), SIZE_2MB);
+  Results = AllocateZeroPool (BENCH_RESULTS_SIZE);
+  if (Arrays == NULL || Chase == NULL || Results == NULL) {
+    Print (L"membench: out of memory\n");
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  //
+  // Only the cache type is changed for each run, the other attributes
+  // (such as EFI_MEMORY_XP) are kept and the original ones restored.
+  //
+  Status = BenchGetAttributes (Arrays, &ArraysAttributes);
+  if (!EFI_ERROR (Status)) {
+    Status = BenchGetAttributes (Chase, &ChaseAttributes);
+  }
+  if (EFI_ERROR (Status)) {
+    Print (L"membench: couldn't get memory attributes: %r\n", Status);
+    goto Exit;
+  }
+
+  ZeroMem (&Ctx, sizeof (Ctx));
+  Ctx.A = (UINT64 *)Arrays;
+  Ctx.B = (UINT64 *)(Arrays + BENCH_ARRAY_SIZE);
+  Ctx.C = (UINT64 *)(Arrays + 2 * BENCH_ARRAY_SIZE);
+  Ctx.Count = BENCH_ARRAY_SIZE / sizeof (UINT64);
+  SetMem64 (Ctx.A, BENCH_ARRAY_SIZE, 1);
+  SetMem64 (Ctx.B, BENCH_ARRAY_SIZE, 2);
+  SetMem64 (Ctx.C, BENCH_ARRAY_SIZE, 0);
+  BenchChaseInit (Chase);
+
+  DdrClock = BenchGetDdrClock ();
+  Print (L"DDR clock %u MHz, %u cores\n\n", DdrClock, (UINT32)NumEnabledCpus);
+  Print (L"  Test    Map  Cores   Result\n");
+
+  ResultsLen = AsciiSPrint (Results, BENCH_RESULTS_SIZE,
+                            "# ddr_mhz=%u cores=%u\ntest,map,cores,value,unit\n",
+                            DdrClock, (UINT32)NumEnabledCpus);
+
+  for (Mapping = 0; Mapping < ARRAY_SIZE (mBenchMappings); Mapping++) {
+    Status = BenchSetMapping (Arrays, ArraysSize,
+                              (ArraysAttributes & ~EFI_MEMORY_CACHETYPE_MASK) |
+                              mBenchMappings[Mapping].Attributes);
+    if (!EFI_ERROR (Status)) {
+      Status = BenchSetMapping (Chase, ChaseSize,
+                                (ChaseAttributes & ~EFI_MEMORY_CACHETYPE_MASK) |
+                                mBenchMappings[Mapping].Attributes);
+    }
+    if (EFI_ERROR (Status)) {
+      Print (L"  %a: couldn't change mapping: %r\n", mBenchMappings[Mapping].Name, Status);
+      continue;
+    }
+
+    //
+    // One pass on the boot core, then one on every core.
+    //
+    for (Run = 0; Run < 2; Run++) {
+      Cpus = (Run == 0) ? 1 : NumEnabledCpus;
+      if (Run == 1 && Cpus == 1) {
+        break;
+      }
+      for (Kernel = 0; Kernel < BenchKernelMax; Kernel++) {
+        Bandwidth = BenchRunKernel (&Ctx, Kernel, MpServices, Cpus,
+                                    mBenchMappings[Mapping].Iterations);
+        Print (L"  %-7a %a   %u       %lu MB/s\n", mBenchKernels[Kernel].Name,
+               mBenchMappings[Mapping].Name, (UINT32)Cpus, Bandwidth);
+        ResultsLen += AsciiSPrint (Results + ResultsLen, BENCH_RESULTS_SIZE - ResultsLen,
+                                   "%a,%a,%u,%lu,MB/s\n", mBenchKernels[Kernel].Name,
+                                   mBenchMappings[Mapping].Name, (UINT32)Cpus, Bandwidth);
+      }
+    }
+
+    Latency = BenchChase (Chase, mBenchMappings[Mapping].ChaseSteps);
+    Print (L"  %-7a %a   1       %lu.%02lu ns\n", "latency", mBenchMappings[Mapping].Name,
+           Latency / 1000, (Latency % 1000) / 10);
+    ResultsLen += AsciiSPrint (Results + ResultsLen, BENCH_RESULTS_SIZE - ResultsLen,
+                               "latency,%a,1,%lu,ps\n", mBenchMappings[Mapping].Name, Latency);
+  }
+
+  BenchSetMapping (Arrays, ArraysSize, ArraysAttributes);
+  BenchSetMapping (Chase, ChaseSize, ChaseAttributes);
+
+  Status = gRT->SetVariable (BENCH_RESULTS_VARIABLE, &gEfiCallerIdGuid,
+                             EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS |
+                             EFI_VARIABLE_RUNTIME_ACCESS,
+                             ResultsLen, Results);
+  if (EFI_ERROR (Status)) {
+    Print (L"\nmembench: couldn't save results: %r\n", Status);
+  } else {
+    Print (L"\nResults saved to %s-%g\n", BENCH_RESULTS_VARIABLE, &gEfiCallerIdGuid);
+  }
+
+Exit:
+  if (Arrays != NULL) {
+    FreeAlignedPages (Arrays, EFI_SIZE_TO_PAGES (ArraysSize));
+  }
+  if (Chase != NULL) {
+    FreeAlignedPages (Chase, EFI_SIZE_TO_PAGES (ChaseSize));
+  }
+  if (Results != NULL) {
+    FreePool (Results);
+  }
+
+  return EFI_ERROR (Status) ? SHELL_DEVICE_ERROR : SHELL_SUCCESS;
+}
+
+STATIC
+CHAR16 *
+EFIAPI
+MemoryBenchCommandGetHelp (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN CONST CHAR8                          *Language
+  )
+{
+  return AllocateCopyPool (sizeof (mMemoryBenchCommandHelp), mMemoryBenchCommandHelp);
+}
+
+STATIC EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL mMemoryBenchCommand = {
+  L"membench",
+  MemoryBenchCommandHandler,
+  MemoryBenchCommandGetHelp
+};
+
+EFI_STATUS
+MemoryBenchCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  )
+{
+  EFI_HANDLE Handle;
+
+  //
+  // A handle can only carry one instance of the dynamic command protocol.
+  //
+  Handle = NULL;
+  return gBS->InstallMultipleProtocolInterfaces (&Handle,
+                                                 &gEfiShellDynamicCommandProtocolGuid,
+                                                 &mMemoryBenchCommand,
+                                                 NULL);
+}
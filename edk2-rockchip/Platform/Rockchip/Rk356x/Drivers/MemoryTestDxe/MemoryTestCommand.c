@@ -0,0 +1,124 @@
+/** @file
+ *
+ *  "memtest" shell command.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/ShellDynamicCommand.h>
+
+#include "MemoryTestDxe.h"
+
+STATIC CONST CHAR16 mMemoryTestCommandHelp[] =
+  L".TH memtest 0 \"Clear or test all free memory on all cores.\"\r\n"
+  L".SH NAME\r\n"
+  L"Clear or test all free memory on all cores.\r\n"
+  L".SH SYNOPSIS\r\n"
+  L"\r\n"
+  L"MEMTEST [zero|walk|addr]\r\n"
+  L".SH OPTIONS\r\n"
+  L"\r\n"
+  L"  zero - Clear memory (default)\r\n"
+  L"  walk - Write and verify a walking ones pattern\r\n"
+  L"  addr - Write and verify each word's own address\r\n"
+  L".SH DESCRIPTION\r\n"
+  L"\r\n"
+  L"Claims all free memory, splits it across every core and fills it with\r\n"
+  L"the selected pattern. Reports the throughput and any words that read\r\n"
+  L"back wrong.\r\n";
+
+STATIC CONST CHAR16 *mMemoryTestCommandArgs[MemoryTestPatternMax] = {
+  L"zero",
+  L"walk",
+  L"addr",
+};
+
+STATIC
+SHELL_STATUS
+EFIAPI
+MemoryTestCommandHandler (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN EFI_SYSTEM_TABLE                     *SystemTable,
+  IN EFI_SHELL_PARAMETERS_PROTOCOL        *ShellParameters,
+  IN EFI_SHELL_PROTOCOL                   *Shell
+  )
+{
+  EFI_STATUS            Status;
+  MEMORY_TEST_PATTERN   Pattern;
+  MEMORY_TEST_RESULT    Result;
+
+  Pattern = MemoryTestPatternZero;
+  if (ShellParameters->Argc == 2) {
+    for (Pattern = 0; Pattern < MemoryTestPatternMax; Pattern++) {
+      if (StrCmp (ShellParameters->Argv[1], mMemoryTestCommandArgs[Pattern]) == 0) {
+        break;
+      }
+    }
+  }
+  if (ShellParameters->Argc > 2 || Pattern == MemoryTestPatternMax) {
+    Print (L"usage: memtest [zero|walk|addr]\n");
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  Print (L"Running %s pattern on all free memory...\n", gMemoryTestPatternNames[Pattern]);
+  Status = MemoryTestRun (Pattern, &Result);
+  if (EFI_ERROR (Status) && Status != EFI_DEVICE_ERROR) {
+    Print (L"memtest: %r\n", Status);
+    return SHELL_DEVICE_ERROR;
+  }
+
+  Print (L"%lu MB on %u cores in %lu ms", Result.Bytes / SIZE_1MB, (UINT32)Result.NumCpus,
+         Result.ElapsedNs / 1000000);
+  if (Result.ElapsedNs != 0) {
+    Print (L", %lu MB/s",
+           DivU64x64Remainder (MultU64x32 (Result.Bytes, 1000), Result.ElapsedNs, NULL));
+  }
+  Print (L"\n");
+
+  if (Result.Errors != 0) {
+    Print (L"FAILED: %lu errors, first at 0x%lx\n", Result.Errors, Result.FirstError);
+    return SHELL_DEVICE_ERROR;
+  }
+  if (Pattern != MemoryTestPatternZero) {
+    Print (L"PASSED\n");
+  }
+
+  return SHELL_SUCCESS;
+}
+
+STATIC
+CHAR16 *
+EFIAPI
+MemoryTestCommandGetHelp (
+  IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+  IN CONST CHAR8                          *Language
+  )
+{
+  return AllocateCopyPool (sizeof (mMemoryTestCommandHelp), mMemoryTestCommandHelp);
+}
+
+STATIC EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL mMemoryTestCommand = {
+  L"memtest",
+  MemoryTestCommandHandler,
+  MemoryTestCommandGetHelp
+};
+
+EFI_STATUS
+MemoryTestCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  )
+{
+  return gBS->InstallMultipleProtocolInterfaces (&ImageHandle,
+                                                 &gEfiShellDynamicCommandProtocolGuid,
+                                                 &mMemoryTestCommand,
+                                                 NULL);
+}
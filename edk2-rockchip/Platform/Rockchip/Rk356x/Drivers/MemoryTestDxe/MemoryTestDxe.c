@@ -0,0 +1,364 @@
+/** @file
+ *
+ *  Multi-core memory scrub and test.
+ *
+ *  All free memory is claimed from the UEFI memory map, split into chunks
+ *  and handed out to every core through the MP services protocol, so that
+ *  clearing or testing memory runs at the combined speed of the cluster.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BootTraceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Protocol/MpService.h>
+#include <ConfigVars.h>
+
+#include "MemoryTestDxe.h"
+
+#define MEMORY_TEST_CHUNK_SIZE    SIZE_64MB
+#define MEMORY_TEST_MAX_CHUNKS    1024
+// Left free while testing, for allocations made by the MP services driver
+#define MEMORY_TEST_RESERVE       SIZE_16MB
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    Base;
+  UINT64                  Length;
+  UINT64                  Errors;
+  EFI_PHYSICAL_ADDRESS    FirstError;
+} MEMORY_TEST_CHUNK;
+
+typedef struct {
+  MEMORY_TEST_PATTERN     Pattern;
+  MEMORY_TEST_CHUNK       *Chunks;
+  UINT32                  NumChunks;
+  volatile UINT32         NextChunk;
+} MEMORY_TEST_CONTEXT;
+
+CONST CHAR16 *gMemoryTestPatternNames[MemoryTestPatternMax] = {
+  L"zero",
+  L"walking ones",
+  L"address",
+};
+
+STATIC
+VOID
+MemoryTestChunk (
+  IN     MEMORY_TEST_PATTERN  Pattern,
+  IN OUT MEMORY_TEST_CHUNK    *Chunk
+  )
+{
+  volatile UINT64   *Ptr;
+  UINTN             Count;
+  UINTN             Index;
+  UINT64            Expected;
+
+  Ptr = (volatile UINT64 *)(UINTN)Chunk->Base;
+  Count = (UINTN)(Chunk->Length / sizeof (UINT64));
+
+  switch (Pattern) {
+  case MemoryTestPatternZero:
+    //
+    // BaseMemoryLibOptDxe clears whole cache lines with DC ZVA.
+    //
+    ZeroMem ((VOID *)(UINTN)Chunk->Base, (UINTN)Chunk->Length);
+    return;
+  case MemoryTestPatternWalkingOnes:
+    for (Index = 0; Index < Count; Index++) {
+      Ptr[Index] = LShiftU64 (1, Index % 64);
+    }
+    break;
+  case MemoryTestPatternAddress:
+    for (Index = 0; Index < Count; Index++) {
+      Ptr[Index] = (UINT64)(UINTN)&Ptr[Index];
+    }
+    break;
+  default:
+    return;
+  }
+
+  //
+  // Write the whole chunk before reading it back, so that the data has
+  // been evicted from the caches and really comes from DRAM.
+  //
+  for (Index = 0; Index < Count; Index++) {
+    if (Pattern == MemoryTestPatternWalkingOnes) {
+      Expected = LShiftU64 (1, Index % 64);
+    } else {
+      Expected = (UINT64)(UINTN)&Ptr[Index];
+    }
+    if (Ptr[Index] != Expected) {
+      if (Chunk->Errors == 0) {
+        Chunk->FirstError = (EFI_PHYSICAL_ADDRESS)(UINTN)&Ptr[Index];
+      }
+      Chunk->Errors++;
+    }
+  }
+}
+
+/*
+ * Runs on every core. Chunks are taken from a shared counter until none
+ * are left, so faster cores simply do more of the work.
+ */
+STATIC
+VOID
+EFIAPI
+MemoryTestWorker (
+  IN OUT VOID *Buffer
+  )
+{
+  MEMORY_TEST_CONTEXT   *Context;
+  UINT32                Index;
+
+  Context = Buffer;
+
+  for (;;) {
+    Index = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Index >= Context->NumChunks) {
+      break;
+    }
+    MemoryTestChunk (Context->Pattern, &Context->Chunks[Index]);
+  }
+}
+
+/*
+ * Allocate every free conventional memory range, except for a small
+ * reserve, and split it into chunks.
+ */
+STATIC
+EFI_STATUS
+MemoryTestClaimFreeMemory (
+  OUT MEMORY_TEST_CONTEXT   *Context
+  )
+{
+  EFI_STATUS              Status;
+  EFI_MEMORY_DESCRIPTOR   *MemoryMap;
+  EFI_MEMORY_DESCRIPTOR   *Desc;
+  UINTN                   MapSize;
+  UINTN                   MapKey;
+  UINTN                   DescSize;
+  UINT32                  DescVersion;
+  EFI_PHYSICAL_ADDRESS    Base;
+  UINT64                  Length;
+  UINT64                  Offset;
+  UINTN                   Index;
+  EFI_PHYSICAL_ADDRESS    Reserve;
+
+  Context->Chunks = AllocateZeroPool (sizeof (MEMORY_TEST_CHUNK) * MEMORY_TEST_MAX_CHUNKS);
+  if (Context->Chunks == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Context->NumChunks = 0;
+
+  Status = gBS->AllocatePages (AllocateAnyPages, EfiBootServicesData,
+                               EFI_SIZE_TO_PAGES (MEMORY_TEST_RESERVE), &Reserve);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  MapSize = 0;
+  Status = gBS->GetMemoryMap (&MapSize, NULL, &MapKey, &DescSize, &DescVersion);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    gBS->FreePages (Reserve, EFI_SIZE_TO_PAGES (MEMORY_TEST_RESERVE));
+    return EFI_ERROR (Status) ? Status : EFI_DEVICE_ERROR;
+  }
+  // Leave room for the map to grow due to this allocation
+  MapSize += 4 * DescSize;
+  MemoryMap = AllocatePool (MapSize);
+  if (MemoryMap == NULL) {
+    gBS->FreePages (Reserve, EFI_SIZE_TO_PAGES (MEMORY_TEST_RESERVE));
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Status = gBS->GetMemoryMap (&MapSize, MemoryMap, &MapKey, &DescSize, &DescVersion);
+  if (EFI_ERROR (Status)) {
+    FreePool (MemoryMap);
+    gBS->FreePages (Reserve, EFI_SIZE_TO_PAGES (MEMORY_TEST_RESERVE));
+    return Status;
+  }
+
+  for (Index = 0; Index < MapSize / DescSize; Index++) {
+    Desc = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)MemoryMap + Index * DescSize);
+    if (Desc->Type != EfiConventionalMemory) {
+      continue;
+    }
+
+    Base = Desc->PhysicalStart;
+    Status = gBS->AllocatePages (AllocateAddress, EfiBootServicesData,
+                                 (UINTN)Desc->NumberOfPages, &Base);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    Length = EFI_PAGES_TO_SIZE (Desc->NumberOfPages);
+    for (Offset = 0; Offset < Length; Offset += MEMORY_TEST_CHUNK_SIZE) {
+      if (Context->NumChunks == MEMORY_TEST_MAX_CHUNKS) {
+        break;
+      }
+      Context->Chunks[Context->NumChunks].Base = Base + Offset;
+      Context->Chunks[Context->NumChunks].Length = MIN (Length - Offset, MEMORY_TEST_CHUNK_SIZE);
+      Context->NumChunks++;
+    }
+  }
+
+  FreePool (MemoryMap);
+  gBS->FreePages (Reserve, EFI_SIZE_TO_PAGES (MEMORY_TEST_RESERVE));
+
+  return Context->NumChunks > 0 ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
+
+STATIC
+VOID
+MemoryTestReleaseMemory (
+  IN MEMORY_TEST_CONTEXT   *Context
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Context->NumChunks; Index++) {
+    gBS->FreePages (Context->Chunks[Index].Base,
+                    EFI_SIZE_TO_PAGES (Context->Chunks[Index].Length));
+  }
+  FreePool (Context->Chunks);
+}
+
+EFI_STATUS
+MemoryTestRun (
+  IN  MEMORY_TEST_PATTERN   Pattern,
+  OUT MEMORY_TEST_RESULT    *Result
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  MEMORY_TEST_CONTEXT       Context;
+  EFI_EVENT                 ApDoneEvent;
+  UINTN                     NumCpus;
+  UINTN                     NumEnabledCpus;
+  UINTN                     EventIndex;
+  UINT64                    Start;
+  UINT32                    Index;
+
+  if (Pattern >= MemoryTestPatternMax) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (&Context, sizeof (Context));
+  ZeroMem (Result, sizeof (*Result));
+  Context.Pattern = Pattern;
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    MpServices = NULL;
+  }
+
+  ApDoneEvent = NULL;
+  NumEnabledCpus = 1;
+  if (MpServices != NULL &&
+      !EFI_ERROR (MpServices->GetNumberOfProcessors (MpServices, &NumCpus, &NumEnabledCpus))) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &ApDoneEvent);
+    ASSERT_EFI_ERROR (Status);
+  }
+
+  Status = MemoryTestClaimFreeMemory (&Context);
+  if (EFI_ERROR (Status)) {
+    if (Context.Chunks != NULL) {
+      MemoryTestReleaseMemory (&Context);
+    }
+    if (ApDoneEvent != NULL) {
+      gBS->CloseEvent (ApDoneEvent);
+    }
+    return Status;
+  }
+
+  BootTrace (BootTraceIdMemoryTestStart, Pattern, 0);
+  Start = GetPerformanceCounter ();
+
+  //
+  // Start the APs without waiting for them, then let the BSP take its
+  // share of the chunks too.
+  //
+  if (ApDoneEvent != NULL && NumEnabledCpus > 1) {
+    Status = MpServices->StartupAllAPs (MpServices, MemoryTestWorker, FALSE,
+                                        ApDoneEvent, 0, &Context, NULL);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "MemoryTest: Couldn't start APs: %r\n", Status));
+      NumEnabledCpus = 1;
+    }
+  }
+
+  MemoryTestWorker (&Context);
+
+  if (NumEnabledCpus > 1) {
+    gBS->WaitForEvent (1, &ApDoneEvent, &EventIndex);
+  }
+
+  Result->ElapsedNs = GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+  Result->NumCpus = NumEnabledCpus;
+
+  for (Index = 0; Index < Context.NumChunks; Index++) {
+    Result->Bytes += Context.Chunks[Index].Length;
+    if (Context.Chunks[Index].Errors != 0) {
+      if (Result->Errors == 0) {
+        Result->FirstError = Context.Chunks[Index].FirstError;
+      }
+      Result->Errors += Context.Chunks[Index].Errors;
+    }
+  }
+  BootTrace (BootTraceIdMemoryTestEnd, Result->Bytes, Result->Errors);
+
+  if (ApDoneEvent != NULL) {
+    gBS->CloseEvent (ApDoneEvent);
+  }
+  MemoryTestReleaseMemory (&Context);
+
+  return Result->Errors == 0 ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+EFI_STATUS
+EFIAPI
+MemoryTestDxeInitialize (
+  IN EFI_HANDLE         ImageHandle,
+  IN EFI_SYSTEM_TABLE   *SystemTable
+  )
+{
+  EFI_STATUS          Status;
+  UINT32              Setting;
+  MEMORY_TEST_RESULT  Result;
+
+  Setting = PcdGet32 (PcdMemoryTest);
+  if (Setting != MEMORY_TEST_DISABLED && Setting - 1 < MemoryTestPatternMax) {
+    DEBUG ((DEBUG_INFO, "MemoryTest: Running %s pattern on all free memory\n",
+            gMemoryTestPatternNames[Setting - 1]));
+    Status = MemoryTestRun (Setting - 1, &Result);
+    if (Result.ElapsedNs != 0) {
+      DEBUG ((DEBUG_INFO, "MemoryTest: %lu MB on %u cores in %lu ms, %lu MB/s\n",
+              Result.Bytes / SIZE_1MB, (UINT32)Result.NumCpus,
+              Result.ElapsedNs / 1000000,
+              DivU64x64Remainder (MultU64x32 (Result.Bytes, 1000), Result.ElapsedNs, NULL)));
+    }
+    if (Status == EFI_DEVICE_ERROR) {
+      DEBUG ((DEBUG_ERROR, "MemoryTest: %lu errors, first at 0x%lx\n",
+              Result.Errors, Result.FirstError));
+    } else if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "MemoryTest: Failed: %r\n", Status));
+    }
+  }
+
+  Status = MemoryTestCommandInstall (ImageHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return MemoryBenchCommandInstall (ImageHandle);
+}
@@ -0,0 +1,47 @@
+/** @file
+ *
+ *  Multi-core memory scrub and test.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef MEMORY_TEST_DXE_H_
+#define MEMORY_TEST_DXE_H_
+
+typedef enum {
+  MemoryTestPatternZero,
+  MemoryTestPatternWalkingOnes,
+  MemoryTestPatternAddress,
+  MemoryTestPatternMax
+} MEMORY_TEST_PATTERN;
+
+typedef struct {
+  UINT64                  Bytes;        // Bytes of memory covered
+  UINT64                  ElapsedNs;
+  UINT64                  Errors;       // Words that failed verification
+  EFI_PHYSICAL_ADDRESS    FirstError;
+  UINTN                   NumCpus;
+} MEMORY_TEST_RESULT;
+
+extern CONST CHAR16 *gMemoryTestPatternNames[MemoryTestPatternMax];
+
+EFI_STATUS
+MemoryTestRun (
+  IN  MEMORY_TEST_PATTERN   Pattern,
+  OUT MEMORY_TEST_RESULT    *Result
+  );
+
+EFI_STATUS
+MemoryTestCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  );
+
+EFI_STATUS
+MemoryBenchCommandInstall (
+  IN EFI_HANDLE ImageHandle
+  );
+
+#endif /* MEMORY_TEST_DXE_H_ */
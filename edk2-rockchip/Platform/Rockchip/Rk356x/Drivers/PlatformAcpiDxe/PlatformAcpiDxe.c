@@ -10,18 +10,196 @@
  **/
 
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/DxeServicesLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/AcpiLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PlatformConfigLib.h>
+#include <Library/PrintLib.h>
+#include <IndustryStandard/Acpi.h>
 #include <ConfigVars.h>
 
+#include "PlatformAcpiDxe.h"
+
+#define AML_NAME_OP           0x08
+#define AML_BYTE_PREFIX       0x0A
+#define AML_WORD_PREFIX       0x0B
+#define AML_DWORD_PREFIX      0x0C
+
+// Convert degrees Celsius to tenths of degrees Kelvin
+#define CELSIUS_TO_DK(x)      ((x) * 10 + 2732)
+
 STATIC CONST EFI_GUID mAcpiTableFile = {
   0x0FBE0D20, 0x3528, 0x4F07, { 0x83, 0x8B, 0x9A, 0x71, 0x1C, 0x62, 0x65, 0x4f }
 };
 
+//
+// Find every "Name (XXXX, Integer)" object with the given name in an AML
+// table and replace its value. The encoded integer width is left as-is,
+// so the new value must fit in whatever the ASL compiler picked.
+//
+STATIC
+VOID
+AcpiUpdateNameInteger (
+  IN EFI_ACPI_DESCRIPTION_HEADER  *Table,
+  IN CONST CHAR8                  *Name,
+  IN UINT32                       Value
+  )
+{
+  UINT8   *Aml;
+  UINTN   Index;
+  UINTN   Found;
+
+  Aml = (UINT8 *)Table;
+  Found = 0;
+
+  for (Index = sizeof (EFI_ACPI_DESCRIPTION_HEADER);
+       Index + 10 <= Table->Length;
+       Index++) {
+    if (Aml[Index] != AML_NAME_OP ||
+        CompareMem (&Aml[Index + 1], Name, 4) != 0) {
+      continue;
+    }
+
+    switch (Aml[Index + 5]) {
+    case AML_BYTE_PREFIX:
+      if (Value > MAX_UINT8) {
+        continue;
+      }
+      Aml[Index + 6] = (UINT8)Value;
+      break;
+    case AML_WORD_PREFIX:
+      if (Value > MAX_UINT16) {
+        continue;
+      }
+      WriteUnaligned16 ((UINT16 *)&Aml[Index + 6], (UINT16)Value);
+      break;
+    case AML_DWORD_PREFIX:
+      WriteUnaligned32 ((UINT32 *)&Aml[Index + 6], Value);
+      break;
+    default:
+      continue;
+    }
+    Found++;
+  }
+
+  if (Found == 0) {
+    DEBUG ((DEBUG_WARN, "%a: Could not update %a\n", __func__, Name));
+  }
+}
+
+//
+// Apply the thermal trip points selected in ConfigDxe to the DSDT.
+//
+STATIC
+VOID
+AcpiUpdateThermalTrips (
+  IN EFI_ACPI_DESCRIPTION_HEADER  *Table
+  )
+{
+  UINT32  Critical;
+  UINT32  Fan;
+
+  Critical = PlatformConfigGetCriticalTrip ();
+  Fan = PlatformConfigGetFanTrip ();
+
+  if (Critical < THERMAL_TRIP_MIN || Critical > THERMAL_TRIP_MAX ||
+      Fan < THERMAL_TRIP_MIN || Fan > THERMAL_TRIP_MAX ||
+      Fan >= Critical) {
+    DEBUG ((DEBUG_WARN, "Invalid thermal trip points (critical %uC, fan %uC), using defaults\n",
+            Critical, Fan));
+    return;
+  }
+
+  DEBUG ((DEBUG_INFO, "Thermal trip points: critical %uC, fan %uC\n",
+          Critical, Fan));
+
+  AcpiUpdateNameInteger (Table, "TCRT", CELSIUS_TO_DK (Critical));
+#if FixedPcdGet8 (PcdFanPwmController) == 0xFF && FixedPcdGet8 (PcdFanGpioBank) != 0xFF
+  AcpiUpdateNameInteger (Table, "TFAN", CELSIUS_TO_DK (Fan));
+#endif
+}
+
+#if FixedPcdGet8 (PcdFanPwmController) != 0xFF
+//
+// Apply the PWM fan curve selected in ConfigDxe to the DSDT. Each point
+// of the curve becomes an active trip point and fan performance state.
+//
+STATIC
+VOID
+AcpiUpdateFanCurve (
+  IN EFI_ACPI_DESCRIPTION_HEADER  *Table
+  )
+{
+  FAN_CURVE_VARSTORE_DATA  Curve;
+  CHAR8                    Name[5];
+  UINT32                   Index;
+
+  if (!PlatformConfigGetFanCurve (&Curve)) {
+    DEBUG ((DEBUG_WARN, "Invalid fan curve, using defaults\n"));
+    return;
+  }
+
+  for (Index = 0; Index < FAN_CURVE_POINTS; Index++) {
+    DEBUG ((DEBUG_INFO, "Fan curve point %u: %uC, %u%%\n",
+            Index, Curve.Temp[Index], Curve.Duty[Index]));
+
+    AsciiSPrint (Name, sizeof (Name), "FT%u_", Index);
+    AcpiUpdateNameInteger (Table, Name, CELSIUS_TO_DK (Curve.Temp[Index]));
+    AsciiSPrint (Name, sizeof (Name), "FD%u_", Index);
+    AcpiUpdateNameInteger (Table, Name, Curve.Duty[Index]);
+  }
+}
+#endif
+
+//
+// Apply the parts of the performance profile that only the OS can act on.
+//
+STATIC
+VOID
+AcpiUpdateFadt (
+  IN EFI_ACPI_DESCRIPTION_HEADER  *Table
+  )
+{
+  EFI_ACPI_6_3_FIXED_ACPI_DESCRIPTION_TABLE *Fadt;
+
+  Fadt = (EFI_ACPI_6_3_FIXED_ACPI_DESCRIPTION_TABLE *)Table;
+
+  //
+  // Keep PCIe links out of low power states for the lowest latency.
+  //
+  if (PcdGet32 (PcdPerformanceProfile) == PERFORMANCE_PROFILE_MAX) {
+    DEBUG ((DEBUG_INFO, "Disabling PCIe ASPM (performance profile)\n"));
+    Fadt->IaPcBootArch |= EFI_ACPI_6_3_PCIE_ASPM_CONTROLS;
+  }
+}
+
+STATIC
+BOOLEAN
+EFIAPI
+AcpiTableCheck (
+  IN EFI_ACPI_DESCRIPTION_HEADER  *AcpiHeader
+  )
+{
+  if (AcpiHeader->Signature == EFI_ACPI_6_3_FIXED_ACPI_DESCRIPTION_TABLE_SIGNATURE) {
+    AcpiUpdateFadt (AcpiHeader);
+  }
+
+  if (AcpiHeader->Signature == EFI_ACPI_6_3_DIFFERENTIATED_SYSTEM_DESCRIPTION_TABLE_SIGNATURE) {
+    AcpiUpdateNameInteger (AcpiHeader, "PPRF", PcdGet32 (PcdPerformanceProfile));
+    AcpiUpdateThermalTrips (AcpiHeader);
+#if FixedPcdGet8 (PcdFanPwmController) != 0xFF
+    AcpiUpdateFanCurve (AcpiHeader);
+#endif
+  }
+
+  return TRUE;
+}
+
 EFI_STATUS
 EFIAPI
 PlatformAcpiDriverEntryPoint (
@@ -29,6 +207,8 @@ PlatformAcpiDriverEntryPoint (
   IN EFI_SYSTEM_TABLE   *SystemTable
   )
 {
+  EFI_STATUS Status;
+
   switch (PcdGet32 (PcdSystemTableMode)) {
   case SYSTEM_TABLE_MODE_BOTH:
   case SYSTEM_TABLE_MODE_ACPI:
@@ -38,5 +218,12 @@ PlatformAcpiDriverEntryPoint (
     return EFI_SUCCESS;
   }
 
-  return LocateAndInstallAcpiFromFv (&mAcpiTableFile);
+  Status = LocateAndInstallAcpiFromFvConditional (&mAcpiTableFile, AcpiTableCheck);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  AcpiInstallPptt ();
+
+  return EFI_SUCCESS;
 }
\ No newline at end of file
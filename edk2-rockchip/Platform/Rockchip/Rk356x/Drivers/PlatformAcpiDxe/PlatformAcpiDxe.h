@@ -0,0 +1,19 @@
+/** @file
+ *
+ *  ACPI support for the Quartz64 platform
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef PLATFORM_ACPI_DXE_H_
+#define PLATFORM_ACPI_DXE_H_
+
+EFI_STATUS
+AcpiInstallPptt (
+  VOID
+  );
+
+#endif /* PLATFORM_ACPI_DXE_H_ */
@@ -0,0 +1,324 @@
+/** @file
+ *
+ *  Processor Properties Topology Table (PPTT)
+ *
+ *  The table is built at boot from the MP core info table and the cache
+ *  geometry reported by CLIDR/CCSIDR.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/ArmLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <IndustryStandard/Acpi.h>
+#include <Guid/ArmMpCoreInfo.h>
+#include <Protocol/AcpiTable.h>
+#include "PlatformAcpiDxe.h"
+
+// Must match the processor container _UID in Cpu.asl
+#define PPTT_CLUSTER_UID          0x100
+
+#define PPTT_MAX_CACHES           8
+
+#define CLIDR_CTYPE(Clidr, Level) (((Clidr) >> (3 * ((Level) - 1))) & 0x7)
+#define CLIDR_CTYPE_NONE          0
+#define CLIDR_CTYPE_INSTRUCTION   1
+#define CLIDR_CTYPE_DATA          2
+#define CLIDR_CTYPE_SEPARATE      3
+#define CLIDR_CTYPE_UNIFIED       4
+
+//
+// Cortex-A55 doesn't implement FEAT_CCIDX, so CCSIDR uses the 32-bit format.
+//
+#define CCSIDR_LINE_SIZE(Ccsidr)  (1U << (((Ccsidr) & 0x7) + 4))
+#define CCSIDR_ASSOC(Ccsidr)      ((((Ccsidr) >> 3) & 0x3FF) + 1)
+#define CCSIDR_NUM_SETS(Ccsidr)   ((((Ccsidr) >> 13) & 0x7FFF) + 1)
+
+typedef struct {
+  UINT32    Level;
+  UINT8     Type;
+  BOOLEAN   Shared;
+  UINT32    Ccsidr;
+} PPTT_CACHE_INFO;
+
+STATIC
+UINT32
+PpttGetCaches (
+  OUT PPTT_CACHE_INFO *Caches
+  )
+{
+  UINT32  Clidr;
+  UINT32  Level;
+  UINT32  Count;
+  UINT32  SharedLevel;
+  UINT32  Index;
+
+  Clidr = ReadCLIDR ();
+  Count = 0;
+  SharedLevel = 0;
+
+  for (Level = 1;
+       Level <= 7 && CLIDR_CTYPE (Clidr, Level) != CLIDR_CTYPE_NONE && Count + 2 <= PPTT_MAX_CACHES;
+       Level++) {
+    switch (CLIDR_CTYPE (Clidr, Level)) {
+    case CLIDR_CTYPE_INSTRUCTION:
+    case CLIDR_CTYPE_SEPARATE:
+      Caches[Count].Level = Level;
+      Caches[Count].Type = EFI_ACPI_6_3_CACHE_ATTRIBUTES_CACHE_TYPE_INSTRUCTION;
+      Caches[Count].Ccsidr = (UINT32)ReadCCSIDR (((Level - 1) << 1) | 1);
+      Count++;
+      if (CLIDR_CTYPE (Clidr, Level) == CLIDR_CTYPE_INSTRUCTION) {
+        break;
+      }
+      // Fall through
+    case CLIDR_CTYPE_DATA:
+      Caches[Count].Level = Level;
+      Caches[Count].Type = EFI_ACPI_6_3_CACHE_ATTRIBUTES_CACHE_TYPE_DATA;
+      Caches[Count].Ccsidr = (UINT32)ReadCCSIDR ((Level - 1) << 1);
+      Count++;
+      break;
+    case CLIDR_CTYPE_UNIFIED:
+    default:
+      Caches[Count].Level = Level;
+      Caches[Count].Type = EFI_ACPI_6_3_CACHE_ATTRIBUTES_CACHE_TYPE_UNIFIED;
+      Caches[Count].Ccsidr = (UINT32)ReadCCSIDR ((Level - 1) << 1);
+      Count++;
+      SharedLevel = Level;
+      break;
+    }
+  }
+
+  //
+  // CLIDR doesn't say which caches are shared. On the DynamIQ cluster the
+  // outermost unified cache is the DSU L3, shared by all cores, and every
+  // other level is private to a core.
+  //
+  for (Index = 0; Index < Count; Index++) {
+    Caches[Index].Shared = (SharedLevel > 1 && Caches[Index].Level == SharedLevel);
+  }
+
+  return Count;
+}
+
+//
+// Offset of the next cache level above Caches[Index], or 0 if there is none.
+//
+STATIC
+UINT32
+PpttNextLevel (
+  IN CONST PPTT_CACHE_INFO  *Caches,
+  IN UINT32                 Count,
+  IN UINT32                 Index,
+  IN CONST UINT32           *Offsets
+  )
+{
+  UINT32 Next;
+
+  for (Next = Index + 1; Next < Count; Next++) {
+    if (Caches[Next].Level > Caches[Index].Level) {
+      return Offsets[Next];
+    }
+  }
+  return 0;
+}
+
+STATIC
+VOID
+PpttFillCache (
+  OUT EFI_ACPI_6_3_PPTT_STRUCTURE_CACHE *Node,
+  IN  CONST PPTT_CACHE_INFO             *Cache,
+  IN  UINT32                            NextLevel
+  )
+{
+  UINT32 Ccsidr;
+
+  Ccsidr = Cache->Ccsidr;
+
+  Node->Type = EFI_ACPI_6_3_PPTT_TYPE_CACHE;
+  Node->Length = sizeof (*Node);
+  Node->Flags.SizePropertyValid = EFI_ACPI_6_3_PPTT_CACHE_SIZE_VALID;
+  Node->Flags.NumberOfSetsValid = EFI_ACPI_6_3_PPTT_NUMBER_OF_SETS_VALID;
+  Node->Flags.AssociativityValid = EFI_ACPI_6_3_PPTT_ASSOCIATIVITY_VALID;
+  Node->Flags.AllocationTypeValid = EFI_ACPI_6_3_PPTT_ALLOCATION_TYPE_VALID;
+  Node->Flags.CacheTypeValid = EFI_ACPI_6_3_PPTT_CACHE_TYPE_VALID;
+  Node->Flags.WritePolicyValid = EFI_ACPI_6_3_PPTT_WRITE_POLICY_VALID;
+  Node->Flags.LineSizeValid = EFI_ACPI_6_3_PPTT_LINE_SIZE_VALID;
+  Node->NextLevelOfCache = NextLevel;
+  Node->NumberOfSets = CCSIDR_NUM_SETS (Ccsidr);
+  Node->Associativity = (UINT8)CCSIDR_ASSOC (Ccsidr);
+  Node->LineSize = (UINT16)CCSIDR_LINE_SIZE (Ccsidr);
+  Node->Size = Node->NumberOfSets * Node->Associativity * Node->LineSize;
+  Node->Attributes.CacheType = Cache->Type;
+  Node->Attributes.AllocationType = (Cache->Type == EFI_ACPI_6_3_CACHE_ATTRIBUTES_CACHE_TYPE_INSTRUCTION) ?
+                                    EFI_ACPI_6_3_CACHE_ATTRIBUTES_ALLOCATION_READ :
+                                    EFI_ACPI_6_3_CACHE_ATTRIBUTES_ALLOCATION_READ_WRITE;
+  Node->Attributes.WritePolicy = EFI_ACPI_6_3_CACHE_ATTRIBUTES_WRITE_POLICY_WRITE_BACK;
+}
+
+EFI_STATUS
+AcpiInstallPptt (
+  VOID
+  )
+{
+  EFI_STATUS                                  Status;
+  EFI_ACPI_TABLE_PROTOCOL                     *AcpiTable;
+  VOID                                        *Hob;
+  UINT32                                      NumCores;
+  PPTT_CACHE_INFO                             Caches[PPTT_MAX_CACHES];
+  UINT32                                      Offsets[PPTT_MAX_CACHES];
+  UINT32                                      NumCaches;
+  UINT32                                      NumShared;
+  UINT32                                      NumPrivate;
+  UINT32                                      NumPrivateRefs;
+  UINT32                                      ClusterSize;
+  UINT32                                      CoreSize;
+  UINT32                                      Length;
+  UINT8                                       *Table;
+  EFI_ACPI_DESCRIPTION_HEADER                 *Header;
+  EFI_ACPI_6_3_PPTT_STRUCTURE_PROCESSOR       *Node;
+  UINT32                                      *Resources;
+  UINT32                                      ClusterOffset;
+  UINT32                                      Offset;
+  UINT32                                      Core;
+  UINT32                                      Index;
+  UINTN                                       TableKey;
+
+  Status = gBS->LocateProtocol (&gEfiAcpiTableProtocolGuid, NULL, (VOID **)&AcpiTable);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Hob = GetFirstGuidHob (&gArmMpCoreInfoGuid);
+  if (Hob == NULL) {
+    DEBUG ((DEBUG_WARN, "PPTT: No MP core info, not installing\n"));
+    return EFI_NOT_FOUND;
+  }
+  NumCores = GET_GUID_HOB_DATA_SIZE (Hob) / sizeof (ARM_CORE_INFO);
+
+  NumCaches = PpttGetCaches (Caches);
+  NumShared = 0;
+  NumPrivateRefs = 0;
+  for (Index = 0; Index < NumCaches; Index++) {
+    DEBUG ((DEBUG_INFO, "PPTT: L%u %a cache, %u KB, %u-way, %u byte lines%a\n",
+            Caches[Index].Level,
+            Caches[Index].Type == EFI_ACPI_6_3_CACHE_ATTRIBUTES_CACHE_TYPE_INSTRUCTION ? "instruction" :
+            Caches[Index].Type == EFI_ACPI_6_3_CACHE_ATTRIBUTES_CACHE_TYPE_DATA ? "data" : "unified",
+            CCSIDR_NUM_SETS (Caches[Index].Ccsidr) * CCSIDR_ASSOC (Caches[Index].Ccsidr) *
+            CCSIDR_LINE_SIZE (Caches[Index].Ccsidr) / 1024,
+            CCSIDR_ASSOC (Caches[Index].Ccsidr), CCSIDR_LINE_SIZE (Caches[Index].Ccsidr),
+            Caches[Index].Shared ? ", shared" : ""));
+    if (Caches[Index].Shared) {
+      NumShared++;
+    } else if (Caches[Index].Level == Caches[0].Level) {
+      NumPrivateRefs++;
+    }
+  }
+  NumPrivate = NumCaches - NumShared;
+
+  //
+  // Layout: header, cluster node and its shared caches, then each core
+  // node followed by its private caches. Cores only reference their first
+  // level caches, the rest are reached through NextLevelOfCache.
+  //
+  ClusterSize = sizeof (EFI_ACPI_6_3_PPTT_STRUCTURE_PROCESSOR) + NumShared * sizeof (UINT32);
+  CoreSize = sizeof (EFI_ACPI_6_3_PPTT_STRUCTURE_PROCESSOR) + NumPrivateRefs * sizeof (UINT32);
+  Length = sizeof (EFI_ACPI_DESCRIPTION_HEADER) +
+           ClusterSize + NumShared * sizeof (EFI_ACPI_6_3_PPTT_STRUCTURE_CACHE) +
+           NumCores * (CoreSize + NumPrivate * sizeof (EFI_ACPI_6_3_PPTT_STRUCTURE_CACHE));
+
+  Table = AllocateZeroPool (Length);
+  if (Table == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Header = (EFI_ACPI_DESCRIPTION_HEADER *)Table;
+  Header->Signature = EFI_ACPI_6_3_PROCESSOR_PROPERTIES_TOPOLOGY_TABLE_STRUCTURE_SIGNATURE;
+  Header->Length = Length;
+  Header->Revision = EFI_ACPI_6_3_PROCESSOR_PROPERTIES_TOPOLOGY_TABLE_REVISION;
+  CopyMem (Header->OemId, "RKCP  ", sizeof (Header->OemId));
+  Header->OemTableId = SIGNATURE_64 ('R','K','3','5','6','X',' ',' ');
+  Header->OemRevision = 0x00000001;
+  Header->CreatorId = SIGNATURE_32 ('E','D','K','2');
+  Header->CreatorRevision = 0x00000001;
+
+  //
+  // Cluster
+  //
+  ClusterOffset = sizeof (EFI_ACPI_DESCRIPTION_HEADER);
+  Offset = ClusterOffset + ClusterSize;
+  for (Index = 0; Index < NumCaches; Index++) {
+    if (Caches[Index].Shared) {
+      Offsets[Index] = Offset;
+      Offset += sizeof (EFI_ACPI_6_3_PPTT_STRUCTURE_CACHE);
+    }
+  }
+
+  Node = (EFI_ACPI_6_3_PPTT_STRUCTURE_PROCESSOR *)(Table + ClusterOffset);
+  Node->Type = EFI_ACPI_6_3_PPTT_TYPE_PROCESSOR;
+  Node->Length = (UINT8)ClusterSize;
+  Node->Flags.PhysicalPackage = EFI_ACPI_6_3_PPTT_PACKAGE_PHYSICAL;
+  Node->Flags.AcpiProcessorIdValid = EFI_ACPI_6_3_PPTT_PROCESSOR_ID_VALID;
+  Node->Flags.IdenticalImplementation = EFI_ACPI_6_3_PPTT_IMPLEMENTATION_IDENTICAL;
+  Node->AcpiProcessorId = PPTT_CLUSTER_UID;
+  Node->NumberOfPrivateResources = NumShared;
+  Resources = (UINT32 *)(Node + 1);
+  for (Index = 0; Index < NumCaches; Index++) {
+    if (Caches[Index].Shared) {
+      *Resources++ = Offsets[Index];
+      PpttFillCache ((EFI_ACPI_6_3_PPTT_STRUCTURE_CACHE *)(Table + Offsets[Index]),
+                     &Caches[Index], PpttNextLevel (Caches, NumCaches, Index, Offsets));
+    }
+  }
+
+  //
+  // Cores. ACPI processor UIDs match the MADT and Cpu.asl.
+  //
+  for (Core = 0; Core < NumCores; Core++) {
+    Node = (EFI_ACPI_6_3_PPTT_STRUCTURE_PROCESSOR *)(Table + Offset);
+    Offset += CoreSize;
+    for (Index = 0; Index < NumCaches; Index++) {
+      if (!Caches[Index].Shared) {
+        Offsets[Index] = Offset;
+        Offset += sizeof (EFI_ACPI_6_3_PPTT_STRUCTURE_CACHE);
+      }
+    }
+
+    Node->Type = EFI_ACPI_6_3_PPTT_TYPE_PROCESSOR;
+    Node->Length = (UINT8)CoreSize;
+    Node->Flags.AcpiProcessorIdValid = EFI_ACPI_6_3_PPTT_PROCESSOR_ID_VALID;
+    Node->Flags.NodeIsALeaf = EFI_ACPI_6_3_PPTT_NODE_IS_LEAF;
+    Node->Flags.IdenticalImplementation = EFI_ACPI_6_3_PPTT_IMPLEMENTATION_IDENTICAL;
+    Node->Parent = ClusterOffset;
+    Node->AcpiProcessorId = Core;
+    Node->NumberOfPrivateResources = NumPrivateRefs;
+    Resources = (UINT32 *)(Node + 1);
+    for (Index = 0; Index < NumCaches; Index++) {
+      if (Caches[Index].Shared) {
+        continue;
+      }
+      if (Caches[Index].Level == Caches[0].Level) {
+        *Resources++ = Offsets[Index];
+      }
+      PpttFillCache ((EFI_ACPI_6_3_PPTT_STRUCTURE_CACHE *)(Table + Offsets[Index]),
+                     &Caches[Index], PpttNextLevel (Caches, NumCaches, Index, Offsets));
+    }
+  }
+
+  ASSERT (Offset == Length);
+
+  Status = AcpiTable->InstallAcpiTable (AcpiTable, Table, Length, &TableKey);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "PPTT: Failed to install table: %r\n", Status));
+  }
+
+  FreePool (Table);
+  return Status;
+}
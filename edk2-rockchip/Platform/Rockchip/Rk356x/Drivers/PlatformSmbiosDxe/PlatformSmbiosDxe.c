@@ -53,6 +53,7 @@
 #include <Library/SdramLib.h>
 #include <Library/OtpLib.h>
 #include <Protocol/ArmScmiClockProtocol.h>
+#include <ConfigVars.h>
 
 #define SMB_IS_DIGIT(c)  (((c) >= '0') && ((c) <= '9'))
 
@@ -476,13 +477,15 @@ CHAR8 *mSysSlotInfoType9Strings[] = {
 ************************************************************************/
 
 CHAR8 mOemInfoProductUrl[128];
+CHAR8 mOemInfoPerformanceProfile[64];
 
 SMBIOS_TABLE_TYPE11 mOemStringsType11 = {
   { EFI_SMBIOS_TYPE_OEM_STRINGS, sizeof (SMBIOS_TABLE_TYPE11), 0 },
-  1 // StringCount
+  2 // StringCount
 };
 CHAR8 *mOemStringsType11Strings[] = {
   mOemInfoProductUrl,
+  mOemInfoPerformanceProfile,
   NULL
 };
 
@@ -991,8 +994,30 @@ OemStringsUpdateSmbiosType11 (
   VOID
   )
 {
+  CONST CHAR8 *Profile;
+
   AsciiStrCpyS (mOemInfoProductUrl, sizeof (mOemInfoProductUrl), (CHAR8 *) PcdGetPtr(PcdProductUrl));
 
+  switch (PcdGet32 (PcdPerformanceProfile)) {
+  case PERFORMANCE_PROFILE_CUSTOM:
+    Profile = "Custom";
+    break;
+  case PERFORMANCE_PROFILE_MAX:
+    Profile = "Max Performance";
+    break;
+  case PERFORMANCE_PROFILE_BALANCED:
+    Profile = "Balanced";
+    break;
+  case PERFORMANCE_PROFILE_QUIET:
+    Profile = "Quiet";
+    break;
+  default:
+    Profile = "Unknown";
+    break;
+  }
+  AsciiSPrint (mOemInfoPerformanceProfile, sizeof (mOemInfoPerformanceProfile),
+               "Performance profile: %a", Profile);
+
   LogSmbiosData ((EFI_SMBIOS_TABLE_HEADER*)&mOemStringsType11, mOemStringsType11Strings, NULL);
 }
 
@@ -30,6 +30,17 @@ typedef struct {
   UINT32 Clock;
 } CUSTOM_CPUCLOCK_VARSTORE_DATA;
 
+typedef struct {
+#define DMCCLOCK_LOW     0
+#define DMCCLOCK_DEFAULT 1
+#define DMCCLOCK_CUSTOM  2
+  UINT32 Clock;
+} DMCCLOCK_VARSTORE_DATA;
+
+typedef struct {
+  UINT32 Clock;
+} CUSTOM_DMCCLOCK_VARSTORE_DATA;
+
 typedef struct {
 #define MULTIPHY_MODE_SEL_USB3 0
 #define MULTIPHY_MODE_SEL_PCIE 1
@@ -41,4 +52,42 @@ typedef struct {
   BOOLEAN Mode;
 } FAN_VARSTORE_DATA;
 
+typedef struct {
+#define THERMAL_TRIP_MIN 40
+#define THERMAL_TRIP_MAX 125
+  UINT32 Temp;
+} THERMAL_CRITICAL_TRIP_VARSTORE_DATA;
+
+typedef struct {
+  UINT32 Temp;
+} THERMAL_FAN_TRIP_VARSTORE_DATA;
+
+typedef struct {
+#define FAN_CURVE_POINTS 4
+  UINT8 Temp[FAN_CURVE_POINTS];   // degrees C
+  UINT8 Duty[FAN_CURVE_POINTS];   // percent
+} FAN_CURVE_VARSTORE_DATA;
+
+typedef struct {
+#define PERFORMANCE_PROFILE_CUSTOM    0
+#define PERFORMANCE_PROFILE_MAX       1
+#define PERFORMANCE_PROFILE_BALANCED  2
+#define PERFORMANCE_PROFILE_QUIET     3
+  UINT32 Profile;
+} PERFORMANCE_PROFILE_VARSTORE_DATA;
+
+typedef struct {
+#define MEMORY_TEST_DISABLED      0
+#define MEMORY_TEST_ZERO          1
+#define MEMORY_TEST_WALKING_ONES  2
+#define MEMORY_TEST_ADDRESS       3
+  UINT32 Pattern;
+} MEMORY_TEST_VARSTORE_DATA;
+
+typedef struct {
+#define FAST_BOOT_DISABLED  0
+#define FAST_BOOT_ENABLED   1
+  UINT32 Mode;
+} FAST_BOOT_VARSTORE_DATA;
+
 #endif /* CONFIG_VARS_H */
\ No newline at end of file
@@ -0,0 +1,97 @@
+/** @file
+ *
+ *  Boot trace ring.
+ *
+ *  Events are stored with a CNTPCT_EL0 timestamp and two arguments in a
+ *  ring at PcdBootTraceBase. The ring is mapped uncached and is only
+ *  reset when its header is invalid, so the events of previous boots
+ *  are still there after a warm reset. Every boot starts with a
+ *  BootTraceIdReset event carrying the boot number.
+ *
+ *  scripts/decodeboottrace.py parses BOOT_TRACE_ID below, so keep the
+ *  enumerators one per line.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef BOOT_TRACE_LIB_H_
+#define BOOT_TRACE_LIB_H_
+
+#define BOOT_TRACE_SIGNATURE    SIGNATURE_32 ('R', 'K', 'B', 'T')
+#define BOOT_TRACE_VERSION      1
+
+typedef enum {
+  BootTraceIdReset = 1,             // Arg0: boot number
+  BootTraceIdMmuEnabled,
+  BootTraceIdDxeStart,
+  BootTraceIdDriverStart,           // Arg0, Arg1: FFS file GUID
+  BootTraceIdDriverEnd,             // Arg0, Arg1: FFS file GUID
+  BootTraceIdStatusCode,            // Arg0: type, Arg1: value
+  BootTraceIdReadyToBoot,
+  BootTraceIdExitBootServices,
+  BootTraceIdMemoryTestStart,       // Arg0: pattern
+  BootTraceIdMemoryTestEnd,         // Arg0: bytes, Arg1: errors
+  BootTraceIdMax
+} BOOT_TRACE_ID;
+
+typedef struct {
+  UINT64    Timestamp;              // CNTPCT_EL0
+  UINT32    Boot;
+  UINT16    Id;
+  UINT16    Reserved;
+  UINT64    Arg[2];
+} BOOT_TRACE_ENTRY;
+
+typedef struct {
+  UINT32    Signature;
+  UINT16    Version;
+  UINT16    EntrySize;
+  UINT32    NumEntries;
+  UINT32    Boot;
+  UINT64    Head;                   // Events ever written, modulo NumEntries is the next slot
+  UINT64    Frequency;              // CNTFRQ_EL0
+} BOOT_TRACE_HEADER;
+
+/**
+  Validate the ring header, or reset it if it isn't valid, and record the
+  start of a new boot. Called once per boot, early in PrePi.
+**/
+VOID
+EFIAPI
+BootTraceInitialize (
+  VOID
+  );
+
+/**
+  Record an event. Boot services only, and only on the boot processor.
+**/
+VOID
+EFIAPI
+BootTrace (
+  IN BOOT_TRACE_ID  Id,
+  IN UINT64         Arg0,
+  IN UINT64         Arg1
+  );
+
+/**
+  Return the ring header, or NULL if the ring isn't valid.
+**/
+BOOT_TRACE_HEADER *
+EFIAPI
+BootTraceGetHeader (
+  VOID
+  );
+
+/**
+  Drop all recorded events.
+**/
+VOID
+EFIAPI
+BootTraceClear (
+  VOID
+  );
+
+#endif /* BOOT_TRACE_LIB_H_ */
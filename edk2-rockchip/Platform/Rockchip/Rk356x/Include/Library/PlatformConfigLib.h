@@ -0,0 +1,83 @@
+/** @file
+ *
+ *  Settings stored by ConfigDxe, read the same way by every driver that
+ *  acts on them.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef PLATFORM_CONFIG_LIB_H_
+#define PLATFORM_CONFIG_LIB_H_
+
+#include <ConfigVars.h>
+
+//
+// Each of these returns the active performance profile's value, or the
+// setting stored in setup if the profile is Custom.
+//
+
+/**
+  Return the CPU clock setting, one of CPUCLOCK_*.
+**/
+UINT32
+EFIAPI
+PlatformConfigGetCpuClock (
+  VOID
+  );
+
+/**
+  Return the DDR clock setting, one of DMCCLOCK_*.
+**/
+UINT32
+EFIAPI
+PlatformConfigGetDmcClock (
+  VOID
+  );
+
+/**
+  Return the critical trip point, in degrees C.
+**/
+UINT32
+EFIAPI
+PlatformConfigGetCriticalTrip (
+  VOID
+  );
+
+/**
+  Return the GPIO fan trip point, in degrees C.
+**/
+UINT32
+EFIAPI
+PlatformConfigGetFanTrip (
+  VOID
+  );
+
+/**
+  Check a fan curve. Temperatures must not decrease from one point to
+  the next, and must not exceed THERMAL_TRIP_MAX. Duty cycles are 0-100%.
+
+  The firmware fan loop and the DSDT both use a curve that passes, and
+  both fall back to their defaults for one that doesn't.
+**/
+BOOLEAN
+EFIAPI
+FanCurveIsValid (
+  IN CONST FAN_CURVE_VARSTORE_DATA  *Curve
+  );
+
+/**
+  Read the fan curve selected in setup.
+
+  @retval TRUE    Curve is valid.
+  @retval FALSE   Curve is invalid and should not be used.
+**/
+BOOLEAN
+EFIAPI
+PlatformConfigGetFanCurve (
+  OUT FAN_CURVE_VARSTORE_DATA  *Curve
+  );
+
+#endif /* PLATFORM_CONFIG_LIB_H_ */
@@ -0,0 +1,112 @@
+/** @file
+ *
+ *  Boot trace ring.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Base.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BootTraceLib.h>
+#include <Library/TimerLib.h>
+
+#define BOOT_TRACE_NUM_ENTRIES  ((FixedPcdGet32 (PcdBootTraceSize) - sizeof (BOOT_TRACE_HEADER)) / \
+                                 sizeof (BOOT_TRACE_ENTRY))
+
+#define BOOT_TRACE_HEADER_PTR   ((BOOT_TRACE_HEADER *)(UINTN)FixedPcdGet64 (PcdBootTraceBase))
+
+BOOT_TRACE_HEADER *
+EFIAPI
+BootTraceGetHeader (
+  VOID
+  )
+{
+  BOOT_TRACE_HEADER *Header;
+
+  Header = BOOT_TRACE_HEADER_PTR;
+  if (Header->Signature != BOOT_TRACE_SIGNATURE ||
+      Header->Version != BOOT_TRACE_VERSION ||
+      Header->EntrySize != sizeof (BOOT_TRACE_ENTRY) ||
+      Header->NumEntries != BOOT_TRACE_NUM_ENTRIES) {
+    return NULL;
+  }
+
+  return Header;
+}
+
+VOID
+EFIAPI
+BootTraceInitialize (
+  VOID
+  )
+{
+  BOOT_TRACE_HEADER *Header;
+
+  //
+  // This runs with the MMU off, so stick to aligned stores.
+  //
+  Header = BootTraceGetHeader ();
+  if (Header != NULL) {
+    Header->Boot++;
+  } else {
+    Header = BOOT_TRACE_HEADER_PTR;
+    Header->Signature = BOOT_TRACE_SIGNATURE;
+    Header->Version = BOOT_TRACE_VERSION;
+    Header->EntrySize = sizeof (BOOT_TRACE_ENTRY);
+    Header->NumEntries = BOOT_TRACE_NUM_ENTRIES;
+    Header->Boot = 0;
+    Header->Head = 0;
+  }
+  Header->Frequency = GetPerformanceCounterProperties (NULL, NULL);
+
+  BootTrace (BootTraceIdReset, Header->Boot, 0);
+}
+
+VOID
+EFIAPI
+BootTrace (
+  IN BOOT_TRACE_ID  Id,
+  IN UINT64         Arg0,
+  IN UINT64         Arg1
+  )
+{
+  BOOT_TRACE_HEADER *Header;
+  BOOT_TRACE_ENTRY  *Entry;
+  BOOLEAN           InterruptState;
+
+  Header = BootTraceGetHeader ();
+  if (Header == NULL) {
+    return;
+  }
+
+  InterruptState = SaveAndDisableInterrupts ();
+
+  Entry = (BOOT_TRACE_ENTRY *)(Header + 1) + ModU64x32 (Header->Head, Header->NumEntries);
+  Entry->Timestamp = GetPerformanceCounter ();
+  Entry->Boot = Header->Boot;
+  Entry->Id = Id;
+  Entry->Reserved = 0;
+  Entry->Arg[0] = Arg0;
+  Entry->Arg[1] = Arg1;
+  Header->Head++;
+
+  SetInterruptState (InterruptState);
+}
+
+VOID
+EFIAPI
+BootTraceClear (
+  VOID
+  )
+{
+  BOOT_TRACE_HEADER *Header;
+
+  Header = BootTraceGetHeader ();
+  if (Header != NULL) {
+    Header->Head = 0;
+  }
+}
@@ -11,6 +11,7 @@
 
 #include <Library/ArmMmuLib.h>
 #include <Library/ArmPlatformLib.h>
+#include <Library/BootTraceLib.h>
 #include <Library/DebugLib.h>
 #include <Library/HobLib.h>
 #include <Library/MemoryAllocationLib.h>
@@ -154,6 +155,7 @@ MemoryPeim (
 
   // Build Memory Allocation Hob
   InitMmu (MemoryTable);
+  BootTrace (BootTraceIdMmuEnabled, 0, 0);
 
   if (FeaturePcdGet (PcdPrePiProduceMemoryTypeInformationHob)) {
     // Optional feature that helps prevent EFI memory map fragmentation.
@@ -0,0 +1,389 @@
+/** @file
+ *
+ *  Fast boot.
+ *
+ *  When the boot image is loaded, the device path of the device it was read
+ *  from (for example the NVMe or eMMC partition) is saved in the
+ *  FastBootTarget variable, together with the boot option that loaded it.
+ *  On the next boot, if fast boot is enabled, BootNext isn't set and the
+ *  boot order still starts with that option, only that device path is
+ *  connected. Anything else, or a device path that no longer connects,
+ *  falls back to connecting every controller.
+ *
+ *  F4 during boot, or deleting the variable, forces a full connect. So do
+ *  ESC and F2: the boot manager menu should list every boot device, so
+ *  while fast boot is enabled those keys are read here rather than being
+ *  registered as BDS hotkeys, which would launch the menu before the
+ *  platform gets a chance to connect anything.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <ConfigVars.h>
+#include <Guid/GlobalVariable.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiBootManagerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Protocol/DevicePath.h>
+#include <Protocol/LoadedImage.h>
+
+#include "PlatformBm.h"
+
+#define FAST_BOOT_TARGET_VARIABLE   L"FastBootTarget"
+#define FAST_BOOT_HOTKEY            SCAN_F4
+
+//
+// FastBootTarget variable. The boot option's FilePath (OptionPathSize bytes)
+// follows the header, then the device path of the device the image was
+// loaded from.
+//
+typedef struct {
+  UINT16    OptionNumber;
+  UINT16    Reserved;
+  UINT32    OptionPathSize;
+} FAST_BOOT_TARGET;
+
+STATIC EFI_EVENT  mReadyToBootEvent;
+STATIC EFI_EVENT  mLoadedImageEvent;
+STATIC VOID       *mLoadedImageRegistration;
+STATIC UINT16     mBootCurrent;
+
+BOOLEAN
+FastBootEnabled (
+  VOID
+  )
+{
+  return PcdGet32 (PcdFastBoot) == FAST_BOOT_ENABLED;
+}
+
+/*
+ * Checks that Boot#### still holds the recorded file path.
+ */
+STATIC
+BOOLEAN
+FastBootOptionMatches (
+  IN UINT16                         OptionNumber,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL *OptionPath,
+  IN UINTN                          OptionPathSize
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_BOOT_MANAGER_LOAD_OPTION  Option;
+  CHAR16                        OptionName[sizeof ("Boot####")];
+  BOOLEAN                       Matches;
+
+  UnicodeSPrint (OptionName, sizeof (OptionName), L"Boot%04x", OptionNumber);
+  Status = EfiBootManagerVariableToLoadOption (OptionName, &Option);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  Matches = GetDevicePathSize (Option.FilePath) == OptionPathSize &&
+            CompareMem (Option.FilePath, OptionPath, OptionPathSize) == 0;
+
+  EfiBootManagerFreeLoadOption (&Option);
+  return Matches;
+}
+
+BOOLEAN
+FastBootConnect (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  FAST_BOOT_TARGET          *Target;
+  UINTN                     TargetSize;
+  EFI_DEVICE_PATH_PROTOCOL  *OptionPath;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath;
+  UINTN                     DevicePathSize;
+  UINT16                    *BootOrder;
+  UINTN                     BootOrderSize;
+  VOID                      *BootNext;
+  EFI_HANDLE                Handle;
+  BOOLEAN                   Connected;
+
+  if (!FastBootEnabled ()) {
+    return FALSE;
+  }
+
+  Status = GetVariable2 (FAST_BOOT_TARGET_VARIABLE,
+             &gRk356xFastBootVariableGuid, (VOID **)&Target, &TargetSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "FastBoot: no target recorded, connecting all\n"));
+    return FALSE;
+  }
+
+  Connected = FALSE;
+
+  if (TargetSize <= sizeof (FAST_BOOT_TARGET) ||
+      Target->OptionPathSize >= TargetSize - sizeof (FAST_BOOT_TARGET)) {
+    DEBUG ((DEBUG_WARN, "FastBoot: invalid target variable\n"));
+    goto Exit;
+  }
+
+  OptionPath = (EFI_DEVICE_PATH_PROTOCOL *)(Target + 1);
+  DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)((UINT8 *)OptionPath + Target->OptionPathSize);
+  DevicePathSize = TargetSize - sizeof (FAST_BOOT_TARGET) - Target->OptionPathSize;
+  if (!IsDevicePathValid (OptionPath, Target->OptionPathSize) ||
+      !IsDevicePathValid (DevicePath, DevicePathSize)) {
+    DEBUG ((DEBUG_WARN, "FastBoot: invalid target variable\n"));
+    goto Exit;
+  }
+
+  //
+  // A one-time boot of another option, or a changed boot order or option,
+  // may need a device that hasn't been seen yet.
+  //
+  Status = GetEfiGlobalVariable2 (EFI_BOOT_NEXT_VARIABLE_NAME, &BootNext, NULL);
+  if (!EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "FastBoot: BootNext is set, connecting all\n"));
+    FreePool (BootNext);
+    goto Exit;
+  }
+
+  Status = GetEfiGlobalVariable2 (EFI_BOOT_ORDER_VARIABLE_NAME,
+             (VOID **)&BootOrder, &BootOrderSize);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+  if (BootOrderSize < sizeof (UINT16) || BootOrder[0] != Target->OptionNumber) {
+    DEBUG ((DEBUG_INFO, "FastBoot: boot order changed, connecting all\n"));
+    FreePool (BootOrder);
+    goto Exit;
+  }
+  FreePool (BootOrder);
+
+  if (!FastBootOptionMatches (Target->OptionNumber, OptionPath, Target->OptionPathSize)) {
+    DEBUG ((DEBUG_INFO, "FastBoot: Boot%04x changed, connecting all\n", Target->OptionNumber));
+    goto Exit;
+  }
+
+  //
+  // Connect the chain of controllers down to the boot device, and make sure
+  // every node on the path came up.
+  //
+  Status = EfiBootManagerConnectDevicePath (DevicePath, NULL);
+  if (!EFI_ERROR (Status)) {
+    RemainingDevicePath = DevicePath;
+    Status = gBS->LocateDevicePath (&gEfiDevicePathProtocolGuid,
+                    &RemainingDevicePath, &Handle);
+    if (!EFI_ERROR (Status) && !IsDevicePathEnd (RemainingDevicePath)) {
+      Status = EFI_NOT_FOUND;
+    }
+  }
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "FastBoot: failed to connect target: %r, connecting all\n", Status));
+    goto Exit;
+  }
+
+  DEBUG ((DEBUG_INFO, "FastBoot: connected Boot%04x target\n", Target->OptionNumber));
+  Connected = TRUE;
+
+Exit:
+  FreePool (Target);
+  return Connected;
+}
+
+/*
+ * Saves the device path of the first image loaded after ReadyToBoot, which
+ * is the image of the boot option being launched.
+ */
+STATIC
+VOID
+EFIAPI
+FastBootLoadedImageNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_HANDLE                    Handle;
+  UINTN                         HandleSize;
+  EFI_LOADED_IMAGE_PROTOCOL     *LoadedImage;
+  EFI_BOOT_MANAGER_LOAD_OPTION  Option;
+  CHAR16                        OptionName[sizeof ("Boot####")];
+  EFI_DEVICE_PATH_PROTOCOL      *DevicePath;
+  UINTN                         OptionPathSize;
+  UINTN                         DevicePathSize;
+  FAST_BOOT_TARGET              *Target;
+  UINTN                         TargetSize;
+  VOID                          *OldTarget;
+  UINTN                         OldTargetSize;
+
+  HandleSize = sizeof (Handle);
+  Status = gBS->LocateHandle (ByRegisterNotify, NULL, mLoadedImageRegistration,
+                  &HandleSize, &Handle);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  gBS->CloseEvent (mLoadedImageEvent);
+  mLoadedImageEvent = NULL;
+
+  Status = gBS->HandleProtocol (Handle, &gEfiLoadedImageProtocolGuid,
+                  (VOID **)&LoadedImage);
+  if (EFI_ERROR (Status) || LoadedImage->DeviceHandle == NULL) {
+    return;
+  }
+
+  DevicePath = DevicePathFromHandle (LoadedImage->DeviceHandle);
+  if (DevicePath == NULL) {
+    return;
+  }
+
+  UnicodeSPrint (OptionName, sizeof (OptionName), L"Boot%04x", mBootCurrent);
+  Status = EfiBootManagerVariableToLoadOption (OptionName, &Option);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  OptionPathSize = GetDevicePathSize (Option.FilePath);
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  TargetSize = sizeof (FAST_BOOT_TARGET) + OptionPathSize + DevicePathSize;
+  Target = AllocateZeroPool (TargetSize);
+  if (Target == NULL) {
+    EfiBootManagerFreeLoadOption (&Option);
+    return;
+  }
+
+  Target->OptionNumber = mBootCurrent;
+  Target->OptionPathSize = (UINT32)OptionPathSize;
+  CopyMem (Target + 1, Option.FilePath, OptionPathSize);
+  CopyMem ((UINT8 *)(Target + 1) + OptionPathSize, DevicePath, DevicePathSize);
+  EfiBootManagerFreeLoadOption (&Option);
+
+  //
+  // Most boots load from the same place, so avoid rewriting the variable
+  // store every time.
+  //
+  Status = GetVariable2 (FAST_BOOT_TARGET_VARIABLE,
+             &gRk356xFastBootVariableGuid, &OldTarget, &OldTargetSize);
+  if (!EFI_ERROR (Status)) {
+    if (OldTargetSize == TargetSize && CompareMem (OldTarget, Target, TargetSize) == 0) {
+      FreePool (OldTarget);
+      FreePool (Target);
+      return;
+    }
+    FreePool (OldTarget);
+  }
+
+  Status = gRT->SetVariable (FAST_BOOT_TARGET_VARIABLE,
+                  &gRk356xFastBootVariableGuid,
+                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS |
+                  EFI_VARIABLE_RUNTIME_ACCESS,
+                  TargetSize, Target);
+  DEBUG ((EFI_ERROR (Status) ? DEBUG_WARN : DEBUG_INFO,
+    "FastBoot: recording Boot%04x target: %r\n", mBootCurrent, Status));
+
+  FreePool (Target);
+}
+
+/*
+ * BootCurrent is set before ReadyToBoot is signalled and the boot option's
+ * image is loaded.
+ */
+STATIC
+VOID
+EFIAPI
+FastBootReadyToBoot (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT16      *BootCurrent;
+
+  Status = GetEfiGlobalVariable2 (EFI_BOOT_CURRENT_VARIABLE_NAME,
+             (VOID **)&BootCurrent, NULL);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+  mBootCurrent = *BootCurrent;
+  FreePool (BootCurrent);
+
+  if (mLoadedImageEvent == NULL) {
+    mLoadedImageEvent = EfiCreateProtocolNotifyEvent (
+                          &gEfiLoadedImageProtocolGuid,
+                          TPL_CALLBACK,
+                          FastBootLoadedImageNotify,
+                          NULL,
+                          &mLoadedImageRegistration
+                          );
+  }
+}
+
+VOID
+FastBootRecordTarget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  if (!FastBootEnabled () || mReadyToBootEvent != NULL) {
+    return;
+  }
+
+  Status = EfiCreateEventReadyToBootEx (TPL_CALLBACK, FastBootReadyToBoot,
+             NULL, &mReadyToBootEvent);
+  ASSERT_EFI_ERROR (Status);
+}
+
+VOID
+FastBootForget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gRT->SetVariable (FAST_BOOT_TARGET_VARIABLE,
+                  &gRk356xFastBootVariableGuid, 0, 0, NULL);
+  if (!EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "FastBoot: target forgotten\n"));
+  }
+}
+
+BOOLEAN
+FastBootHotkeyPressed (
+  OUT BOOLEAN  *BootMenu
+  )
+{
+  EFI_INPUT_KEY Key;
+  BOOLEAN       Pressed;
+
+  *BootMenu = FALSE;
+  if (!FastBootEnabled () || gST->ConIn == NULL) {
+    return FALSE;
+  }
+
+  //
+  // BDS drops keystrokes that aren't hotkeys, and its own hotkeys are
+  // delivered through key notifications, so reading them here is harmless.
+  //
+  Pressed = FALSE;
+  while (gST->ConIn->ReadKeyStroke (gST->ConIn, &Key) == EFI_SUCCESS) {
+    if (Key.ScanCode == FAST_BOOT_HOTKEY) {
+      Pressed = TRUE;
+    } else if (Key.ScanCode == SCAN_ESC || Key.ScanCode == SCAN_F2) {
+      *BootMenu = TRUE;
+    }
+  }
+
+  if (Pressed) {
+    Print (L"\nFull device discovery requested\n");
+  }
+
+  return Pressed || *BootMenu;
+}
@@ -0,0 +1,70 @@
+/** @file
+ *
+ *  Rk356x platform boot manager.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *  Copyright (C) 2015-2016, Red Hat, Inc.
+ *  Copyright (c) 2014, ARM Ltd. All rights reserved.<BR>
+ *  Copyright (c) 2004 - 2008, Intel Corporation. All rights reserved.<BR>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef PLATFORM_BM_H_
+#define PLATFORM_BM_H_
+
+/**
+  Return TRUE if fast boot is enabled in setup.
+**/
+BOOLEAN
+FastBootEnabled (
+  VOID
+  );
+
+/**
+  Connect the device path recorded by the previous boot, if fast boot is
+  enabled and the boot order still starts with the option that used it.
+
+  @retval TRUE   The recorded device is connected. The caller may skip
+                 connecting everything else.
+  @retval FALSE  Fast boot doesn't apply, or the device could not be
+                 connected. The caller must connect all controllers.
+**/
+BOOLEAN
+FastBootConnect (
+  VOID
+  );
+
+/**
+  Record the device that the next boot option loads its image from, so
+  that the next boot can connect only that device.
+**/
+VOID
+FastBootRecordTarget (
+  VOID
+  );
+
+/**
+  Forget the recorded device, so that the next boot connects everything.
+**/
+VOID
+FastBootForget (
+  VOID
+  );
+
+/**
+  Drain pending keystrokes and report whether the user asked for a full
+  connect, either with F4 or by asking for the boot manager menu.
+
+  @param[out] BootMenu  Set to TRUE if ESC or F2 was pressed.
+
+  @retval TRUE   Fast boot is enabled and one of the keys was pressed.
+  @retval FALSE  Otherwise.
+**/
+BOOLEAN
+FastBootHotkeyPressed (
+  OUT BOOLEAN  *BootMenu
+  );
+
+#endif /* PLATFORM_BM_H_ */
@@ -0,0 +1,175 @@
+/** @file
+ *
+ *  Settings stored by ConfigDxe, read the same way by every driver that
+ *  acts on them.
+ *
+ *  A performance profile is a bundle of the individual performance,
+ *  thermal and fan settings. While one is active its values are used in
+ *  place of the stored settings, which are left untouched so that they
+ *  apply again once Custom is selected.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Base.h>
+
+#include <Library/PcdLib.h>
+#include <Library/PlatformConfigLib.h>
+
+typedef struct {
+  UINT32        CpuClock;
+  UINT32        DmcClock;
+  UINT32        CriticalTrip;
+  UINT32        FanTrip;
+  UINT8         FanCurveTemp[FAN_CURVE_POINTS];
+  UINT8         FanCurveDuty[FAN_CURVE_POINTS];
+} PERFORMANCE_PROFILE;
+
+//
+// Indexed by PERFORMANCE_PROFILE_*
+//
+STATIC CONST PERFORMANCE_PROFILE mProfiles[] = {
+  {
+    0,  // Custom, uses the stored settings
+  },
+  {
+    CPUCLOCK_MAX,
+    DMCCLOCK_DEFAULT,
+    115, 50,
+    { 40, 50, 60, 70 },
+    { 40, 60, 80, 100 },
+  },
+  {
+    CPUCLOCK_DEFAULT,
+    DMCCLOCK_DEFAULT,
+    115, 60,
+    { 45, 55, 65, 75 },
+    { 30, 50, 75, 100 },
+  },
+  {
+    CPUCLOCK_LOW,
+    DMCCLOCK_LOW,
+    110, 70,
+    { 55, 65, 75, 85 },
+    { 20, 35, 60, 100 },
+  },
+};
+
+//
+// Return the active profile, or NULL for Custom and unknown profiles.
+//
+STATIC
+CONST PERFORMANCE_PROFILE *
+GetProfile (
+  VOID
+  )
+{
+  UINT32 Index;
+
+  Index = PcdGet32 (PcdPerformanceProfile);
+  if (Index == PERFORMANCE_PROFILE_CUSTOM || Index >= ARRAY_SIZE (mProfiles)) {
+    return NULL;
+  }
+
+  return &mProfiles[Index];
+}
+
+UINT32
+EFIAPI
+PlatformConfigGetCpuClock (
+  VOID
+  )
+{
+  CONST PERFORMANCE_PROFILE *Profile;
+
+  Profile = GetProfile ();
+  return Profile != NULL ? Profile->CpuClock : PcdGet32 (PcdCpuClock);
+}
+
+UINT32
+EFIAPI
+PlatformConfigGetDmcClock (
+  VOID
+  )
+{
+  CONST PERFORMANCE_PROFILE *Profile;
+
+  Profile = GetProfile ();
+  return Profile != NULL ? Profile->DmcClock : PcdGet32 (PcdDmcClock);
+}
+
+UINT32
+EFIAPI
+PlatformConfigGetCriticalTrip (
+  VOID
+  )
+{
+  CONST PERFORMANCE_PROFILE *Profile;
+
+  Profile = GetProfile ();
+  return Profile != NULL ? Profile->CriticalTrip : PcdGet32 (PcdThermalCriticalTrip);
+}
+
+UINT32
+EFIAPI
+PlatformConfigGetFanTrip (
+  VOID
+  )
+{
+  CONST PERFORMANCE_PROFILE *Profile;
+
+  Profile = GetProfile ();
+  return Profile != NULL ? Profile->FanTrip : PcdGet32 (PcdThermalFanTrip);
+}
+
+BOOLEAN
+EFIAPI
+FanCurveIsValid (
+  IN CONST FAN_CURVE_VARSTORE_DATA  *Curve
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < FAN_CURVE_POINTS; Index++) {
+    if (Curve->Temp[Index] > THERMAL_TRIP_MAX || Curve->Duty[Index] > 100) {
+      return FALSE;
+    }
+    if (Index > 0 && Curve->Temp[Index] < Curve->Temp[Index - 1]) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+BOOLEAN
+EFIAPI
+PlatformConfigGetFanCurve (
+  OUT FAN_CURVE_VARSTORE_DATA  *Curve
+  )
+{
+  CONST PERFORMANCE_PROFILE *Profile;
+  UINTN                     Index;
+
+  Profile = GetProfile ();
+  if (Profile != NULL) {
+    for (Index = 0; Index < FAN_CURVE_POINTS; Index++) {
+      Curve->Temp[Index] = Profile->FanCurveTemp[Index];
+      Curve->Duty[Index] = Profile->FanCurveDuty[Index];
+    }
+  } else {
+    Curve->Temp[0] = PcdGet8 (PcdFanCurveTemp0);
+    Curve->Temp[1] = PcdGet8 (PcdFanCurveTemp1);
+    Curve->Temp[2] = PcdGet8 (PcdFanCurveTemp2);
+    Curve->Temp[3] = PcdGet8 (PcdFanCurveTemp3);
+    Curve->Duty[0] = PcdGet8 (PcdFanCurveDuty0);
+    Curve->Duty[1] = PcdGet8 (PcdFanCurveDuty1);
+    Curve->Duty[2] = PcdGet8 (PcdFanCurveDuty2);
+    Curve->Duty[3] = PcdGet8 (PcdFanCurveDuty3);
+  }
+
+  return FanCurveIsValid (Curve);
+}
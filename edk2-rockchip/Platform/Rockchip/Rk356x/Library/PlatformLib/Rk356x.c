@@ -9,8 +9,10 @@
  *
  **/
 
+#include <Library/ArmLib.h>
 #include <Library/IoLib.h>
 #include <Library/ArmPlatformLib.h>
+#include <Library/BootTraceLib.h>
 #include <Library/DebugLib.h>
 #include <Pi/PiBootMode.h>
 
@@ -40,6 +42,8 @@ ArmPlatformInitialize (
   IN  UINTN  MpId
   )
 {
+  BootTraceInitialize ();
+
   return RETURN_SUCCESS;
 }
 
@@ -50,11 +54,14 @@ ArmPlatformInitializeSystemMemory (
 {
 }
 
+//
+// MPIDR of each core. ArmPsciMpServicesDxe passes these to PSCI CPU_ON.
+//
 STATIC ARM_CORE_INFO mQuartz64InfoTable[] = {
-  { 0x0, 0x000 },             // Cluster 0, Core 0
-  { 0x0, 0x100 },             // Cluster 0, Core 1
-  { 0x0, 0x200 },             // Cluster 0, Core 2
-  { 0x0, 0x300 },             // Cluster 0, Core 3
+  { GET_MPID (0, 0x000) },    // Cluster 0, Core 0
+  { GET_MPID (0, 0x100) },    // Cluster 0, Core 1
+  { GET_MPID (0, 0x200) },    // Cluster 0, Core 2
+  { GET_MPID (0, 0x300) },    // Cluster 0, Core 3
 };
 
 STATIC
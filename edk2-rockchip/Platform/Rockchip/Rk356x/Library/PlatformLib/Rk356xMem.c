@@ -17,12 +17,13 @@
 #include <Library/Rk356xMem.h>
 #include <Library/SdramLib.h>
 #include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xPcie.h>
 
 UINT64 mSystemMemoryBase = FixedPcdGet64 (PcdSystemMemoryBase);
 STATIC UINT64 mSystemMemorySize = FixedPcdGet64 (PcdSystemMemorySize);
 
 // The total number of descriptors, including the final "end-of-table" descriptor.
-#define MAX_VIRTUAL_MEMORY_MAP_DESCRIPTORS 11
+#define MAX_VIRTUAL_MEMORY_MAP_DESCRIPTORS 17
 
 STATIC BOOLEAN                     VirtualMemoryInfoInitialized = FALSE;
 STATIC RK356X_MEMORY_REGION_INFO   VirtualMemoryInfo[MAX_VIRTUAL_MEMORY_MAP_DESCRIPTORS];
@@ -36,6 +37,81 @@ STATIC RK356X_MEMORY_REGION_INFO   VirtualMemoryInfo[MAX_VIRTUAL_MEMORY_MAP_DESC
                        FixedPcdGet32(PcdFdSize) - \
                        VariablesSize)
 
+//
+// The FDT, boot trace ring and UART TX ring are placed back to back at
+// fixed addresses in the DEC files, so catch any overlap at build time.
+//
+#define REGIONS_OVERLAP(BaseA, SizeA, BaseB, SizeB) \
+  ((BaseA) < (BaseB) + (SizeB) && (BaseB) < (BaseA) + (SizeA))
+
+STATIC_ASSERT (!REGIONS_OVERLAP (FixedPcdGet64 (PcdFdtBaseAddress), FixedPcdGet32 (PcdFdtSize),
+                                 FixedPcdGet64 (PcdBootTraceBase), FixedPcdGet32 (PcdBootTraceSize)),
+               "FDT overlaps the boot trace ring");
+STATIC_ASSERT (!REGIONS_OVERLAP (FixedPcdGet64 (PcdFdtBaseAddress), FixedPcdGet32 (PcdFdtSize),
+                                 FixedPcdGet64 (PcdUartTxRingBase), FixedPcdGet32 (PcdUartTxRingSize)),
+               "FDT overlaps the UART TX ring");
+STATIC_ASSERT (!REGIONS_OVERLAP (FixedPcdGet64 (PcdBootTraceBase), FixedPcdGet32 (PcdBootTraceSize),
+                                 FixedPcdGet64 (PcdUartTxRingBase), FixedPcdGet32 (PcdUartTxRingSize)),
+               "Boot trace ring overlaps the UART TX ring");
+
+STATIC
+VOID
+AddMmioRange (
+  IN     ARM_MEMORY_REGION_DESCRIPTOR  *VirtualMemoryTable,
+  IN OUT UINTN                         *Index,
+  IN     UINT64                        Base,
+  IN     UINT64                        Length,
+  IN     ARM_MEMORY_REGION_ATTRIBUTES  Attributes,
+  IN     CONST CHAR16                  *Name
+  )
+{
+  if (Length == 0) {
+    return;
+  }
+
+  VirtualMemoryTable[*Index].PhysicalBase   = Base;
+  VirtualMemoryTable[*Index].VirtualBase    = Base;
+  VirtualMemoryTable[*Index].Length         = Length;
+  VirtualMemoryTable[*Index].Attributes     = Attributes;
+  VirtualMemoryInfo[*Index].Type            = RK356X_MEM_UNMAPPED_REGION;
+  VirtualMemoryInfo[(*Index)++].Name        = Name;
+}
+
+/**
+  Add an MMIO region to the memory map as Device memory, except for the
+  PCIe prefetchable window inside it, which is mapped Normal Non-cacheable
+  so that CPU writes to prefetchable BARs are merged on the way out.
+
+**/
+STATIC
+VOID
+AddMmioRegion (
+  IN     ARM_MEMORY_REGION_DESCRIPTOR  *VirtualMemoryTable,
+  IN OUT UINTN                         *Index,
+  IN     UINT64                        Base,
+  IN     UINT64                        Length,
+  IN     UINT64                        PrefetchBase,
+  IN     UINT64                        PrefetchLength,
+  IN     CONST CHAR16                  *Name
+  )
+{
+  if (PrefetchLength == 0 ||
+      PrefetchBase < Base ||
+      PrefetchBase + PrefetchLength > Base + Length) {
+    ASSERT (PrefetchLength == 0);
+    PrefetchBase = Base + Length;
+    PrefetchLength = 0;
+  }
+
+  AddMmioRange (VirtualMemoryTable, Index, Base, PrefetchBase - Base,
+                ARM_MEMORY_REGION_ATTRIBUTE_DEVICE, Name);
+  AddMmioRange (VirtualMemoryTable, Index, PrefetchBase, PrefetchLength,
+                ARM_MEMORY_REGION_ATTRIBUTE_UNCACHED_UNBUFFERED, L"PCIe Prefetchable");
+  AddMmioRange (VirtualMemoryTable, Index, PrefetchBase + PrefetchLength,
+                Base + Length - (PrefetchBase + PrefetchLength),
+                ARM_MEMORY_REGION_ATTRIBUTE_DEVICE, Name);
+}
+
 /**
   Return the Virtual Memory Map of your platform
 
@@ -67,21 +143,15 @@ ArmPlatformGetVirtualMemoryMap (
     return;
   }
 
-  // MMIO
-  VirtualMemoryTable[Index].PhysicalBase    = FixedPcdGet64 (PcdReservedBaseAddress);
-  VirtualMemoryTable[Index].VirtualBase     = VirtualMemoryTable[Index].PhysicalBase;
-  VirtualMemoryTable[Index].Length          = FixedPcdGet32 (PcdReservedSize);
-  VirtualMemoryTable[Index].Attributes      = ARM_MEMORY_REGION_ATTRIBUTE_DEVICE;
-  VirtualMemoryInfo[Index].Type             = RK356X_MEM_UNMAPPED_REGION;
-  VirtualMemoryInfo[Index++].Name           = L"Reserved";
+  // MMIO, including the 32-bit PCIe window
+  AddMmioRegion (VirtualMemoryTable, &Index,
+                 FixedPcdGet64 (PcdReservedBaseAddress), FixedPcdGet32 (PcdReservedSize),
+                 PCIE_PMEM32_BASE, PCIE_PMEM32_SIZE, L"Reserved");
 
-  // MMIO > 4GB
-  VirtualMemoryTable[Index].PhysicalBase    = 0x0000000300000000UL;
-  VirtualMemoryTable[Index].VirtualBase     = VirtualMemoryTable[Index].PhysicalBase;
-  VirtualMemoryTable[Index].Length          = 0x00000000C0C00000UL;
-  VirtualMemoryTable[Index].Attributes      = ARM_MEMORY_REGION_ATTRIBUTE_DEVICE;
-  VirtualMemoryInfo[Index].Type             = RK356X_MEM_UNMAPPED_REGION;
-  VirtualMemoryInfo[Index++].Name           = L"Reserved > 4GB";
+  // MMIO > 4GB, including the 64-bit PCIe window
+  AddMmioRegion (VirtualMemoryTable, &Index,
+                 0x0000000300000000UL, 0x00000000C0C00000UL,
+                 PCIE_PMEM64_BASE, PCIE_PMEM64_SIZE, L"Reserved > 4GB");
 
   // Base System RAM
   VirtualMemoryTable[Index].PhysicalBase    = mSystemMemoryBase;
@@ -149,6 +219,22 @@ ArmPlatformGetVirtualMemoryMap (
   VirtualMemoryInfo[Index].Type             = RK356X_MEM_RESERVED_REGION;
   VirtualMemoryInfo[Index++].Name           = L"Flattened Device Tree";
 
+  // Boot trace ring, uncached so that nothing is lost to the caches on a warm reset
+  VirtualMemoryTable[Index].PhysicalBase    = FixedPcdGet64 (PcdBootTraceBase);
+  VirtualMemoryTable[Index].VirtualBase     = VirtualMemoryTable[Index].PhysicalBase;
+  VirtualMemoryTable[Index].Length          = FixedPcdGet32 (PcdBootTraceSize);
+  VirtualMemoryTable[Index].Attributes      = ARM_MEMORY_REGION_ATTRIBUTE_UNCACHED_UNBUFFERED;
+  VirtualMemoryInfo[Index].Type             = RK356X_MEM_RESERVED_REGION;
+  VirtualMemoryInfo[Index++].Name           = L"Boot Trace";
+
+  // Console UART transmit ring, drained from the UART interrupt during DXE
+  VirtualMemoryTable[Index].PhysicalBase    = FixedPcdGet64 (PcdUartTxRingBase);
+  VirtualMemoryTable[Index].VirtualBase     = VirtualMemoryTable[Index].PhysicalBase;
+  VirtualMemoryTable[Index].Length          = FixedPcdGet32 (PcdUartTxRingSize);
+  VirtualMemoryTable[Index].Attributes      = ARM_MEMORY_REGION_ATTRIBUTE_WRITE_BACK;
+  VirtualMemoryInfo[Index].Type             = RK356X_MEM_RESERVED_REGION;
+  VirtualMemoryInfo[Index++].Name           = L"UART TX Ring";
+
   // End of Table
   VirtualMemoryTable[Index].PhysicalBase    = 0;
   VirtualMemoryTable[Index].VirtualBase     = 0;
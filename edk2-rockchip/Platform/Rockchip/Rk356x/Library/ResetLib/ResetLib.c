@@ -19,6 +19,7 @@
 #include <Library/TimerLib.h>
 #include <Library/EfiResetSystemLib.h>
 #include <Library/ArmSmcLib.h>
+#include <Library/SerialPortLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/UefiRuntimeLib.h>
@@ -59,6 +60,11 @@ LibResetSystem (
     if (Delay != 0) {
       MicroSecondDelay (Delay);
     }
+
+    //
+    // Console output may still be buffered, wait for it to go out.
+    //
+    SerialPortWrite (NULL, 0);
   }
 
   switch (ResetType) {
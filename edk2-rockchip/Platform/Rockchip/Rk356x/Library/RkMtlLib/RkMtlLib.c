@@ -17,6 +17,7 @@
 #include <Library/ArmMtlLib.h>
 #include <Library/DebugLib.h>
 #include <Library/IoLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/UefiBootServicesTableLib.h>
@@ -31,6 +32,205 @@ STATIC CONST MTL_CHANNEL Channels[NUM_CHANNELS] = {
     },
   };
 
+STATIC MTL_CACHE_ENTRY  mCache[MTL_CACHE_ENTRIES];
+STATIC UINTN            mCacheCount;
+
+// Request sent on the channel that may be added to the cache once answered.
+STATIC MTL_CACHE_ENTRY  mPending;
+STATIC BOOLEAN          mPendingValid;
+
+// TPL to restore once the message in flight has been answered.
+STATIC EFI_TPL          mTransactionTpl;
+STATIC BOOLEAN          mTransactionActive;
+
+/** Start a mailbox transaction.
+
+  SCMI requests may be issued from timer callbacks (the TsadcDxe thermal
+  governor) as well as from TPL_APPLICATION code. Nothing else serialises
+  access to the single shared mailbox or to the pending request state, so
+  keep callbacks out from the doorbell until the response has been read.
+**/
+STATIC
+VOID
+MtlTransactionBegin (
+  VOID
+  )
+{
+  ASSERT (!mTransactionActive);
+  mTransactionTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  mTransactionActive = TRUE;
+}
+
+/** End the mailbox transaction started by MtlTransactionBegin ().
+**/
+STATIC
+VOID
+MtlTransactionEnd (
+  VOID
+  )
+{
+  if (mTransactionActive) {
+    mTransactionActive = FALSE;
+    gBS->RestoreTPL (mTransactionTpl);
+  }
+}
+
+/** Check whether the response to a message never changes.
+
+  @param[in] MessageHeader          Message header.
+
+  @retval TRUE                      The response can be cached.
+  @retval FALSE                     The response must not be cached.
+**/
+STATIC
+BOOLEAN
+MtlIsCacheable (
+  IN UINT32  MessageHeader
+  )
+{
+  UINT32  MessageId;
+
+  if (SCMI_MESSAGE_TYPE (MessageHeader) != SCMI_MESSAGE_TYPE_COMMAND) {
+    return FALSE;
+  }
+
+  // PROTOCOL_VERSION, PROTOCOL_ATTRIBUTES and PROTOCOL_MESSAGE_ATTRIBUTES
+  MessageId = SCMI_MESSAGE_ID (MessageHeader);
+  if (MessageId <= 2) {
+    return TRUE;
+  }
+
+  switch (SCMI_PROTOCOL_ID (MessageHeader)) {
+  case SCMI_PROTOCOL_ID_BASE:
+    // DISCOVER_VENDOR, DISCOVER_SUB_VENDOR, DISCOVER_IMPLEMENTATION_VERSION,
+    // DISCOVER_LIST_PROTOCOLS
+    return MessageId >= 3 && MessageId <= 6;
+  case SCMI_PROTOCOL_ID_PERFORMANCE:
+    // PERFORMANCE_DOMAIN_ATTRIBUTES, PERFORMANCE_DESCRIBE_LEVELS
+    return MessageId == 3 || MessageId == 4;
+  case SCMI_PROTOCOL_ID_CLOCK:
+    // CLOCK_DESCRIBE_RATES. CLOCK_ATTRIBUTES is not cached as it reports
+    // whether the clock is enabled.
+    return MessageId == 4;
+  default:
+    return FALSE;
+  }
+}
+
+/** Look for a cached response to the request in the mailbox.
+
+  On a hit, the response is written to the mailbox and the channel is
+  left free, as if the SCP had answered the request.
+
+  @param[in] Channel                Pointer to a channel.
+  @param[in] MessageHeader          Message header.
+  @param[in] PayloadLength          Request payload length.
+
+  @retval TRUE                      The response was found in the cache.
+  @retval FALSE                     The request must be sent to the SCP.
+**/
+STATIC
+BOOLEAN
+MtlCacheLookup (
+  IN MTL_CHANNEL  *Channel,
+  IN UINT32       MessageHeader,
+  IN UINT32       PayloadLength
+  )
+{
+  MTL_MAILBOX     *MailBox = Channel->MailBox;
+  MTL_CACHE_ENTRY *Entry;
+  UINTN           Index;
+  UINTN           Word;
+
+  mPendingValid = FALSE;
+
+  if (!MtlIsCacheable (MessageHeader) ||
+      PayloadLength > sizeof (mPending.Request) ||
+      (PayloadLength % sizeof (UINT32)) != 0) {
+    return FALSE;
+  }
+
+  ZeroMem (&mPending, sizeof (mPending));
+  mPending.MessageHeader = MessageHeader & ~SCMI_MESSAGE_TOKEN_MASK;
+  mPending.RequestLength = PayloadLength;
+  for (Word = 0; Word < PayloadLength / sizeof (UINT32); Word++) {
+    mPending.Request[Word] = MailBox->Payload[Word];
+  }
+
+  for (Index = 0; Index < mCacheCount; Index++) {
+    Entry = &mCache[Index];
+    if (Entry->MessageHeader != mPending.MessageHeader ||
+        Entry->RequestLength != mPending.RequestLength ||
+        CompareMem (Entry->Request, mPending.Request, PayloadLength) != 0) {
+      continue;
+    }
+
+    for (Word = 0; Word < Entry->ResponseLength / sizeof (UINT32); Word++) {
+      MailBox->Payload[Word] = Entry->Response[Word];
+    }
+    MailBox->MessageHeader = MessageHeader;
+    MailBox->Length = Entry->ResponseLength + sizeof (MessageHeader);
+    ArmDataSynchronizationBarrier ();
+
+    DEBUG ((DEBUG_VERBOSE, "MtlSendMessage cached response for message header 0x%08X\n",
+            MessageHeader));
+    return TRUE;
+  }
+
+  mPendingValid = TRUE;
+  return FALSE;
+}
+
+/** Add the response in the mailbox to the cache, if it answers a
+    cacheable request.
+
+  @param[in] Channel                Pointer to a channel.
+**/
+STATIC
+VOID
+MtlCacheInsert (
+  IN MTL_CHANNEL  *Channel
+  )
+{
+  MTL_MAILBOX     *MailBox = Channel->MailBox;
+  MTL_CACHE_ENTRY *Entry;
+  UINT32          Length;
+  UINTN           Word;
+
+  if (!mPendingValid) {
+    return;
+  }
+  mPendingValid = FALSE;
+
+  if (mCacheCount == MTL_CACHE_ENTRIES) {
+    return;
+  }
+
+  Length = MailBox->Length - sizeof (MailBox->MessageHeader);
+  if ((MailBox->MessageHeader & ~SCMI_MESSAGE_TOKEN_MASK) != mPending.MessageHeader ||
+      Length < sizeof (UINT32) ||
+      Length > MTL_MAILBOX_SIZE - OFFSET_OF (MTL_MAILBOX, Payload) ||
+      (Length % sizeof (UINT32)) != 0 ||
+      MailBox->Payload[0] != SCMI_SUCCESS) {
+    return;
+  }
+
+  Entry = &mCache[mCacheCount];
+  Entry->Response = AllocatePool (Length);
+  if (Entry->Response == NULL) {
+    return;
+  }
+
+  Entry->MessageHeader = mPending.MessageHeader;
+  Entry->RequestLength = mPending.RequestLength;
+  CopyMem (Entry->Request, mPending.Request, sizeof (Entry->Request));
+  Entry->ResponseLength = Length;
+  for (Word = 0; Word < Length / sizeof (UINT32); Word++) {
+    Entry->Response[Word] = MailBox->Payload[Word];
+  }
+  mCacheCount++;
+}
+
 /** Wait until channel is free.
 
   @param[in] Channel                Pointer to a channel.
@@ -45,6 +245,15 @@ MtlWaitUntilChannelFree (
   IN UINTN        TimeOutInMicroSeconds
   )
 {
+  UINTN Spin;
+
+  for (Spin = 0; Spin < MTL_SPIN_COUNT; Spin++) {
+    ArmDataSynchronizationBarrier ();
+    if (Channel->MailBox->ChannelStatus == MTL_CHANNEL_FREE) {
+      return EFI_SUCCESS;
+    }
+  }
+
   while (TimeOutInMicroSeconds != 0) {
     ArmDataSynchronizationBarrier ();
 
@@ -129,12 +338,19 @@ MtlSendMessage (
   MTL_MAILBOX *MailBox = Channel->MailBox;
   ARM_SMC_ARGS SmcRegs = {0};
 
+  MtlTransactionBegin ();
+
   ArmDataSynchronizationBarrier ();
   if (Channel->MailBox->ChannelStatus != MTL_CHANNEL_FREE) {
     DEBUG ((DEBUG_WARN, "Mailbox is busy\n"));
+    MtlTransactionEnd ();
     return EFI_DEVICE_ERROR;
   }
 
+  if (MtlCacheLookup (Channel, MessageHeader, PayloadLength)) {
+    return EFI_SUCCESS;
+  }
+
   // Mark the channel busy before ringing doorbell.
   Channel->MailBox->ChannelStatus = MTL_CHANNEL_BUSY;
   ArmDataSynchronizationBarrier ();
@@ -147,7 +363,7 @@ MtlSendMessage (
 
   ArmDataSynchronizationBarrier ();
 
-  DEBUG ((DEBUG_WARN, "MtlSendMessage ringing doorbell 0x%08X with message header 0x%08X length 0x%08X\n",
+  DEBUG ((DEBUG_VERBOSE, "MtlSendMessage ringing doorbell 0x%08X with message header 0x%08X length 0x%08X\n",
           FixedPcdGet32 (PcdRkMtlMailBoxSmcId), MailBox->MessageHeader, MailBox->Length));
 
   // Ring the doorbell.
@@ -155,7 +371,9 @@ MtlSendMessage (
   ArmCallSmc (&SmcRegs);
 
   if (SmcRegs.Arg0 != 0) {
-    DEBUG ((DEBUG_WARN, "SMC doorbell call failed: 0x%lX\n", FixedPcdGet32 (PcdRkMtlMailBoxSmcId), SmcRegs.Arg0));
+    mPendingValid = FALSE;
+    DEBUG ((DEBUG_WARN, "SMC doorbell call 0x%08X failed: 0x%lX\n", FixedPcdGet32 (PcdRkMtlMailBoxSmcId), SmcRegs.Arg0));
+    MtlTransactionEnd ();
     return EFI_DEVICE_ERROR;
   }
 
@@ -185,13 +403,19 @@ MtlReceiveMessage (
 
   Status = MtlWaitUntilChannelFree (Channel, RESPONSE_TIMEOUT);
   if (EFI_ERROR (Status)) {
+    mPendingValid = FALSE;
+    MtlTransactionEnd ();
     return Status;
   }
 
+  MtlCacheInsert (Channel);
+
   *MessageHeader = MailBox->MessageHeader;
 
   // Deduct message header length.
   *PayloadLength = MailBox->Length - sizeof (*MessageHeader);
 
+  MtlTransactionEnd ();
+
   return EFI_SUCCESS;
 }
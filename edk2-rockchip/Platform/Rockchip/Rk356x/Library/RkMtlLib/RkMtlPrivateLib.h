@@ -27,7 +27,37 @@
 #define  NUM_CHANNELS      1
 
 // Arbitarary poll time.
-#define MTL_POLL_WAIT_TIME 100000
+#define MTL_POLL_WAIT_TIME 1000
+
+// Number of status reads before falling back to timed waits. The doorbell
+// SMC is handled synchronously by the secure firmware, so a response is
+// almost always ready by the first read.
+#define MTL_SPIN_COUNT     1000
+
+// SCMI message header fields.
+#define SCMI_MESSAGE_ID(Header)       ((Header) & 0xFF)
+#define SCMI_MESSAGE_TYPE(Header)     (((Header) >> 8) & 0x3)
+#define SCMI_PROTOCOL_ID(Header)      (((Header) >> 10) & 0xFF)
+#define SCMI_MESSAGE_TOKEN_MASK       (0x3FFU << 18)
+
+#define SCMI_PROTOCOL_ID_BASE         0x10
+#define SCMI_PROTOCOL_ID_PERFORMANCE  0x13
+#define SCMI_PROTOCOL_ID_CLOCK        0x14
+
+#define SCMI_MESSAGE_TYPE_COMMAND     0
+#define SCMI_SUCCESS                  0
+
+// Response cache for SCMI queries with immutable answers.
+#define MTL_CACHE_ENTRIES             32
+#define MTL_CACHE_MAX_REQUEST         2     // Request payload size in words
+
+typedef struct {
+  UINT32  MessageHeader;                    // Token bits cleared
+  UINT32  RequestLength;                    // Bytes
+  UINT32  Request[MTL_CACHE_MAX_REQUEST];
+  UINT32  ResponseLength;                   // Bytes
+  UINT32  *Response;
+} MTL_CACHE_ENTRY;
 
 #endif /* RK_MTL_PRIVATE_LIB_H_ */
 
@@ -0,0 +1,328 @@
+/** @file
+ *
+ *  Block I/O, Block I/O 2 and Disk Info protocols.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AhciNcqDxe.h"
+
+STATIC
+EFI_STATUS
+AhciCheckRequest (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  UINT32          MediaId,
+    IN  EFI_LBA         Lba,
+    IN  UINTN           BufferSize,
+    IN  VOID            *Buffer
+    )
+{
+    EFI_BLOCK_IO_MEDIA *Media = &Dev->Media;
+
+    if (MediaId != Media->MediaId) {
+        return EFI_MEDIA_CHANGED;
+    }
+    if (Buffer == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    if ((BufferSize % Media->BlockSize) != 0) {
+        return EFI_BAD_BUFFER_SIZE;
+    }
+    if (Lba > Media->LastBlock ||
+        BufferSize / Media->BlockSize > Media->LastBlock - Lba + 1) {
+        return EFI_INVALID_PARAMETER;
+    }
+    if (Media->IoAlign > 1 && ((UINTN)Buffer & (Media->IoAlign - 1)) != 0) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+AhciTransfer (
+    IN  AHCI_NCQ_DEVICE     *Dev,
+    IN  UINT32              MediaId,
+    IN  EFI_LBA             Lba,
+    IN  EFI_BLOCK_IO2_TOKEN *Token,
+    IN  UINTN               BufferSize,
+    IN  VOID                *Buffer,
+    IN  BOOLEAN             Write
+    )
+{
+    AHCI_REQUEST *Request;
+    AHCI_REQUEST LocalRequest;
+    EFI_STATUS Status;
+
+    if (Token != NULL && Token->Event == NULL) {
+        Token = NULL;
+    }
+
+    if (BufferSize == 0) {
+        if (MediaId != Dev->Media.MediaId) {
+            return EFI_MEDIA_CHANGED;
+        }
+        if (Token != NULL) {
+            Token->TransactionStatus = EFI_SUCCESS;
+            gBS->SignalEvent (Token->Event);
+        }
+        return EFI_SUCCESS;
+    }
+
+    Status = AhciCheckRequest (Dev, MediaId, Lba, BufferSize, Buffer);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    /* Blocking requests live on the stack; queued ones outlive the call */
+    if (Token != NULL) {
+        Request = AllocateZeroPool (sizeof (*Request));
+        if (Request == NULL) {
+            return EFI_OUT_OF_RESOURCES;
+        }
+    } else {
+        ZeroMem (&LocalRequest, sizeof (LocalRequest));
+        Request = &LocalRequest;
+    }
+
+    Request->Token = Token;
+    Request->Write = Write;
+    Request->Lba = Lba;
+    Request->Buffer = Buffer;
+    Request->Remaining = BufferSize;
+
+    return AhciSubmit (Dev, Request);
+}
+
+STATIC
+EFI_STATUS
+AhciFlush (
+    IN  AHCI_NCQ_DEVICE     *Dev,
+    IN  EFI_BLOCK_IO2_TOKEN *Token
+    )
+{
+    AHCI_REQUEST *Request;
+    AHCI_REQUEST LocalRequest;
+
+    if (Token != NULL && Token->Event == NULL) {
+        Token = NULL;
+    }
+
+    if (Token != NULL) {
+        Request = AllocateZeroPool (sizeof (*Request));
+        if (Request == NULL) {
+            return EFI_OUT_OF_RESOURCES;
+        }
+    } else {
+        ZeroMem (&LocalRequest, sizeof (LocalRequest));
+        Request = &LocalRequest;
+    }
+
+    Request->Token = Token;
+    Request->Flush = TRUE;
+
+    return AhciSubmit (Dev, Request);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIoReset (
+    IN  EFI_BLOCK_IO_PROTOCOL   *This,
+    IN  BOOLEAN                 ExtendedVerification
+    )
+{
+    return AhciReset (AHCI_NCQ_DEVICE_FROM_BLOCK_IO (This));
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIoReadBlocks (
+    IN  EFI_BLOCK_IO_PROTOCOL   *This,
+    IN  UINT32                  MediaId,
+    IN  EFI_LBA                 Lba,
+    IN  UINTN                   BufferSize,
+    OUT VOID                    *Buffer
+    )
+{
+    return AhciTransfer (AHCI_NCQ_DEVICE_FROM_BLOCK_IO (This), MediaId, Lba, NULL,
+                         BufferSize, Buffer, FALSE);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIoWriteBlocks (
+    IN  EFI_BLOCK_IO_PROTOCOL   *This,
+    IN  UINT32                  MediaId,
+    IN  EFI_LBA                 Lba,
+    IN  UINTN                   BufferSize,
+    IN  VOID                    *Buffer
+    )
+{
+    return AhciTransfer (AHCI_NCQ_DEVICE_FROM_BLOCK_IO (This), MediaId, Lba, NULL,
+                         BufferSize, Buffer, TRUE);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIoFlushBlocks (
+    IN  EFI_BLOCK_IO_PROTOCOL   *This
+    )
+{
+    return AhciFlush (AHCI_NCQ_DEVICE_FROM_BLOCK_IO (This), NULL);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIo2Reset (
+    IN  EFI_BLOCK_IO2_PROTOCOL  *This,
+    IN  BOOLEAN                 ExtendedVerification
+    )
+{
+    return AhciReset (AHCI_NCQ_DEVICE_FROM_BLOCK_IO2 (This));
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIo2ReadBlocksEx (
+    IN      EFI_BLOCK_IO2_PROTOCOL  *This,
+    IN      UINT32                  MediaId,
+    IN      EFI_LBA                 Lba,
+    IN OUT  EFI_BLOCK_IO2_TOKEN     *Token,
+    IN      UINTN                   BufferSize,
+    OUT     VOID                    *Buffer
+    )
+{
+    return AhciTransfer (AHCI_NCQ_DEVICE_FROM_BLOCK_IO2 (This), MediaId, Lba, Token,
+                         BufferSize, Buffer, FALSE);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIo2WriteBlocksEx (
+    IN      EFI_BLOCK_IO2_PROTOCOL  *This,
+    IN      UINT32                  MediaId,
+    IN      EFI_LBA                 Lba,
+    IN OUT  EFI_BLOCK_IO2_TOKEN     *Token,
+    IN      UINTN                   BufferSize,
+    IN      VOID                    *Buffer
+    )
+{
+    return AhciTransfer (AHCI_NCQ_DEVICE_FROM_BLOCK_IO2 (This), MediaId, Lba, Token,
+                         BufferSize, Buffer, TRUE);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciBlockIo2FlushBlocksEx (
+    IN      EFI_BLOCK_IO2_PROTOCOL  *This,
+    IN OUT  EFI_BLOCK_IO2_TOKEN     *Token
+    )
+{
+    return AhciFlush (AHCI_NCQ_DEVICE_FROM_BLOCK_IO2 (This), Token);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciDiskInfoInquiry (
+    IN      EFI_DISK_INFO_PROTOCOL  *This,
+    IN OUT  VOID                    *InquiryData,
+    IN OUT  UINT32                  *InquiryDataSize
+    )
+{
+    return EFI_NOT_FOUND;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciDiskInfoIdentify (
+    IN      EFI_DISK_INFO_PROTOCOL  *This,
+    IN OUT  VOID                    *IdentifyData,
+    IN OUT  UINT32                  *IdentifyDataSize
+    )
+{
+    AHCI_NCQ_DEVICE *Dev = AHCI_NCQ_DEVICE_FROM_DISK_INFO (This);
+
+    if (*IdentifyDataSize < sizeof (Dev->IdentifyData)) {
+        *IdentifyDataSize = sizeof (Dev->IdentifyData);
+        return EFI_BUFFER_TOO_SMALL;
+    }
+
+    CopyMem (IdentifyData, &Dev->IdentifyData, sizeof (Dev->IdentifyData));
+    *IdentifyDataSize = sizeof (Dev->IdentifyData);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciDiskInfoSenseData (
+    IN      EFI_DISK_INFO_PROTOCOL  *This,
+    IN OUT  VOID                    *SenseData,
+    IN OUT  UINT32                  *SenseDataSize,
+    OUT     UINT8                   *SenseDataNumber
+    )
+{
+    return EFI_NOT_FOUND;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciDiskInfoWhichIde (
+    IN  EFI_DISK_INFO_PROTOCOL  *This,
+    OUT UINT32                  *IdeChannel,
+    OUT UINT32                  *IdeDevice
+    )
+{
+    /* Single port controller, no port multiplier */
+    *IdeChannel = 0;
+    *IdeDevice = 0;
+
+    return EFI_SUCCESS;
+}
+
+VOID
+AhciBlockIoInit (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    Dev->BlockIo.Revision = EFI_BLOCK_IO_PROTOCOL_REVISION3;
+    Dev->BlockIo.Media = &Dev->Media;
+    Dev->BlockIo.Reset = AhciBlockIoReset;
+    Dev->BlockIo.ReadBlocks = AhciBlockIoReadBlocks;
+    Dev->BlockIo.WriteBlocks = AhciBlockIoWriteBlocks;
+    Dev->BlockIo.FlushBlocks = AhciBlockIoFlushBlocks;
+
+    Dev->BlockIo2.Media = &Dev->Media;
+    Dev->BlockIo2.Reset = AhciBlockIo2Reset;
+    Dev->BlockIo2.ReadBlocksEx = AhciBlockIo2ReadBlocksEx;
+    Dev->BlockIo2.WriteBlocksEx = AhciBlockIo2WriteBlocksEx;
+    Dev->BlockIo2.FlushBlocksEx = AhciBlockIo2FlushBlocksEx;
+
+    CopyGuid (&Dev->DiskInfo.Interface, &gEfiDiskInfoAhciInterfaceGuid);
+    Dev->DiskInfo.Inquiry = AhciDiskInfoInquiry;
+    Dev->DiskInfo.Identify = AhciDiskInfoIdentify;
+    Dev->DiskInfo.SenseData = AhciDiskInfoSenseData;
+    Dev->DiskInfo.WhichIde = AhciDiskInfoWhichIde;
+}
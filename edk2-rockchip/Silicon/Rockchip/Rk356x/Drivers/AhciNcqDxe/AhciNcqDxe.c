@@ -0,0 +1,357 @@
+/** @file
+ *
+ *  Native command queuing Block I/O driver for the RK356x AHCI controllers.
+ *
+ *  The generic AtaAtapiPassThru and AtaBusDxe stack issues one command at a
+ *  time. This driver binds to SATA controllers registered by SataDxe ahead
+ *  of the generic stack and, when the attached disk supports NCQ, produces
+ *  Block I/O and Block I/O 2 directly on top of a queue of FPDMA commands.
+ *  Anything else (ATAPI devices, disks without NCQ) is left to the generic
+ *  stack.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <Protocol/NonDiscoverableDevice.h>
+
+#include "AhciNcqDxe.h"
+
+STATIC
+VOID
+EFIAPI
+AhciExitBootServices (
+    IN  EFI_EVENT       Event,
+    IN  VOID            *Context
+    )
+{
+    AHCI_NCQ_DEVICE *Dev = Context;
+
+    /* Leave the port idle so that the OS driver does not find DMA in flight */
+    AhciPortStop (Dev);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciNcqDriverSupported (
+    IN  EFI_DRIVER_BINDING_PROTOCOL *This,
+    IN  EFI_HANDLE                  Controller,
+    IN  EFI_DEVICE_PATH_PROTOCOL    *RemainingDevicePath OPTIONAL
+    )
+{
+    NON_DISCOVERABLE_DEVICE *NonDiscoverable;
+    EFI_PCI_IO_PROTOCOL *PciIo;
+    EFI_STATUS Status;
+
+    Status = gBS->OpenProtocol (Controller, &gEdkiiNonDiscoverableDeviceProtocolGuid,
+                                (VOID **)&NonDiscoverable, This->DriverBindingHandle,
+                                Controller, EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+    if (!CompareGuid (NonDiscoverable->Type, &gEdkiiNonDiscoverableAhciDeviceGuid)) {
+        return EFI_UNSUPPORTED;
+    }
+
+    Status = gBS->OpenProtocol (Controller, &gEfiPciIoProtocolGuid, (VOID **)&PciIo,
+                                This->DriverBindingHandle, Controller,
+                                EFI_OPEN_PROTOCOL_BY_DRIVER);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+    gBS->CloseProtocol (Controller, &gEfiPciIoProtocolGuid, This->DriverBindingHandle, Controller);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+AhciNcqCreateChild (
+    IN  EFI_DRIVER_BINDING_PROTOCOL *This,
+    IN  AHCI_NCQ_DEVICE             *Dev
+    )
+{
+    EFI_DEVICE_PATH_PROTOCOL *ParentDevicePath;
+    SATA_DEVICE_PATH SataNode;
+    EFI_PCI_IO_PROTOCOL *PciIo;
+    EFI_STATUS Status;
+
+    Status = gBS->OpenProtocol (Dev->Controller, &gEfiDevicePathProtocolGuid,
+                                (VOID **)&ParentDevicePath, This->DriverBindingHandle,
+                                Dev->Controller, EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    ZeroMem (&SataNode, sizeof (SataNode));
+    SataNode.Header.Type = MESSAGING_DEVICE_PATH;
+    SataNode.Header.SubType = MSG_SATA_DP;
+    SetDevicePathNodeLength (&SataNode.Header, sizeof (SataNode));
+    SataNode.HBAPortNumber = 0;
+    SataNode.PortMultiplierPortNumber = 0xFFFF;
+    SataNode.Lun = 0;
+
+    Dev->DevicePath = AppendDevicePathNode (ParentDevicePath, &SataNode.Header);
+    if (Dev->DevicePath == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+
+    AhciBlockIoInit (Dev);
+
+    Status = gBS->InstallMultipleProtocolInterfaces (&Dev->Handle,
+                                                     &gEfiDevicePathProtocolGuid, Dev->DevicePath,
+                                                     &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                                                     &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                                                     &gEfiDiskInfoProtocolGuid, &Dev->DiskInfo,
+                                                     NULL);
+    if (EFI_ERROR (Status)) {
+        FreePool (Dev->DevicePath);
+        Dev->DevicePath = NULL;
+        return Status;
+    }
+
+    gBS->OpenProtocol (Dev->Controller, &gEfiPciIoProtocolGuid, (VOID **)&PciIo,
+                       This->DriverBindingHandle, Dev->Handle,
+                       EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciNcqDriverStart (
+    IN  EFI_DRIVER_BINDING_PROTOCOL *This,
+    IN  EFI_HANDLE                  Controller,
+    IN  EFI_DEVICE_PATH_PROTOCOL    *RemainingDevicePath OPTIONAL
+    )
+{
+    AHCI_NCQ_DEVICE *Dev;
+    EFI_PCI_IO_PROTOCOL *PciIo;
+    UINT64 Attributes;
+    EFI_STATUS Status;
+
+    Status = gBS->OpenProtocol (Controller, &gEfiPciIoProtocolGuid, (VOID **)&PciIo,
+                                This->DriverBindingHandle, Controller,
+                                EFI_OPEN_PROTOCOL_BY_DRIVER);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    Dev = AllocateZeroPool (sizeof (*Dev));
+    if (Dev == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto CloseProtocol;
+    }
+    Dev->Signature = AHCI_NCQ_SIGNATURE;
+    Dev->Controller = Controller;
+    Dev->PciIo = PciIo;
+    InitializeListHead (&Dev->Queue);
+
+    Status = PciIo->Attributes (PciIo, EfiPciIoAttributeOperationGet, 0, &Dev->OriginalAttributes);
+    if (EFI_ERROR (Status)) {
+        goto FreeDevice;
+    }
+    Status = PciIo->Attributes (PciIo, EfiPciIoAttributeOperationEnable,
+                                EFI_PCI_DEVICE_ENABLE, NULL);
+    if (EFI_ERROR (Status)) {
+        goto FreeDevice;
+    }
+    if ((AhciRead32 (Dev, SATA_CAP) & SATA_CAP_S64A) != 0) {
+        Attributes = EFI_PCI_IO_ATTRIBUTE_DUAL_ADDRESS_CYCLE;
+        PciIo->Attributes (PciIo, EfiPciIoAttributeOperationEnable, Attributes, NULL);
+    }
+
+    Status = AhciAllocateDma (Dev);
+    if (EFI_ERROR (Status)) {
+        goto RestoreAttributes;
+    }
+
+    Status = AhciPortInit (Dev);
+    if (!EFI_ERROR (Status)) {
+        Status = AhciIdentify (Dev);
+    }
+    if (EFI_ERROR (Status)) {
+        /* Let the generic ATA/ATAPI stack have a go at the port */
+        DEBUG ((DEBUG_INFO, "AHCI: Not using NCQ on this port: %r\n", Status));
+        AhciPortStop (Dev);
+        Status = EFI_UNSUPPORTED;
+        goto FreeDma;
+    }
+
+    Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_NOTIFY,
+                               AhciPollEvent, Dev, &Dev->PollEvent);
+    if (EFI_ERROR (Status)) {
+        goto StopPort;
+    }
+    Status = gBS->CreateEventEx (EVT_NOTIFY_SIGNAL, TPL_NOTIFY, AhciExitBootServices,
+                                 Dev, &gEfiEventExitBootServicesGuid,
+                                 &Dev->ExitBootServicesEvent);
+    if (EFI_ERROR (Status)) {
+        goto ClosePollEvent;
+    }
+
+    Status = gBS->InstallMultipleProtocolInterfaces (&Controller,
+                                                     &gEfiCallerIdGuid, Dev,
+                                                     NULL);
+    if (EFI_ERROR (Status)) {
+        goto CloseExitBootServicesEvent;
+    }
+
+    Status = AhciNcqCreateChild (This, Dev);
+    if (EFI_ERROR (Status)) {
+        goto UninstallCallerId;
+    }
+
+    gBS->SetTimer (Dev->PollEvent, TimerPeriodic, AHCI_POLL_PERIOD);
+
+    return EFI_SUCCESS;
+
+UninstallCallerId:
+    gBS->UninstallMultipleProtocolInterfaces (Controller, &gEfiCallerIdGuid, Dev, NULL);
+CloseExitBootServicesEvent:
+    gBS->CloseEvent (Dev->ExitBootServicesEvent);
+ClosePollEvent:
+    gBS->CloseEvent (Dev->PollEvent);
+StopPort:
+    AhciPortStop (Dev);
+FreeDma:
+    AhciFreeDma (Dev);
+RestoreAttributes:
+    PciIo->Attributes (PciIo, EfiPciIoAttributeOperationSet, Dev->OriginalAttributes, NULL);
+FreeDevice:
+    FreePool (Dev);
+CloseProtocol:
+    gBS->CloseProtocol (Controller, &gEfiPciIoProtocolGuid, This->DriverBindingHandle, Controller);
+
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+AhciNcqDestroyChild (
+    IN  EFI_DRIVER_BINDING_PROTOCOL *This,
+    IN  EFI_HANDLE                  Controller,
+    IN  EFI_HANDLE                  Child
+    )
+{
+    EFI_BLOCK_IO_PROTOCOL *BlockIo;
+    AHCI_NCQ_DEVICE *Dev;
+    EFI_PCI_IO_PROTOCOL *PciIo;
+    EFI_STATUS Status;
+
+    Status = gBS->OpenProtocol (Child, &gEfiBlockIoProtocolGuid, (VOID **)&BlockIo,
+                                This->DriverBindingHandle, Controller,
+                                EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+    Dev = AHCI_NCQ_DEVICE_FROM_BLOCK_IO (BlockIo);
+
+    gBS->CloseProtocol (Controller, &gEfiPciIoProtocolGuid, This->DriverBindingHandle, Child);
+
+    Status = gBS->UninstallMultipleProtocolInterfaces (Child,
+                                                       &gEfiDevicePathProtocolGuid, Dev->DevicePath,
+                                                       &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                                                       &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                                                       &gEfiDiskInfoProtocolGuid, &Dev->DiskInfo,
+                                                       NULL);
+    if (EFI_ERROR (Status)) {
+        gBS->OpenProtocol (Controller, &gEfiPciIoProtocolGuid, (VOID **)&PciIo,
+                           This->DriverBindingHandle, Child,
+                           EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER);
+        return Status;
+    }
+
+    gBS->SetTimer (Dev->PollEvent, TimerCancel, 0);
+    AhciAbortAll (Dev, EFI_ABORTED);
+
+    FreePool (Dev->DevicePath);
+    Dev->DevicePath = NULL;
+    Dev->Handle = NULL;
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+AhciNcqDriverStop (
+    IN  EFI_DRIVER_BINDING_PROTOCOL *This,
+    IN  EFI_HANDLE                  Controller,
+    IN  UINTN                       NumberOfChildren,
+    IN  EFI_HANDLE                  *ChildHandleBuffer OPTIONAL
+    )
+{
+    AHCI_NCQ_DEVICE *Dev;
+    EFI_STATUS Status;
+    UINTN Index;
+
+    if (NumberOfChildren != 0) {
+        for (Index = 0; Index < NumberOfChildren; Index++) {
+            Status = AhciNcqDestroyChild (This, Controller, ChildHandleBuffer[Index]);
+            if (EFI_ERROR (Status)) {
+                return Status;
+            }
+        }
+        return EFI_SUCCESS;
+    }
+
+    Status = gBS->OpenProtocol (Controller, &gEfiCallerIdGuid, (VOID **)&Dev,
+                                This->DriverBindingHandle, Controller,
+                                EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    Status = gBS->UninstallMultipleProtocolInterfaces (Controller, &gEfiCallerIdGuid, Dev, NULL);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    gBS->CloseEvent (Dev->ExitBootServicesEvent);
+    gBS->CloseEvent (Dev->PollEvent);
+    AhciPortStop (Dev);
+    AhciFreeDma (Dev);
+    Dev->PciIo->Attributes (Dev->PciIo, EfiPciIoAttributeOperationSet,
+                            Dev->OriginalAttributes, NULL);
+    gBS->CloseProtocol (Controller, &gEfiPciIoProtocolGuid, This->DriverBindingHandle, Controller);
+    FreePool (Dev);
+
+    return EFI_SUCCESS;
+}
+
+/*
+ * Version above that of AtaAtapiPassThru, so that this driver gets the
+ * first chance at every AHCI controller.
+ */
+STATIC EFI_DRIVER_BINDING_PROTOCOL mAhciNcqDriverBinding = {
+    AhciNcqDriverSupported,
+    AhciNcqDriverStart,
+    AhciNcqDriverStop,
+    0x20,
+    NULL,
+    NULL
+};
+
+EFI_STATUS
+EFIAPI
+InitializeAhciNcq (
+    IN EFI_HANDLE            ImageHandle,
+    IN EFI_SYSTEM_TABLE      *SystemTable
+    )
+{
+    return EfiLibInstallDriverBinding (ImageHandle, SystemTable,
+                                       &mAhciNcqDriverBinding, ImageHandle);
+}
@@ -0,0 +1,235 @@
+/** @file
+ *
+ *  Native command queuing Block I/O driver for the RK356x AHCI controllers.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef AHCINCQDXE_H__
+#define AHCINCQDXE_H__
+
+#include <Uefi.h>
+
+#include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
+#include <Protocol/DevicePath.h>
+#include <Protocol/DiskInfo.h>
+#include <Protocol/DriverBinding.h>
+#include <Protocol/PciIo.h>
+
+#include <IndustryStandard/Atapi.h>
+#include <IndustryStandard/Rk356xSata.h>
+
+/* NonDiscoverablePciDeviceDxe presents the AHCI registers as BAR 5 (ABAR) */
+#define AHCI_BAR_INDEX              5
+
+#define AHCI_MAX_SLOTS              32
+
+/* Command header, one per slot in the command list */
+typedef struct {
+    UINT32  Flags;
+    UINT32  Prdbc;
+    UINT32  Ctba;
+    UINT32  Ctbau;
+    UINT32  Reserved[4];
+} AHCI_CMD_HEADER;
+
+#define AHCI_CMD_HEADER_CFL(n)      ((UINT32)(n) & 0x1F)
+#define AHCI_CMD_HEADER_W           BIT6
+#define AHCI_CMD_HEADER_PRDTL(n)    ((UINT32)(n) << 16)
+
+/* Physical region descriptor */
+typedef struct {
+    UINT32  Dba;
+    UINT32  Dbau;
+    UINT32  Reserved;
+    UINT32  Dbc;
+} AHCI_PRD;
+
+#define AHCI_PRD_MAX_LENGTH         SIZE_4MB
+
+/* Command table with a single PRD; every transfer is one mapped region */
+typedef struct {
+    UINT8       Cfis[64];
+    UINT8       Acmd[16];
+    UINT8       Reserved[48];
+    AHCI_PRD    Prd;
+} AHCI_CMD_TABLE;
+
+/* Host to device register FIS */
+#define AHCI_FIS_H2D                0x27
+#define AHCI_FIS_H2D_LENGTH         5
+#define AHCI_FIS_H2D_C              BIT7
+
+/* DMA area layout: command list, received FIS area, command tables, identify data */
+#define AHCI_CMD_LIST_OFFSET        0x0000
+#define AHCI_RFIS_OFFSET            0x0400
+#define AHCI_CMD_TABLE_OFFSET       0x0500
+#define AHCI_CMD_TABLE_SIZE         0x0100
+#define AHCI_IDENTIFY_OFFSET        (AHCI_CMD_TABLE_OFFSET + AHCI_MAX_SLOTS * AHCI_CMD_TABLE_SIZE)
+#define AHCI_DMA_SIZE               (AHCI_IDENTIFY_OFFSET + sizeof (ATA_IDENTIFY_DATA))
+
+#define AHCI_ATA_CMD_IDENTIFY               0xEC
+#define AHCI_ATA_CMD_FLUSH_CACHE_EXT        0xEA
+#define AHCI_ATA_CMD_READ_FPDMA_QUEUED      0x60
+#define AHCI_ATA_CMD_WRITE_FPDMA_QUEUED     0x61
+#define AHCI_ATA_DEVICE_LBA                 BIT6
+
+/* IDENTIFY DEVICE fields */
+#define AHCI_ID_SATA_CAP_NCQ        BIT8
+#define AHCI_ID_QUEUE_DEPTH_MASK    0x1F
+#define AHCI_ID_CMD_SET_LBA48       BIT10
+
+#define AHCI_LINK_TIMEOUT_US        1000000
+#define AHCI_SPINUP_TIMEOUT_US      10000000
+#define AHCI_STOP_TIMEOUT_US        500000
+#define AHCI_COMMAND_TIMEOUT_NS     30000000000ULL
+#define AHCI_POLL_PERIOD            EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+#define AHCI_REQUEST_SIGNATURE      SIGNATURE_32 ('A', 'N', 'C', 'R')
+
+typedef struct {
+    UINT32                  Signature;
+    LIST_ENTRY              Link;
+    EFI_BLOCK_IO2_TOKEN     *Token;     /* NULL for blocking callers */
+    BOOLEAN                 Write;
+    BOOLEAN                 Flush;
+    EFI_LBA                 Lba;        /* next block to issue */
+    UINT8                   *Buffer;    /* next byte to issue */
+    UINTN                   Remaining;  /* bytes not issued yet */
+    UINTN                   InFlight;   /* commands issued and not completed */
+    EFI_STATUS              Status;
+    BOOLEAN                 Done;
+} AHCI_REQUEST;
+
+typedef struct {
+    AHCI_REQUEST            *Request;
+    VOID                    *Mapping;
+    UINT64                  Deadline;
+} AHCI_SLOT;
+
+#define AHCI_NCQ_SIGNATURE          SIGNATURE_32 ('A', 'N', 'C', 'Q')
+
+typedef struct {
+    UINT32                      Signature;
+    EFI_HANDLE                  Controller;
+    EFI_HANDLE                  Handle;
+    EFI_PCI_IO_PROTOCOL         *PciIo;
+    UINT64                      OriginalAttributes;
+    EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
+
+    EFI_BLOCK_IO_PROTOCOL       BlockIo;
+    EFI_BLOCK_IO2_PROTOCOL      BlockIo2;
+    EFI_BLOCK_IO_MEDIA          Media;
+    EFI_DISK_INFO_PROTOCOL      DiskInfo;
+    ATA_IDENTIFY_DATA           IdentifyData;
+
+    UINT8                       *Dma;
+    EFI_PHYSICAL_ADDRESS        DmaAddress;
+    VOID                        *DmaMapping;
+
+    UINT32                      QueueDepth;
+    UINT32                      ActiveSlots;
+    BOOLEAN                     NonQueuedActive;
+    AHCI_SLOT                   Slots[AHCI_MAX_SLOTS];
+    LIST_ENTRY                  Queue;
+    EFI_EVENT                   PollEvent;
+    EFI_EVENT                   ExitBootServicesEvent;
+} AHCI_NCQ_DEVICE;
+
+#define AHCI_NCQ_DEVICE_FROM_BLOCK_IO(a) \
+    CR (a, AHCI_NCQ_DEVICE, BlockIo, AHCI_NCQ_SIGNATURE)
+#define AHCI_NCQ_DEVICE_FROM_BLOCK_IO2(a) \
+    CR (a, AHCI_NCQ_DEVICE, BlockIo2, AHCI_NCQ_SIGNATURE)
+#define AHCI_NCQ_DEVICE_FROM_DISK_INFO(a) \
+    CR (a, AHCI_NCQ_DEVICE, DiskInfo, AHCI_NCQ_SIGNATURE)
+
+/* AhciPort.c */
+UINT32
+AhciRead32 (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  UINT32          Offset
+    );
+
+VOID
+AhciWrite32 (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  UINT32          Offset,
+    IN  UINT32          Data
+    );
+
+VOID
+AhciBuildFis (
+    OUT UINT8           *Fis,
+    IN  UINT8           Command,
+    IN  UINT64          Lba,
+    IN  UINT16          Features,
+    IN  UINT16          Count,
+    IN  UINT8           Device
+    );
+
+EFI_STATUS
+AhciAllocateDma (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+VOID
+AhciFreeDma (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+EFI_STATUS
+AhciPortInit (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+EFI_STATUS
+AhciPortRestart (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+VOID
+AhciPortStop (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+EFI_STATUS
+AhciIdentify (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+/* AhciQueue.c */
+EFI_STATUS
+AhciSubmit (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  AHCI_REQUEST    *Request
+    );
+
+VOID
+EFIAPI
+AhciPollEvent (
+    IN  EFI_EVENT       Event,
+    IN  VOID            *Context
+    );
+
+VOID
+AhciAbortAll (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  EFI_STATUS      Status
+    );
+
+EFI_STATUS
+AhciReset (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+/* AhciBlockIo.c */
+VOID
+AhciBlockIoInit (
+    IN  AHCI_NCQ_DEVICE *Dev
+    );
+
+#endif /* AHCINCQDXE_H__ */
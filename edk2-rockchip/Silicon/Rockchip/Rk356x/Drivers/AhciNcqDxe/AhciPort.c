@@ -0,0 +1,388 @@
+/** @file
+ *
+ *  AHCI port bring-up and device identification.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/TimerLib.h>
+
+#include "AhciNcqDxe.h"
+
+UINT32
+AhciRead32 (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  UINT32          Offset
+    )
+{
+    UINT32 Data;
+
+    Dev->PciIo->Mem.Read (Dev->PciIo, EfiPciIoWidthUint32, AHCI_BAR_INDEX, Offset, 1, &Data);
+    return Data;
+}
+
+VOID
+AhciWrite32 (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  UINT32          Offset,
+    IN  UINT32          Data
+    )
+{
+    Dev->PciIo->Mem.Write (Dev->PciIo, EfiPciIoWidthUint32, AHCI_BAR_INDEX, Offset, 1, &Data);
+}
+
+STATIC
+BOOLEAN
+AhciWaitReg (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  UINT32          Offset,
+    IN  UINT32          Mask,
+    IN  UINT32          Value,
+    IN  UINTN           TimeoutUs
+    )
+{
+    UINTN Retry;
+
+    for (Retry = 0; Retry < TimeoutUs; Retry++) {
+        if ((AhciRead32 (Dev, Offset) & Mask) == Value) {
+            return TRUE;
+        }
+        MicroSecondDelay (1);
+    }
+
+    return FALSE;
+}
+
+VOID
+AhciBuildFis (
+    OUT UINT8           *Fis,
+    IN  UINT8           Command,
+    IN  UINT64          Lba,
+    IN  UINT16          Features,
+    IN  UINT16          Count,
+    IN  UINT8           Device
+    )
+{
+    ZeroMem (Fis, AHCI_FIS_H2D_LENGTH * sizeof (UINT32));
+    Fis[0] = AHCI_FIS_H2D;
+    Fis[1] = AHCI_FIS_H2D_C;
+    Fis[2] = Command;
+    Fis[3] = (UINT8)Features;
+    Fis[4] = (UINT8)Lba;
+    Fis[5] = (UINT8)RShiftU64 (Lba, 8);
+    Fis[6] = (UINT8)RShiftU64 (Lba, 16);
+    Fis[7] = Device;
+    Fis[8] = (UINT8)RShiftU64 (Lba, 24);
+    Fis[9] = (UINT8)RShiftU64 (Lba, 32);
+    Fis[10] = (UINT8)RShiftU64 (Lba, 40);
+    Fis[11] = (UINT8)(Features >> 8);
+    Fis[12] = (UINT8)Count;
+    Fis[13] = (UINT8)(Count >> 8);
+}
+
+EFI_STATUS
+AhciAllocateDma (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    EFI_PCI_IO_PROTOCOL *PciIo = Dev->PciIo;
+    AHCI_CMD_HEADER *CmdList;
+    EFI_PHYSICAL_ADDRESS Table;
+    UINTN Pages;
+    UINTN Bytes;
+    UINTN Slot;
+    EFI_STATUS Status;
+
+    /* Common buffers from a non-coherent PciIo are uncached, so no cache maintenance */
+    Pages = EFI_SIZE_TO_PAGES (AHCI_DMA_SIZE);
+    Status = PciIo->AllocateBuffer (PciIo, AllocateAnyPages, EfiBootServicesData,
+                                    Pages, (VOID **)&Dev->Dma, 0);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    Bytes = EFI_PAGES_TO_SIZE (Pages);
+    Status = PciIo->Map (PciIo, EfiPciIoOperationBusMasterCommonBuffer, Dev->Dma,
+                         &Bytes, &Dev->DmaAddress, &Dev->DmaMapping);
+    if (EFI_ERROR (Status) || Bytes < AHCI_DMA_SIZE) {
+        if (!EFI_ERROR (Status)) {
+            PciIo->Unmap (PciIo, Dev->DmaMapping);
+            Status = EFI_OUT_OF_RESOURCES;
+        }
+        PciIo->FreeBuffer (PciIo, Pages, Dev->Dma);
+        Dev->Dma = NULL;
+        return Status;
+    }
+
+    ZeroMem (Dev->Dma, EFI_PAGES_TO_SIZE (Pages));
+
+    CmdList = (AHCI_CMD_HEADER *)(Dev->Dma + AHCI_CMD_LIST_OFFSET);
+    for (Slot = 0; Slot < AHCI_MAX_SLOTS; Slot++) {
+        Table = Dev->DmaAddress + AHCI_CMD_TABLE_OFFSET + Slot * AHCI_CMD_TABLE_SIZE;
+        CmdList[Slot].Ctba = (UINT32)Table;
+        CmdList[Slot].Ctbau = (UINT32)RShiftU64 (Table, 32);
+    }
+
+    return EFI_SUCCESS;
+}
+
+VOID
+AhciFreeDma (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    if (Dev->Dma != NULL) {
+        Dev->PciIo->Unmap (Dev->PciIo, Dev->DmaMapping);
+        Dev->PciIo->FreeBuffer (Dev->PciIo, EFI_SIZE_TO_PAGES (AHCI_DMA_SIZE), Dev->Dma);
+        Dev->Dma = NULL;
+    }
+}
+
+VOID
+AhciPortStop (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    UINT32 Cmd;
+
+    /* Clearing ST also clears PxCI and PxSACT, dropping anything outstanding */
+    Cmd = AhciRead32 (Dev, SATA_CMD);
+    if ((Cmd & (SATA_CMD_ST | SATA_CMD_CR)) != 0) {
+        AhciWrite32 (Dev, SATA_CMD, Cmd & ~SATA_CMD_ST);
+        if (!AhciWaitReg (Dev, SATA_CMD, SATA_CMD_CR, 0, AHCI_STOP_TIMEOUT_US)) {
+            DEBUG ((DEBUG_WARN, "AHCI: Command list engine did not stop\n"));
+        }
+    }
+
+    Cmd = AhciRead32 (Dev, SATA_CMD);
+    if ((Cmd & (SATA_CMD_FRE | SATA_CMD_FR)) != 0) {
+        AhciWrite32 (Dev, SATA_CMD, Cmd & ~SATA_CMD_FRE);
+        if (!AhciWaitReg (Dev, SATA_CMD, SATA_CMD_FR, 0, AHCI_STOP_TIMEOUT_US)) {
+            DEBUG ((DEBUG_WARN, "AHCI: FIS receive engine did not stop\n"));
+        }
+    }
+}
+
+STATIC
+EFI_STATUS
+AhciPortStart (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    EFI_PHYSICAL_ADDRESS Addr;
+
+    Addr = Dev->DmaAddress + AHCI_CMD_LIST_OFFSET;
+    AhciWrite32 (Dev, SATA_CLB, (UINT32)Addr);
+    AhciWrite32 (Dev, SATA_CLBU, (UINT32)RShiftU64 (Addr, 32));
+    Addr = Dev->DmaAddress + AHCI_RFIS_OFFSET;
+    AhciWrite32 (Dev, SATA_FB, (UINT32)Addr);
+    AhciWrite32 (Dev, SATA_FBU, (UINT32)RShiftU64 (Addr, 32));
+
+    AhciWrite32 (Dev, SATA_SERR, MAX_UINT32);
+    AhciWrite32 (Dev, SATA_PIS, MAX_UINT32);
+
+    AhciWrite32 (Dev, SATA_CMD, AhciRead32 (Dev, SATA_CMD) | SATA_CMD_FRE);
+
+    /* Rotating media may take a while to report ready after spin-up */
+    if (!AhciWaitReg (Dev, SATA_TFD, SATA_TFD_BSY | SATA_TFD_DRQ, 0, AHCI_SPINUP_TIMEOUT_US)) {
+        DEBUG ((DEBUG_WARN, "AHCI: Device busy, TFD 0x%08X\n", AhciRead32 (Dev, SATA_TFD)));
+        return EFI_TIMEOUT;
+    }
+
+    AhciWrite32 (Dev, SATA_CMD, AhciRead32 (Dev, SATA_CMD) | SATA_CMD_ST);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+AhciPortComReset (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    UINT32 Sctl;
+
+    /* Keep the speed and power state limits that SataDxe programmed */
+    Sctl = AhciRead32 (Dev, SATA_SCTL) & ~SATA_SCTL_DET_MASK;
+    AhciWrite32 (Dev, SATA_SCTL, Sctl | SATA_SCTL_DET_COMRESET);
+    MicroSecondDelay (1000);
+    AhciWrite32 (Dev, SATA_SCTL, Sctl);
+
+    if (!AhciWaitReg (Dev, SATA_SSTS, SATA_SSTS_DET_MASK, SATA_SSTS_DET_PHY, AHCI_LINK_TIMEOUT_US)) {
+        return EFI_NOT_FOUND;
+    }
+
+    AhciWrite32 (Dev, SATA_SERR, MAX_UINT32);
+
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS
+AhciPortRestart (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    EFI_STATUS Status;
+
+    AhciPortStop (Dev);
+
+    Status = AhciPortComReset (Dev);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    return AhciPortStart (Dev);
+}
+
+EFI_STATUS
+AhciPortInit (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    EFI_STATUS Status;
+    UINT32 Sig;
+
+    AhciWrite32 (Dev, SATA_GHC, AhciRead32 (Dev, SATA_GHC) | SATA_GHC_AE);
+    /* Completions are polled */
+    AhciWrite32 (Dev, SATA_PIE, 0);
+
+    AhciPortStop (Dev);
+    AhciWrite32 (Dev, SATA_CMD, AhciRead32 (Dev, SATA_CMD) | SATA_CMD_SUD | SATA_CMD_POD);
+
+    Status = AhciPortRestart (Dev);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    Sig = AhciRead32 (Dev, SATA_SIG);
+    if (Sig != SATA_SIG_ATA) {
+        DEBUG ((DEBUG_INFO, "AHCI: Not an ATA device, signature 0x%08X\n", Sig));
+        AhciPortStop (Dev);
+        return EFI_UNSUPPORTED;
+    }
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+AhciExecPolled (
+    IN  AHCI_NCQ_DEVICE         *Dev,
+    IN  UINT8                   Command,
+    IN  EFI_PHYSICAL_ADDRESS    DataAddress,
+    IN  UINT32                  DataLength
+    )
+{
+    AHCI_CMD_HEADER *Header;
+    AHCI_CMD_TABLE *Table;
+    UINT32 Is;
+    UINTN Retry;
+
+    Header = (AHCI_CMD_HEADER *)(Dev->Dma + AHCI_CMD_LIST_OFFSET);
+    Table = (AHCI_CMD_TABLE *)(Dev->Dma + AHCI_CMD_TABLE_OFFSET);
+
+    ZeroMem (Table, sizeof (*Table));
+    AhciBuildFis (Table->Cfis, Command, 0, 0, 0, 0);
+    Header->Flags = AHCI_CMD_HEADER_CFL (AHCI_FIS_H2D_LENGTH);
+    if (DataLength != 0) {
+        Table->Prd.Dba = (UINT32)DataAddress;
+        Table->Prd.Dbau = (UINT32)RShiftU64 (DataAddress, 32);
+        Table->Prd.Dbc = DataLength - 1;
+        Header->Flags |= AHCI_CMD_HEADER_PRDTL (1);
+    }
+    Header->Prdbc = 0;
+
+    MemoryFence ();
+    AhciWrite32 (Dev, SATA_CI, BIT0);
+
+    for (Retry = 0; Retry < AHCI_SPINUP_TIMEOUT_US; Retry++) {
+        Is = AhciRead32 (Dev, SATA_PIS);
+        if ((Is & SATA_PIS_ERRORS) != 0 || (AhciRead32 (Dev, SATA_TFD) & SATA_TFD_ERR) != 0) {
+            DEBUG ((DEBUG_WARN, "AHCI: Command 0x%02X failed, IS 0x%08X TFD 0x%08X\n",
+                    Command, Is, AhciRead32 (Dev, SATA_TFD)));
+            return EFI_DEVICE_ERROR;
+        }
+        if ((AhciRead32 (Dev, SATA_CI) & BIT0) == 0) {
+            AhciWrite32 (Dev, SATA_PIS, Is);
+            return EFI_SUCCESS;
+        }
+        MicroSecondDelay (1);
+    }
+
+    return EFI_TIMEOUT;
+}
+
+EFI_STATUS
+AhciIdentify (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    ATA_IDENTIFY_DATA *Id = &Dev->IdentifyData;
+    EFI_BLOCK_IO_MEDIA *Media = &Dev->Media;
+    UINT32 Slots;
+    UINT32 DeviceDepth;
+    UINT16 Alignment;
+    EFI_STATUS Status;
+
+    Status = AhciExecPolled (Dev, AHCI_ATA_CMD_IDENTIFY,
+                             Dev->DmaAddress + AHCI_IDENTIFY_OFFSET,
+                             sizeof (ATA_IDENTIFY_DATA));
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+    CopyMem (Id, Dev->Dma + AHCI_IDENTIFY_OFFSET, sizeof (*Id));
+
+    /* Anything without NCQ is left to the generic ATA stack */
+    if ((AhciRead32 (Dev, SATA_CAP) & SATA_CAP_SNCQ) == 0 ||
+        (Id->serial_ata_capabilities & AHCI_ID_SATA_CAP_NCQ) == 0 ||
+        (Id->command_set_supported_83 & AHCI_ID_CMD_SET_LBA48) == 0) {
+        return EFI_UNSUPPORTED;
+    }
+
+    Slots = ((AhciRead32 (Dev, SATA_CAP) & SATA_CAP_NCS_MASK) >> SATA_CAP_NCS_SHIFT) + 1;
+    DeviceDepth = (Id->queue_depth & AHCI_ID_QUEUE_DEPTH_MASK) + 1;
+    Dev->QueueDepth = MIN (Slots, DeviceDepth);
+
+    Media->MediaId = 0;
+    Media->RemovableMedia = FALSE;
+    Media->MediaPresent = TRUE;
+    Media->LogicalPartition = FALSE;
+    Media->ReadOnly = FALSE;
+    Media->WriteCaching = FALSE;
+    /* PRD data base addresses must be word aligned */
+    Media->IoAlign = 2;
+    Media->BlockSize = 512;
+    Media->LogicalBlocksPerPhysicalBlock = 1;
+    Media->LowestAlignedLba = 0;
+
+    if ((Id->phy_logic_sector_support & (BIT15 | BIT14)) == BIT14) {
+        if ((Id->phy_logic_sector_support & BIT12) != 0) {
+            Media->BlockSize = (Id->logic_sector_size_lo | ((UINT32)Id->logic_sector_size_hi << 16)) * 2;
+        }
+        if ((Id->phy_logic_sector_support & BIT13) != 0) {
+            Media->LogicalBlocksPerPhysicalBlock = 1U << (Id->phy_logic_sector_support & 0xF);
+            Alignment = Id->alignment_logic_in_phy_blocks;
+            if ((Alignment & (BIT15 | BIT14)) == BIT14) {
+                Media->LowestAlignedLba = (Media->LogicalBlocksPerPhysicalBlock -
+                                           (Alignment & 0x3FFF)) %
+                                          Media->LogicalBlocksPerPhysicalBlock;
+            }
+        }
+    }
+
+    Media->LastBlock = (Id->maximum_lba_for_48bit_addressing[0] |
+                        LShiftU64 (Id->maximum_lba_for_48bit_addressing[1], 16) |
+                        LShiftU64 (Id->maximum_lba_for_48bit_addressing[2], 32) |
+                        LShiftU64 (Id->maximum_lba_for_48bit_addressing[3], 48)) - 1;
+
+    DEBUG ((DEBUG_INFO, "AHCI: %lu blocks of %u bytes, queue depth %u\n",
+            Media->LastBlock + 1, Media->BlockSize, Dev->QueueDepth));
+
+    return EFI_SUCCESS;
+}
@@ -0,0 +1,405 @@
+/** @file
+ *
+ *  Command queue. Requests are split into chunks of at most one PRD and
+ *  issued as FPDMA QUEUED commands, one per free command slot, so that the
+ *  device can reorder and overlap them. Completions are polled from a
+ *  periodic timer and from blocking callers; all queue state is only
+ *  touched at TPL_NOTIFY.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AhciNcqDxe.h"
+
+STATIC
+VOID
+AhciFinishRequest (
+    IN  AHCI_REQUEST    *Request
+    )
+{
+    if (Request->Token != NULL) {
+        Request->Token->TransactionStatus = Request->Status;
+        gBS->SignalEvent (Request->Token->Event);
+        FreePool (Request);
+    } else {
+        Request->Done = TRUE;
+    }
+}
+
+/* Called when the last outstanding command of a request has completed */
+STATIC
+VOID
+AhciRetireRequest (
+    IN  AHCI_REQUEST    *Request
+    )
+{
+    if (Request->InFlight == 0 &&
+        (Request->Remaining == 0 || EFI_ERROR (Request->Status)) &&
+        IsListEmpty (&Request->Link)) {
+        AhciFinishRequest (Request);
+    }
+}
+
+STATIC
+VOID
+AhciCompleteSlot (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  UINT32          Slot,
+    IN  EFI_STATUS      Status
+    )
+{
+    AHCI_SLOT *SlotInfo = &Dev->Slots[Slot];
+    AHCI_REQUEST *Request = SlotInfo->Request;
+
+    if (SlotInfo->Mapping != NULL) {
+        Dev->PciIo->Unmap (Dev->PciIo, SlotInfo->Mapping);
+        SlotInfo->Mapping = NULL;
+    }
+    SlotInfo->Request = NULL;
+    Dev->ActiveSlots &= ~(1U << Slot);
+
+    if (EFI_ERROR (Status) && !EFI_ERROR (Request->Status)) {
+        Request->Status = Status;
+    }
+    Request->InFlight--;
+    AhciRetireRequest (Request);
+}
+
+STATIC
+EFI_STATUS
+AhciIssueFlush (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  AHCI_REQUEST    *Request
+    )
+{
+    AHCI_CMD_HEADER *Header;
+    AHCI_CMD_TABLE *Table;
+
+    Header = (AHCI_CMD_HEADER *)(Dev->Dma + AHCI_CMD_LIST_OFFSET);
+    Table = (AHCI_CMD_TABLE *)(Dev->Dma + AHCI_CMD_TABLE_OFFSET);
+
+    AhciBuildFis (Table->Cfis, AHCI_ATA_CMD_FLUSH_CACHE_EXT, 0, 0, 0, AHCI_ATA_DEVICE_LBA);
+    Header->Flags = AHCI_CMD_HEADER_CFL (AHCI_FIS_H2D_LENGTH);
+    Header->Prdbc = 0;
+
+    Dev->Slots[0].Request = Request;
+    Dev->Slots[0].Mapping = NULL;
+    Dev->Slots[0].Deadline = GetTimeInNanoSecond (GetPerformanceCounter ()) + AHCI_COMMAND_TIMEOUT_NS;
+    Dev->ActiveSlots |= BIT0;
+    Dev->NonQueuedActive = TRUE;
+    Request->InFlight++;
+
+    MemoryFence ();
+    AhciWrite32 (Dev, SATA_CI, BIT0);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+AhciIssueChunk (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  AHCI_REQUEST    *Request,
+    IN  UINT32          Slot
+    )
+{
+    EFI_PCI_IO_PROTOCOL *PciIo = Dev->PciIo;
+    UINT32 BlockSize = Dev->Media.BlockSize;
+    AHCI_CMD_HEADER *Header;
+    AHCI_CMD_TABLE *Table;
+    EFI_PHYSICAL_ADDRESS DeviceAddress;
+    VOID *Mapping;
+    UINTN Length;
+    UINTN Mapped;
+    UINT32 Blocks;
+    EFI_STATUS Status;
+
+    /* The FPDMA sector count is 16 bits wide, 0 meaning 65536 */
+    Length = MIN (Request->Remaining, AHCI_PRD_MAX_LENGTH);
+    Length = MIN (Length, (UINTN)SIZE_64KB * BlockSize);
+    Mapped = Length;
+    Status = PciIo->Map (PciIo,
+                         Request->Write ? EfiPciIoOperationBusMasterRead : EfiPciIoOperationBusMasterWrite,
+                         Request->Buffer, &Mapped, &DeviceAddress, &Mapping);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+    if (Mapped < BlockSize) {
+        PciIo->Unmap (PciIo, Mapping);
+        return EFI_OUT_OF_RESOURCES;
+    }
+    /* Bounce buffering may give us less than we asked for */
+    Length = Mapped - (Mapped % BlockSize);
+    Blocks = (UINT32)(Length / BlockSize);
+
+    Header = (AHCI_CMD_HEADER *)(Dev->Dma + AHCI_CMD_LIST_OFFSET) + Slot;
+    Table = (AHCI_CMD_TABLE *)(Dev->Dma + AHCI_CMD_TABLE_OFFSET + Slot * AHCI_CMD_TABLE_SIZE);
+
+    AhciBuildFis (Table->Cfis,
+                  Request->Write ? AHCI_ATA_CMD_WRITE_FPDMA_QUEUED : AHCI_ATA_CMD_READ_FPDMA_QUEUED,
+                  Request->Lba, (UINT16)Blocks, (UINT16)(Slot << 3), AHCI_ATA_DEVICE_LBA);
+    Table->Prd.Dba = (UINT32)DeviceAddress;
+    Table->Prd.Dbau = (UINT32)RShiftU64 (DeviceAddress, 32);
+    Table->Prd.Dbc = (UINT32)Length - 1;
+
+    Header->Flags = AHCI_CMD_HEADER_CFL (AHCI_FIS_H2D_LENGTH) | AHCI_CMD_HEADER_PRDTL (1);
+    if (Request->Write) {
+        Header->Flags |= AHCI_CMD_HEADER_W;
+    }
+    Header->Prdbc = 0;
+
+    Dev->Slots[Slot].Request = Request;
+    Dev->Slots[Slot].Mapping = Mapping;
+    Dev->Slots[Slot].Deadline = GetTimeInNanoSecond (GetPerformanceCounter ()) + AHCI_COMMAND_TIMEOUT_NS;
+    Dev->ActiveSlots |= 1U << Slot;
+    Request->InFlight++;
+    Request->Lba += Blocks;
+    Request->Buffer += Length;
+    Request->Remaining -= Length;
+
+    /* SACT must be set before CI for queued commands */
+    MemoryFence ();
+    AhciWrite32 (Dev, SATA_SACT, 1U << Slot);
+    AhciWrite32 (Dev, SATA_CI, 1U << Slot);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+AhciDispatch (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    AHCI_REQUEST *Request;
+    UINT32 SlotMask;
+    UINT32 Free;
+    UINT32 Slot;
+    EFI_STATUS Status;
+
+    SlotMask = Dev->QueueDepth >= 32 ? MAX_UINT32 : (1U << Dev->QueueDepth) - 1;
+
+    while (!IsListEmpty (&Dev->Queue) && !Dev->NonQueuedActive) {
+        Request = BASE_CR (GetFirstNode (&Dev->Queue), AHCI_REQUEST, Link);
+
+        if (Request->Flush) {
+            /* Non-queued commands may only be issued to an idle queue */
+            if (Dev->ActiveSlots != 0) {
+                return;
+            }
+            RemoveEntryList (&Request->Link);
+            InitializeListHead (&Request->Link);
+            AhciIssueFlush (Dev, Request);
+            return;
+        }
+
+        /* A failed request issues nothing more once its commands drain */
+        if (EFI_ERROR (Request->Status)) {
+            Request->Remaining = 0;
+        } else {
+            Free = ~Dev->ActiveSlots & SlotMask;
+            if (Free == 0) {
+                return;
+            }
+            Slot = (UINT32)LowBitSet32 (Free);
+
+            Status = AhciIssueChunk (Dev, Request, Slot);
+            if (EFI_ERROR (Status)) {
+                if (Status == EFI_OUT_OF_RESOURCES && Dev->ActiveSlots != 0) {
+                    /* Bounce buffers exhausted, retry once something completes */
+                    return;
+                }
+                Request->Status = Status;
+                Request->Remaining = 0;
+            }
+        }
+
+        if (Request->Remaining == 0) {
+            RemoveEntryList (&Request->Link);
+            InitializeListHead (&Request->Link);
+            AhciRetireRequest (Request);
+        }
+    }
+}
+
+STATIC
+VOID
+AhciRecover (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  EFI_STATUS      Status
+    )
+{
+    UINT32 Slot;
+
+    DEBUG ((DEBUG_WARN, "AHCI: %r, IS 0x%08X TFD 0x%08X SERR 0x%08X SACT 0x%08X CI 0x%08X\n",
+            Status, AhciRead32 (Dev, SATA_PIS), AhciRead32 (Dev, SATA_TFD),
+            AhciRead32 (Dev, SATA_SERR), AhciRead32 (Dev, SATA_SACT), AhciRead32 (Dev, SATA_CI)));
+
+    /*
+     * Without READ LOG EXT the failing tag cannot be identified, so every
+     * outstanding command is failed. Stopping the port clears SACT and CI.
+     */
+    AhciPortStop (Dev);
+    for (Slot = 0; Slot < AHCI_MAX_SLOTS; Slot++) {
+        if ((Dev->ActiveSlots & (1U << Slot)) != 0) {
+            AhciCompleteSlot (Dev, Slot, Status);
+        }
+    }
+    Dev->NonQueuedActive = FALSE;
+
+    AhciWrite32 (Dev, SATA_SERR, MAX_UINT32);
+    AhciWrite32 (Dev, SATA_PIS, MAX_UINT32);
+
+    if (EFI_ERROR (AhciPortRestart (Dev))) {
+        DEBUG ((DEBUG_ERROR, "AHCI: Port restart failed\n"));
+    }
+}
+
+STATIC
+VOID
+AhciPoll (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    UINT32 Is;
+    UINT32 Done;
+    UINT32 Slot;
+    UINT64 Now;
+
+    if (Dev->ActiveSlots != 0) {
+        Is = AhciRead32 (Dev, SATA_PIS);
+        if ((Is & SATA_PIS_ERRORS) != 0 ||
+            (Dev->NonQueuedActive && (AhciRead32 (Dev, SATA_TFD) & SATA_TFD_ERR) != 0)) {
+            AhciRecover (Dev, EFI_DEVICE_ERROR);
+        } else {
+            AhciWrite32 (Dev, SATA_PIS, Is);
+
+            Done = Dev->ActiveSlots & ~(AhciRead32 (Dev, SATA_SACT) | AhciRead32 (Dev, SATA_CI));
+            while (Done != 0) {
+                Slot = (UINT32)LowBitSet32 (Done);
+                Done &= ~(1U << Slot);
+                Dev->NonQueuedActive = FALSE;
+                AhciCompleteSlot (Dev, Slot, EFI_SUCCESS);
+            }
+
+            if (Dev->ActiveSlots != 0) {
+                Now = GetTimeInNanoSecond (GetPerformanceCounter ());
+                for (Slot = 0; Slot < AHCI_MAX_SLOTS; Slot++) {
+                    if ((Dev->ActiveSlots & (1U << Slot)) != 0 && Now > Dev->Slots[Slot].Deadline) {
+                        AhciRecover (Dev, EFI_TIMEOUT);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    AhciDispatch (Dev);
+}
+
+VOID
+EFIAPI
+AhciPollEvent (
+    IN  EFI_EVENT       Event,
+    IN  VOID            *Context
+    )
+{
+    AhciPoll ((AHCI_NCQ_DEVICE *)Context);
+}
+
+EFI_STATUS
+AhciSubmit (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  AHCI_REQUEST    *Request
+    )
+{
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    Request->Signature = AHCI_REQUEST_SIGNATURE;
+    Request->Status = EFI_SUCCESS;
+    Request->InFlight = 0;
+    Request->Done = FALSE;
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+    InsertTailList (&Dev->Queue, &Request->Link);
+    AhciDispatch (Dev);
+
+    if (Request->Token != NULL) {
+        gBS->RestoreTPL (OldTpl);
+        return EFI_SUCCESS;
+    }
+
+    /* Blocking callers drive completion themselves rather than wait for the timer */
+    while (!Request->Done) {
+        MicroSecondDelay (1);
+        AhciPoll (Dev);
+    }
+    Status = Request->Status;
+
+    gBS->RestoreTPL (OldTpl);
+
+    return Status;
+}
+
+VOID
+AhciAbortAll (
+    IN  AHCI_NCQ_DEVICE *Dev,
+    IN  EFI_STATUS      Status
+    )
+{
+    AHCI_REQUEST *Request;
+    UINT32 Slot;
+    EFI_TPL OldTpl;
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+    AhciPortStop (Dev);
+    for (Slot = 0; Slot < AHCI_MAX_SLOTS; Slot++) {
+        if ((Dev->ActiveSlots & (1U << Slot)) != 0) {
+            AhciCompleteSlot (Dev, Slot, Status);
+        }
+    }
+    Dev->NonQueuedActive = FALSE;
+
+    while (!IsListEmpty (&Dev->Queue)) {
+        Request = BASE_CR (GetFirstNode (&Dev->Queue), AHCI_REQUEST, Link);
+        RemoveEntryList (&Request->Link);
+        InitializeListHead (&Request->Link);
+        Request->Status = Status;
+        Request->Remaining = 0;
+        AhciRetireRequest (Request);
+    }
+
+    gBS->RestoreTPL (OldTpl);
+}
+
+EFI_STATUS
+AhciReset (
+    IN  AHCI_NCQ_DEVICE *Dev
+    )
+{
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    AhciAbortAll (Dev, EFI_ABORTED);
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    AhciWrite32 (Dev, SATA_SERR, MAX_UINT32);
+    AhciWrite32 (Dev, SATA_PIS, MAX_UINT32);
+    Status = AhciPortRestart (Dev);
+    gBS->RestoreTPL (OldTpl);
+
+    return Status;
+}
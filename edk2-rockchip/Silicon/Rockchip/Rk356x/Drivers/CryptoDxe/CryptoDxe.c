@@ -0,0 +1,214 @@
+/** @file
+ *
+ *  RK356x crypto engine driver.
+ *
+ *  Every hash algorithm is checked against a known answer and against the
+ *  software implementation over a multi-part message before the engine is
+ *  trusted with it. Algorithms that fail are served by BaseCryptLib.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "CryptoDxe.h"
+
+#define CRYPTO_TEST_LENGTH      (SIZE_4KB + 77)
+#define CRYPTO_BENCH_LENGTH     SIZE_1MB
+
+STATIC CONST UINT8 mCryptoKatMessage[] = { 'a', 'b', 'c' };
+
+/* FIPS 180-2 appendix digests of "abc", in mCryptoHashAlgos order */
+STATIC CONST UINT8 mCryptoKatDigest[][SHA512_DIGEST_SIZE] = {
+    {
+        0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e, 0x25, 0x71,
+        0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d
+    },
+    {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde,
+        0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+        0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+    },
+    {
+        0xcb, 0x00, 0x75, 0x3f, 0x45, 0xa3, 0x5e, 0x8b, 0xb5, 0xa0, 0x3d, 0x69,
+        0x9a, 0xc6, 0x50, 0x07, 0x27, 0x2c, 0x32, 0xab, 0x0e, 0xde, 0xd1, 0x63,
+        0x1a, 0x8b, 0x60, 0x5a, 0x43, 0xff, 0x5b, 0xed, 0x80, 0x86, 0x07, 0x2b,
+        0xa1, 0xe7, 0xcc, 0x23, 0x58, 0xba, 0xec, 0xa1, 0x34, 0xc8, 0x25, 0xa7
+    },
+    {
+        0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49,
+        0xae, 0x20, 0x41, 0x31, 0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+        0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a, 0x21, 0x92, 0x99, 0x2a,
+        0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+        0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f,
+        0xa5, 0x4c, 0xa4, 0x9f
+    },
+};
+
+/* Odd split points so the residual handling and the bounce buffer get used */
+STATIC CONST UINTN mCryptoTestSplit[] = { 1, 63, 64, 200, 1, SIZE_2KB + 3 };
+
+STATIC
+EFI_STATUS
+CryptoHashMultiPart (
+    IN  EFI_HASH2_PROTOCOL      *Hash2,
+    IN  CRYPTO_HASH_ALGO        *Algo,
+    IN  CONST UINT8             *Message,
+    IN  UINTN                   MessageSize,
+    OUT UINT8                   *Digest
+    )
+{
+    EFI_STATUS Status;
+    UINTN Index;
+    UINTN Length;
+
+    Status = Hash2->HashInit (Hash2, Algo->Guid);
+    for (Index = 0; !EFI_ERROR (Status) && MessageSize > 0; Index++) {
+        if (Index < ARRAY_SIZE (mCryptoTestSplit)) {
+            Length = MIN (MessageSize, mCryptoTestSplit[Index]);
+        } else {
+            Length = MessageSize;
+        }
+        Status = Hash2->HashUpdate (Hash2, Message, Length);
+        Message += Length;
+        MessageSize -= Length;
+    }
+    if (!EFI_ERROR (Status)) {
+        Status = Hash2->HashFinal (Hash2, (EFI_HASH2_OUTPUT *)Digest);
+    }
+
+    return Status;
+}
+
+STATIC
+BOOLEAN
+CryptoSelfTest (
+    IN  EFI_HASH2_PROTOCOL      *Hash2,
+    IN  UINTN                   AlgoIndex,
+    IN  CONST UINT8             *Message
+    )
+{
+    CRYPTO_HASH_ALGO *Algo;
+    UINT8 Expected[SHA512_DIGEST_SIZE];
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    EFI_STATUS Status;
+
+    Algo = &mCryptoHashAlgos[AlgoIndex];
+
+    /* Provisionally route this algorithm to the engine */
+    Algo->HwUsable = TRUE;
+
+    Status = CryptoHashOneShot (Algo, TRUE, mCryptoKatMessage, sizeof (mCryptoKatMessage), Digest);
+    if (EFI_ERROR (Status) || !Algo->HwUsable ||
+        CompareMem (Digest, mCryptoKatDigest[AlgoIndex], Algo->DigestSize) != 0) {
+        DEBUG ((DEBUG_WARN, "CRYPTO: %a known answer test failed\n", Algo->Name));
+        Algo->HwUsable = FALSE;
+        return FALSE;
+    }
+
+    /* Unaligned start so the bounce buffer path is covered too */
+    Status = CryptoHashMultiPart (Hash2, Algo, Message + 1, CRYPTO_TEST_LENGTH - 1, Digest);
+    if (!EFI_ERROR (Status)) {
+        Status = CryptoHashOneShot (Algo, FALSE, Message + 1, CRYPTO_TEST_LENGTH - 1, Expected);
+    }
+    if (EFI_ERROR (Status) || CompareMem (Digest, Expected, Algo->DigestSize) != 0) {
+        DEBUG ((DEBUG_WARN, "CRYPTO: %a multi-part test failed: %r\n", Algo->Name, Status));
+        Algo->HwUsable = FALSE;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+STATIC
+UINT64
+CryptoBenchmark (
+    IN  CRYPTO_HASH_ALGO        *Algo,
+    IN  BOOLEAN                 UseHw,
+    IN  CONST UINT8             *Message
+    )
+{
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    UINT64 Start;
+    UINT64 Nanoseconds;
+
+    Start = GetPerformanceCounter ();
+    CryptoHashOneShot (Algo, UseHw, Message, CRYPTO_BENCH_LENGTH, Digest);
+    Nanoseconds = GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+
+    /* MB/s */
+    return Nanoseconds == 0 ? 0 : DivU64x64Remainder (CRYPTO_BENCH_LENGTH * 1000ULL, Nanoseconds, NULL);
+}
+
+EFI_STATUS
+EFIAPI
+InitializeCrypto (
+    IN EFI_HANDLE            ImageHandle,
+    IN EFI_SYSTEM_TABLE      *SystemTable
+    )
+{
+    EFI_HANDLE TestHandle;
+    EFI_HASH2_PROTOCOL *Hash2;
+    EFI_STATUS Status;
+    UINT8 *Message;
+    UINTN Index;
+
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    &ImageHandle,
+                    &gEfiHash2ServiceBindingProtocolGuid,
+                    &mCryptoHash2ServiceBinding,
+                    NULL
+                    );
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    Status = CryptoHwInit ();
+    if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_WARN, "CRYPTO: Engine unavailable (%r), hashing in software\n", Status));
+        return EFI_SUCCESS;
+    }
+
+    Message = AllocatePool (CRYPTO_BENCH_LENGTH);
+    if (Message == NULL) {
+        return EFI_SUCCESS;
+    }
+    for (Index = 0; Index < CRYPTO_BENCH_LENGTH; Index++) {
+        Message[Index] = (UINT8)(Index * 7 + 3);
+    }
+
+    TestHandle = NULL;
+    Status = mCryptoHash2ServiceBinding.CreateChild (&mCryptoHash2ServiceBinding, &TestHandle);
+    if (!EFI_ERROR (Status)) {
+        Status = gBS->HandleProtocol (TestHandle, &gEfiHash2ProtocolGuid, (VOID **)&Hash2);
+        ASSERT_EFI_ERROR (Status);
+
+        for (Index = 0; Index < mCryptoHashAlgoCount; Index++) {
+            if (!CryptoSelfTest (Hash2, Index, Message)) {
+                continue;
+            }
+
+            DEBUG_CODE_BEGIN ();
+            DEBUG ((DEBUG_INFO, "CRYPTO: %a engine %lu MB/s, software %lu MB/s\n",
+                    mCryptoHashAlgos[Index].Name,
+                    CryptoBenchmark (&mCryptoHashAlgos[Index], TRUE, Message),
+                    CryptoBenchmark (&mCryptoHashAlgos[Index], FALSE, Message)));
+            DEBUG_CODE_END ();
+        }
+
+        mCryptoHash2ServiceBinding.DestroyChild (&mCryptoHash2ServiceBinding, TestHandle);
+    }
+
+    FreePool (Message);
+
+    return EFI_SUCCESS;
+}
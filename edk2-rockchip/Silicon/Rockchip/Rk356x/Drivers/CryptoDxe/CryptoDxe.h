@@ -0,0 +1,162 @@
+/** @file
+ *
+ *  RK356x crypto engine (v2) definitions.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef CRYPTODXE_H__
+#define CRYPTODXE_H__
+
+#include <Uefi.h>
+
+#include <Protocol/Hash.h>
+#include <Protocol/Hash2.h>
+#include <Protocol/ServiceBinding.h>
+
+#include <IndustryStandard/Rk356x.h>
+
+/* Register writes that take a write-enable mask in the upper 16 bits */
+#define CRYPTO_HIWORD(Mask, Val)            (((UINT32)(Mask) << 16) | (Val))
+
+#define CRYPTO_CLK_CTL                      (CRYPTO_BASE + 0x0000)
+#define CRYPTO_RST_CTL                      (CRYPTO_BASE + 0x0004)
+#define  CRYPTO_RST_CTL_SW_CC_RESET         BIT0
+#define CRYPTO_DMA_INT_EN                   (CRYPTO_BASE + 0x0008)
+#define CRYPTO_DMA_INT_ST                   (CRYPTO_BASE + 0x000C)
+#define  CRYPTO_DMA_INT_LIST_DONE           BIT0
+#define  CRYPTO_DMA_INT_DST_ITEM_DONE       BIT1
+#define  CRYPTO_DMA_INT_SRC_ITEM_DONE       BIT2
+#define  CRYPTO_DMA_INT_DST_ERR             BIT3
+#define  CRYPTO_DMA_INT_SRC_ERR             BIT4
+#define  CRYPTO_DMA_INT_LIST_ERR            BIT5
+#define  CRYPTO_DMA_INT_ZERO_LEN            BIT6
+#define  CRYPTO_DMA_INT_ERRORS              (CRYPTO_DMA_INT_DST_ERR | CRYPTO_DMA_INT_SRC_ERR | \
+                                             CRYPTO_DMA_INT_LIST_ERR | CRYPTO_DMA_INT_ZERO_LEN)
+#define CRYPTO_DMA_CTL                      (CRYPTO_BASE + 0x0010)
+#define  CRYPTO_DMA_CTL_START               BIT0
+#define  CRYPTO_DMA_CTL_RESTART             BIT1
+#define CRYPTO_DMA_LLI_ADDR                 (CRYPTO_BASE + 0x0014)
+#define CRYPTO_HASH_CTL                     (CRYPTO_BASE + 0x0048)
+#define  CRYPTO_HASH_CTL_ENABLE             BIT0
+#define  CRYPTO_HASH_CTL_HW_PAD             BIT2
+#define  CRYPTO_HASH_CTL_ALGO_SHIFT         4
+#define  CRYPTO_HASH_CTL_ALGO_MASK          (0xFU << CRYPTO_HASH_CTL_ALGO_SHIFT)
+#define  CRYPTO_HASH_CTL_ALGO_SHA1          (0x0U << CRYPTO_HASH_CTL_ALGO_SHIFT)
+#define  CRYPTO_HASH_CTL_ALGO_SHA256        (0x2U << CRYPTO_HASH_CTL_ALGO_SHIFT)
+#define  CRYPTO_HASH_CTL_ALGO_SHA512        (0x8U << CRYPTO_HASH_CTL_ALGO_SHIFT)
+#define  CRYPTO_HASH_CTL_ALGO_SHA384        (0x9U << CRYPTO_HASH_CTL_ALGO_SHIFT)
+#define CRYPTO_HASH_DOUT(n)                 (CRYPTO_BASE + 0x03A0 + (n) * 4)
+#define CRYPTO_HASH_VALID                   (CRYPTO_BASE + 0x03E4)
+#define  CRYPTO_HASH_VALID_IS_VALID         BIT0
+
+/* DMA link list item, fetched by the engine from memory below 4 GiB */
+typedef struct {
+    UINT32  SrcAddr;
+    UINT32  SrcLen;
+    UINT32  DstAddr;
+    UINT32  DstLen;
+    UINT32  UserDefine;
+    UINT32  Reserved;
+    UINT32  DmaCtrl;
+    UINT32  NextAddr;
+} CRYPTO_LLI_DESC;
+
+#define CRYPTO_LLI_USER_CIPHER_START        BIT0
+#define CRYPTO_LLI_USER_STRING_START        BIT1
+#define CRYPTO_LLI_USER_STRING_LAST         BIT2
+#define CRYPTO_LLI_DMA_CTRL_LAST            BIT0
+#define CRYPTO_LLI_DMA_CTRL_PAUSE           BIT1
+#define CRYPTO_LLI_DMA_CTRL_SRC_DONE        BIT10
+
+/* Largest single DMA transfer, and the bounce buffer for unaligned or high data */
+#define CRYPTO_DMA_MAX_LENGTH               SIZE_1MB
+#define CRYPTO_BOUNCE_SIZE                  SIZE_64KB
+#define CRYPTO_TIMEOUT_US                   100000
+
+#define CRYPTO_MAX_BLOCK_SIZE               128
+
+typedef BOOLEAN (EFIAPI *CRYPTO_SW_INIT)(VOID *HashContext);
+typedef BOOLEAN (EFIAPI *CRYPTO_SW_UPDATE)(VOID *HashContext, CONST VOID *Data, UINTN DataSize);
+typedef BOOLEAN (EFIAPI *CRYPTO_SW_FINAL)(VOID *HashContext, UINT8 *HashValue);
+typedef UINTN   (EFIAPI *CRYPTO_SW_CONTEXT_SIZE)(VOID);
+
+typedef struct {
+    EFI_GUID                *Guid;
+    CONST CHAR8             *Name;
+    UINT32                  HwMode;
+    UINTN                   DigestSize;
+    UINTN                   BlockSize;
+    CRYPTO_SW_CONTEXT_SIZE  SwContextSize;
+    CRYPTO_SW_INIT          SwInit;
+    CRYPTO_SW_UPDATE        SwUpdate;
+    CRYPTO_SW_FINAL         SwFinal;
+    BOOLEAN                 HwUsable;
+} CRYPTO_HASH_ALGO;
+
+#define CRYPTO_HASH2_SIGNATURE              SIGNATURE_32 ('R', 'K', 'H', '2')
+
+typedef struct {
+    UINT32                  Signature;
+    EFI_HANDLE              Handle;
+    EFI_HASH2_PROTOCOL      Hash2;
+    LIST_ENTRY              Link;
+
+    /* Multi-part state between HashInit () and HashFinal () */
+    CRYPTO_HASH_ALGO        *Algo;
+    BOOLEAN                 UseHw;
+    VOID                    *SwContext;
+    UINT8                   Residual[CRYPTO_MAX_BLOCK_SIZE];
+    UINTN                   ResidualLength;
+} CRYPTO_HASH2_INSTANCE;
+
+#define CRYPTO_HASH2_INSTANCE_FROM_THIS(a) \
+    CR (a, CRYPTO_HASH2_INSTANCE, Hash2, CRYPTO_HASH2_SIGNATURE)
+
+/* CryptoHw.c */
+EFI_STATUS
+CryptoHwInit (
+    VOID
+    );
+
+EFI_STATUS
+CryptoHwHashStart (
+    IN  CONST CRYPTO_HASH_ALGO  *Algo
+    );
+
+EFI_STATUS
+CryptoHwHashUpdate (
+    IN  CONST UINT8             *Data,
+    IN  UINTN                   Length,
+    IN  BOOLEAN                 Last
+    );
+
+EFI_STATUS
+CryptoHwHashFinish (
+    IN  CONST CRYPTO_HASH_ALGO  *Algo,
+    OUT UINT8                   *Digest
+    );
+
+VOID
+CryptoHwHashAbort (
+    VOID
+    );
+
+/* CryptoHash2.c */
+extern CRYPTO_HASH_ALGO mCryptoHashAlgos[];
+extern CONST UINTN mCryptoHashAlgoCount;
+extern EFI_SERVICE_BINDING_PROTOCOL mCryptoHash2ServiceBinding;
+
+EFI_STATUS
+CryptoHashOneShot (
+    IN  CRYPTO_HASH_ALGO        *Algo,
+    IN  BOOLEAN                 UseHw,
+    IN  CONST UINT8             *Message,
+    IN  UINTN                   MessageSize,
+    OUT UINT8                   *Digest
+    );
+
+#endif /* CRYPTODXE_H__ */
@@ -0,0 +1,489 @@
+/** @file
+ *
+ *  EFI_HASH2_PROTOCOL and its service binding, backed by the RK356x crypto
+ *  engine with a BaseCryptLib fallback.
+ *
+ *  There is a single hash engine. It is claimed by a one-shot Hash () call
+ *  or by a HashInit () and held until the matching HashFinal (); anything
+ *  that finds it busy, or an algorithm that failed the self test, is hashed
+ *  in software instead.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "CryptoDxe.h"
+
+CRYPTO_HASH_ALGO mCryptoHashAlgos[] = {
+    {
+        &gEfiHashAlgorithmSha1Guid, "SHA-1", CRYPTO_HASH_CTL_ALGO_SHA1,
+        SHA1_DIGEST_SIZE, 64,
+        Sha1GetContextSize, Sha1Init, Sha1Update, Sha1Final, FALSE
+    },
+    {
+        &gEfiHashAlgorithmSha256Guid, "SHA-256", CRYPTO_HASH_CTL_ALGO_SHA256,
+        SHA256_DIGEST_SIZE, 64,
+        Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final, FALSE
+    },
+    {
+        &gEfiHashAlgorithmSha384Guid, "SHA-384", CRYPTO_HASH_CTL_ALGO_SHA384,
+        SHA384_DIGEST_SIZE, 128,
+        Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final, FALSE
+    },
+    {
+        &gEfiHashAlgorithmSha512Guid, "SHA-512", CRYPTO_HASH_CTL_ALGO_SHA512,
+        SHA512_DIGEST_SIZE, 128,
+        Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final, FALSE
+    },
+};
+CONST UINTN mCryptoHashAlgoCount = ARRAY_SIZE (mCryptoHashAlgos);
+
+STATIC LIST_ENTRY mCryptoHash2Instances = INITIALIZE_LIST_HEAD_VARIABLE (mCryptoHash2Instances);
+STATIC VOID *mHwOwner;
+
+STATIC
+CRYPTO_HASH_ALGO *
+CryptoFindAlgo (
+    IN  CONST EFI_GUID  *HashAlgorithm
+    )
+{
+    UINTN Index;
+
+    for (Index = 0; Index < mCryptoHashAlgoCount; Index++) {
+        if (CompareGuid (HashAlgorithm, mCryptoHashAlgos[Index].Guid)) {
+            return &mCryptoHashAlgos[Index];
+        }
+    }
+
+    return NULL;
+}
+
+STATIC
+BOOLEAN
+CryptoHwClaim (
+    IN  VOID    *Owner
+    )
+{
+    EFI_TPL OldTpl;
+    BOOLEAN Claimed;
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Claimed = (mHwOwner == NULL);
+    if (Claimed) {
+        mHwOwner = Owner;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    return Claimed;
+}
+
+STATIC
+VOID
+CryptoHwRelease (
+    IN  VOID    *Owner
+    )
+{
+    ASSERT (mHwOwner == Owner);
+    mHwOwner = NULL;
+}
+
+STATIC
+EFI_STATUS
+CryptoSwHashAll (
+    IN  CRYPTO_HASH_ALGO        *Algo,
+    IN  CONST UINT8             *Message,
+    IN  UINTN                   MessageSize,
+    OUT UINT8                   *Digest
+    )
+{
+    VOID *Context;
+    BOOLEAN Ok;
+
+    Context = AllocatePool (Algo->SwContextSize ());
+    if (Context == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+
+    Ok = Algo->SwInit (Context) &&
+         Algo->SwUpdate (Context, Message, MessageSize) &&
+         Algo->SwFinal (Context, Digest);
+
+    FreePool (Context);
+
+    return Ok ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+EFI_STATUS
+CryptoHashOneShot (
+    IN  CRYPTO_HASH_ALGO        *Algo,
+    IN  BOOLEAN                 UseHw,
+    IN  CONST UINT8             *Message,
+    IN  UINTN                   MessageSize,
+    OUT UINT8                   *Digest
+    )
+{
+    EFI_STATUS Status;
+
+    /* The engine needs at least one byte to mark the end of the string */
+    if (UseHw && Algo->HwUsable && MessageSize > 0 && CryptoHwClaim (Algo)) {
+        CryptoHwHashStart (Algo);
+        Status = CryptoHwHashUpdate (Message, MessageSize, TRUE);
+        if (!EFI_ERROR (Status)) {
+            Status = CryptoHwHashFinish (Algo, Digest);
+        } else {
+            CryptoHwHashAbort ();
+        }
+        CryptoHwRelease (Algo);
+
+        if (!EFI_ERROR (Status)) {
+            return EFI_SUCCESS;
+        }
+
+        /* Still have the whole message, so nothing is lost by retrying */
+        DEBUG ((DEBUG_WARN, "CRYPTO: %a engine failed (%r), using software\n", Algo->Name, Status));
+        Algo->HwUsable = FALSE;
+    }
+
+    return CryptoSwHashAll (Algo, Message, MessageSize, Digest);
+}
+
+STATIC
+VOID
+CryptoHash2Reset (
+    IN  CRYPTO_HASH2_INSTANCE   *Instance
+    )
+{
+    if (Instance->UseHw) {
+        CryptoHwHashAbort ();
+        CryptoHwRelease (Instance);
+    }
+    if (Instance->SwContext != NULL) {
+        FreePool (Instance->SwContext);
+    }
+    Instance->Algo = NULL;
+    Instance->UseHw = FALSE;
+    Instance->SwContext = NULL;
+    Instance->ResidualLength = 0;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+CryptoHash2GetHashSize (
+    IN  CONST EFI_HASH2_PROTOCOL    *This,
+    IN  CONST EFI_GUID              *HashAlgorithm,
+    OUT UINTN                       *HashSize
+    )
+{
+    CRYPTO_HASH_ALGO *Algo;
+
+    if (HashAlgorithm == NULL || HashSize == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Algo = CryptoFindAlgo (HashAlgorithm);
+    if (Algo == NULL) {
+        return EFI_UNSUPPORTED;
+    }
+
+    *HashSize = Algo->DigestSize;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+CryptoHash2Hash (
+    IN  CONST EFI_HASH2_PROTOCOL    *This,
+    IN  CONST EFI_GUID              *HashAlgorithm,
+    IN  CONST UINT8                 *Message,
+    IN  UINTN                       MessageSize,
+    IN  OUT EFI_HASH2_OUTPUT        *Hash
+    )
+{
+    CRYPTO_HASH_ALGO *Algo;
+
+    if (HashAlgorithm == NULL || Hash == NULL || (Message == NULL && MessageSize != 0)) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Algo = CryptoFindAlgo (HashAlgorithm);
+    if (Algo == NULL) {
+        return EFI_UNSUPPORTED;
+    }
+
+    return CryptoHashOneShot (Algo, TRUE, Message, MessageSize, (UINT8 *)Hash);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+CryptoHash2HashInit (
+    IN  CONST EFI_HASH2_PROTOCOL    *This,
+    IN  CONST EFI_GUID              *HashAlgorithm
+    )
+{
+    CRYPTO_HASH2_INSTANCE *Instance;
+    CRYPTO_HASH_ALGO *Algo;
+
+    if (HashAlgorithm == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Algo = CryptoFindAlgo (HashAlgorithm);
+    if (Algo == NULL) {
+        return EFI_UNSUPPORTED;
+    }
+
+    Instance = CRYPTO_HASH2_INSTANCE_FROM_THIS (This);
+    if (Instance->Algo != NULL) {
+        return EFI_ALREADY_STARTED;
+    }
+
+    if (Algo->HwUsable && CryptoHwClaim (Instance)) {
+        CryptoHwHashStart (Algo);
+        Instance->UseHw = TRUE;
+    } else {
+        Instance->SwContext = AllocatePool (Algo->SwContextSize ());
+        if (Instance->SwContext == NULL) {
+            return EFI_OUT_OF_RESOURCES;
+        }
+        if (!Algo->SwInit (Instance->SwContext)) {
+            FreePool (Instance->SwContext);
+            Instance->SwContext = NULL;
+            return EFI_DEVICE_ERROR;
+        }
+    }
+
+    Instance->Algo = Algo;
+    Instance->ResidualLength = 0;
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+CryptoHash2HashUpdate (
+    IN  CONST EFI_HASH2_PROTOCOL    *This,
+    IN  CONST UINT8                 *Message,
+    IN  UINTN                       MessageSize
+    )
+{
+    CRYPTO_HASH2_INSTANCE *Instance;
+    UINTN BlockSize;
+    UINTN Fill;
+    UINTN Length;
+    EFI_STATUS Status;
+
+    if (Message == NULL && MessageSize != 0) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Instance = CRYPTO_HASH2_INSTANCE_FROM_THIS (This);
+    if (Instance->Algo == NULL) {
+        return EFI_NOT_READY;
+    }
+
+    if (!Instance->UseHw) {
+        if (!Instance->Algo->SwUpdate (Instance->SwContext, Message, MessageSize)) {
+            return EFI_DEVICE_ERROR;
+        }
+        return EFI_SUCCESS;
+    }
+
+    /*
+     * Only whole blocks can be fed to the engine before the end of the
+     * string, and the final transfer must not be empty, so always hold
+     * back between one byte and one block for HashFinal ().
+     */
+    BlockSize = Instance->Algo->BlockSize;
+    if (Instance->ResidualLength + MessageSize <= BlockSize) {
+        CopyMem (&Instance->Residual[Instance->ResidualLength], Message, MessageSize);
+        Instance->ResidualLength += MessageSize;
+        return EFI_SUCCESS;
+    }
+
+    if (Instance->ResidualLength > 0) {
+        Fill = BlockSize - Instance->ResidualLength;
+        CopyMem (&Instance->Residual[Instance->ResidualLength], Message, Fill);
+        Message += Fill;
+        MessageSize -= Fill;
+        Status = CryptoHwHashUpdate (Instance->Residual, BlockSize, FALSE);
+        if (EFI_ERROR (Status)) {
+            goto Fail;
+        }
+    }
+
+    Length = ((MessageSize - 1) / BlockSize) * BlockSize;
+    if (Length > 0) {
+        Status = CryptoHwHashUpdate (Message, Length, FALSE);
+        if (EFI_ERROR (Status)) {
+            goto Fail;
+        }
+    }
+
+    Instance->ResidualLength = MessageSize - Length;
+    CopyMem (Instance->Residual, Message + Length, Instance->ResidualLength);
+
+    return EFI_SUCCESS;
+
+Fail:
+    /*
+     * Data already consumed by the engine cannot be replayed in software,
+     * but later callers can be kept off the engine, as in CryptoHashOneShot ().
+     */
+    DEBUG ((DEBUG_ERROR, "CRYPTO: %a update failed: %r\n", Instance->Algo->Name, Status));
+    Instance->Algo->HwUsable = FALSE;
+    CryptoHash2Reset (Instance);
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+CryptoHash2HashFinal (
+    IN  CONST EFI_HASH2_PROTOCOL    *This,
+    IN  OUT EFI_HASH2_OUTPUT        *Hash
+    )
+{
+    CRYPTO_HASH2_INSTANCE *Instance;
+    CRYPTO_HASH_ALGO *Algo;
+    EFI_STATUS Status;
+
+    if (Hash == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Instance = CRYPTO_HASH2_INSTANCE_FROM_THIS (This);
+    Algo = Instance->Algo;
+    if (Algo == NULL) {
+        return EFI_NOT_READY;
+    }
+
+    if (!Instance->UseHw) {
+        Status = Algo->SwFinal (Instance->SwContext, (UINT8 *)Hash) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+    } else if (Instance->ResidualLength == 0) {
+        /* Nothing was ever fed to the engine; hash the empty message in software */
+        Status = CryptoSwHashAll (Algo, NULL, 0, (UINT8 *)Hash);
+    } else {
+        Status = CryptoHwHashUpdate (Instance->Residual, Instance->ResidualLength, TRUE);
+        if (!EFI_ERROR (Status)) {
+            Status = CryptoHwHashFinish (Algo, (UINT8 *)Hash);
+            CryptoHwRelease (Instance);
+            Instance->UseHw = FALSE;
+        }
+        if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_ERROR, "CRYPTO: %a final failed: %r\n", Algo->Name, Status));
+            Algo->HwUsable = FALSE;
+        }
+    }
+
+    CryptoHash2Reset (Instance);
+
+    return Status;
+}
+
+STATIC CONST EFI_HASH2_PROTOCOL mCryptoHash2ProtocolTemplate = {
+    CryptoHash2GetHashSize,
+    CryptoHash2Hash,
+    CryptoHash2HashInit,
+    CryptoHash2HashUpdate,
+    CryptoHash2HashFinal
+};
+
+STATIC
+EFI_STATUS
+EFIAPI
+CryptoHash2CreateChild (
+    IN      EFI_SERVICE_BINDING_PROTOCOL    *This,
+    IN OUT  EFI_HANDLE                      *ChildHandle
+    )
+{
+    CRYPTO_HASH2_INSTANCE *Instance;
+    EFI_STATUS Status;
+
+    if (ChildHandle == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Instance = AllocateZeroPool (sizeof (CRYPTO_HASH2_INSTANCE));
+    if (Instance == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    Instance->Signature = CRYPTO_HASH2_SIGNATURE;
+    CopyMem (&Instance->Hash2, &mCryptoHash2ProtocolTemplate, sizeof (Instance->Hash2));
+
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    ChildHandle,
+                    &gEfiHash2ProtocolGuid,
+                    &Instance->Hash2,
+                    NULL
+                    );
+    if (EFI_ERROR (Status)) {
+        FreePool (Instance);
+        return Status;
+    }
+
+    Instance->Handle = *ChildHandle;
+    InsertTailList (&mCryptoHash2Instances, &Instance->Link);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+CryptoHash2DestroyChild (
+    IN  EFI_SERVICE_BINDING_PROTOCOL    *This,
+    IN  EFI_HANDLE                      ChildHandle
+    )
+{
+    CRYPTO_HASH2_INSTANCE *Instance;
+    LIST_ENTRY *Entry;
+    EFI_STATUS Status;
+
+    if (ChildHandle == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    for (Entry = GetFirstNode (&mCryptoHash2Instances);
+         !IsNull (&mCryptoHash2Instances, Entry);
+         Entry = GetNextNode (&mCryptoHash2Instances, Entry)) {
+        Instance = BASE_CR (Entry, CRYPTO_HASH2_INSTANCE, Link);
+        if (Instance->Handle != ChildHandle) {
+            continue;
+        }
+
+        Status = gBS->UninstallMultipleProtocolInterfaces (
+                        ChildHandle,
+                        &gEfiHash2ProtocolGuid,
+                        &Instance->Hash2,
+                        NULL
+                        );
+        if (EFI_ERROR (Status)) {
+            return Status;
+        }
+
+        CryptoHash2Reset (Instance);
+        RemoveEntryList (&Instance->Link);
+        FreePool (Instance);
+        return EFI_SUCCESS;
+    }
+
+    return EFI_UNSUPPORTED;
+}
+
+EFI_SERVICE_BINDING_PROTOCOL mCryptoHash2ServiceBinding = {
+    CryptoHash2CreateChild,
+    CryptoHash2DestroyChild
+};
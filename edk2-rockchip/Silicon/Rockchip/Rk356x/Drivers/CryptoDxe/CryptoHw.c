@@ -0,0 +1,227 @@
+/** @file
+ *
+ *  RK356x crypto engine (v2) hash DMA support.
+ *
+ *  The engine hashes a message as a sequence of DMA transfers. The first
+ *  transfer is marked as the string start and the last one as the string
+ *  end, and the engine applies the padding itself. Between transfers the
+ *  list is paused on a single self-linked descriptor that is rewritten and
+ *  restarted for every chunk.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/IoLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "CryptoDxe.h"
+
+STATIC CRYPTO_LLI_DESC *mLli;
+STATIC UINT8 *mBounce;
+STATIC BOOLEAN mStarted;
+
+STATIC
+EFI_STATUS
+CryptoHwRunDma (
+    IN  EFI_PHYSICAL_ADDRESS    Addr,
+    IN  UINTN                   Length,
+    IN  BOOLEAN                 Last
+    )
+{
+    UINT32 DmaCtl;
+    UINT32 Status;
+    UINTN Retry;
+
+    ASSERT (Addr + Length <= SIZE_4GB);
+    ASSERT (Length > 0 && Length <= CRYPTO_DMA_MAX_LENGTH);
+
+    ZeroMem (mLli, sizeof (*mLli));
+    mLli->SrcAddr = (UINT32)Addr;
+    mLli->SrcLen = (UINT32)Length;
+    mLli->DmaCtrl = CRYPTO_LLI_DMA_CTRL_SRC_DONE;
+    if (Last) {
+        mLli->UserDefine |= CRYPTO_LLI_USER_STRING_LAST;
+        mLli->DmaCtrl |= CRYPTO_LLI_DMA_CTRL_LAST;
+    } else {
+        /* Pause on this descriptor so the next chunk can be restarted into it */
+        mLli->NextAddr = (UINT32)(UINTN)mLli;
+        mLli->DmaCtrl |= CRYPTO_LLI_DMA_CTRL_PAUSE;
+    }
+    if (!mStarted) {
+        mLli->UserDefine |= CRYPTO_LLI_USER_STRING_START | CRYPTO_LLI_USER_CIPHER_START;
+        MmioWrite32 (CRYPTO_DMA_LLI_ADDR, (UINT32)(UINTN)mLli);
+        DmaCtl = CRYPTO_DMA_CTL_START;
+        mStarted = TRUE;
+    } else {
+        DmaCtl = CRYPTO_DMA_CTL_RESTART;
+    }
+    WriteBackDataCacheRange (mLli, sizeof (*mLli));
+
+    MmioWrite32 (CRYPTO_DMA_CTL, CRYPTO_HIWORD (DmaCtl, DmaCtl));
+
+    for (Retry = 0; Retry < CRYPTO_TIMEOUT_US; Retry++) {
+        Status = MmioRead32 (CRYPTO_DMA_INT_ST);
+        if ((Status & (CRYPTO_DMA_INT_SRC_ITEM_DONE | CRYPTO_DMA_INT_ERRORS)) != 0) {
+            break;
+        }
+        MicroSecondDelay (1);
+    }
+    MmioWrite32 (CRYPTO_DMA_INT_ST, Status);
+
+    if (Retry == CRYPTO_TIMEOUT_US) {
+        DEBUG ((DEBUG_ERROR, "CRYPTO: DMA timeout, status 0x%08X\n", Status));
+        return EFI_TIMEOUT;
+    }
+    if ((Status & CRYPTO_DMA_INT_ERRORS) != 0) {
+        DEBUG ((DEBUG_ERROR, "CRYPTO: DMA error, status 0x%08X\n", Status));
+        return EFI_DEVICE_ERROR;
+    }
+
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS
+CryptoHwHashStart (
+    IN  CONST CRYPTO_HASH_ALGO  *Algo
+    )
+{
+    UINT32 Mask;
+
+    mStarted = FALSE;
+
+    MmioWrite32 (CRYPTO_DMA_INT_EN, CRYPTO_HIWORD (0xFFFF, 0));
+    MmioWrite32 (CRYPTO_DMA_INT_ST, MmioRead32 (CRYPTO_DMA_INT_ST));
+
+    Mask = CRYPTO_HASH_CTL_ENABLE | CRYPTO_HASH_CTL_HW_PAD | CRYPTO_HASH_CTL_ALGO_MASK;
+    MmioWrite32 (CRYPTO_HASH_CTL,
+                 CRYPTO_HIWORD (Mask, CRYPTO_HASH_CTL_ENABLE | CRYPTO_HASH_CTL_HW_PAD | Algo->HwMode));
+
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS
+CryptoHwHashUpdate (
+    IN  CONST UINT8             *Data,
+    IN  UINTN                   Length,
+    IN  BOOLEAN                 Last
+    )
+{
+    EFI_PHYSICAL_ADDRESS Addr;
+    EFI_STATUS Status;
+    UINTN Chunk;
+
+    while (Length > 0) {
+        Addr = (EFI_PHYSICAL_ADDRESS)(UINTN)Data;
+        if ((Addr & 0x7) == 0 && Addr + Length <= SIZE_4GB) {
+            /* Hash in place: the engine only reads, so a clean is enough */
+            Chunk = MIN (Length, CRYPTO_DMA_MAX_LENGTH);
+            WriteBackDataCacheRange ((VOID *)Data, Chunk);
+        } else {
+            Chunk = MIN (Length, CRYPTO_BOUNCE_SIZE);
+            CopyMem (mBounce, Data, Chunk);
+            WriteBackDataCacheRange (mBounce, Chunk);
+            Addr = (EFI_PHYSICAL_ADDRESS)(UINTN)mBounce;
+        }
+
+        Status = CryptoHwRunDma (Addr, Chunk, Last && Chunk == Length);
+        if (EFI_ERROR (Status)) {
+            return Status;
+        }
+
+        Data += Chunk;
+        Length -= Chunk;
+    }
+
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS
+CryptoHwHashFinish (
+    IN  CONST CRYPTO_HASH_ALGO  *Algo,
+    OUT UINT8                   *Digest
+    )
+{
+    EFI_STATUS Status;
+    UINT32 Word;
+    UINTN Retry;
+    UINTN Index;
+
+    Status = EFI_TIMEOUT;
+    for (Retry = 0; Retry < CRYPTO_TIMEOUT_US; Retry++) {
+        if ((MmioRead32 (CRYPTO_HASH_VALID) & CRYPTO_HASH_VALID_IS_VALID) != 0) {
+            Status = EFI_SUCCESS;
+            break;
+        }
+        MicroSecondDelay (1);
+    }
+
+    if (!EFI_ERROR (Status)) {
+        /* The digest registers hold the result as big endian words */
+        for (Index = 0; Index < Algo->DigestSize / 4; Index++) {
+            Word = SwapBytes32 (MmioRead32 (CRYPTO_HASH_DOUT (Index)));
+            CopyMem (&Digest[Index * 4], &Word, sizeof (Word));
+        }
+        MmioWrite32 (CRYPTO_HASH_VALID, CRYPTO_HASH_VALID_IS_VALID);
+    } else {
+        DEBUG ((DEBUG_ERROR, "CRYPTO: Timeout waiting for digest\n"));
+    }
+
+    CryptoHwHashAbort ();
+
+    return Status;
+}
+
+VOID
+CryptoHwHashAbort (
+    VOID
+    )
+{
+    MmioWrite32 (CRYPTO_HASH_CTL, CRYPTO_HIWORD (0xFFFF, 0));
+    MmioWrite32 (CRYPTO_DMA_INT_ST, MmioRead32 (CRYPTO_DMA_INT_ST));
+    mStarted = FALSE;
+}
+
+EFI_STATUS
+CryptoHwInit (
+    VOID
+    )
+{
+    EFI_PHYSICAL_ADDRESS Addr;
+    EFI_STATUS Status;
+    UINTN Retry;
+
+    /* Descriptor in the first page, bounce buffer after it, all below 4 GiB */
+    Addr = SIZE_4GB - 1;
+    Status = gBS->AllocatePages (AllocateMaxAddress, EfiBootServicesData,
+                                 EFI_SIZE_TO_PAGES (EFI_PAGE_SIZE + CRYPTO_BOUNCE_SIZE),
+                                 &Addr);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+    mLli = (CRYPTO_LLI_DESC *)(UINTN)Addr;
+    mBounce = (UINT8 *)(UINTN)(Addr + EFI_PAGE_SIZE);
+
+    MmioWrite32 (CRYPTO_RST_CTL, CRYPTO_HIWORD (CRYPTO_RST_CTL_SW_CC_RESET, CRYPTO_RST_CTL_SW_CC_RESET));
+    for (Retry = 0; Retry < 1000; Retry++) {
+        if ((MmioRead32 (CRYPTO_RST_CTL) & CRYPTO_RST_CTL_SW_CC_RESET) == 0) {
+            break;
+        }
+        MicroSecondDelay (1);
+    }
+    if (Retry == 1000) {
+        gBS->FreePages (Addr, EFI_SIZE_TO_PAGES (EFI_PAGE_SIZE + CRYPTO_BOUNCE_SIZE));
+        return EFI_DEVICE_ERROR;
+    }
+
+    CryptoHwHashAbort ();
+
+    return EFI_SUCCESS;
+}
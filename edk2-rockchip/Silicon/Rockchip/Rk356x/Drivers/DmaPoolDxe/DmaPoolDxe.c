@@ -0,0 +1,345 @@
+/** @file
+ *
+ *  Uncached DMA pool for the non-coherent RK356x bus masters.
+ *
+ *  A single region below 4 GiB is remapped Normal Non-cacheable at load
+ *  time. Each page of it is either free, carved into blocks of one size
+ *  class and tracked with a bitmap, or part of a run of whole pages.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DxeServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <Protocol/Rk356xDmaPool.h>
+
+#define DMA_POOL_MIN_SHIFT      5
+#define DMA_POOL_MAX_SHIFT      11
+#define DMA_POOL_MAP_WORDS      ((EFI_PAGE_SIZE >> DMA_POOL_MIN_SHIFT) / 32)
+
+/* DMA_POOL_PAGE.Class values other than a size class shift */
+#define DMA_POOL_PAGE_FREE      0x00
+#define DMA_POOL_PAGE_RUN       0xFE
+#define DMA_POOL_PAGE_RUN_TAIL  0xFF
+
+typedef struct {
+    UINT8   Class;
+    UINT16  Used;                       /* blocks in use, size class pages */
+    UINT32  Pages;                      /* run length, first page of a run */
+    UINT32  Map[DMA_POOL_MAP_WORDS];    /* allocated blocks, size class pages */
+} DMA_POOL_PAGE;
+
+STATIC UINT8 *mPoolBase;
+STATIC UINTN mPoolPages;
+STATIC DMA_POOL_PAGE *mPoolPage;
+
+STATIC
+EFI_STATUS
+DmaPoolMapUncached (
+    IN  EFI_PHYSICAL_ADDRESS    Base,
+    IN  UINTN                   Length
+    )
+{
+    EFI_GCD_MEMORY_SPACE_DESCRIPTOR Desc;
+    EFI_STATUS Status;
+
+    Status = gDS->GetMemorySpaceDescriptor (Base, &Desc);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    if ((Desc.Capabilities & EFI_MEMORY_WC) == 0) {
+        Status = gDS->SetMemorySpaceCapabilities (Base, Length,
+                                                  Desc.Capabilities | EFI_MEMORY_WC);
+        if (EFI_ERROR (Status)) {
+            return Status;
+        }
+    }
+
+    /* EFI_MEMORY_WC is Normal Non-cacheable on AArch64 */
+    Status = gDS->SetMemorySpaceAttributes (Base, Length,
+                                            (Desc.Attributes & ~EFI_MEMORY_CACHETYPE_MASK) |
+                                            EFI_MEMORY_WC);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    /* Drop any lines allocated while the region was still cacheable */
+    InvalidateDataCacheRange ((VOID *)(UINTN)Base, Length);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+UINTN
+DmaPoolClassShift (
+    IN  UINTN   Size
+    )
+{
+    UINTN Shift;
+
+    for (Shift = DMA_POOL_MIN_SHIFT; Shift <= DMA_POOL_MAX_SHIFT; Shift++) {
+        if (Size <= (1U << Shift)) {
+            return Shift;
+        }
+    }
+
+    return 0;
+}
+
+STATIC
+VOID *
+DmaPoolAllocateBlock (
+    IN  UINTN   Shift
+    )
+{
+    DMA_POOL_PAGE *Page;
+    UINTN Blocks = EFI_PAGE_SIZE >> Shift;
+    UINTN Index;
+    UINTN Word;
+    UINTN Bit;
+    UINT32 Free;
+
+    /* Prefer a partly used page of this class over a fresh one */
+    Page = NULL;
+    for (Index = 0; Index < mPoolPages; Index++) {
+        if (mPoolPage[Index].Class == Shift && mPoolPage[Index].Used < Blocks) {
+            Page = &mPoolPage[Index];
+            break;
+        }
+    }
+    if (Page == NULL) {
+        for (Index = 0; Index < mPoolPages; Index++) {
+            if (mPoolPage[Index].Class == DMA_POOL_PAGE_FREE) {
+                Page = &mPoolPage[Index];
+                ZeroMem (Page, sizeof (*Page));
+                Page->Class = (UINT8)Shift;
+                break;
+            }
+        }
+    }
+    if (Page == NULL) {
+        return NULL;
+    }
+
+    for (Word = 0; Word * 32 < Blocks; Word++) {
+        Free = ~Page->Map[Word];
+        if (Blocks - Word * 32 < 32) {
+            Free &= (1U << (Blocks - Word * 32)) - 1;
+        }
+        if (Free != 0) {
+            Bit = Word * 32 + (UINTN)LowBitSet32 (Free);
+            Page->Map[Word] |= 1U << (Bit % 32);
+            Page->Used++;
+            return mPoolBase + Index * EFI_PAGE_SIZE + (Bit << Shift);
+        }
+    }
+
+    ASSERT (FALSE);
+    return NULL;
+}
+
+STATIC
+VOID *
+DmaPoolAllocatePages (
+    IN  UINTN   Pages,
+    IN  UINTN   Alignment
+    )
+{
+    UINTN Step;
+    UINTN Start;
+    UINTN Index;
+
+    Step = 1;
+    Start = 0;
+    if (Alignment > EFI_PAGE_SIZE) {
+        Step = Alignment / EFI_PAGE_SIZE;
+        Start = (ALIGN_VALUE ((UINTN)mPoolBase, Alignment) - (UINTN)mPoolBase) / EFI_PAGE_SIZE;
+    }
+    for (; Start + Pages <= mPoolPages; Start += Step) {
+        for (Index = Start; Index < Start + Pages; Index++) {
+            if (mPoolPage[Index].Class != DMA_POOL_PAGE_FREE) {
+                break;
+            }
+        }
+        if (Index == Start + Pages) {
+            for (Index = Start; Index < Start + Pages; Index++) {
+                ZeroMem (&mPoolPage[Index], sizeof (mPoolPage[Index]));
+                mPoolPage[Index].Class = DMA_POOL_PAGE_RUN_TAIL;
+            }
+            mPoolPage[Start].Class = DMA_POOL_PAGE_RUN;
+            mPoolPage[Start].Pages = (UINT32)Pages;
+            return mPoolBase + Start * EFI_PAGE_SIZE;
+        }
+    }
+
+    return NULL;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+DmaPoolAllocate (
+    IN  RK356X_DMA_POOL_PROTOCOL    *This,
+    IN  UINTN                       Size,
+    IN  UINTN                       Alignment,
+    OUT VOID                        **HostAddress,
+    OUT EFI_PHYSICAL_ADDRESS        *DeviceAddress
+    )
+{
+    EFI_TPL OldTpl;
+    UINTN Shift;
+    VOID *Block;
+
+    if (Size == 0 || (Alignment & (Alignment - 1)) != 0 ||
+        HostAddress == NULL || DeviceAddress == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    /* Blocks are aligned to their size, so alignment is just a bigger block */
+    Shift = DmaPoolClassShift (MAX (Size, Alignment));
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (Shift != 0) {
+        Block = DmaPoolAllocateBlock (Shift);
+    } else {
+        Block = DmaPoolAllocatePages (EFI_SIZE_TO_PAGES (Size), Alignment);
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    if (Block == NULL) {
+        DEBUG ((DEBUG_WARN, "DmaPool: Out of memory for %lu bytes\n", (UINT64)Size));
+        return EFI_OUT_OF_RESOURCES;
+    }
+
+    ZeroMem (Block, Shift != 0 ? (1U << Shift) : EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (Size)));
+
+    /* Bus masters see DRAM at its physical address */
+    *HostAddress = Block;
+    *DeviceAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)Block;
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+DmaPoolFree (
+    IN  RK356X_DMA_POOL_PROTOCOL    *This,
+    IN  VOID                        *HostAddress,
+    IN  UINTN                       Size,
+    IN  UINTN                       Alignment
+    )
+{
+    DMA_POOL_PAGE *Page;
+    EFI_TPL OldTpl;
+    UINTN Offset;
+    UINTN Shift;
+    UINTN Bit;
+    UINTN Pages;
+    UINTN Index;
+    EFI_STATUS Status;
+
+    if ((UINT8 *)HostAddress < mPoolBase ||
+        (UINT8 *)HostAddress >= mPoolBase + EFI_PAGES_TO_SIZE (mPoolPages) ||
+        Size == 0) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Offset = (UINT8 *)HostAddress - mPoolBase;
+    Page = &mPoolPage[Offset / EFI_PAGE_SIZE];
+    Shift = DmaPoolClassShift (MAX (Size, Alignment));
+    Status = EFI_INVALID_PARAMETER;
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (Shift != 0) {
+        Bit = (Offset % EFI_PAGE_SIZE) >> Shift;
+        if (Page->Class == Shift && (Offset & ((1U << Shift) - 1)) == 0 &&
+            (Page->Map[Bit / 32] & (1U << (Bit % 32))) != 0) {
+            Page->Map[Bit / 32] &= ~(1U << (Bit % 32));
+            if (--Page->Used == 0) {
+                Page->Class = DMA_POOL_PAGE_FREE;
+            }
+            Status = EFI_SUCCESS;
+        }
+    } else {
+        Pages = EFI_SIZE_TO_PAGES (Size);
+        if (Page->Class == DMA_POOL_PAGE_RUN && Page->Pages == Pages &&
+            (Offset % EFI_PAGE_SIZE) == 0) {
+            for (Index = 0; Index < Pages; Index++) {
+                Page[Index].Class = DMA_POOL_PAGE_FREE;
+            }
+            Status = EFI_SUCCESS;
+        }
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    ASSERT_EFI_ERROR (Status);
+    return Status;
+}
+
+STATIC RK356X_DMA_POOL_PROTOCOL mDmaPool = {
+    DmaPoolAllocate,
+    DmaPoolFree
+};
+
+EFI_STATUS
+EFIAPI
+InitializeDmaPool (
+    IN EFI_HANDLE            ImageHandle,
+    IN EFI_SYSTEM_TABLE      *SystemTable
+    )
+{
+    EFI_PHYSICAL_ADDRESS Base;
+    EFI_STATUS Status;
+
+    mPoolPages = EFI_SIZE_TO_PAGES (FixedPcdGet32 (PcdDmaPoolSize));
+    mPoolPage = AllocateZeroPool (mPoolPages * sizeof (*mPoolPage));
+    if (mPoolPage == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+
+    /* Several of the bus masters only drive 32 address bits */
+    Base = BASE_4GB - 1;
+    Status = gBS->AllocatePages (AllocateMaxAddress, EfiBootServicesData,
+                                 mPoolPages, &Base);
+    if (EFI_ERROR (Status)) {
+        goto FreePageInfo;
+    }
+
+    Status = DmaPoolMapUncached (Base, EFI_PAGES_TO_SIZE (mPoolPages));
+    if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "DmaPool: Failed to remap pool: %r\n", Status));
+        goto FreePages;
+    }
+    mPoolBase = (UINT8 *)(UINTN)Base;
+
+    Status = gBS->InstallMultipleProtocolInterfaces (&ImageHandle,
+                                                     &gRk356xDmaPoolProtocolGuid, &mDmaPool,
+                                                     NULL);
+    if (EFI_ERROR (Status)) {
+        goto FreePages;
+    }
+
+    DEBUG ((DEBUG_INFO, "DmaPool: %u KiB uncached at 0x%lx\n",
+            (UINT32)(EFI_PAGES_TO_SIZE (mPoolPages) / SIZE_1KB), Base));
+
+    return EFI_SUCCESS;
+
+FreePages:
+    gBS->FreePages (Base, mPoolPages);
+FreePageInfo:
+    FreePool (mPoolPage);
+    mPoolPage = NULL;
+
+    return Status;
+}
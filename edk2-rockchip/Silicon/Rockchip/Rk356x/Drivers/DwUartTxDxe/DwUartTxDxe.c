@@ -0,0 +1,90 @@
+/** @file
+ *
+ *  Drains the console UART transmit ring from the UART interrupt, so that
+ *  SerialPortWrite () returns without waiting for the line.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+#include <Library/DebugLib.h>
+#include <Library/DwUartSerialPortLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xUart.h>
+#include <Protocol/HardwareInterrupt.h>
+
+STATIC EFI_HARDWARE_INTERRUPT_PROTOCOL  *mInterrupt;
+STATIC HARDWARE_INTERRUPT_SOURCE        mUartIrq;
+STATIC EFI_EVENT                        mExitBootServicesEvent;
+
+STATIC
+VOID
+EFIAPI
+DwUartTxInterruptHandler (
+    IN HARDWARE_INTERRUPT_SOURCE    Source,
+    IN EFI_SYSTEM_CONTEXT           SystemContext
+    )
+{
+    DwUartTxRingInterrupt ();
+    mInterrupt->EndOfInterrupt (mInterrupt, Source);
+}
+
+STATIC
+VOID
+EFIAPI
+DwUartTxExitBootServices (
+    IN EFI_EVENT    Event,
+    IN VOID         *Context
+    )
+{
+    /* The OS gets a quiet UART with an empty FIFO */
+    DwUartTxRingStop ();
+    mInterrupt->DisableInterruptSource (mInterrupt, mUartIrq);
+}
+
+EFI_STATUS
+EFIAPI
+DwUartTxDxeInitialize (
+    IN EFI_HANDLE        ImageHandle,
+    IN EFI_SYSTEM_TABLE  *SystemTable
+    )
+{
+    EFI_STATUS Status;
+
+    mUartIrq = UART_IRQ (UART_INDEX (FixedPcdGet64 (PcdSerialRegisterBase)));
+
+    Status = gBS->LocateProtocol (&gHardwareInterruptProtocolGuid, NULL, (VOID **)&mInterrupt);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    Status = mInterrupt->RegisterInterruptSource (mInterrupt, mUartIrq, DwUartTxInterruptHandler);
+    if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "DwUartTxDxe: Failed to register interrupt %u: %r\n", mUartIrq, Status));
+        return Status;
+    }
+
+    Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_NOTIFY,
+                               DwUartTxExitBootServices, NULL, &mExitBootServicesEvent);
+    if (EFI_ERROR (Status)) {
+        mInterrupt->RegisterInterruptSource (mInterrupt, mUartIrq, NULL);
+        return Status;
+    }
+
+    Status = DwUartTxRingStart ();
+    if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "DwUartTxDxe: Failed to start TX ring: %r\n", Status));
+        gBS->CloseEvent (mExitBootServicesEvent);
+        mInterrupt->RegisterInterruptSource (mInterrupt, mUartIrq, NULL);
+        return Status;
+    }
+
+    DEBUG ((DEBUG_INFO, "DwUartTxDxe: Console output buffered, drained from interrupt %u\n", mUartIrq));
+
+    return EFI_SUCCESS;
+}
@@ -0,0 +1,196 @@
+/** @file
+ *
+ *  Synopsys DesignWare Ethernet Quality-of-Service (GMAC) driver for RK356x.
+ *
+ *  Board init code sets up pins, clocks, RGMII delays and the PHY, and
+ *  programs the station address. This driver takes it from there and
+ *  exposes each enabled GMAC as a Simple Network Protocol instance.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <IndustryStandard/Rk356x.h>
+
+#include "EqosDxe.h"
+
+#pragma pack (1)
+typedef struct {
+    MEMMAP_DEVICE_PATH          MemMap;
+    MAC_ADDR_DEVICE_PATH        MacAddr;
+    EFI_DEVICE_PATH_PROTOCOL    End;
+} EQOS_DEVICE_PATH;
+#pragma pack ()
+
+STATIC CONST EQOS_DEVICE_PATH mEqosDevicePathTemplate = {
+    {
+        { HARDWARE_DEVICE_PATH, HW_MEMMAP_DP,
+          { (UINT8)sizeof (MEMMAP_DEVICE_PATH), (UINT8)(sizeof (MEMMAP_DEVICE_PATH) >> 8) } },
+        EfiMemoryMappedIO,
+        0,
+        0
+    },
+    {
+        { MESSAGING_DEVICE_PATH, MSG_MAC_ADDR_DP,
+          { (UINT8)sizeof (MAC_ADDR_DEVICE_PATH), (UINT8)(sizeof (MAC_ADDR_DEVICE_PATH) >> 8) } },
+        { { 0 } },
+        EQOS_IFTYPE_ETHERNET
+    },
+    {
+        END_DEVICE_PATH_TYPE, END_ENTIRE_DEVICE_PATH_SUBTYPE,
+        { sizeof (EFI_DEVICE_PATH_PROTOCOL), 0 }
+    }
+};
+
+STATIC
+VOID
+EFIAPI
+EqosExitBootServicesCallback (
+    IN EFI_EVENT    Event,
+    IN VOID         *Context
+    )
+{
+    EQOS_PRIVATE_DATA *Private = Context;
+
+    /* The OS must not find the DMA engine writing into memory it now owns */
+    if (Private->Mode.State == EfiSimpleNetworkInitialized) {
+        EqosStopHardware (Private);
+    }
+}
+
+STATIC
+EFI_STATUS
+EqosRegisterController (
+    IN  UINT32                  Index,
+    IN  EFI_PHYSICAL_ADDRESS    Base
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EQOS_DEVICE_PATH *DevicePath;
+    EFI_STATUS Status;
+
+    Private = AllocateZeroPool (sizeof (EQOS_PRIVATE_DATA));
+    if (Private == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    Private->Signature = EQOS_SIGNATURE;
+    Private->Base = Base;
+    Private->Index = Index;
+
+    EqosSnpInit (Private);
+
+    if (IsZeroBuffer (&Private->Mode.PermanentAddress, EQOS_ETHER_ADDR_LEN)) {
+        DEBUG ((DEBUG_WARN, "GMAC%u: No station address programmed, skipping\n", Index));
+        Status = EFI_NOT_READY;
+        goto Fail;
+    }
+
+    DevicePath = AllocateCopyPool (sizeof (mEqosDevicePathTemplate), &mEqosDevicePathTemplate);
+    if (DevicePath == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto Fail;
+    }
+    DevicePath->MemMap.StartingAddress = Base;
+    DevicePath->MemMap.EndingAddress = Base + SIZE_64KB - 1;
+    CopyMem (&DevicePath->MacAddr.MacAddress, &Private->Mode.PermanentAddress,
+             EQOS_ETHER_ADDR_LEN);
+    Private->DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)DevicePath;
+
+    DEBUG ((DEBUG_INFO, "GMAC%u: Registering controller at 0x%08lX, version 0x%02X, "
+            "MAC %02X:%02X:%02X:%02X:%02X:%02X\n",
+            Index, Base,
+            MmioRead32 (Base + GMAC_MAC_VERSION) & GMAC_MAC_VERSION_SNPSVER_MASK,
+            Private->Mode.PermanentAddress.Addr[0], Private->Mode.PermanentAddress.Addr[1],
+            Private->Mode.PermanentAddress.Addr[2], Private->Mode.PermanentAddress.Addr[3],
+            Private->Mode.PermanentAddress.Addr[4], Private->Mode.PermanentAddress.Addr[5]));
+
+    Status = gBS->CreateEventEx (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    EqosExitBootServicesCallback,
+                    Private,
+                    &gEfiEventExitBootServicesGuid,
+                    &Private->ExitBootServicesEvent
+                    );
+    if (EFI_ERROR (Status)) {
+        FreePool (DevicePath);
+        goto Fail;
+    }
+
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    &Private->Handle,
+                    &gEfiSimpleNetworkProtocolGuid,
+                    &Private->Snp,
+                    &gEfiDevicePathProtocolGuid,
+                    Private->DevicePath,
+                    NULL
+                    );
+    if (EFI_ERROR (Status)) {
+        gBS->CloseEvent (Private->ExitBootServicesEvent);
+        FreePool (DevicePath);
+        goto Fail;
+    }
+
+    return EFI_SUCCESS;
+
+Fail:
+    gBS->CloseEvent (Private->Snp.WaitForPacket);
+    FreePool (Private);
+    return Status;
+}
+
+VOID
+EFIAPI
+EqosEndOfDxeCallback (
+    IN EFI_EVENT  Event,
+    IN VOID       *Context
+    )
+{
+    EFI_STATUS Status;
+
+    if (FixedPcdGet8 (PcdMac0Status) != 0x0) {
+        Status = EqosRegisterController (0, GMAC0_BASE);
+        if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_ERROR, "GMAC0: Failed to register: %r\n", Status));
+        }
+    }
+    if (FixedPcdGet8 (PcdMac1Status) != 0x0) {
+        Status = EqosRegisterController (1, GMAC1_BASE);
+        if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_ERROR, "GMAC1: Failed to register: %r\n", Status));
+        }
+    }
+
+    gBS->CloseEvent (Event);
+}
+
+EFI_STATUS
+EFIAPI
+InitializeEqos (
+    IN EFI_HANDLE            ImageHandle,
+    IN EFI_SYSTEM_TABLE      *SystemTable
+    )
+{
+    EFI_EVENT EndOfDxeEvent;
+
+    /* Board init programs the station address, wait until it has run */
+    return gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  EqosEndOfDxeCallback,
+                  NULL,
+                  &gEfiEndOfDxeEventGroupGuid,
+                  &EndOfDxeEvent
+                  );
+}
@@ -0,0 +1,303 @@
+/** @file
+ *
+ *  Synopsys DesignWare Ethernet Quality-of-Service (GMAC) driver for RK356x.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef EQOSDXE_H__
+#define EQOSDXE_H__
+
+#include <Uefi.h>
+
+#include <Protocol/DevicePath.h>
+#include <Protocol/Rk356xDmaPool.h>
+#include <Protocol/SimpleNetwork.h>
+
+/* MAC registers */
+#define GMAC_MAC_CONFIGURATION                  0x0000
+#define  GMAC_MAC_CONFIGURATION_IPC             BIT27
+#define  GMAC_MAC_CONFIGURATION_CST             BIT21
+#define  GMAC_MAC_CONFIGURATION_ACS             BIT20
+#define  GMAC_MAC_CONFIGURATION_BE              BIT18
+#define  GMAC_MAC_CONFIGURATION_PS              BIT15
+#define  GMAC_MAC_CONFIGURATION_FES             BIT14
+#define  GMAC_MAC_CONFIGURATION_DM              BIT13
+#define  GMAC_MAC_CONFIGURATION_TE              BIT1
+#define  GMAC_MAC_CONFIGURATION_RE              BIT0
+#define GMAC_MAC_PACKET_FILTER                  0x0008
+#define  GMAC_MAC_PACKET_FILTER_DBF             BIT5
+#define  GMAC_MAC_PACKET_FILTER_PM              BIT4
+#define  GMAC_MAC_PACKET_FILTER_HMC             BIT2
+#define  GMAC_MAC_PACKET_FILTER_PR              BIT0
+#define GMAC_MAC_HASH_TABLE_REG0                0x0010
+#define GMAC_MAC_HASH_TABLE_REG1                0x0014
+#define GMAC_RXQ_CTRL0                          0x00A0
+#define  GMAC_RXQ_CTRL0_EN_MASK                 0x3U
+#define  GMAC_RXQ_CTRL0_EN_DCB                  0x2U
+#define GMAC_MAC_INTERRUPT_ENABLE               0x00B4
+#define GMAC_MAC_VERSION                        0x0110
+#define  GMAC_MAC_VERSION_SNPSVER_MASK          0xFFU
+#define GMAC_MAC_HW_FEATURE1                    0x0120
+#define  GMAC_MAC_HW_FEATURE1_TXFIFOSIZE_SHIFT  6
+#define  GMAC_MAC_HW_FEATURE1_TXFIFOSIZE_MASK   (0x1FU << GMAC_MAC_HW_FEATURE1_TXFIFOSIZE_SHIFT)
+#define  GMAC_MAC_HW_FEATURE1_RXFIFOSIZE_MASK   0x1FU
+#define GMAC_MAC_MDIO_ADDRESS                   0x0200
+#define  GMAC_MAC_MDIO_ADDRESS_PA_SHIFT         21
+#define  GMAC_MAC_MDIO_ADDRESS_RDA_SHIFT        16
+#define  GMAC_MAC_MDIO_ADDRESS_CR_SHIFT         8
+#define  GMAC_MAC_MDIO_ADDRESS_CR_100_150       (1U << GMAC_MAC_MDIO_ADDRESS_CR_SHIFT)
+#define  GMAC_MAC_MDIO_ADDRESS_GOC_SHIFT        2
+#define  GMAC_MAC_MDIO_ADDRESS_GOC_READ         (3U << GMAC_MAC_MDIO_ADDRESS_GOC_SHIFT)
+#define  GMAC_MAC_MDIO_ADDRESS_GOC_WRITE        (1U << GMAC_MAC_MDIO_ADDRESS_GOC_SHIFT)
+#define  GMAC_MAC_MDIO_ADDRESS_GB               BIT0
+#define GMAC_MAC_MDIO_DATA                      0x0204
+#define GMAC_MAC_ADDRESS0_HIGH                  0x0300
+#define GMAC_MAC_ADDRESS0_LOW                   0x0304
+#define GMAC_MMC_CONTROL                        0x0700
+#define  GMAC_MMC_CONTROL_CNTRST                BIT0
+#define GMAC_MMC_RX_INTERRUPT_MASK              0x070C
+#define GMAC_MMC_TX_INTERRUPT_MASK              0x0710
+#define GMAC_MMC_IPC_RX_INTERRUPT_MASK          0x0800
+
+/* MTL registers */
+#define GMAC_MTL_TXQ0_OPERATION_MODE            0x0D00
+#define  GMAC_MTL_TXQ0_OPERATION_MODE_TQS_SHIFT 16
+#define  GMAC_MTL_TXQ0_OPERATION_MODE_TQS_MASK  (0x1FFU << GMAC_MTL_TXQ0_OPERATION_MODE_TQS_SHIFT)
+#define  GMAC_MTL_TXQ0_OPERATION_MODE_TXQEN     (2U << 2)
+#define  GMAC_MTL_TXQ0_OPERATION_MODE_TSF       BIT1
+#define  GMAC_MTL_TXQ0_OPERATION_MODE_FTQ       BIT0
+#define GMAC_MTL_RXQ0_OPERATION_MODE            0x0D30
+#define  GMAC_MTL_RXQ0_OPERATION_MODE_RQS_SHIFT 20
+#define  GMAC_MTL_RXQ0_OPERATION_MODE_RQS_MASK  (0x3FFU << GMAC_MTL_RXQ0_OPERATION_MODE_RQS_SHIFT)
+#define  GMAC_MTL_RXQ0_OPERATION_MODE_RSF       BIT5
+
+/* DMA registers */
+#define GMAC_DMA_MODE                           0x1000
+#define  GMAC_DMA_MODE_SWR                      BIT0
+#define GMAC_DMA_SYSBUS_MODE                    0x1004
+#define  GMAC_DMA_SYSBUS_MODE_WR_OSR_LMT_SHIFT  24
+#define  GMAC_DMA_SYSBUS_MODE_RD_OSR_LMT_SHIFT  16
+#define  GMAC_DMA_SYSBUS_MODE_AAL               BIT12
+#define  GMAC_DMA_SYSBUS_MODE_BLEN16            BIT3
+#define  GMAC_DMA_SYSBUS_MODE_BLEN8             BIT2
+#define  GMAC_DMA_SYSBUS_MODE_BLEN4             BIT1
+#define GMAC_DMA_CHAN0_CONTROL                  0x1100
+#define  GMAC_DMA_CHAN0_CONTROL_DSL_SHIFT       18
+#define GMAC_DMA_CHAN0_TX_CONTROL               0x1104
+#define  GMAC_DMA_CHAN0_TX_CONTROL_TXPBL_SHIFT  16
+#define  GMAC_DMA_CHAN0_TX_CONTROL_OSP          BIT4
+#define  GMAC_DMA_CHAN0_TX_CONTROL_START        BIT0
+#define GMAC_DMA_CHAN0_RX_CONTROL               0x1108
+#define  GMAC_DMA_CHAN0_RX_CONTROL_RXPBL_SHIFT  16
+#define  GMAC_DMA_CHAN0_RX_CONTROL_RBSZ_SHIFT   1
+#define  GMAC_DMA_CHAN0_RX_CONTROL_START        BIT0
+#define GMAC_DMA_CHAN0_TX_BASE_ADDR_HI          0x1110
+#define GMAC_DMA_CHAN0_TX_BASE_ADDR             0x1114
+#define GMAC_DMA_CHAN0_RX_BASE_ADDR_HI          0x1118
+#define GMAC_DMA_CHAN0_RX_BASE_ADDR             0x111C
+#define GMAC_DMA_CHAN0_TX_END_ADDR              0x1120
+#define GMAC_DMA_CHAN0_RX_END_ADDR              0x1128
+#define GMAC_DMA_CHAN0_TX_RING_LEN              0x112C
+#define GMAC_DMA_CHAN0_RX_RING_LEN              0x1130
+#define GMAC_DMA_CHAN0_INTR_ENABLE              0x1134
+#define GMAC_DMA_CHAN0_STATUS                   0x1160
+
+/* TX descriptor, read format */
+#define EQOS_TDES2_IOC                          BIT31
+#define EQOS_TDES3_OWN                          BIT31
+#define EQOS_TDES3_FD                           BIT29
+#define EQOS_TDES3_LD                           BIT28
+#define EQOS_TDES3_CIC_SHIFT                    16
+#define EQOS_TDES3_CIC_FULL                     (3U << EQOS_TDES3_CIC_SHIFT)
+/* TX descriptor, write-back format */
+#define EQOS_TDES3_ES                           BIT15
+
+/* RX descriptor, read format */
+#define EQOS_RDES3_OWN                          BIT31
+#define EQOS_RDES3_IOC                          BIT30
+#define EQOS_RDES3_BUF1V                        BIT24
+/* RX descriptor, write-back format */
+#define EQOS_RDES1_IPCE                         BIT7
+#define EQOS_RDES1_IPHE                         BIT3
+#define EQOS_RDES3_FD                           BIT29
+#define EQOS_RDES3_LD                           BIT28
+#define EQOS_RDES3_RS1V                         BIT26
+#define EQOS_RDES3_ES                           BIT15
+#define EQOS_RDES3_PL_MASK                      0x7FFFU
+
+/* MII registers */
+#define MII_BMCR                                0x00
+#define MII_BMSR                                0x01
+#define  MII_BMSR_LINK                          BIT2
+#define  MII_BMSR_ACOMP                         BIT5
+#define MII_ANAR                                0x04
+#define MII_ANLPAR                              0x05
+#define  MII_ANLPAR_10_HD                       BIT5
+#define  MII_ANLPAR_10_FD                       BIT6
+#define  MII_ANLPAR_100_HD                      BIT7
+#define  MII_ANLPAR_100_FD                      BIT8
+#define MII_GTCR                                0x09
+#define  MII_GTCR_ADV_1000_FD                   BIT9
+#define  MII_GTCR_ADV_1000_HD                   BIT8
+#define MII_GTSR                                0x0A
+#define  MII_GTSR_LP_1000_FD                    BIT11
+#define  MII_GTSR_LP_1000_HD                    BIT10
+
+/* PHY address used by the board init code */
+#define EQOS_PHY_ADDR                           0
+
+/*
+ * Descriptor rings come from the uncached DMA pool and are packed back to
+ * back, so no cache maintenance is done on them. Frame buffers are cached,
+ * 2 KiB each and cache line aligned.
+ */
+#define EQOS_DESC_SKIP                          0
+
+#define EQOS_TX_DESC_COUNT                      64
+#define EQOS_RX_DESC_COUNT                      128
+#define EQOS_BUFFER_SIZE                        2048
+
+#define EQOS_ETHER_ADDR_LEN                     6
+#define EQOS_ETHER_HEADER_SIZE                  14
+#define EQOS_ETHER_MTU                          1500
+#define EQOS_IFTYPE_ETHERNET                    0x01
+#define EQOS_MAX_MCAST_FILTER_COUNT             16
+
+/* How often GetStatus() samples the PHY for link changes */
+#define EQOS_LINK_POLL_INTERVAL_US              1000000
+
+typedef struct {
+    UINT32                          Des0;
+    UINT32                          Des1;
+    UINT32                          Des2;
+    UINT32                          Des3;
+} EQOS_DMA_DESC;
+
+#define EQOS_SIGNATURE                          SIGNATURE_32 ('E', 'Q', 'O', 'S')
+
+typedef struct {
+    UINT32                          Signature;
+    EFI_HANDLE                      Handle;
+    EFI_PHYSICAL_ADDRESS            Base;
+    UINT32                          Index;
+
+    EFI_SIMPLE_NETWORK_PROTOCOL     Snp;
+    EFI_SIMPLE_NETWORK_MODE         Mode;
+    EFI_NETWORK_STATISTICS          Stats;
+    EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
+    EFI_EVENT                       ExitBootServicesEvent;
+
+    /* DMA memory, allocated once below 4 GiB and kept across Shutdown() */
+    RK356X_DMA_POOL_PROTOCOL        *DmaPool;
+    EFI_PHYSICAL_ADDRESS            DmaBase;
+    UINTN                           DmaPages;
+    EQOS_DMA_DESC                   *TxRing;
+    EQOS_DMA_DESC                   *RxRing;
+    EFI_PHYSICAL_ADDRESS            TxRingAddr;
+    EFI_PHYSICAL_ADDRESS            RxRingAddr;
+    UINT8                           *TxBuffers;
+    UINT8                           *RxBuffers;
+
+    /* Caller buffers of in-flight TX descriptors, handed back by GetStatus() */
+    VOID                            *TxToken[EQOS_TX_DESC_COUNT];
+    UINT32                          TxHead;
+    UINT32                          TxTail;
+    UINT32                          TxQueued;
+    UINT32                          RxHead;
+
+    BOOLEAN                         LinkUp;
+    UINT32                          LinkSpeed;
+    BOOLEAN                         FullDuplex;
+    UINT64                          LinkPollTime;
+} EQOS_PRIVATE_DATA;
+
+#define EQOS_PRIVATE_DATA_FROM_SNP(a)   CR (a, EQOS_PRIVATE_DATA, Snp, EQOS_SIGNATURE)
+
+/* EqosHw.c */
+
+EFI_STATUS
+EqosMdioRead (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  UINT8               Reg,
+    OUT UINT16              *Value
+    );
+
+VOID
+EqosUpdateLink (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+EFI_STATUS
+EqosAllocateDma (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+VOID
+EqosFreeDma (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+EFI_STATUS
+EqosInitHardware (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+VOID
+EqosStopHardware (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+VOID
+EqosSetMacAddress (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  EFI_MAC_ADDRESS     *MacAddress
+    );
+
+VOID
+EqosGetMacAddress (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    OUT EFI_MAC_ADDRESS     *MacAddress
+    );
+
+VOID
+EqosSetRxFilter (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+EFI_STATUS
+EqosTransmit (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  VOID                *Token,
+    IN  CONST UINT8         *Frame,
+    IN  UINTN               Length
+    );
+
+VOID *
+EqosReclaimTx (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+BOOLEAN
+EqosRxPending (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+EFI_STATUS
+EqosReceive (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    OUT UINT8               *Frame,
+    IN OUT UINTN            *Length
+    );
+
+/* EqosSnp.c */
+
+VOID
+EqosSnpInit (
+    IN  EQOS_PRIVATE_DATA   *Private
+    );
+
+#endif /* EQOSDXE_H__ */
@@ -0,0 +1,647 @@
+/** @file
+ *
+ *  Synopsys DesignWare Ethernet Quality-of-Service (GMAC) driver for RK356x.
+ *  MAC, DMA ring and PHY link handling.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/IoLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xCru.h>
+
+#include "EqosDxe.h"
+
+#define EQOS_MDIO_TIMEOUT_US        10000
+#define EQOS_RESET_TIMEOUT_US       100000
+
+#define EQOS_TX_DESC(Private, n)    (&(Private)->TxRing[(n)])
+#define EQOS_RX_DESC(Private, n)    (&(Private)->RxRing[(n)])
+#define EQOS_TX_BUF(Private, n)     ((Private)->TxBuffers + (n) * EQOS_BUFFER_SIZE)
+#define EQOS_RX_BUF(Private, n)     ((Private)->RxBuffers + (n) * EQOS_BUFFER_SIZE)
+#define EQOS_TX_DESC_ADDR(Private, n)   ((UINT32)((Private)->TxRingAddr + (n) * sizeof (EQOS_DMA_DESC)))
+#define EQOS_RX_DESC_ADDR(Private, n)   ((UINT32)((Private)->RxRingAddr + (n) * sizeof (EQOS_DMA_DESC)))
+#define EQOS_DMA_ADDR(Ptr)          ((UINT32)(UINTN)(Ptr))
+
+#define EQOS_TX_RING_SIZE           (sizeof (EQOS_DMA_DESC) * EQOS_TX_DESC_COUNT)
+#define EQOS_RX_RING_SIZE           (sizeof (EQOS_DMA_DESC) * EQOS_RX_DESC_COUNT)
+
+EFI_STATUS
+EqosMdioRead (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  UINT8               Reg,
+    OUT UINT16              *Value
+    )
+{
+    UINT32 Addr;
+    UINTN Retry;
+
+    Addr = GMAC_MAC_MDIO_ADDRESS_CR_100_150 |
+           (EQOS_PHY_ADDR << GMAC_MAC_MDIO_ADDRESS_PA_SHIFT) |
+           (Reg << GMAC_MAC_MDIO_ADDRESS_RDA_SHIFT) |
+           GMAC_MAC_MDIO_ADDRESS_GOC_READ |
+           GMAC_MAC_MDIO_ADDRESS_GB;
+    MmioWrite32 (Private->Base + GMAC_MAC_MDIO_ADDRESS, Addr);
+
+    /* A management frame takes ~30us at 2.5MHz MDC, so poll rather than sleep */
+    for (Retry = EQOS_MDIO_TIMEOUT_US; Retry > 0; Retry--) {
+        Addr = MmioRead32 (Private->Base + GMAC_MAC_MDIO_ADDRESS);
+        if ((Addr & GMAC_MAC_MDIO_ADDRESS_GB) == 0) {
+            *Value = MmioRead32 (Private->Base + GMAC_MAC_MDIO_DATA) & 0xFFFFu;
+            return EFI_SUCCESS;
+        }
+        MicroSecondDelay (1);
+    }
+
+    DEBUG ((DEBUG_WARN, "GMAC%u: PHY read timeout (reg 0x%x)\n", Private->Index, Reg));
+    return EFI_TIMEOUT;
+}
+
+STATIC
+VOID
+EqosSetSpeed (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  UINT32              Speed,
+    IN  BOOLEAN             FullDuplex
+    )
+{
+    UINT32 Config;
+    UINT32 ClkSel;
+
+    Config = MmioRead32 (Private->Base + GMAC_MAC_CONFIGURATION);
+    Config &= ~(GMAC_MAC_CONFIGURATION_PS |
+                GMAC_MAC_CONFIGURATION_FES |
+                GMAC_MAC_CONFIGURATION_DM);
+
+    switch (Speed) {
+    case 1000:
+        ClkSel = CRU_CLKSEL_GMAC_RGMII_SPEED_125M;
+        break;
+    case 100:
+        Config |= GMAC_MAC_CONFIGURATION_PS | GMAC_MAC_CONFIGURATION_FES;
+        ClkSel = CRU_CLKSEL_GMAC_RGMII_SPEED_25M;
+        break;
+    default:
+        Config |= GMAC_MAC_CONFIGURATION_PS;
+        ClkSel = CRU_CLKSEL_GMAC_RGMII_SPEED_2_5M;
+        break;
+    }
+    if (FullDuplex) {
+        Config |= GMAC_MAC_CONFIGURATION_DM;
+    }
+
+    /* RGMII TX clock follows the link speed */
+    MmioWrite32 (CRU_CLKSEL_CON (CRU_CLKSEL_GMAC_CON (Private->Index)),
+                 (CRU_CLKSEL_GMAC_RGMII_SPEED_MASK << 16) |
+                 (ClkSel << CRU_CLKSEL_GMAC_RGMII_SPEED_SHIFT));
+    MmioWrite32 (Private->Base + GMAC_MAC_CONFIGURATION, Config);
+}
+
+VOID
+EqosUpdateLink (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    UINT16 Bmsr, Gtcr, Gtsr, Anar, Anlpar, Common;
+    UINT32 Speed;
+    BOOLEAN FullDuplex;
+
+    /* Link status is latched low, the second read returns the current state */
+    if (EFI_ERROR (EqosMdioRead (Private, MII_BMSR, &Bmsr)) ||
+        EFI_ERROR (EqosMdioRead (Private, MII_BMSR, &Bmsr))) {
+        return;
+    }
+
+    if ((Bmsr & (MII_BMSR_LINK | MII_BMSR_ACOMP)) != (MII_BMSR_LINK | MII_BMSR_ACOMP)) {
+        if (Private->LinkUp) {
+            DEBUG ((DEBUG_INFO, "GMAC%u: Link down\n", Private->Index));
+        }
+        Private->LinkUp = FALSE;
+        Private->Mode.MediaPresent = FALSE;
+        return;
+    }
+
+    if (EFI_ERROR (EqosMdioRead (Private, MII_GTCR, &Gtcr)) ||
+        EFI_ERROR (EqosMdioRead (Private, MII_GTSR, &Gtsr)) ||
+        EFI_ERROR (EqosMdioRead (Private, MII_ANAR, &Anar)) ||
+        EFI_ERROR (EqosMdioRead (Private, MII_ANLPAR, &Anlpar))) {
+        return;
+    }
+
+    /* Resolve the highest common mode. ANAR and ANLPAR share a layout. */
+    Common = Anar & Anlpar;
+    if ((Gtcr & MII_GTCR_ADV_1000_FD) != 0 && (Gtsr & MII_GTSR_LP_1000_FD) != 0) {
+        Speed = 1000;
+        FullDuplex = TRUE;
+    } else if ((Gtcr & MII_GTCR_ADV_1000_HD) != 0 && (Gtsr & MII_GTSR_LP_1000_HD) != 0) {
+        Speed = 1000;
+        FullDuplex = FALSE;
+    } else if ((Common & MII_ANLPAR_100_FD) != 0) {
+        Speed = 100;
+        FullDuplex = TRUE;
+    } else if ((Common & MII_ANLPAR_100_HD) != 0) {
+        Speed = 100;
+        FullDuplex = FALSE;
+    } else {
+        Speed = 10;
+        FullDuplex = (Common & MII_ANLPAR_10_FD) != 0;
+    }
+
+    if (!Private->LinkUp ||
+        Private->LinkSpeed != Speed ||
+        Private->FullDuplex != FullDuplex) {
+        DEBUG ((DEBUG_INFO, "GMAC%u: Link up, %u Mbps, %a duplex\n",
+                Private->Index, Speed, FullDuplex ? "full" : "half"));
+        EqosSetSpeed (Private, Speed, FullDuplex);
+    }
+
+    Private->LinkUp = TRUE;
+    Private->LinkSpeed = Speed;
+    Private->FullDuplex = FullDuplex;
+    Private->Mode.MediaPresent = TRUE;
+}
+
+EFI_STATUS
+EqosAllocateDma (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    EFI_STATUS Status;
+    UINTN TxBufSize, RxBufSize;
+    UINT8 *Ptr;
+
+    if (Private->DmaPages != 0) {
+        return EFI_SUCCESS;
+    }
+
+    if (Private->DmaPool == NULL) {
+        Status = gBS->LocateProtocol (&gRk356xDmaPoolProtocolGuid, NULL,
+                                      (VOID **)&Private->DmaPool);
+        if (EFI_ERROR (Status)) {
+            return Status;
+        }
+    }
+
+    /* The pool lives below 4 GiB, the GMAC DMA engine only drives 32 address bits */
+    Status = Private->DmaPool->Allocate (Private->DmaPool, EQOS_TX_RING_SIZE, 0,
+                                         (VOID **)&Private->TxRing, &Private->TxRingAddr);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+    Status = Private->DmaPool->Allocate (Private->DmaPool, EQOS_RX_RING_SIZE, 0,
+                                         (VOID **)&Private->RxRing, &Private->RxRingAddr);
+    if (EFI_ERROR (Status)) {
+        goto FreeTxRing;
+    }
+
+    TxBufSize = EQOS_BUFFER_SIZE * EQOS_TX_DESC_COUNT;
+    RxBufSize = EQOS_BUFFER_SIZE * EQOS_RX_DESC_COUNT;
+
+    Private->DmaBase = BASE_4GB - 1;
+    Private->DmaPages = EFI_SIZE_TO_PAGES (TxBufSize + RxBufSize);
+    Status = gBS->AllocatePages (AllocateMaxAddress, EfiBootServicesData,
+                                 Private->DmaPages, &Private->DmaBase);
+    if (EFI_ERROR (Status)) {
+        Private->DmaPages = 0;
+        goto FreeRxRing;
+    }
+
+    Ptr = (UINT8 *)(UINTN)Private->DmaBase;
+    ZeroMem (Ptr, EFI_PAGES_TO_SIZE (Private->DmaPages));
+    WriteBackInvalidateDataCacheRange (Ptr, EFI_PAGES_TO_SIZE (Private->DmaPages));
+
+    Private->TxBuffers = Ptr;
+    Ptr += TxBufSize;
+    Private->RxBuffers = Ptr;
+
+    return EFI_SUCCESS;
+
+FreeRxRing:
+    Private->DmaPool->Free (Private->DmaPool, Private->RxRing, EQOS_RX_RING_SIZE, 0);
+FreeTxRing:
+    Private->DmaPool->Free (Private->DmaPool, Private->TxRing, EQOS_TX_RING_SIZE, 0);
+    Private->TxRing = NULL;
+    Private->RxRing = NULL;
+
+    return Status;
+}
+
+VOID
+EqosFreeDma (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    if (Private->DmaPages != 0) {
+        gBS->FreePages (Private->DmaBase, Private->DmaPages);
+        Private->DmaPages = 0;
+        Private->DmaPool->Free (Private->DmaPool, Private->RxRing, EQOS_RX_RING_SIZE, 0);
+        Private->DmaPool->Free (Private->DmaPool, Private->TxRing, EQOS_TX_RING_SIZE, 0);
+        Private->TxRing = NULL;
+        Private->RxRing = NULL;
+    }
+}
+
+VOID
+EqosGetMacAddress (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    OUT EFI_MAC_ADDRESS     *MacAddress
+    )
+{
+    UINT32 MacLo, MacHi;
+
+    MacLo = MmioRead32 (Private->Base + GMAC_MAC_ADDRESS0_LOW);
+    MacHi = MmioRead32 (Private->Base + GMAC_MAC_ADDRESS0_HIGH);
+
+    ZeroMem (MacAddress, sizeof (EFI_MAC_ADDRESS));
+    MacAddress->Addr[0] = MacLo & 0xFF;
+    MacAddress->Addr[1] = (MacLo >> 8) & 0xFF;
+    MacAddress->Addr[2] = (MacLo >> 16) & 0xFF;
+    MacAddress->Addr[3] = (MacLo >> 24) & 0xFF;
+    MacAddress->Addr[4] = MacHi & 0xFF;
+    MacAddress->Addr[5] = (MacHi >> 8) & 0xFF;
+}
+
+VOID
+EqosSetMacAddress (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  EFI_MAC_ADDRESS     *MacAddress
+    )
+{
+    MmioWrite32 (Private->Base + GMAC_MAC_ADDRESS0_LOW,
+                 MacAddress->Addr[0] |
+                 (MacAddress->Addr[1] << 8) |
+                 (MacAddress->Addr[2] << 16) |
+                 ((UINT32)MacAddress->Addr[3] << 24));
+    MmioWrite32 (Private->Base + GMAC_MAC_ADDRESS0_HIGH,
+                 MacAddress->Addr[4] |
+                 (MacAddress->Addr[5] << 8));
+}
+
+STATIC
+UINT32
+EqosBitReverse32 (
+    IN  UINT32  Value
+    )
+{
+    UINT32 Result;
+    UINTN Bit;
+
+    for (Result = 0, Bit = 0; Bit < 32; Bit++) {
+        Result = (Result << 1) | (Value & 1);
+        Value >>= 1;
+    }
+
+    return Result;
+}
+
+VOID
+EqosSetRxFilter (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    UINT32 Setting;
+    UINT32 Filter;
+    UINT32 Hash[2];
+    UINT32 Bit;
+    UINTN Index;
+
+    Setting = Private->Mode.ReceiveFilterSetting;
+    Filter = 0;
+    Hash[0] = Hash[1] = 0;
+
+    if ((Setting & EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS) != 0) {
+        Filter |= GMAC_MAC_PACKET_FILTER_PR;
+    }
+    if ((Setting & EFI_SIMPLE_NETWORK_RECEIVE_BROADCAST) == 0) {
+        Filter |= GMAC_MAC_PACKET_FILTER_DBF;
+    }
+    if ((Setting & EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS_MULTICAST) != 0) {
+        Filter |= GMAC_MAC_PACKET_FILTER_PM;
+    } else if ((Setting & EFI_SIMPLE_NETWORK_RECEIVE_MULTICAST) != 0) {
+        /* 64-bit hash filter, indexed by the top 6 bits of the reflected CRC */
+        Filter |= GMAC_MAC_PACKET_FILTER_HMC;
+        for (Index = 0; Index < Private->Mode.MCastFilterCount; Index++) {
+            Bit = EqosBitReverse32 (CalculateCrc32 (Private->Mode.MCastFilter[Index].Addr,
+                                                    EQOS_ETHER_ADDR_LEN)) >> 26;
+            Hash[Bit >> 5] |= 1U << (Bit & 0x1F);
+        }
+    }
+
+    MmioWrite32 (Private->Base + GMAC_MAC_HASH_TABLE_REG0, Hash[0]);
+    MmioWrite32 (Private->Base + GMAC_MAC_HASH_TABLE_REG1, Hash[1]);
+    MmioWrite32 (Private->Base + GMAC_MAC_PACKET_FILTER, Filter);
+}
+
+STATIC
+VOID
+EqosRxRefill (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  UINT32              Index
+    )
+{
+    EQOS_DMA_DESC *Desc;
+
+    Desc = EQOS_RX_DESC (Private, Index);
+    Desc->Des0 = EQOS_DMA_ADDR (EQOS_RX_BUF (Private, Index));
+    Desc->Des1 = 0;
+    Desc->Des2 = 0;
+    MemoryFence ();
+    Desc->Des3 = EQOS_RDES3_OWN | EQOS_RDES3_IOC | EQOS_RDES3_BUF1V;
+
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_RX_END_ADDR,
+                 EQOS_RX_DESC_ADDR (Private, (Index + 1) % EQOS_RX_DESC_COUNT));
+}
+
+STATIC
+VOID
+EqosInitRings (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    UINT32 Index;
+
+    ZeroMem (Private->TxRing, EQOS_TX_RING_SIZE);
+    for (Index = 0; Index < EQOS_TX_DESC_COUNT; Index++) {
+        Private->TxToken[Index] = NULL;
+    }
+    Private->TxHead = 0;
+    Private->TxTail = 0;
+    Private->TxQueued = 0;
+
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_TX_BASE_ADDR_HI, 0);
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_TX_BASE_ADDR, EQOS_TX_DESC_ADDR (Private, 0));
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_TX_RING_LEN, EQOS_TX_DESC_COUNT - 1);
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_TX_END_ADDR, EQOS_TX_DESC_ADDR (Private, 0));
+
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_RX_BASE_ADDR_HI, 0);
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_RX_BASE_ADDR, EQOS_RX_DESC_ADDR (Private, 0));
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_RX_RING_LEN, EQOS_RX_DESC_COUNT - 1);
+    for (Index = 0; Index < EQOS_RX_DESC_COUNT; Index++) {
+        EqosRxRefill (Private, Index);
+    }
+    Private->RxHead = 0;
+}
+
+EFI_STATUS
+EqosInitHardware (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    UINT32 HwFeature, FifoSize, Tqs, Rqs;
+    UINTN Retry;
+
+    /* Software reset. This also clears the station address. */
+    MmioOr32 (Private->Base + GMAC_DMA_MODE, GMAC_DMA_MODE_SWR);
+    for (Retry = EQOS_RESET_TIMEOUT_US; Retry > 0; Retry--) {
+        if ((MmioRead32 (Private->Base + GMAC_DMA_MODE) & GMAC_DMA_MODE_SWR) == 0) {
+            break;
+        }
+        MicroSecondDelay (1);
+    }
+    if (Retry == 0) {
+        DEBUG ((DEBUG_ERROR, "GMAC%u: Soft reset timeout\n", Private->Index));
+        return EFI_DEVICE_ERROR;
+    }
+
+    EqosSetMacAddress (Private, &Private->Mode.CurrentAddress);
+
+    /* Nothing is interrupt driven, SNP consumers poll */
+    MmioWrite32 (Private->Base + GMAC_MAC_INTERRUPT_ENABLE, 0);
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_INTR_ENABLE, 0);
+    MmioWrite32 (Private->Base + GMAC_MMC_RX_INTERRUPT_MASK, 0xFFFFFFFF);
+    MmioWrite32 (Private->Base + GMAC_MMC_TX_INTERRUPT_MASK, 0xFFFFFFFF);
+    MmioWrite32 (Private->Base + GMAC_MMC_IPC_RX_INTERRUPT_MASK, 0xFFFFFFFF);
+    MmioWrite32 (Private->Base + GMAC_MMC_CONTROL, GMAC_MMC_CONTROL_CNTRST);
+
+    /* AXI burst and outstanding request limits, as used by the vendor kernel */
+    MmioWrite32 (Private->Base + GMAC_DMA_SYSBUS_MODE,
+                 (4 << GMAC_DMA_SYSBUS_MODE_WR_OSR_LMT_SHIFT) |
+                 (8 << GMAC_DMA_SYSBUS_MODE_RD_OSR_LMT_SHIFT) |
+                 GMAC_DMA_SYSBUS_MODE_BLEN16 |
+                 GMAC_DMA_SYSBUS_MODE_BLEN8 |
+                 GMAC_DMA_SYSBUS_MODE_BLEN4);
+
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_CONTROL,
+                 EQOS_DESC_SKIP << GMAC_DMA_CHAN0_CONTROL_DSL_SHIFT);
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_TX_CONTROL,
+                 (16 << GMAC_DMA_CHAN0_TX_CONTROL_TXPBL_SHIFT) |
+                 GMAC_DMA_CHAN0_TX_CONTROL_OSP);
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_RX_CONTROL,
+                 (16 << GMAC_DMA_CHAN0_RX_CONTROL_RXPBL_SHIFT) |
+                 (EQOS_BUFFER_SIZE << GMAC_DMA_CHAN0_RX_CONTROL_RBSZ_SHIFT));
+
+    EqosInitRings (Private);
+
+    /*
+     * Store-and-forward in both directions, which TX checksum insertion
+     * requires. The whole FIFO goes to queue 0.
+     */
+    HwFeature = MmioRead32 (Private->Base + GMAC_MAC_HW_FEATURE1);
+    FifoSize = 128U << ((HwFeature & GMAC_MAC_HW_FEATURE1_TXFIFOSIZE_MASK) >>
+                        GMAC_MAC_HW_FEATURE1_TXFIFOSIZE_SHIFT);
+    Tqs = FifoSize / 256 - 1;
+    FifoSize = 128U << (HwFeature & GMAC_MAC_HW_FEATURE1_RXFIFOSIZE_MASK);
+    Rqs = FifoSize / 256 - 1;
+
+    MmioWrite32 (Private->Base + GMAC_MTL_TXQ0_OPERATION_MODE,
+                 ((Tqs << GMAC_MTL_TXQ0_OPERATION_MODE_TQS_SHIFT) &
+                  GMAC_MTL_TXQ0_OPERATION_MODE_TQS_MASK) |
+                 GMAC_MTL_TXQ0_OPERATION_MODE_TXQEN |
+                 GMAC_MTL_TXQ0_OPERATION_MODE_TSF);
+    MmioWrite32 (Private->Base + GMAC_MTL_RXQ0_OPERATION_MODE,
+                 ((Rqs << GMAC_MTL_RXQ0_OPERATION_MODE_RQS_SHIFT) &
+                  GMAC_MTL_RXQ0_OPERATION_MODE_RQS_MASK) |
+                 GMAC_MTL_RXQ0_OPERATION_MODE_RSF);
+    MmioAndThenOr32 (Private->Base + GMAC_RXQ_CTRL0,
+                     ~GMAC_RXQ_CTRL0_EN_MASK, GMAC_RXQ_CTRL0_EN_DCB);
+
+    /* Checksum offload, strip the FCS. Speed and duplex follow the PHY. */
+    MmioWrite32 (Private->Base + GMAC_MAC_CONFIGURATION,
+                 GMAC_MAC_CONFIGURATION_IPC |
+                 GMAC_MAC_CONFIGURATION_CST |
+                 GMAC_MAC_CONFIGURATION_ACS |
+                 GMAC_MAC_CONFIGURATION_DM);
+    Private->LinkUp = FALSE;
+    EqosUpdateLink (Private);
+    Private->LinkPollTime = GetTimeInNanoSecond (GetPerformanceCounter ());
+
+    EqosSetRxFilter (Private);
+
+    MmioOr32 (Private->Base + GMAC_DMA_CHAN0_TX_CONTROL, GMAC_DMA_CHAN0_TX_CONTROL_START);
+    MmioOr32 (Private->Base + GMAC_DMA_CHAN0_RX_CONTROL, GMAC_DMA_CHAN0_RX_CONTROL_START);
+    MmioOr32 (Private->Base + GMAC_MAC_CONFIGURATION,
+              GMAC_MAC_CONFIGURATION_TE | GMAC_MAC_CONFIGURATION_RE);
+
+    return EFI_SUCCESS;
+}
+
+VOID
+EqosStopHardware (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    MmioAnd32 (Private->Base + GMAC_DMA_CHAN0_TX_CONTROL, ~GMAC_DMA_CHAN0_TX_CONTROL_START);
+    MmioAnd32 (Private->Base + GMAC_MAC_CONFIGURATION,
+               ~(GMAC_MAC_CONFIGURATION_TE | GMAC_MAC_CONFIGURATION_RE));
+    MmioAnd32 (Private->Base + GMAC_DMA_CHAN0_RX_CONTROL, ~GMAC_DMA_CHAN0_RX_CONTROL_START);
+    MmioOr32 (Private->Base + GMAC_MTL_TXQ0_OPERATION_MODE, GMAC_MTL_TXQ0_OPERATION_MODE_FTQ);
+
+    /* Let a frame already in flight on the RX side land before the buffers go away */
+    MicroSecondDelay (1000);
+}
+
+EFI_STATUS
+EqosTransmit (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    IN  VOID                *Token,
+    IN  CONST UINT8         *Frame,
+    IN  UINTN               Length
+    )
+{
+    EQOS_DMA_DESC *Desc;
+    UINT8 *Buffer;
+    UINT32 Index;
+
+    //
+    // Keep one descriptor free: the DMA takes a tail pointer equal to its
+    // current descriptor as an empty ring, so a full one would never be sent.
+    //
+    if (Private->TxQueued == EQOS_TX_DESC_COUNT - 1) {
+        return EFI_NOT_READY;
+    }
+
+    Index = Private->TxHead;
+    Desc = EQOS_TX_DESC (Private, Index);
+    Buffer = EQOS_TX_BUF (Private, Index);
+
+    CopyMem (Buffer, Frame, Length);
+    WriteBackDataCacheRange (Buffer, Length);
+
+    Desc->Des0 = EQOS_DMA_ADDR (Buffer);
+    Desc->Des1 = 0;
+    Desc->Des2 = (UINT32)Length;
+    MemoryFence ();
+    Desc->Des3 = EQOS_TDES3_OWN | EQOS_TDES3_FD | EQOS_TDES3_LD |
+                 EQOS_TDES3_CIC_FULL | (UINT32)Length;
+
+    Private->TxToken[Index] = Token;
+    Private->TxHead = (Index + 1) % EQOS_TX_DESC_COUNT;
+    Private->TxQueued++;
+
+    MmioWrite32 (Private->Base + GMAC_DMA_CHAN0_TX_END_ADDR,
+                 EQOS_TX_DESC_ADDR (Private, Private->TxHead));
+
+    return EFI_SUCCESS;
+}
+
+VOID *
+EqosReclaimTx (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    EQOS_DMA_DESC *Desc;
+    VOID *Token;
+
+    if (Private->TxQueued == 0) {
+        return NULL;
+    }
+
+    Desc = EQOS_TX_DESC (Private, Private->TxTail);
+    if ((Desc->Des3 & EQOS_TDES3_OWN) != 0) {
+        return NULL;
+    }
+
+    Private->Stats.TxTotalFrames++;
+    if ((Desc->Des3 & EQOS_TDES3_ES) != 0) {
+        Private->Stats.TxErrorFrames++;
+    } else {
+        Private->Stats.TxGoodFrames++;
+    }
+
+    Token = Private->TxToken[Private->TxTail];
+    Private->TxToken[Private->TxTail] = NULL;
+    Private->TxTail = (Private->TxTail + 1) % EQOS_TX_DESC_COUNT;
+    Private->TxQueued--;
+
+    return Token;
+}
+
+BOOLEAN
+EqosRxPending (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    EQOS_DMA_DESC *Desc;
+
+    Desc = EQOS_RX_DESC (Private, Private->RxHead);
+
+    return (Desc->Des3 & EQOS_RDES3_OWN) == 0;
+}
+
+EFI_STATUS
+EqosReceive (
+    IN  EQOS_PRIVATE_DATA   *Private,
+    OUT UINT8               *Frame,
+    IN OUT UINTN            *Length
+    )
+{
+    EQOS_DMA_DESC *Desc;
+    UINT8 *Buffer;
+    UINT32 Des1, Des3;
+    UINTN FrameLength;
+
+    for (;;) {
+        Desc = EQOS_RX_DESC (Private, Private->RxHead);
+        Des3 = Desc->Des3;
+        if ((Des3 & EQOS_RDES3_OWN) != 0) {
+            return EFI_NOT_READY;
+        }
+        /* Don't let the other descriptor words be read ahead of OWN */
+        MemoryFence ();
+        Des1 = Desc->Des1;
+        FrameLength = Des3 & EQOS_RDES3_PL_MASK;
+
+        if ((Des3 & (EQOS_RDES3_ES | EQOS_RDES3_FD | EQOS_RDES3_LD)) !=
+            (EQOS_RDES3_FD | EQOS_RDES3_LD)) {
+            /* Receive error, or a frame that did not fit in one buffer */
+            Private->Stats.RxTotalFrames++;
+            Private->Stats.RxDroppedFrames++;
+        } else if ((Des3 & EQOS_RDES3_RS1V) != 0 && (Des1 & EQOS_RDES1_IPHE) != 0) {
+            /*
+             * Bad IPv4 header checksum. Payload checksum errors are left
+             * to the stack, the MAC doesn't verify every IP fragment.
+             */
+            Private->Stats.RxTotalFrames++;
+            Private->Stats.RxDroppedFrames++;
+        } else if (FrameLength > *Length) {
+            *Length = FrameLength;
+            return EFI_BUFFER_TOO_SMALL;
+        } else {
+            Buffer = EQOS_RX_BUF (Private, Private->RxHead);
+            InvalidateDataCacheRange (Buffer, FrameLength);
+            CopyMem (Frame, Buffer, FrameLength);
+            *Length = FrameLength;
+
+            Private->Stats.RxTotalFrames++;
+            Private->Stats.RxGoodFrames++;
+            Private->Stats.RxTotalBytes += FrameLength;
+
+            EqosRxRefill (Private, Private->RxHead);
+            Private->RxHead = (Private->RxHead + 1) % EQOS_RX_DESC_COUNT;
+            return EFI_SUCCESS;
+        }
+
+        EqosRxRefill (Private, Private->RxHead);
+        Private->RxHead = (Private->RxHead + 1) % EQOS_RX_DESC_COUNT;
+    }
+}
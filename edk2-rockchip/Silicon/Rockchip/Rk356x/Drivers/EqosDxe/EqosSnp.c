@@ -0,0 +1,697 @@
+/** @file
+ *
+ *  Synopsys DesignWare Ethernet Quality-of-Service (GMAC) driver for RK356x.
+ *  Simple Network Protocol.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "EqosDxe.h"
+
+#define EQOS_RECEIVE_FILTER_MASK    (EFI_SIMPLE_NETWORK_RECEIVE_UNICAST |               \
+                                     EFI_SIMPLE_NETWORK_RECEIVE_MULTICAST |             \
+                                     EFI_SIMPLE_NETWORK_RECEIVE_BROADCAST |             \
+                                     EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS |           \
+                                     EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS_MULTICAST)
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpStart (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    if (This == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    if (Private->Mode.State == EfiSimpleNetworkStopped) {
+        Private->Mode.State = EfiSimpleNetworkStarted;
+        Status = EFI_SUCCESS;
+    } else {
+        Status = EFI_ALREADY_STARTED;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpStop (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    if (This == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkStarted:
+        Private->Mode.State = EfiSimpleNetworkStopped;
+        Status = EFI_SUCCESS;
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        break;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        break;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpInitialize (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN UINTN                        ExtraRxBufferSize OPTIONAL,
+    IN UINTN                        ExtraTxBufferSize OPTIONAL
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    if (This == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkStarted:
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        goto Done;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        goto Done;
+    }
+
+    Status = EqosAllocateDma (Private);
+    if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "GMAC%u: Failed to allocate DMA memory: %r\n",
+                Private->Index, Status));
+        goto Done;
+    }
+
+    Private->Mode.ReceiveFilterSetting = 0;
+    Private->Mode.MCastFilterCount = 0;
+
+    Status = EqosInitHardware (Private);
+    if (EFI_ERROR (Status)) {
+        EqosFreeDma (Private);
+        goto Done;
+    }
+
+    Private->Mode.State = EfiSimpleNetworkInitialized;
+
+Done:
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpReset (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN BOOLEAN                      ExtendedVerification
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    if (This == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        EqosStopHardware (Private);
+        Status = EqosInitHardware (Private);
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        break;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        break;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpShutdown (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    if (This == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        EqosStopHardware (Private);
+        EqosFreeDma (Private);
+        Private->Mode.State = EfiSimpleNetworkStarted;
+        Status = EFI_SUCCESS;
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        break;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        break;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpReceiveFilters (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN UINT32                       Enable,
+    IN UINT32                       Disable,
+    IN BOOLEAN                      ResetMCastFilter,
+    IN UINTN                        MCastFilterCnt OPTIONAL,
+    IN EFI_MAC_ADDRESS              *MCastFilter OPTIONAL
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+    UINTN Index;
+
+    if (This == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    if (((Enable | Disable) & ~EQOS_RECEIVE_FILTER_MASK) != 0) {
+        return EFI_INVALID_PARAMETER;
+    }
+    if (!ResetMCastFilter && MCastFilterCnt != 0) {
+        if (MCastFilterCnt > Private->Mode.MaxMCastFilterCount || MCastFilter == NULL) {
+            return EFI_INVALID_PARAMETER;
+        }
+        for (Index = 0; Index < MCastFilterCnt; Index++) {
+            if ((MCastFilter[Index].Addr[0] & 0x01) == 0) {
+                return EFI_INVALID_PARAMETER;
+            }
+        }
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        goto Done;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        goto Done;
+    }
+
+    Private->Mode.ReceiveFilterSetting |= Enable;
+    Private->Mode.ReceiveFilterSetting &= ~Disable;
+
+    if (ResetMCastFilter) {
+        Private->Mode.MCastFilterCount = 0;
+        ZeroMem (Private->Mode.MCastFilter, sizeof (Private->Mode.MCastFilter));
+    } else if (MCastFilterCnt != 0) {
+        Private->Mode.MCastFilterCount = (UINT32)MCastFilterCnt;
+        CopyMem (Private->Mode.MCastFilter, MCastFilter,
+                 MCastFilterCnt * sizeof (EFI_MAC_ADDRESS));
+    }
+
+    EqosSetRxFilter (Private);
+    Status = EFI_SUCCESS;
+
+Done:
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpStationAddress (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN BOOLEAN                      Reset,
+    IN EFI_MAC_ADDRESS              *New OPTIONAL
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    if (This == NULL || (!Reset && New == NULL)) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        if (Reset) {
+            CopyMem (&Private->Mode.CurrentAddress, &Private->Mode.PermanentAddress,
+                     sizeof (EFI_MAC_ADDRESS));
+        } else {
+            CopyMem (&Private->Mode.CurrentAddress, New, sizeof (EFI_MAC_ADDRESS));
+        }
+        EqosSetMacAddress (Private, &Private->Mode.CurrentAddress);
+        Status = EFI_SUCCESS;
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        break;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        break;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpStatistics (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN BOOLEAN                      Reset,
+    IN OUT UINTN                    *StatisticsSize OPTIONAL,
+    OUT EFI_NETWORK_STATISTICS      *StatisticsTable OPTIONAL
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_NETWORK_STATISTICS Stats;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+
+    if (This == NULL ||
+        (!Reset && StatisticsSize == NULL) ||
+        (StatisticsSize != NULL && *StatisticsSize != 0 && StatisticsTable == NULL)) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        goto Done;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        goto Done;
+    }
+
+    Status = EFI_SUCCESS;
+    if (StatisticsSize != NULL) {
+        /* Counters the driver doesn't keep read as all ones */
+        SetMem (&Stats, sizeof (Stats), 0xFF);
+        Stats.RxTotalFrames = Private->Stats.RxTotalFrames;
+        Stats.RxGoodFrames = Private->Stats.RxGoodFrames;
+        Stats.RxDroppedFrames = Private->Stats.RxDroppedFrames;
+        Stats.RxTotalBytes = Private->Stats.RxTotalBytes;
+        Stats.TxTotalFrames = Private->Stats.TxTotalFrames;
+        Stats.TxGoodFrames = Private->Stats.TxGoodFrames;
+        Stats.TxErrorFrames = Private->Stats.TxErrorFrames;
+        Stats.TxTotalBytes = Private->Stats.TxTotalBytes;
+
+        if (*StatisticsSize < sizeof (Stats)) {
+            Status = EFI_BUFFER_TOO_SMALL;
+        }
+        CopyMem (StatisticsTable, &Stats, MIN (*StatisticsSize, sizeof (Stats)));
+        *StatisticsSize = sizeof (Stats);
+    }
+
+    if (Reset) {
+        ZeroMem (&Private->Stats, sizeof (Private->Stats));
+    }
+
+Done:
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpMCastIpToMac (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN BOOLEAN                      IPv6,
+    IN EFI_IP_ADDRESS               *IP,
+    OUT EFI_MAC_ADDRESS             *MAC
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+
+    if (This == NULL || IP == NULL || MAC == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        break;
+    case EfiSimpleNetworkStopped:
+        return EFI_NOT_STARTED;
+    default:
+        return EFI_DEVICE_ERROR;
+    }
+
+    ZeroMem (MAC, sizeof (EFI_MAC_ADDRESS));
+    if (IPv6) {
+        /* RFC 2464: 33:33 followed by the low 32 bits of the group */
+        if (IP->v6.Addr[0] != 0xFF) {
+            return EFI_INVALID_PARAMETER;
+        }
+        MAC->Addr[0] = 0x33;
+        MAC->Addr[1] = 0x33;
+        CopyMem (&MAC->Addr[2], &IP->v6.Addr[12], 4);
+    } else {
+        /* RFC 1112: 01:00:5E followed by the low 23 bits of the group */
+        if ((IP->v4.Addr[0] & 0xF0) != 0xE0) {
+            return EFI_INVALID_PARAMETER;
+        }
+        MAC->Addr[0] = 0x01;
+        MAC->Addr[1] = 0x00;
+        MAC->Addr[2] = 0x5E;
+        MAC->Addr[3] = IP->v4.Addr[1] & 0x7F;
+        MAC->Addr[4] = IP->v4.Addr[2];
+        MAC->Addr[5] = IP->v4.Addr[3];
+    }
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpNvData (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN BOOLEAN                      ReadWrite,
+    IN UINTN                        Offset,
+    IN UINTN                        BufferSize,
+    IN OUT VOID                     *Buffer
+    )
+{
+    return EFI_UNSUPPORTED;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpGetStatus (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    OUT UINT32                      *InterruptStatus OPTIONAL,
+    OUT VOID                        **TxBuf OPTIONAL
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+    UINT64 Now;
+
+    if (This == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        goto Done;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        goto Done;
+    }
+
+    /* The stack calls this on every poll, keep MDIO traffic off the fast path */
+    Now = GetTimeInNanoSecond (GetPerformanceCounter ());
+    if (Now - Private->LinkPollTime >= EQOS_LINK_POLL_INTERVAL_US * 1000ULL) {
+        EqosUpdateLink (Private);
+        Private->LinkPollTime = Now;
+    }
+
+    if (TxBuf != NULL) {
+        *TxBuf = EqosReclaimTx (Private);
+    }
+
+    if (InterruptStatus != NULL) {
+        *InterruptStatus = 0;
+        if (EqosRxPending (Private)) {
+            *InterruptStatus |= EFI_SIMPLE_NETWORK_RECEIVE_INTERRUPT;
+        }
+        if (TxBuf != NULL && *TxBuf != NULL) {
+            *InterruptStatus |= EFI_SIMPLE_NETWORK_TRANSMIT_INTERRUPT;
+        }
+    }
+
+    Status = EFI_SUCCESS;
+
+Done:
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpTransmit (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    IN UINTN                        HeaderSize,
+    IN UINTN                        BufferSize,
+    IN VOID                         *Buffer,
+    IN EFI_MAC_ADDRESS              *SrcAddr OPTIONAL,
+    IN EFI_MAC_ADDRESS              *DestAddr OPTIONAL,
+    IN UINT16                       *Protocol OPTIONAL
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+    UINT8 *Frame;
+
+    if (This == NULL || Buffer == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    if (HeaderSize != 0 &&
+        (HeaderSize != Private->Mode.MediaHeaderSize || DestAddr == NULL || Protocol == NULL)) {
+        return EFI_INVALID_PARAMETER;
+    }
+    if (BufferSize < Private->Mode.MediaHeaderSize) {
+        return EFI_BUFFER_TOO_SMALL;
+    }
+    if (BufferSize > Private->Mode.MediaHeaderSize + Private->Mode.MaxPacketSize) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        goto Done;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        goto Done;
+    }
+
+    if (HeaderSize != 0) {
+        Frame = Buffer;
+        CopyMem (&Frame[0], DestAddr, EQOS_ETHER_ADDR_LEN);
+        CopyMem (&Frame[EQOS_ETHER_ADDR_LEN],
+                 SrcAddr != NULL ? SrcAddr : &Private->Mode.CurrentAddress,
+                 EQOS_ETHER_ADDR_LEN);
+        Frame[12] = (UINT8)(*Protocol >> 8);
+        Frame[13] = (UINT8)(*Protocol & 0xFF);
+    }
+
+    Status = EqosTransmit (Private, Buffer, Buffer, BufferSize);
+    if (!EFI_ERROR (Status)) {
+        Private->Stats.TxTotalBytes += BufferSize;
+    }
+
+Done:
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EqosSnpReceive (
+    IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+    OUT UINTN                       *HeaderSize OPTIONAL,
+    IN OUT UINTN                    *BufferSize,
+    OUT VOID                        *Buffer,
+    OUT EFI_MAC_ADDRESS             *SrcAddr OPTIONAL,
+    OUT EFI_MAC_ADDRESS             *DestAddr OPTIONAL,
+    OUT UINT16                      *Protocol OPTIONAL
+    )
+{
+    EQOS_PRIVATE_DATA *Private;
+    EFI_TPL OldTpl;
+    EFI_STATUS Status;
+    UINT8 *Frame;
+
+    if (This == NULL || BufferSize == NULL || Buffer == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    Private = EQOS_PRIVATE_DATA_FROM_SNP (This);
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    switch (Private->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+        break;
+    case EfiSimpleNetworkStopped:
+        Status = EFI_NOT_STARTED;
+        goto Done;
+    default:
+        Status = EFI_DEVICE_ERROR;
+        goto Done;
+    }
+
+    Status = EqosReceive (Private, Buffer, BufferSize);
+    if (EFI_ERROR (Status) || *BufferSize < Private->Mode.MediaHeaderSize) {
+        goto Done;
+    }
+
+    Frame = Buffer;
+    if (HeaderSize != NULL) {
+        *HeaderSize = Private->Mode.MediaHeaderSize;
+    }
+    if (DestAddr != NULL) {
+        ZeroMem (DestAddr, sizeof (EFI_MAC_ADDRESS));
+        CopyMem (DestAddr, &Frame[0], EQOS_ETHER_ADDR_LEN);
+    }
+    if (SrcAddr != NULL) {
+        ZeroMem (SrcAddr, sizeof (EFI_MAC_ADDRESS));
+        CopyMem (SrcAddr, &Frame[EQOS_ETHER_ADDR_LEN], EQOS_ETHER_ADDR_LEN);
+    }
+    if (Protocol != NULL) {
+        *Protocol = (UINT16)((Frame[12] << 8) | Frame[13]);
+    }
+
+Done:
+    gBS->RestoreTPL (OldTpl);
+    return Status;
+}
+
+STATIC
+VOID
+EFIAPI
+EqosSnpWaitForPacket (
+    IN EFI_EVENT    Event,
+    IN VOID         *Context
+    )
+{
+    EQOS_PRIVATE_DATA *Private = Context;
+
+    if (Private->Mode.State == EfiSimpleNetworkInitialized && EqosRxPending (Private)) {
+        gBS->SignalEvent (Event);
+    }
+}
+
+VOID
+EqosSnpInit (
+    IN  EQOS_PRIVATE_DATA   *Private
+    )
+{
+    EFI_SIMPLE_NETWORK_MODE *Mode = &Private->Mode;
+    EFI_STATUS Status;
+
+    Mode->State = EfiSimpleNetworkStopped;
+    Mode->HwAddressSize = EQOS_ETHER_ADDR_LEN;
+    Mode->MediaHeaderSize = EQOS_ETHER_HEADER_SIZE;
+    Mode->MaxPacketSize = EQOS_ETHER_MTU;
+    Mode->NvRamSize = 0;
+    Mode->NvRamAccessSize = 0;
+    Mode->ReceiveFilterMask = EQOS_RECEIVE_FILTER_MASK;
+    Mode->ReceiveFilterSetting = 0;
+    Mode->MaxMCastFilterCount = EQOS_MAX_MCAST_FILTER_COUNT;
+    Mode->MCastFilterCount = 0;
+    EqosGetMacAddress (Private, &Mode->PermanentAddress);
+    CopyMem (&Mode->CurrentAddress, &Mode->PermanentAddress, sizeof (EFI_MAC_ADDRESS));
+    SetMem (&Mode->BroadcastAddress, EQOS_ETHER_ADDR_LEN, 0xFF);
+    Mode->IfType = EQOS_IFTYPE_ETHERNET;
+    Mode->MacAddressChangeable = TRUE;
+    Mode->MultipleTxSupported = TRUE;
+    Mode->MediaPresentSupported = TRUE;
+    Mode->MediaPresent = FALSE;
+
+    Private->Snp.Revision = EFI_SIMPLE_NETWORK_PROTOCOL_REVISION;
+    Private->Snp.Start = EqosSnpStart;
+    Private->Snp.Stop = EqosSnpStop;
+    Private->Snp.Initialize = EqosSnpInitialize;
+    Private->Snp.Reset = EqosSnpReset;
+    Private->Snp.Shutdown = EqosSnpShutdown;
+    Private->Snp.ReceiveFilters = EqosSnpReceiveFilters;
+    Private->Snp.StationAddress = EqosSnpStationAddress;
+    Private->Snp.Statistics = EqosSnpStatistics;
+    Private->Snp.MCastIpToMac = EqosSnpMCastIpToMac;
+    Private->Snp.NvData = EqosSnpNvData;
+    Private->Snp.GetStatus = EqosSnpGetStatus;
+    Private->Snp.Transmit = EqosSnpTransmit;
+    Private->Snp.Receive = EqosSnpReceive;
+    Private->Snp.Mode = Mode;
+
+    Status = gBS->CreateEvent (EVT_NOTIFY_WAIT, TPL_NOTIFY, EqosSnpWaitForPacket,
+                               Private, &Private->Snp.WaitForPacket);
+    ASSERT_EFI_ERROR (Status);
+}
@@ -17,45 +17,127 @@
 #include <Protocol/NonDiscoverableDevice.h>
 
 #include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xSata.h>
 
 #define SATA_BASE           FixedPcdGet64 (PcdSataBaseAddr)
 
-#define SATA_CAP            0x0000
-#define  SATA_CAP_SSS       BIT27
-#define SATA_GHC            0x0004
-#define  SATA_GHC_AE        BIT31
-#define  SATA_GHC_IE        BIT1
-#define  SATA_GHC_HR        BIT0
-#define SATA_PI             0x000C
-#define SATA_PIS            0x0110
-#define SATA_CMD            0x0118
-#define  SATA_CMD_FBSCP     BIT22
+#define SATA_MAX_CONTROLLERS        3
+#define SATA_RESET_TIMEOUT_US       1000000
 
-EFIAPI
-EFI_STATUS
-InitializeSataController (
+STATIC
+UINT8
+SataGetSpeedLimit (
+    IN  UINT32  Index
+    )
+{
+    switch (Index) {
+    case 0:     return FixedPcdGet8 (PcdSata0SpeedLimit);
+    case 1:     return FixedPcdGet8 (PcdSata1SpeedLimit);
+    default:    return FixedPcdGet8 (PcdSata2SpeedLimit);
+    }
+}
+
+STATIC
+UINT8
+SataGetLinkPm (
+    IN  UINT32  Index
+    )
+{
+    switch (Index) {
+    case 0:     return FixedPcdGet8 (PcdSata0LinkPm);
+    case 1:     return FixedPcdGet8 (PcdSata1LinkPm);
+    default:    return FixedPcdGet8 (PcdSata2LinkPm);
+    }
+}
+
+STATIC
+VOID
+SataResetController (
+    IN  UINT32                  Index,
     IN  EFI_PHYSICAL_ADDRESS    SataBase
     )
 {
+    UINT8 SpeedLimit = SataGetSpeedLimit (Index);
+    UINT8 LinkPm = SataGetLinkPm (Index);
+    UINT32 Cap;
+
     /* Set port implemented flag */
     MmioWrite32 (SataBase + SATA_PI, 0x1);
-    /* Supports staggered spin-up */
-    MmioOr32 (SataBase + SATA_CAP, SATA_CAP_SSS);
     /* Supports FIS-based switching */
     MmioOr32 (SataBase + SATA_CMD, SATA_CMD_FBSCP);
 
-    /* Reset controller */
-    MmioOr32 (SataBase + SATA_GHC, SATA_GHC_HR);
-    while ((MmioRead32 (SataBase + SATA_GHC) & SATA_GHC_HR) != 0) {
-        DEBUG ((DEBUG_INFO, "SATA: Waiting for reset ...\n"));
-        gBS->Stall (10000);
+    /*
+     * Advertise staggered spin-up, the speed limit and the link power
+     * states so that the OS, which sets up the port itself, sees the same
+     * restrictions as we do. These are HwInit fields and survive the reset
+     * below, but CAP may only take one write, so it's built up first.
+     */
+    Cap = MmioRead32 (SataBase + SATA_CAP);
+    Cap |= SATA_CAP_SSS;
+    if (SpeedLimit != SATA_SPEED_NO_LIMIT) {
+        Cap &= ~SATA_CAP_ISS_MASK;
+        Cap |= (UINT32)SpeedLimit << SATA_CAP_ISS_SHIFT;
     }
+    Cap &= ~(SATA_CAP_SALP | SATA_CAP_PSC | SATA_CAP_SSC);
+    if ((LinkPm & SATA_LINK_PM_PARTIAL) != 0) {
+        Cap |= SATA_CAP_PSC;
+    }
+    if ((LinkPm & SATA_LINK_PM_SLUMBER) != 0) {
+        Cap |= SATA_CAP_SSC;
+    }
+    /* Aggressive link PM needs a state to go to */
+    if ((LinkPm & SATA_LINK_PM_HIPM) != 0 && (Cap & (SATA_CAP_PSC | SATA_CAP_SSC)) != 0) {
+        Cap |= SATA_CAP_SALP;
+    }
+    MmioWrite32 (SataBase + SATA_CAP, Cap);
+
+    /* Reset controller, completion is polled by the caller */
+    MmioOr32 (SataBase + SATA_GHC, SATA_GHC_HR);
+}
+
+STATIC
+VOID
+SataRegisterController (
+    IN  UINT32                  Index,
+    IN  EFI_PHYSICAL_ADDRESS    SataBase
+    )
+{
+    EFI_STATUS Status;
+    UINT32 Cap;
+    UINT32 Sctl;
+
     MmioWrite32 (SataBase + SATA_PIS, 0xFFFFFFFF);
 
+    /*
+     * The speed limit and the allowed power state transitions take effect
+     * at the next COMRESET, which the AHCI driver issues when it spins up
+     * the port.
+     */
+    Cap = MmioRead32 (SataBase + SATA_CAP);
+    Sctl = MmioRead32 (SataBase + SATA_SCTL) & ~(SATA_SCTL_SPD_MASK | SATA_SCTL_IPM_MASK);
+    Sctl |= (UINT32)SataGetSpeedLimit (Index) << SATA_SCTL_SPD_SHIFT;
+    if ((Cap & SATA_CAP_PSC) == 0) {
+        Sctl |= SATA_SCTL_IPM_NO_PARTIAL;
+    }
+    if ((Cap & SATA_CAP_SSC) == 0) {
+        Sctl |= SATA_SCTL_IPM_NO_SLUMBER;
+    }
+    MmioWrite32 (SataBase + SATA_SCTL, Sctl);
+
     /* Enable controller */
     MmioOr32 (SataBase + SATA_GHC, SATA_GHC_AE);
 
-    return EFI_SUCCESS;
+    DEBUG ((DEBUG_INFO, "SATA%u: Registering SATA controller at 0x%08X, CAP 0x%08X SCTL 0x%08X\n",
+            Index, SataBase, Cap, Sctl));
+
+    Status = RegisterNonDiscoverableMmioDevice (
+            NonDiscoverableDeviceTypeAhci,
+            NonDiscoverableDeviceDmaTypeNonCoherent,
+            NULL,
+            NULL,
+            1,
+            SataBase, SIZE_4MB);
+    ASSERT_EFI_ERROR (Status);
 }
 
 VOID
@@ -65,34 +147,49 @@ SataEndOfDxeCallback (
     IN VOID       *Context
     )
 {
-    EFI_STATUS Status;
-    EFI_PHYSICAL_ADDRESS SataBase;
-    UINTN Index;
-    UINT32 NumSataController = PcdGet32 (PcdSataNumController);
-
-    /* Register SATA controllers */
-    for (Index = 0, SataBase = SATA_BASE;
-         Index < NumSataController;
-         Index++, SataBase += PcdGet64 (PcdSataSize)) {
-
+    EFI_PHYSICAL_ADDRESS SataBase[SATA_MAX_CONTROLLERS];
+    UINT32 Pending;
+    UINT32 Index;
+    UINTN Retry;
+    UINT32 NumSataController = MIN (PcdGet32 (PcdSataNumController), SATA_MAX_CONTROLLERS);
+
+    /*
+     * Put every enabled controller into reset at once, then register each
+     * one as soon as its reset completes, so that port spin-up and COMINIT
+     * on the controllers overlap instead of running back to back.
+     */
+    Pending = 0;
+    for (Index = 0; Index < NumSataController; Index++) {
         if ((Index == 0 && FixedPcdGet8(PcdSata0Status) == 0x0) ||
             (Index == 1 && FixedPcdGet8(PcdSata1Status) == 0x0) ||
             (Index == 2 && FixedPcdGet8(PcdSata2Status) == 0x0)) {
             continue;
         }
 
-        DEBUG ((DEBUG_INFO, "SATA: Registering SATA controller at 0x%08X\n", SataBase));
+        SataBase[Index] = SATA_BASE + Index * PcdGet64 (PcdSataSize);
+        SataResetController (Index, SataBase[Index]);
+        Pending |= 1U << Index;
+    }
+
+    for (Retry = 0; Pending != 0 && Retry < SATA_RESET_TIMEOUT_US; Retry++) {
+        for (Index = 0; Index < NumSataController; Index++) {
+            if ((Pending & (1U << Index)) == 0 ||
+                (MmioRead32 (SataBase[Index] + SATA_GHC) & SATA_GHC_HR) != 0) {
+                continue;
+            }
 
-        InitializeSataController (SataBase);
+            SataRegisterController (Index, SataBase[Index]);
+            Pending &= ~(1U << Index);
+        }
+        if (Pending != 0) {
+            MicroSecondDelay (1);
+        }
+    }
 
-        Status = RegisterNonDiscoverableMmioDevice (
-                NonDiscoverableDeviceTypeAhci,
-                NonDiscoverableDeviceDmaTypeNonCoherent,
-                NULL,
-                NULL,
-                1,
-                SataBase, SIZE_4MB);
-        ASSERT_EFI_ERROR (Status);
+    for (Index = 0; Index < NumSataController; Index++) {
+        if ((Pending & (1U << Index)) != 0) {
+            DEBUG ((DEBUG_ERROR, "SATA%u: Timeout waiting for controller reset\n", Index));
+        }
     }
 }
 
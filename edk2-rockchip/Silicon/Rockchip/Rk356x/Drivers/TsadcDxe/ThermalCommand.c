@@ -0,0 +1,158 @@
+/** @file
+ *
+ *  "thermal" shell command. Shows the TS-ADC temperatures and the state of
+ *  the thermal governor.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <Protocol/ShellDynamicCommand.h>
+
+#include "TsadcDxe.h"
+
+STATIC CONST CHAR16 mThermalCommandHelp[] =
+    L".TH thermal 0 \"Display SoC temperature and thermal throttling state.\"\r\n"
+    L".SH NAME\r\n"
+    L"Display SoC temperature and thermal throttling state.\r\n"
+    L".SH SYNOPSIS\r\n"
+    L"\r\n"
+    L"THERMAL\r\n"
+    L".SH DESCRIPTION\r\n"
+    L"\r\n"
+    L"Shows the current CPU and GPU temperatures, the CPU clock limits applied\r\n"
+    L"by the firmware thermal governor, and the most recent throttle events.\r\n";
+
+STATIC
+VOID
+PrintTemperature (
+    IN CONST CHAR16 *Label,
+    IN INT32        Temperature
+    )
+{
+    CHAR16  *Sign;
+
+    Sign = L"";
+    if (Temperature < 0) {
+        Sign = L"-";
+        Temperature = -Temperature;
+    }
+
+    Print (L"%s%s%d.%d C\n", Label, Sign, Temperature / 1000, (Temperature % 1000) / 100);
+}
+
+STATIC
+SHELL_STATUS
+EFIAPI
+ThermalCommandHandler (
+    IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+    IN EFI_SYSTEM_TABLE                     *SystemTable,
+    IN EFI_SHELL_PARAMETERS_PROTOCOL        *ShellParameters,
+    IN EFI_SHELL_PROTOCOL                   *Shell
+    )
+{
+    EFI_STATUS              Status;
+    RK356X_THERMAL_PROTOCOL *Thermal;
+    RK356X_THERMAL_STATUS   GovernorStatus;
+    RK356X_THERMAL_EVENT    *Events;
+    UINTN                   Count;
+    UINTN                   Index;
+    INT32                   Temperature;
+
+    Status = gBS->LocateProtocol (&gRk356xThermalProtocolGuid, NULL, (VOID **)&Thermal);
+    if (EFI_ERROR (Status)) {
+        Print (L"thermal: protocol not found: %r\n", Status);
+        return SHELL_NOT_FOUND;
+    }
+
+    Status = Thermal->GetTemperature (Thermal, Rk356xThermalSensorCpu, &Temperature);
+    if (EFI_ERROR (Status)) {
+        Print (L"CPU temperature:      %r\n", Status);
+    } else {
+        PrintTemperature (L"CPU temperature:      ", Temperature);
+    }
+    Status = Thermal->GetTemperature (Thermal, Rk356xThermalSensorGpu, &Temperature);
+    if (EFI_ERROR (Status)) {
+        Print (L"GPU temperature:      %r\n", Status);
+    } else {
+        PrintTemperature (L"GPU temperature:      ", Temperature);
+    }
+
+    Thermal->GetStatus (Thermal, &GovernorStatus);
+    if (GovernorStatus.SampleCount == 0) {
+        Print (L"Thermal governor:     not running\n");
+        return SHELL_SUCCESS;
+    }
+
+    PrintTemperature (L"Maximum temperature:  ", GovernorStatus.MaxTemperature);
+    PrintTemperature (L"Trip temperature:     ", GovernorStatus.TripTemperature);
+    PrintTemperature (L"Hysteresis:           ", GovernorStatus.Hysteresis);
+    Print (L"CPU clock:            %lu MHz (ceiling %lu MHz)\n",
+           GovernorStatus.CurrentRate / 1000000, GovernorStatus.CeilingRate / 1000000);
+    Print (L"Throttle level:       %u\n", GovernorStatus.ThrottleLevel);
+    Print (L"Throttle events:      %u\n", GovernorStatus.ThrottleCount);
+    Print (L"Samples:              %u\n", GovernorStatus.SampleCount);
+
+    Count = 0;
+    Status = Thermal->GetHistory (Thermal, &Count, NULL);
+    if (Status != EFI_BUFFER_TOO_SMALL) {
+        return SHELL_SUCCESS;
+    }
+
+    Events = AllocatePool (Count * sizeof (*Events));
+    if (Events == NULL) {
+        return SHELL_OUT_OF_RESOURCES;
+    }
+    Status = Thermal->GetHistory (Thermal, &Count, Events);
+    if (!EFI_ERROR (Status)) {
+        Print (L"\nRecent CPU clock changes:\n");
+        for (Index = 0; Index < Count; Index++) {
+            Temperature = Events[Index].Temperature;
+            Print (L"  %5lu.%03lu s  %3d.%d C  %4lu -> %4lu MHz\n",
+                   Events[Index].Timestamp / 1000000000,
+                   (Events[Index].Timestamp / 1000000) % 1000,
+                   Temperature / 1000, ABS (Temperature % 1000) / 100,
+                   Events[Index].OldRate / 1000000,
+                   Events[Index].NewRate / 1000000);
+        }
+    }
+    FreePool (Events);
+
+    return SHELL_SUCCESS;
+}
+
+STATIC
+CHAR16 *
+EFIAPI
+ThermalCommandGetHelp (
+    IN EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL   *This,
+    IN CONST CHAR8                          *Language
+    )
+{
+    return AllocateCopyPool (sizeof (mThermalCommandHelp), mThermalCommandHelp);
+}
+
+STATIC EFI_SHELL_DYNAMIC_COMMAND_PROTOCOL mThermalCommand = {
+    L"thermal",
+    ThermalCommandHandler,
+    ThermalCommandGetHelp
+};
+
+EFI_STATUS
+ThermalCommandInstall (
+    IN EFI_HANDLE   ImageHandle
+    )
+{
+    return gBS->InstallMultipleProtocolInterfaces (&ImageHandle,
+                                                   &gEfiShellDynamicCommandProtocolGuid,
+                                                   &mThermalCommand,
+                                                   NULL);
+}
@@ -0,0 +1,378 @@
+/** @file
+ *
+ *  Boot-time thermal governor. Samples the TS-ADC channels periodically and
+ *  steps the CPU clock down (and back up, with hysteresis) through SCMI to
+ *  keep the SoC below the trip temperature while firmware is in control.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CpuVoltageLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <Protocol/ArmScmi.h>
+#include <Protocol/ArmScmiClockProtocol.h>
+
+#include "TsadcDxe.h"
+
+#define CLOCK_ID_CLK_SCMI_CPU       0
+
+#define GOVERNOR_PERIOD             EFI_TIMER_PERIOD_MILLISECONDS (FixedPcdGet32 (PcdThermalGovernorPeriodMs))
+#define GOVERNOR_TRIP_TEMP          ((INT32)FixedPcdGet32 (PcdThermalGovernorTripTemp))
+#define GOVERNOR_HYSTERESIS         ((INT32)FixedPcdGet32 (PcdThermalGovernorHysteresis))
+
+#define THERMAL_HISTORY_SIZE        32
+
+STATIC EFI_EVENT                mGovernorTimer;
+STATIC SCMI_CLOCK_PROTOCOL      *mClockProtocol;
+STATIC UINT64                   *mCpuRates;
+STATIC UINT32                   mNumCpuRates;
+STATIC UINT32                   mCeilingIndex;
+STATIC UINT32                   mCurrentIndex;
+STATIC BOOLEAN                  mGovernorFailed;
+
+STATIC RK356X_THERMAL_STATUS    mStatus;
+STATIC RK356X_THERMAL_EVENT     mHistory[THERMAL_HISTORY_SIZE];
+STATIC UINTN                    mHistoryCount;
+STATIC UINTN                    mHistoryNext;
+
+STATIC
+EFI_STATUS
+ThermalGovernorProbeRates (
+    VOID
+    )
+{
+    EFI_STATUS              Status;
+    EFI_GUID                ClockProtocolGuid = ARM_SCMI_CLOCK_PROTOCOL_GUID;
+    UINT32                  TotalRates;
+    UINT32                  ClockRateSize;
+    SCMI_CLOCK_RATE         *ClockRate;
+    SCMI_CLOCK_RATE_FORMAT  ClockRateFormat;
+    UINT64                  CurRate;
+    UINT32                  Index;
+
+    Status = gBS->LocateProtocol (&ClockProtocolGuid, NULL, (VOID **)&mClockProtocol);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    TotalRates = 0;
+    ClockRateSize = 0;
+    Status = mClockProtocol->DescribeRates (mClockProtocol,
+                                            CLOCK_ID_CLK_SCMI_CPU,
+                                            &ClockRateFormat,
+                                            &TotalRates,
+                                            &ClockRateSize,
+                                            NULL);
+    if (Status != EFI_BUFFER_TOO_SMALL ||
+        TotalRates == 0 ||
+        ClockRateFormat != ScmiClockRateFormatDiscrete) {
+        return EFI_UNSUPPORTED;
+    }
+
+    ClockRateSize = sizeof (*ClockRate) * TotalRates;
+    ClockRate = AllocatePool (ClockRateSize);
+    if (ClockRate == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    Status = mClockProtocol->DescribeRates (mClockProtocol,
+                                            CLOCK_ID_CLK_SCMI_CPU,
+                                            &ClockRateFormat,
+                                            &TotalRates,
+                                            &ClockRateSize,
+                                            ClockRate);
+    if (EFI_ERROR (Status)) {
+        FreePool (ClockRate);
+        return Status;
+    }
+
+    mCpuRates = AllocatePool (sizeof (*mCpuRates) * TotalRates);
+    if (mCpuRates == NULL) {
+        FreePool (ClockRate);
+        return EFI_OUT_OF_RESOURCES;
+    }
+    for (Index = 0; Index < TotalRates; Index++) {
+        mCpuRates[Index] = ClockRate[Index].DiscreteRate.Rate;
+    }
+    mNumCpuRates = TotalRates;
+    FreePool (ClockRate);
+
+    Status = mClockProtocol->RateGet (mClockProtocol, CLOCK_ID_CLK_SCMI_CPU, &CurRate);
+    if (!EFI_ERROR (Status)) {
+        mStatus.CurrentRate = CurRate;
+        mStatus.CeilingRate = CurRate;
+    }
+
+    DEBUG ((DEBUG_INFO, "TSADC: Thermal governor using %u CPU rates (%lu - %lu Hz)\n",
+            mNumCpuRates, mCpuRates[0], mCpuRates[mNumCpuRates - 1]));
+
+    return EFI_SUCCESS;
+}
+
+/*
+ * Return the index of the highest supported rate that does not exceed Rate.
+ */
+STATIC
+UINT32
+ThermalGovernorRateIndex (
+    IN UINT64   Rate
+    )
+{
+    UINT32 Index;
+
+    for (Index = mNumCpuRates - 1; Index > 0; Index--) {
+        if (mCpuRates[Index] <= Rate) {
+            break;
+        }
+    }
+
+    return Index;
+}
+
+STATIC
+EFI_STATUS
+ThermalGovernorSetRate (
+    IN UINT32   NewIndex,
+    IN INT32    Temperature
+    )
+{
+    EFI_STATUS              Status;
+    UINT64                  OldRate;
+    UINT64                  NewRate;
+    RK356X_THERMAL_EVENT    *Event;
+
+    OldRate = mCpuRates[mCurrentIndex];
+    NewRate = mCpuRates[NewIndex];
+
+    if (NewRate > OldRate) {
+        Status = CpuVoltageSet (NewRate);
+        if (EFI_ERROR (Status)) {
+            return Status;
+        }
+    }
+
+    Status = mClockProtocol->RateSet (mClockProtocol, CLOCK_ID_CLK_SCMI_CPU, NewRate);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    if (NewRate < OldRate) {
+        CpuVoltageSet (NewRate);
+    }
+
+    mCurrentIndex = NewIndex;
+    mStatus.CurrentRate = NewRate;
+
+    Event = &mHistory[mHistoryNext];
+    Event->Timestamp = GetTimeInNanoSecond (GetPerformanceCounter ());
+    Event->Temperature = Temperature;
+    Event->OldRate = OldRate;
+    Event->NewRate = NewRate;
+    mHistoryNext = (mHistoryNext + 1) % THERMAL_HISTORY_SIZE;
+    if (mHistoryCount < THERMAL_HISTORY_SIZE) {
+        mHistoryCount++;
+    }
+
+    DEBUG ((DEBUG_INFO, "TSADC: %d mC, CPU clock %lu -> %lu Hz\n",
+            Temperature, OldRate, NewRate));
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+EFIAPI
+ThermalGovernorTick (
+    IN EFI_EVENT    Event,
+    IN VOID         *Context
+    )
+{
+    EFI_STATUS  Status;
+    INT32       Temperature;
+    INT32       GpuTemperature;
+    UINT64      CurRate;
+
+    Status = TsadcReadTemperature (Rk356xThermalSensorCpu, &Temperature);
+    if (EFI_ERROR (Status)) {
+        return;
+    }
+    Status = TsadcReadTemperature (Rk356xThermalSensorGpu, &GpuTemperature);
+    if (!EFI_ERROR (Status) && GpuTemperature > Temperature) {
+        Temperature = GpuTemperature;
+    }
+
+    mStatus.SampleCount++;
+    if (mStatus.SampleCount == 1 || Temperature > mStatus.MaxTemperature) {
+        mStatus.MaxTemperature = Temperature;
+    }
+
+    if (mGovernorFailed) {
+        return;
+    }
+
+    if (mCpuRates == NULL) {
+        Status = ThermalGovernorProbeRates ();
+        if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_WARN, "TSADC: CPU clock control not available: %r\n", Status));
+            mGovernorFailed = TRUE;
+            return;
+        }
+    }
+
+    if (Temperature >= GOVERNOR_TRIP_TEMP) {
+        if (mStatus.ThrottleLevel == 0) {
+            /*
+             * Not throttled yet. Whatever the CPU is running at now (the
+             * default or the user's choice from setup) is the ceiling we
+             * return to once things cool down.
+             */
+            Status = mClockProtocol->RateGet (mClockProtocol, CLOCK_ID_CLK_SCMI_CPU, &CurRate);
+            if (EFI_ERROR (Status)) {
+                return;
+            }
+            mCeilingIndex = ThermalGovernorRateIndex (CurRate);
+            mCurrentIndex = mCeilingIndex;
+            mStatus.CeilingRate = mCpuRates[mCeilingIndex];
+            mStatus.CurrentRate = CurRate;
+        }
+        if (mCurrentIndex > 0) {
+            Status = ThermalGovernorSetRate (mCurrentIndex - 1, Temperature);
+            if (!EFI_ERROR (Status)) {
+                mStatus.ThrottleLevel++;
+                mStatus.ThrottleCount++;
+            }
+        }
+    } else if (mStatus.ThrottleLevel > 0 &&
+               Temperature < GOVERNOR_TRIP_TEMP - GOVERNOR_HYSTERESIS) {
+        Status = ThermalGovernorSetRate (mCurrentIndex + 1, Temperature);
+        if (!EFI_ERROR (Status)) {
+            mStatus.ThrottleLevel--;
+        }
+    }
+}
+
+STATIC
+VOID
+EFIAPI
+ThermalGovernorStart (
+    IN EFI_EVENT    Event,
+    IN VOID         *Context
+    )
+{
+    EFI_STATUS  Status;
+
+    gBS->CloseEvent (Event);
+
+    Status = gBS->SetTimer (mGovernorTimer, TimerPeriodic, GOVERNOR_PERIOD);
+    ASSERT_EFI_ERROR (Status);
+}
+
+STATIC
+VOID
+EFIAPI
+ThermalGovernorStop (
+    IN EFI_EVENT    Event,
+    IN VOID         *Context
+    )
+{
+    gBS->SetTimer (mGovernorTimer, TimerCancel, 0);
+}
+
+VOID
+ThermalGovernorGetStatus (
+    OUT RK356X_THERMAL_STATUS   *Status
+    )
+{
+    EFI_TPL OldTpl;
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    CopyMem (Status, &mStatus, sizeof (*Status));
+    gBS->RestoreTPL (OldTpl);
+}
+
+EFI_STATUS
+ThermalGovernorGetHistory (
+    IN OUT UINTN                *Count,
+    OUT    RK356X_THERMAL_EVENT *Events OPTIONAL
+    )
+{
+    EFI_TPL OldTpl;
+    UINTN   Index;
+    UINTN   Slot;
+
+    if (Count == NULL || (Events == NULL && *Count != 0)) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+    if (*Count < mHistoryCount) {
+        *Count = mHistoryCount;
+        gBS->RestoreTPL (OldTpl);
+        return EFI_BUFFER_TOO_SMALL;
+    }
+
+    Slot = mHistoryNext;
+    for (Index = 0; Index < mHistoryCount; Index++) {
+        Slot = (Slot + THERMAL_HISTORY_SIZE - 1) % THERMAL_HISTORY_SIZE;
+        CopyMem (&Events[Index], &mHistory[Slot], sizeof (Events[Index]));
+    }
+    *Count = mHistoryCount;
+
+    gBS->RestoreTPL (OldTpl);
+
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS
+ThermalGovernorInit (
+    VOID
+    )
+{
+    EFI_STATUS  Status;
+    EFI_EVENT   Event;
+
+    mStatus.TripTemperature = GOVERNOR_TRIP_TEMP;
+    mStatus.Hysteresis = GOVERNOR_HYSTERESIS;
+
+    Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_CALLBACK,
+                               ThermalGovernorTick, NULL, &mGovernorTimer);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    /*
+     * Don't touch the CPU clock until all drivers have been dispatched, so
+     * that the ceiling is the setting ConfigDxe applies from its entry
+     * point. This does not make the tick safe against other SCMI or
+     * regulator users: RkMtlLib and CpuVoltageLib raise the TPL around each
+     * mailbox and I2C transaction, and SCMI callers that run after
+     * EndOfDxe (the dmc and membench shell commands) raise to TPL_CALLBACK
+     * around each request so that this timer can't land in the middle.
+     */
+    Status = gBS->CreateEventEx (EVT_NOTIFY_SIGNAL, TPL_CALLBACK,
+                                 ThermalGovernorStart, NULL,
+                                 &gEfiEndOfDxeEventGroupGuid, &Event);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_CALLBACK,
+                               ThermalGovernorStop, NULL, &Event);
+    if (EFI_ERROR (Status)) {
+        return Status;
+    }
+
+    DEBUG ((DEBUG_INFO, "TSADC: Thermal governor trip %d mC, hysteresis %d mC\n",
+            GOVERNOR_TRIP_TEMP, GOVERNOR_HYSTERESIS));
+
+    return EFI_SUCCESS;
+}
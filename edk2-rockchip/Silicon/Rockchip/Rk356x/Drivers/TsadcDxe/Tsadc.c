@@ -14,6 +14,8 @@
 
 #include <IndustryStandard/Rk356x.h>
 
+#include "TsadcDxe.h"
+
 /* SYS_GRF */
 #define GRF_TSADC_CON               (SYS_GRF + 0x0600)
 #define  TSADC_ANA_REG(n)           (1U << (n))
@@ -27,11 +29,107 @@
 #define  TSADC_Q_SEL                BIT1
 #define  SRC0_EN                    BIT4
 #define  SRC1_EN                    BIT5
+#define TSADC_DATA(n)               (TSADC_BASE + 0x0020 + (n) * 0x4)
+#define  TSADC_DATA_MASK            0xFFF
 #define TSADC_HIGHT_INT_DEBOUNCE    (TSADC_BASE + 0x0060)
 #define TSADC_HIGHT_TSHUT_DEBOUNCE  (TSADC_BASE + 0x0064)
 #define TSADC_AUTO_PERIOD           (TSADC_BASE + 0x0068)
 #define TSADC_AUTO_PERIOD_HT        (TSADC_BASE + 0x006C)
 
+/* Data code table. Each entry represents a 5 degC step, starting at -40 degC */
+STATIC CONST UINT32 mTsadcCodeTable[] = {
+    1584, 1620, 1652, 1688, 1720, 1756, 1788, 1824, 1856, 1892, 1924, 1956,
+    1992, 2024, 2060, 2092, 2128, 2160, 2196, 2228, 2264, 2300, 2332, 2368,
+    2400, 2436, 2468, 2500, 2536, 2572, 2604, 2636, 2672, 2704
+};
+#define TSADC_TABLE_MIN_TEMP        (-40000)
+#define TSADC_TABLE_STEP            5000
+
+EFI_STATUS
+TsadcReadTemperature (
+    IN  RK356X_THERMAL_SENSOR   Sensor,
+    OUT INT32                   *Temperature
+    )
+{
+    UINT32 Code;
+    UINT32 Index;
+    UINT32 Prev;
+
+    if (Sensor >= Rk356xThermalSensorMax || Temperature == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    Code = MmioRead32 (TSADC_DATA (Sensor)) & TSADC_DATA_MASK;
+    if (Code == 0) {
+        return EFI_NOT_READY;
+    }
+
+    /* Clamp to the range of the table */
+    if (Code <= mTsadcCodeTable[0]) {
+        *Temperature = TSADC_TABLE_MIN_TEMP;
+        return EFI_SUCCESS;
+    }
+
+    for (Index = 1; Index < ARRAY_SIZE (mTsadcCodeTable); Index++) {
+        if (Code <= mTsadcCodeTable[Index]) {
+            Prev = mTsadcCodeTable[Index - 1];
+            *Temperature = TSADC_TABLE_MIN_TEMP + (INT32)(Index - 1) * TSADC_TABLE_STEP +
+                           (INT32)((Code - Prev) * TSADC_TABLE_STEP / (mTsadcCodeTable[Index] - Prev));
+            return EFI_SUCCESS;
+        }
+    }
+
+    *Temperature = TSADC_TABLE_MIN_TEMP + (INT32)(ARRAY_SIZE (mTsadcCodeTable) - 1) * TSADC_TABLE_STEP;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+ThermalGetTemperature (
+    IN  RK356X_THERMAL_PROTOCOL *This,
+    IN  RK356X_THERMAL_SENSOR   Sensor,
+    OUT INT32                   *Temperature
+    )
+{
+    return TsadcReadTemperature (Sensor, Temperature);
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+ThermalGetStatus (
+    IN  RK356X_THERMAL_PROTOCOL *This,
+    OUT RK356X_THERMAL_STATUS   *Status
+    )
+{
+    if (Status == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    ThermalGovernorGetStatus (Status);
+
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+ThermalGetHistory (
+    IN     RK356X_THERMAL_PROTOCOL  *This,
+    IN OUT UINTN                    *Count,
+    OUT    RK356X_THERMAL_EVENT     *Events OPTIONAL
+    )
+{
+    return ThermalGovernorGetHistory (Count, Events);
+}
+
+STATIC RK356X_THERMAL_PROTOCOL mThermalProtocol = {
+    ThermalGetTemperature,
+    ThermalGetStatus,
+    ThermalGetHistory
+};
+
 EFI_STATUS
 EFIAPI
 InitializeTsadc (
@@ -39,6 +137,7 @@ InitializeTsadc (
     IN EFI_SYSTEM_TABLE      *SystemTable
     )
 {
+    EFI_STATUS Status;
     UINT32 Index;
 
     MmioWrite32 (TSADC_USER_CON, 0x3F << INTER_PD_SOC_SHIFT);
@@ -58,5 +157,26 @@ InitializeTsadc (
     MmioOr32 (TSADC_AUTO_CON, AUTO_EN | TSADC_Q_SEL);
     MicroSecondDelay (100);
 
+    Status = gBS->InstallMultipleProtocolInterfaces (&ImageHandle,
+                                                     &gRk356xThermalProtocolGuid,
+                                                     &mThermalProtocol,
+                                                     NULL);
+    if (EFI_ERROR (Status)) {
+        ASSERT_EFI_ERROR (Status);
+        return Status;
+    }
+
+    if (FixedPcdGetBool (PcdThermalGovernorEnable)) {
+        Status = ThermalGovernorInit ();
+        if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_WARN, "TSADC: Failed to start thermal governor: %r\n", Status));
+        }
+    }
+
+    Status = ThermalCommandInstall (ImageHandle);
+    if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_WARN, "TSADC: Failed to install shell command: %r\n", Status));
+    }
+
     return EFI_SUCCESS;
 }
\ No newline at end of file
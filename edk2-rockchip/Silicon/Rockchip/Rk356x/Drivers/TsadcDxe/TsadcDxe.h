@@ -0,0 +1,42 @@
+/** @file
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef TSADCDXE_H__
+#define TSADCDXE_H__
+
+#include <Uefi.h>
+#include <Protocol/Rk356xThermal.h>
+
+EFI_STATUS
+TsadcReadTemperature (
+    IN  RK356X_THERMAL_SENSOR   Sensor,
+    OUT INT32                   *Temperature
+    );
+
+EFI_STATUS
+ThermalGovernorInit (
+    VOID
+    );
+
+VOID
+ThermalGovernorGetStatus (
+    OUT RK356X_THERMAL_STATUS   *Status
+    );
+
+EFI_STATUS
+ThermalGovernorGetHistory (
+    IN OUT UINTN                *Count,
+    OUT    RK356X_THERMAL_EVENT *Events OPTIONAL
+    );
+
+EFI_STATUS
+ThermalCommandInstall (
+    IN EFI_HANDLE               ImageHandle
+    );
+
+#endif /* TSADCDXE_H__ */
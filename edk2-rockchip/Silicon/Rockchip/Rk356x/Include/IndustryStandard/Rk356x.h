@@ -25,6 +25,7 @@
 #define I2C0_BASE           0xFDD40000UL
 #define UART_BASE(n)        ((n) == 0 ? 0xFDD50000UL : (0xFE650000UL + ((n) - 1) * 0x10000))
 #define GPIO_BASE(n)        ((n) == 0 ? 0xFDD60000UL : (0xFE740000UL + ((n) - 1) * 0x10000))
+#define PWM_BASE(n)         ((n) == 0 ? 0xFDD70000UL : (0xFE6E0000UL + ((n) - 1) * 0x10000))
 #define PMU_BASE            0xFDD90000UL
 #define GMAC1_BASE          0xFE010000UL
 #define VOP_BASE            0xFE040000UL
@@ -33,6 +34,7 @@
 #define PCIE3X1_APB_BASE    0xFE270000UL
 #define PCIE3X2_APB_BASE    0xFE280000UL
 #define GMAC0_BASE          0xFE2A0000UL
+#define CRYPTO_BASE         0xFE380000UL
 #define TRNG_BASE           0xFE388000UL
 #define OTP_BASE            0xFE38C000UL
 #define TSADC_BASE          0xFE710000UL
@@ -72,14 +72,44 @@
 #define CRU_CLKSEL_CON30_CLK_SDMMC0_SEL_SHIFT    8
 #define CRU_CLKSEL_CON30_CLK_SDMMC0_SEL_MASK     (0x7U << CRU_CLKSEL_CON30_CLK_SDMMC0_SEL_SHIFT)
 
+/* CLKSEL_CON31 (GMAC0) and CLKSEL_CON33 (GMAC1) fields */
+#define CRU_CLKSEL_GMAC_CON(n)                   (31 + (n) * 2)
+#define CRU_CLKSEL_GMAC_RGMII_SPEED_SHIFT        4
+#define CRU_CLKSEL_GMAC_RGMII_SPEED_MASK         (0x3U << CRU_CLKSEL_GMAC_RGMII_SPEED_SHIFT)
+#define CRU_CLKSEL_GMAC_RGMII_SPEED_125M         0
+#define CRU_CLKSEL_GMAC_RGMII_SPEED_2_5M         2
+#define CRU_CLKSEL_GMAC_RGMII_SPEED_25M          3
+
 /* CLKSEL_CON32 fields */
 #define CRU_CLKSEL_CON32_CLK_SDMMC2_SEL_SHIFT    8
 #define CRU_CLKSEL_CON32_CLK_SDMMC2_SEL_MASK     (0x7U << CRU_CLKSEL_CON32_CLK_SDMMC2_SEL_SHIFT)
 
+/* CLKSEL_CON52-69 fields, a source/mux and a fractional divider register per UART1-9 */
+#define CRU_CLKSEL_UART_SRC_CON(n)               (52 + ((n) - 1) * 2)
+#define CRU_CLKSEL_UART_FRAC_CON(n)              (53 + ((n) - 1) * 2)
+#define CRU_CLKSEL_UART_SEL_SHIFT                12
+#define CRU_CLKSEL_UART_SEL_MASK                 (0x3U << CRU_CLKSEL_UART_SEL_SHIFT)
+#define CRU_CLKSEL_UART_SEL_SRC                  0
+#define CRU_CLKSEL_UART_SEL_FRAC                 1
+#define CRU_CLKSEL_UART_SEL_XIN24M               2
+#define CRU_CLKSEL_UART_SRC_SEL_SHIFT            8
+#define CRU_CLKSEL_UART_SRC_SEL_MASK             (0x3U << CRU_CLKSEL_UART_SRC_SEL_SHIFT)
+#define CRU_CLKSEL_UART_SRC_SEL_GPLL             0
+#define CRU_CLKSEL_UART_SRC_DIV_MASK             0x7fU
+#define CRU_CLKSEL_UART_FRAC_NUM_SHIFT           16
+#define CRU_CLKSEL_UART_FRAC_DEN_MASK            0xffffU
+
 
 /* GATE registers */
 #define CRU_GATE_CON(n)     (CRU_BASE + (n) * 0x4 + 0x0300)
 
+/* GATE_CON10-12 fields, pclk, src, frac and sclk gates per UART1-9 */
+#define CRU_GATE_UART_SRC(n)        (3 + ((n) - 1) * 4)
+#define CRU_GATE_UART_FRAC(n)       (4 + ((n) - 1) * 4)
+#define CRU_GATE_UART_SCLK(n)       (5 + ((n) - 1) * 4)
+#define CRU_GATE_UART_CON(g)        (10 + (g) / 16)
+#define CRU_GATE_UART_BIT(g)        ((g) % 16)
+
 /* SOFTRST registers */
 #define CRU_SOFTRST_CON(n)  (CRU_BASE + (n) * 0x4 + 0x0400)
 
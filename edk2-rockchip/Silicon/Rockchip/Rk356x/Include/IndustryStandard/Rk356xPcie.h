@@ -0,0 +1,30 @@
+/** @file
+ *
+ *  RK356x PCIe memory window layout.
+ *
+ *  The 32-bit and 64-bit PCI MMIO windows are each split in two. The
+ *  prefetchable part at the bottom of the window keeps the natural
+ *  alignment of the window base, so large prefetchable BARs fit, and is
+ *  mapped Normal Non-cacheable so that CPU writes to it can be merged.
+ *  The non-prefetchable rest of the window is mapped as Device memory.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef RK356XPCIE_H__
+#define RK356XPCIE_H__
+
+#define PCIE_PMEM32_BASE    ((UINT64)FixedPcdGet32 (PcdPciMmio32Base))
+#define PCIE_PMEM32_SIZE    ((UINT64)FixedPcdGet32 (PcdPciPrefetchMmio32Size))
+#define PCIE_MEM32_BASE     (PCIE_PMEM32_BASE + PCIE_PMEM32_SIZE)
+#define PCIE_MEM32_SIZE     ((UINT64)FixedPcdGet32 (PcdPciMmio32Size) - PCIE_PMEM32_SIZE)
+
+#define PCIE_PMEM64_BASE    FixedPcdGet64 (PcdPciMmio64Base)
+#define PCIE_PMEM64_SIZE    FixedPcdGet64 (PcdPciPrefetchMmio64Size)
+#define PCIE_MEM64_BASE     (PCIE_PMEM64_BASE + PCIE_PMEM64_SIZE)
+#define PCIE_MEM64_SIZE     (FixedPcdGet64 (PcdPciMmio64Size) - PCIE_PMEM64_SIZE)
+
+#endif /* RK356XPCIE_H__ */
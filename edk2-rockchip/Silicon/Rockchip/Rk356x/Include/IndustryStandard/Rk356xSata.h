@@ -0,0 +1,97 @@
+/** @file
+ *
+ *  RK356x AHCI controller registers. Each controller implements a single
+ *  port, so only the port 0 registers are described.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *  Copyright (c) 2022-2023, Jared McNeill <jmcneill@invisible.ca>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef RK356XSATA_H__
+#define RK356XSATA_H__
+
+#define SATA_CAP                0x0000
+#define  SATA_CAP_S64A          BIT31
+#define  SATA_CAP_SNCQ          BIT30
+#define  SATA_CAP_SSS           BIT27
+#define  SATA_CAP_SALP          BIT26
+#define  SATA_CAP_ISS_SHIFT     20
+#define  SATA_CAP_ISS_MASK      (0xFU << SATA_CAP_ISS_SHIFT)
+#define  SATA_CAP_SSC           BIT14
+#define  SATA_CAP_PSC           BIT13
+#define  SATA_CAP_NCS_SHIFT     8
+#define  SATA_CAP_NCS_MASK      (0x1FU << SATA_CAP_NCS_SHIFT)
+#define SATA_GHC                0x0004
+#define  SATA_GHC_AE            BIT31
+#define  SATA_GHC_IE            BIT1
+#define  SATA_GHC_HR            BIT0
+#define SATA_PI                 0x000C
+#define SATA_CLB                0x0100
+#define SATA_CLBU               0x0104
+#define SATA_FB                 0x0108
+#define SATA_FBU                0x010C
+#define SATA_PIS                0x0110
+#define  SATA_PIS_TFES          BIT30
+#define  SATA_PIS_HBFS          BIT29
+#define  SATA_PIS_HBDS          BIT28
+#define  SATA_PIS_IFS           BIT27
+#define  SATA_PIS_OFS           BIT24
+#define  SATA_PIS_ERRORS        (SATA_PIS_TFES | SATA_PIS_HBFS | SATA_PIS_HBDS | \
+                                 SATA_PIS_IFS | SATA_PIS_OFS)
+#define SATA_PIE                0x0114
+#define SATA_CMD                0x0118
+#define  SATA_CMD_FBSCP         BIT22
+#define  SATA_CMD_CR            BIT15
+#define  SATA_CMD_FR            BIT14
+#define  SATA_CMD_FRE           BIT4
+#define  SATA_CMD_CLO           BIT3
+#define  SATA_CMD_POD           BIT2
+#define  SATA_CMD_SUD           BIT1
+#define  SATA_CMD_ST            BIT0
+#define SATA_TFD                0x0120
+#define  SATA_TFD_BSY           BIT7
+#define  SATA_TFD_DRQ           BIT3
+#define  SATA_TFD_ERR           BIT0
+#define SATA_SIG                0x0124
+#define  SATA_SIG_ATA           0x00000101
+#define SATA_SSTS               0x0128
+#define  SATA_SSTS_IPM_SHIFT    8
+#define  SATA_SSTS_IPM_MASK     (0xFU << SATA_SSTS_IPM_SHIFT)
+#define  SATA_SSTS_IPM_ACTIVE   1
+#define  SATA_SSTS_IPM_PARTIAL  2
+#define  SATA_SSTS_IPM_SLUMBER  6
+#define  SATA_SSTS_IPM_DEVSLEEP 8
+#define  SATA_SSTS_SPD_SHIFT    4
+#define  SATA_SSTS_SPD_MASK     (0xFU << SATA_SSTS_SPD_SHIFT)
+#define  SATA_SSTS_DET_MASK     0xFU
+#define  SATA_SSTS_DET_PRESENT  1
+#define  SATA_SSTS_DET_PHY      3
+#define  SATA_SSTS_DET_OFFLINE  4
+#define SATA_SCTL               0x012C
+#define  SATA_SCTL_IPM_SHIFT    8
+#define  SATA_SCTL_IPM_MASK     (0xFU << SATA_SCTL_IPM_SHIFT)
+#define  SATA_SCTL_IPM_NO_PARTIAL   BIT8
+#define  SATA_SCTL_IPM_NO_SLUMBER   BIT9
+#define  SATA_SCTL_SPD_SHIFT    4
+#define  SATA_SCTL_SPD_MASK     (0xFU << SATA_SCTL_SPD_SHIFT)
+#define  SATA_SCTL_DET_MASK     0xFU
+#define  SATA_SCTL_DET_COMRESET 1
+#define SATA_SERR               0x0130
+#define SATA_SACT               0x0134
+#define SATA_CI                 0x0138
+
+/* PcdSata<n>SpeedLimit */
+#define SATA_SPEED_NO_LIMIT     0
+#define SATA_SPEED_GEN1         1
+#define SATA_SPEED_GEN2         2
+#define SATA_SPEED_GEN3         3
+
+/* PcdSata<n>LinkPm */
+#define SATA_LINK_PM_HIPM       BIT0
+#define SATA_LINK_PM_PARTIAL    BIT1
+#define SATA_LINK_PM_SLUMBER    BIT2
+
+#endif /* RK356XSATA_H__ */
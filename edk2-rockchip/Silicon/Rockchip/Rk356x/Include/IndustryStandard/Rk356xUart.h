@@ -0,0 +1,81 @@
+/** @file
+ *
+ *  Synopsys DesignWare APB UART registers, as found on RK356x.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef RK356XUART_H__
+#define RK356XUART_H__
+
+/* UART index from a UART_BASE() address */
+#define UART_INDEX(Base)    ((Base) == UART_BASE (0) ? 0 : ((Base) - UART_BASE (1)) / 0x10000 + 1)
+
+/* GIC interrupt ID, UART0-9 are SPIs 116-125 */
+#define UART_IRQ(n)         (148 + (n))
+
+#define UART_FIFO_DEPTH     64
+
+/* Registers */
+#define UART_RBR            0x00
+#define UART_THR            0x00
+#define UART_DLL            0x00
+#define UART_IER            0x04
+#define UART_DLH            0x04
+#define UART_IIR            0x08
+#define UART_FCR            0x08
+#define UART_LCR            0x0C
+#define UART_MCR            0x10
+#define UART_LSR            0x14
+#define UART_MSR            0x18
+#define UART_SCR            0x1C
+#define UART_USR            0x7C
+
+/* IER fields */
+#define UART_IER_ERBFI      BIT0
+#define UART_IER_ETBEI      BIT1
+
+/* IIR fields */
+#define UART_IIR_IID_MASK   0xFU
+#define UART_IIR_IID_NONE   0x1U
+#define UART_IIR_IID_THRE   0x2U
+#define UART_IIR_IID_BUSY   0x7U
+#define UART_IIR_FIFOSE     (BIT7 | BIT6)
+
+/* FCR fields */
+#define UART_FCR_FIFOE      BIT0
+#define UART_FCR_RFIFOR     BIT1
+#define UART_FCR_XFIFOR     BIT2
+
+/* LCR fields */
+#define UART_LCR_DLS_MASK   0x3U
+#define UART_LCR_STOP       BIT2
+#define UART_LCR_PEN        BIT3
+#define UART_LCR_EPS        BIT4
+#define UART_LCR_SP         BIT5
+#define UART_LCR_DLAB       BIT7
+
+/* MCR fields */
+#define UART_MCR_DTR        BIT0
+#define UART_MCR_RTS        BIT1
+#define UART_MCR_LOOPBACK   BIT4
+
+/* LSR fields */
+#define UART_LSR_DR         BIT0
+#define UART_LSR_THRE       BIT5
+#define UART_LSR_TEMT       BIT6
+
+/* MSR fields */
+#define UART_MSR_CTS        BIT4
+#define UART_MSR_DSR        BIT5
+#define UART_MSR_RI         BIT6
+#define UART_MSR_DCD        BIT7
+
+/* USR fields */
+#define UART_USR_BUSY       BIT0
+#define UART_USR_TFNF       BIT1
+
+#endif /* RK356XUART_H__ */
@@ -0,0 +1,47 @@
+/** @file
+ *
+ *  Transmit ring interfaces of the DXE DwUartSerialPortLib instance, used by
+ *  the driver that drains the ring from the UART interrupt.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef DWUARTSERIALPORTLIB_H__
+#define DWUARTSERIALPORTLIB_H__
+
+/**
+  Start buffering SerialPortWrite () output in the transmit ring. The caller
+  must be ready to call DwUartTxRingInterrupt () from the UART interrupt.
+
+  @retval RETURN_SUCCESS           The ring is in use.
+  @retval RETURN_BUFFER_TOO_SMALL  PcdUartTxRingSize leaves no room for data.
+**/
+RETURN_STATUS
+EFIAPI
+DwUartTxRingStart (
+  VOID
+  );
+
+/**
+  Send everything still in the ring and go back to polled output.
+**/
+VOID
+EFIAPI
+DwUartTxRingStop (
+  VOID
+  );
+
+/**
+  Refill the transmit FIFO from the ring. Called with interrupts disabled from
+  the UART interrupt handler.
+**/
+VOID
+EFIAPI
+DwUartTxRingInterrupt (
+  VOID
+  );
+
+#endif /* DWUARTSERIALPORTLIB_H__ */
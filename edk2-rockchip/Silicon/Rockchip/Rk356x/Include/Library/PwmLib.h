@@ -0,0 +1,37 @@
+/** @file
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef PWMLIB_H__
+#define PWMLIB_H__
+
+#define PWM_NCONTROLLERS    4
+#define PWM_NCHANNELS       4
+
+EFI_STATUS
+PwmConfigure (
+  IN UINT8   Controller,
+  IN UINT8   Channel,
+  IN UINT32  PeriodNs,
+  IN UINT32  DutyNs,
+  IN BOOLEAN Inverted
+  );
+
+EFI_STATUS
+PwmSetDuty (
+  IN UINT8   Controller,
+  IN UINT8   Channel,
+  IN UINT32  DutyNs
+  );
+
+VOID
+PwmDisable (
+  IN UINT8   Controller,
+  IN UINT8   Channel
+  );
+
+#endif /* PWMLIB_H__ */
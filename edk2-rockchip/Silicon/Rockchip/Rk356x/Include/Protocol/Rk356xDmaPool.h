@@ -0,0 +1,86 @@
+/** @file
+ *
+ *  RK356x uncached DMA pool protocol.
+ *
+ *  Hands out small blocks of memory from a region that is mapped
+ *  Normal Non-cacheable once, at boot, so that descriptor rings and other
+ *  structures shared with non-coherent DMA masters never need cache
+ *  maintenance and never cost a page table split per allocation.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef RK356X_DMA_POOL_H__
+#define RK356X_DMA_POOL_H__
+
+#define RK356X_DMA_POOL_PROTOCOL_GUID \
+  { 0x2C8E1D47, 0x6A3B, 0x4F05, { 0xB1, 0x9E, 0x73, 0x0D, 0x5C, 0x42, 0xE8, 0x19 } }
+
+typedef struct _RK356X_DMA_POOL_PROTOCOL RK356X_DMA_POOL_PROTOCOL;
+
+/**
+  Allocate a zeroed block of uncached memory below 4 GiB.
+
+  Requests up to 2 KiB are served from power of two size classes starting
+  at 32 bytes, and blocks are aligned to their size class. Larger requests
+  are served in whole pages.
+
+  The block is Normal Non-cacheable memory. Use MemoryFence () where the
+  order of two accesses to it matters, such as before handing a descriptor
+  to the device by setting its ownership bit; IoLib MMIO accesses already
+  order themselves against it.
+
+  @param[in]  This            Protocol instance.
+  @param[in]  Size            Number of bytes to allocate.
+  @param[in]  Alignment       Required alignment in bytes, a power of two,
+                              or 0 for the natural alignment of the block.
+  @param[out] HostAddress     CPU address of the block.
+  @param[out] DeviceAddress   Bus master address of the block.
+
+  @retval EFI_SUCCESS           The block was allocated.
+  @retval EFI_INVALID_PARAMETER Size is 0, Alignment is not a power of two,
+                                or an output pointer is NULL.
+  @retval EFI_OUT_OF_RESOURCES  The pool is exhausted.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *RK356X_DMA_POOL_ALLOCATE) (
+  IN  RK356X_DMA_POOL_PROTOCOL  *This,
+  IN  UINTN                     Size,
+  IN  UINTN                     Alignment,
+  OUT VOID                      **HostAddress,
+  OUT EFI_PHYSICAL_ADDRESS      *DeviceAddress
+  );
+
+/**
+  Return a block to the pool.
+
+  @param[in]  This            Protocol instance.
+  @param[in]  HostAddress     CPU address returned by Allocate ().
+  @param[in]  Size            Size passed to Allocate ().
+  @param[in]  Alignment       Alignment passed to Allocate ().
+
+  @retval EFI_SUCCESS           The block was freed.
+  @retval EFI_INVALID_PARAMETER The block was not allocated from the pool
+                                with this size and alignment.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *RK356X_DMA_POOL_FREE) (
+  IN  RK356X_DMA_POOL_PROTOCOL  *This,
+  IN  VOID                      *HostAddress,
+  IN  UINTN                     Size,
+  IN  UINTN                     Alignment
+  );
+
+struct _RK356X_DMA_POOL_PROTOCOL {
+  RK356X_DMA_POOL_ALLOCATE      Allocate;
+  RK356X_DMA_POOL_FREE          Free;
+};
+
+extern EFI_GUID gRk356xDmaPoolProtocolGuid;
+
+#endif /* RK356X_DMA_POOL_H__ */
@@ -0,0 +1,115 @@
+/** @file
+ *
+ *  RK356x thermal sensor and governor protocol.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef RK356X_THERMAL_H__
+#define RK356X_THERMAL_H__
+
+#define RK356X_THERMAL_PROTOCOL_GUID \
+  { 0x6B3D9B0E, 0x1C4A, 0x4E8F, { 0x9A, 0x37, 0x5D, 0x2E, 0x81, 0xC0, 0x4F, 0x6A } }
+
+typedef struct _RK356X_THERMAL_PROTOCOL RK356X_THERMAL_PROTOCOL;
+
+typedef enum {
+  Rk356xThermalSensorCpu = 0,
+  Rk356xThermalSensorGpu,
+  Rk356xThermalSensorMax
+} RK356X_THERMAL_SENSOR;
+
+//
+// Governor state. Temperatures are in millidegrees Celsius.
+//
+typedef struct {
+  INT32     TripTemperature;      // Throttle when above this temperature
+  INT32     Hysteresis;           // Unthrottle when below Trip - Hysteresis
+  INT32     MaxTemperature;       // Highest temperature seen so far
+  UINT32    ThrottleLevel;        // Number of rate steps below the ceiling
+  UINT64    CurrentRate;          // CPU clock rate in Hz (0 if not known yet)
+  UINT64    CeilingRate;          // CPU clock rate in Hz when not throttled
+  UINT32    ThrottleCount;        // Number of step down events
+  UINT32    SampleCount;          // Number of temperature samples taken
+} RK356X_THERMAL_STATUS;
+
+//
+// A single CPU clock change made by the governor.
+//
+typedef struct {
+  UINT64    Timestamp;            // Nanoseconds since the timer started
+  INT32     Temperature;          // Temperature that triggered the change
+  UINT64    OldRate;              // CPU clock rate in Hz before
+  UINT64    NewRate;              // CPU clock rate in Hz after
+} RK356X_THERMAL_EVENT;
+
+/**
+  Read the current temperature of a sensor.
+
+  @param[in]  This            Protocol instance.
+  @param[in]  Sensor          Sensor to read.
+  @param[out] Temperature     Temperature in millidegrees Celsius.
+
+  @retval EFI_SUCCESS           The temperature was read.
+  @retval EFI_INVALID_PARAMETER Sensor or Temperature is invalid.
+  @retval EFI_NOT_READY         The sensor has not produced a valid sample.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *RK356X_THERMAL_GET_TEMPERATURE) (
+  IN  RK356X_THERMAL_PROTOCOL   *This,
+  IN  RK356X_THERMAL_SENSOR     Sensor,
+  OUT INT32                     *Temperature
+  );
+
+/**
+  Return the current governor state.
+
+  @param[in]  This            Protocol instance.
+  @param[out] Status          Governor state.
+
+  @retval EFI_SUCCESS           The state was returned.
+  @retval EFI_INVALID_PARAMETER Status is NULL.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *RK356X_THERMAL_GET_STATUS) (
+  IN  RK356X_THERMAL_PROTOCOL   *This,
+  OUT RK356X_THERMAL_STATUS     *Status
+  );
+
+/**
+  Return the most recent throttle events, newest first.
+
+  @param[in]      This        Protocol instance.
+  @param[in, out] Count       On input, the number of entries in Events.
+                              On output, the number of entries returned, or
+                              the number of entries available if the buffer
+                              is too small.
+  @param[out]     Events      Buffer for the events.
+
+  @retval EFI_SUCCESS           The events were returned.
+  @retval EFI_BUFFER_TOO_SMALL  Events is too small; Count has been updated.
+  @retval EFI_INVALID_PARAMETER Count is NULL, or Events is NULL and
+                                *Count is not zero.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *RK356X_THERMAL_GET_HISTORY) (
+  IN     RK356X_THERMAL_PROTOCOL  *This,
+  IN OUT UINTN                    *Count,
+  OUT    RK356X_THERMAL_EVENT     *Events OPTIONAL
+  );
+
+struct _RK356X_THERMAL_PROTOCOL {
+  RK356X_THERMAL_GET_TEMPERATURE  GetTemperature;
+  RK356X_THERMAL_GET_STATUS       GetStatus;
+  RK356X_THERMAL_GET_HISTORY      GetHistory;
+};
+
+extern EFI_GUID gRk356xThermalProtocolGuid;
+
+#endif /* RK356X_THERMAL_H__ */
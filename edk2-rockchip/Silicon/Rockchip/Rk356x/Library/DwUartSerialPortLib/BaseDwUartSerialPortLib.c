@@ -0,0 +1,91 @@
+/** @file
+ *
+ *  RK3566/RK3568 DesignWare APB UART serial port library, polled instance
+ *  for the phases before DXE.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/IoLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SerialPortLib.h>
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xUart.h>
+
+#include "DwUartSerialPortLibInternal.h"
+
+VOID
+DwUartFlush (
+    VOID
+    )
+{
+    DwUartWaitForTransmitter ();
+}
+
+BOOLEAN
+DwUartTxEmpty (
+    VOID
+    )
+{
+    return (MmioRead32 (DW_UART_REG (UART_LSR)) & UART_LSR_TEMT) != 0;
+}
+
+/**
+  Initialize the serial device hardware.
+
+  Always programs the UART, so that whatever an earlier boot stage left behind
+  isn't mistaken for our own settings by the DXE instance.
+
+  @retval RETURN_SUCCESS        The serial device was initialized.
+  @retval RETURN_DEVICE_ERROR   The serial device could not be initialized.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortInitialize (
+    VOID
+    )
+{
+    RETURN_STATUS Status;
+
+    Status = DwUartConfigureDefault ();
+    if (RETURN_ERROR (Status)) {
+        return RETURN_DEVICE_ERROR;
+    }
+
+    MmioWrite32 (DW_UART_REG (UART_SCR), DW_UART_SCR_CONFIGURED);
+
+    return RETURN_SUCCESS;
+}
+
+/**
+  Write data from buffer to serial device.
+
+  A NumberOfBytes of 0 waits for earlier output to leave the UART.
+
+  @param  Buffer           Point of data buffer which need to be written.
+  @param  NumberOfBytes    Number of output bytes which are cached in Buffer.
+
+  @retval 0                Write data failed.
+  @retval !0               Actual number of bytes written to serial device.
+
+**/
+UINTN
+EFIAPI
+SerialPortWrite (
+    IN UINT8    *Buffer,
+    IN UINTN    NumberOfBytes
+    )
+{
+    if (NumberOfBytes == 0) {
+        DwUartWaitForTransmitter ();
+        return 0;
+    }
+
+    return DwUartWritePolled (Buffer, NumberOfBytes);
+}
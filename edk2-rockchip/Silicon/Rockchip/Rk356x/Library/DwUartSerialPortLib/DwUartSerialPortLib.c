@@ -0,0 +1,586 @@
+/** @file
+ *
+ *  RK3566/RK3568 DesignWare APB UART serial port library, shared parts.
+ *
+ *  Baud rates that the 24 MHz reference can't produce within 1% are run
+ *  from GPLL through the UART's fractional divider instead.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/IoLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SerialPortLib.h>
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xCru.h>
+#include <IndustryStandard/Rk356xUart.h>
+
+#include "DwUartSerialPortLibInternal.h"
+
+/* The fractional divider wants its parent at least 20 times its output */
+#define DW_UART_FRAC_PARENT_RATIO   20
+
+STATIC
+UINT64
+DwUartGetGpllRate (
+    VOID
+    )
+{
+    UINT32 Con0, Con1, Con2;
+    UINT64 FOutVco, PostDiv1, PostDiv2;
+    UINT64 RefDiv, FbDiv;
+
+    /* CruLib has this too, but prints, and printing from here recurses */
+    Con0 = MmioRead32 (CRU_PLL_CON0 (CRU_GPLL));
+    if ((Con0 & CRU_PLL_CON0_BYPASS) != 0) {
+        return CRU_CLKREF_RATE;
+    }
+    FbDiv = Con0 & CRU_PLL_CON0_FBDIV_MASK;
+    PostDiv1 = (Con0 & CRU_PLL_CON0_POSTDIV1_MASK) >> CRU_PLL_CON0_POSTDIV1_SHIFT;
+
+    Con1 = MmioRead32 (CRU_PLL_CON1 (CRU_GPLL));
+    RefDiv = Con1 & CRU_PLL_CON1_REFDIV_MASK;
+    PostDiv2 = (Con1 & CRU_PLL_CON1_POSTDIV2_MASK) >> CRU_PLL_CON1_POSTDIV2_SHIFT;
+
+    FOutVco = CRU_CLKREF_RATE / RefDiv * FbDiv;
+    if ((Con1 & CRU_PLL_CON1_DSMPD) == 0) {
+        Con2 = MmioRead32 (CRU_PLL_CON2 (CRU_GPLL));
+        FOutVco += (CRU_CLKREF_RATE * (Con2 & CRU_PLL_CON2_FRACDIV_MASK)) >> 24;
+    }
+
+    return FOutVco / PostDiv1 / PostDiv2;
+}
+
+STATIC
+VOID
+DwUartGetFracConfig (
+    IN  UINT32  ClockRate,
+    OUT UINT32  *SrcDiv,
+    OUT UINT32  *Numerator,
+    OUT UINT32  *Denominator
+    )
+{
+    UINT64 ParentRate;
+    UINT64 Div;
+    UINT32 Num, Den, A, B, T;
+
+    ParentRate = DwUartGetGpllRate ();
+    Div = DivU64x32 (ParentRate, ClockRate * DW_UART_FRAC_PARENT_RATIO);
+    Div = MAX (Div, 1);
+    Div = MIN (Div, CRU_CLKSEL_UART_SRC_DIV_MASK + 1);
+
+    Num = ClockRate;
+    Den = (UINT32)DivU64x32 (ParentRate, (UINT32)Div);
+
+    A = Num;
+    B = Den;
+    while (B != 0) {
+        T = A % B;
+        A = B;
+        B = T;
+    }
+    Num /= A;
+    Den /= A;
+
+    while (Den > CRU_CLKSEL_UART_FRAC_DEN_MASK) {
+        Num >>= 1;
+        Den >>= 1;
+    }
+
+    *SrcDiv = (UINT32)Div - 1;
+    *Numerator = Num;
+    *Denominator = Den;
+}
+
+STATIC
+BOOLEAN
+DwUartClockMatches (
+    IN UINT32   ClockRate
+    )
+{
+    UINT32 Index, Con, SrcDiv, Num, Den;
+
+    Index = DW_UART_INDEX;
+    if (Index == 0) {
+        /* UART0 is clocked from PMUCRU, which isn't touched */
+        return TRUE;
+    }
+
+    Con = MmioRead32 (CRU_CLKSEL_CON (CRU_CLKSEL_UART_SRC_CON (Index)));
+    if (ClockRate == PcdGet32 (PcdSerialClockRate)) {
+        return (Con & CRU_CLKSEL_UART_SEL_MASK) == (CRU_CLKSEL_UART_SEL_XIN24M << CRU_CLKSEL_UART_SEL_SHIFT);
+    }
+
+    DwUartGetFracConfig (ClockRate, &SrcDiv, &Num, &Den);
+    if ((Con & (CRU_CLKSEL_UART_SEL_MASK | CRU_CLKSEL_UART_SRC_SEL_MASK | CRU_CLKSEL_UART_SRC_DIV_MASK)) !=
+        ((CRU_CLKSEL_UART_SEL_FRAC << CRU_CLKSEL_UART_SEL_SHIFT) |
+         (CRU_CLKSEL_UART_SRC_SEL_GPLL << CRU_CLKSEL_UART_SRC_SEL_SHIFT) |
+         SrcDiv)) {
+        return FALSE;
+    }
+    return MmioRead32 (CRU_CLKSEL_CON (CRU_CLKSEL_UART_FRAC_CON (Index))) ==
+           ((Num << CRU_CLKSEL_UART_FRAC_NUM_SHIFT) | Den);
+}
+
+STATIC
+VOID
+DwUartSetClock (
+    IN UINT32   ClockRate
+    )
+{
+    UINT32 Index, SrcDiv, Num, Den;
+    UINT32 Gates[3];
+    UINTN  Gate;
+
+    Index = DW_UART_INDEX;
+    if (Index == 0) {
+        return;
+    }
+
+    if (ClockRate == PcdGet32 (PcdSerialClockRate)) {
+        MmioWrite32 (CRU_CLKSEL_CON (CRU_CLKSEL_UART_SRC_CON (Index)),
+                     (CRU_CLKSEL_UART_SEL_MASK << 16) |
+                     (CRU_CLKSEL_UART_SEL_XIN24M << CRU_CLKSEL_UART_SEL_SHIFT));
+        return;
+    }
+
+    DwUartGetFracConfig (ClockRate, &SrcDiv, &Num, &Den);
+
+    /* Earlier boot stages may only have enabled the xin24m path */
+    Gates[0] = CRU_GATE_UART_SRC (Index);
+    Gates[1] = CRU_GATE_UART_FRAC (Index);
+    Gates[2] = CRU_GATE_UART_SCLK (Index);
+    for (Gate = 0; Gate < ARRAY_SIZE (Gates); Gate++) {
+        MmioWrite32 (CRU_GATE_CON (CRU_GATE_UART_CON (Gates[Gate])),
+                     1U << (CRU_GATE_UART_BIT (Gates[Gate]) + 16));
+    }
+
+    /* Set up the source and divider before switching the mux over to them */
+    MmioWrite32 (CRU_CLKSEL_CON (CRU_CLKSEL_UART_SRC_CON (Index)),
+                 ((CRU_CLKSEL_UART_SRC_SEL_MASK | CRU_CLKSEL_UART_SRC_DIV_MASK) << 16) |
+                 (CRU_CLKSEL_UART_SRC_SEL_GPLL << CRU_CLKSEL_UART_SRC_SEL_SHIFT) |
+                 SrcDiv);
+    MmioWrite32 (CRU_CLKSEL_CON (CRU_CLKSEL_UART_FRAC_CON (Index)),
+                 (Num << CRU_CLKSEL_UART_FRAC_NUM_SHIFT) | Den);
+    MmioWrite32 (CRU_CLKSEL_CON (CRU_CLKSEL_UART_SRC_CON (Index)),
+                 (CRU_CLKSEL_UART_SEL_MASK << 16) |
+                 (CRU_CLKSEL_UART_SEL_FRAC << CRU_CLKSEL_UART_SEL_SHIFT));
+}
+
+STATIC
+RETURN_STATUS
+DwUartGetClock (
+    IN  UINT64  BaudRate,
+    OUT UINT32  *ClockRate,
+    OUT UINT32  *Divisor
+    )
+{
+    UINT32 RefRate, Div, Actual, Error;
+
+    if (BaudRate == 0 || BaudRate > DW_UART_MAX_BAUD_RATE) {
+        return RETURN_INVALID_PARAMETER;
+    }
+
+    RefRate = PcdGet32 (PcdSerialClockRate);
+    Div = (RefRate + 8 * (UINT32)BaudRate) / (16 * (UINT32)BaudRate);
+    if (Div != 0 && Div <= 0xFFFF) {
+        Actual = RefRate / (16 * Div);
+        Error = Actual > BaudRate ? Actual - (UINT32)BaudRate : (UINT32)BaudRate - Actual;
+        if (Error * 100 <= BaudRate) {
+            *ClockRate = RefRate;
+            *Divisor = Div;
+            return RETURN_SUCCESS;
+        }
+    }
+
+    if (DW_UART_INDEX == 0) {
+        return RETURN_UNSUPPORTED;
+    }
+
+    *ClockRate = 16 * (UINT32)BaudRate;
+    *Divisor = 1;
+    return RETURN_SUCCESS;
+}
+
+STATIC
+RETURN_STATUS
+DwUartGetLcr (
+    IN  EFI_PARITY_TYPE     Parity,
+    IN  UINT8               DataBits,
+    IN  EFI_STOP_BITS_TYPE  StopBits,
+    OUT UINT8               *Lcr
+    )
+{
+    UINT8 Value;
+
+    if (DataBits < 5 || DataBits > 8) {
+        return RETURN_INVALID_PARAMETER;
+    }
+    Value = DataBits - 5;
+
+    switch (Parity) {
+    case NoParity:
+        break;
+    case EvenParity:
+        Value |= UART_LCR_PEN | UART_LCR_EPS;
+        break;
+    case OddParity:
+        Value |= UART_LCR_PEN;
+        break;
+    case MarkParity:
+        Value |= UART_LCR_PEN | UART_LCR_SP;
+        break;
+    case SpaceParity:
+        Value |= UART_LCR_PEN | UART_LCR_EPS | UART_LCR_SP;
+        break;
+    default:
+        return RETURN_INVALID_PARAMETER;
+    }
+
+    switch (StopBits) {
+    case OneStopBit:
+        break;
+    case OneFiveStopBits:
+    case TwoStopBits:
+        /* 1.5 stop bits with 5 data bits, 2 otherwise */
+        Value |= UART_LCR_STOP;
+        break;
+    default:
+        return RETURN_INVALID_PARAMETER;
+    }
+
+    *Lcr = Value;
+    return RETURN_SUCCESS;
+}
+
+STATIC
+BOOLEAN
+DwUartIsConfigured (
+    IN UINT32   ClockRate,
+    IN UINT32   Divisor,
+    IN UINT8    Lcr
+    )
+{
+    UINT32 Current;
+
+    if ((MmioRead32 (DW_UART_REG (UART_IIR)) & UART_IIR_FIFOSE) != UART_IIR_FIFOSE) {
+        return FALSE;
+    }
+    if ((MmioRead32 (DW_UART_REG (UART_LCR)) & ~UART_LCR_DLAB & 0xFF) != Lcr) {
+        return FALSE;
+    }
+    if (!DwUartClockMatches (ClockRate)) {
+        return FALSE;
+    }
+
+    /* LCR writes are dropped while busy, and then DLL would read as RBR */
+    if ((MmioRead32 (DW_UART_REG (UART_USR)) & UART_USR_BUSY) != 0) {
+        return FALSE;
+    }
+    MmioWrite32 (DW_UART_REG (UART_LCR), Lcr | UART_LCR_DLAB);
+    Current = (MmioRead32 (DW_UART_REG (UART_DLL)) & 0xFF) |
+              ((MmioRead32 (DW_UART_REG (UART_DLH)) & 0xFF) << 8);
+    MmioWrite32 (DW_UART_REG (UART_LCR), Lcr);
+
+    return Current == Divisor;
+}
+
+VOID
+DwUartWaitForTransmitter (
+    VOID
+    )
+{
+    while ((MmioRead32 (DW_UART_REG (UART_LSR)) & UART_LSR_TEMT) == 0);
+}
+
+RETURN_STATUS
+DwUartConfigure (
+    IN UINT64   BaudRate,
+    IN UINT8    Lcr
+    )
+{
+    RETURN_STATUS   Status;
+    UINT32          ClockRate;
+    UINT32          Divisor;
+    BOOLEAN         InterruptState;
+
+    Status = DwUartGetClock (BaudRate, &ClockRate, &Divisor);
+    if (RETURN_ERROR (Status)) {
+        return Status;
+    }
+
+    InterruptState = SaveAndDisableInterrupts ();
+
+    /* A clock or divisor change garbles whatever is still being sent */
+    DwUartFlush ();
+
+    if (!DwUartIsConfigured (ClockRate, Divisor, Lcr)) {
+        DwUartSetClock (ClockRate);
+
+        /* Resetting the FIFOs also clears USR.BUSY, so that LCR can be written */
+        MmioWrite32 (DW_UART_REG (UART_FCR), UART_FCR_FIFOE | UART_FCR_RFIFOR | UART_FCR_XFIFOR);
+        MmioWrite32 (DW_UART_REG (UART_LCR), Lcr | UART_LCR_DLAB);
+        MmioWrite32 (DW_UART_REG (UART_DLL), Divisor & 0xFF);
+        MmioWrite32 (DW_UART_REG (UART_DLH), (Divisor >> 8) & 0xFF);
+        MmioWrite32 (DW_UART_REG (UART_LCR), Lcr);
+    }
+
+    SetInterruptState (InterruptState);
+
+    return RETURN_SUCCESS;
+}
+
+RETURN_STATUS
+DwUartConfigureDefault (
+    VOID
+    )
+{
+    RETURN_STATUS   Status;
+    UINT8           Lcr;
+
+    Status = DwUartGetLcr (FixedPcdGet8 (PcdUartDefaultParity),
+                           FixedPcdGet8 (PcdUartDefaultDataBits),
+                           FixedPcdGet8 (PcdUartDefaultStopBits),
+                           &Lcr);
+    if (RETURN_ERROR (Status)) {
+        return Status;
+    }
+
+    return DwUartConfigure (FixedPcdGet64 (PcdUartDefaultBaudRate), Lcr);
+}
+
+UINTN
+DwUartWritePolled (
+    IN UINT8    *Buffer,
+    IN UINTN    NumberOfBytes
+    )
+{
+    UINTN Index;
+
+    if (Buffer == NULL) {
+        return 0;
+    }
+
+    for (Index = 0; Index < NumberOfBytes; Index++) {
+        while ((MmioRead32 (DW_UART_REG (UART_USR)) & UART_USR_TFNF) == 0);
+        MmioWrite32 (DW_UART_REG (UART_THR), Buffer[Index]);
+    }
+
+    return NumberOfBytes;
+}
+
+/**
+  Read data from serial device and save the datas in buffer.
+
+  @param  Buffer           Point of data buffer which need to be written.
+  @param  NumberOfBytes    Number of output bytes which are cached in Buffer.
+
+  @retval 0                Read data failed.
+  @retval !0               Actual number of bytes read from serial device.
+
+**/
+UINTN
+EFIAPI
+SerialPortRead (
+    OUT UINT8   *Buffer,
+    IN  UINTN   NumberOfBytes
+    )
+{
+    UINTN Index;
+
+    if (Buffer == NULL) {
+        return 0;
+    }
+
+    for (Index = 0; Index < NumberOfBytes; Index++) {
+        while ((MmioRead32 (DW_UART_REG (UART_LSR)) & UART_LSR_DR) == 0);
+        Buffer[Index] = (UINT8)MmioRead32 (DW_UART_REG (UART_RBR));
+    }
+
+    return NumberOfBytes;
+}
+
+/**
+  Check to see if any data is available to be read from the debug device.
+
+  @retval TRUE       At least one byte of data is available to be read
+  @retval FALSE      No data is available to be read
+
+**/
+BOOLEAN
+EFIAPI
+SerialPortPoll (
+    VOID
+    )
+{
+    return (MmioRead32 (DW_UART_REG (UART_LSR)) & UART_LSR_DR) != 0;
+}
+
+/**
+  Sets the control bits on a serial device.
+
+  @param Control                Sets the bits of Control that are settable.
+
+  @retval RETURN_SUCCESS        The new control bits were set on the serial device.
+  @retval RETURN_UNSUPPORTED    The serial device does not support this operation.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortSetControl (
+    IN UINT32   Control
+    )
+{
+    UINT32 Mcr;
+
+    if ((Control & ~(EFI_SERIAL_DATA_TERMINAL_READY |
+                     EFI_SERIAL_REQUEST_TO_SEND |
+                     EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE)) != 0) {
+        return RETURN_UNSUPPORTED;
+    }
+
+    Mcr = MmioRead32 (DW_UART_REG (UART_MCR));
+    Mcr &= ~(UART_MCR_DTR | UART_MCR_RTS | UART_MCR_LOOPBACK);
+    if ((Control & EFI_SERIAL_DATA_TERMINAL_READY) != 0) {
+        Mcr |= UART_MCR_DTR;
+    }
+    if ((Control & EFI_SERIAL_REQUEST_TO_SEND) != 0) {
+        Mcr |= UART_MCR_RTS;
+    }
+    if ((Control & EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE) != 0) {
+        Mcr |= UART_MCR_LOOPBACK;
+    }
+    MmioWrite32 (DW_UART_REG (UART_MCR), Mcr);
+
+    return RETURN_SUCCESS;
+}
+
+/**
+  Retrieve the status of the control bits on a serial device.
+
+  @param Control                A pointer to return the current control signals from the serial device.
+
+  @retval RETURN_SUCCESS        The control bits were read from the serial device.
+  @retval RETURN_UNSUPPORTED    The serial device does not support this operation.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortGetControl (
+    OUT UINT32  *Control
+    )
+{
+    UINT32 Msr, Mcr;
+
+    *Control = 0;
+
+    Msr = MmioRead32 (DW_UART_REG (UART_MSR));
+    if ((Msr & UART_MSR_CTS) != 0) {
+        *Control |= EFI_SERIAL_CLEAR_TO_SEND;
+    }
+    if ((Msr & UART_MSR_DSR) != 0) {
+        *Control |= EFI_SERIAL_DATA_SET_READY;
+    }
+    if ((Msr & UART_MSR_RI) != 0) {
+        *Control |= EFI_SERIAL_RING_INDICATE;
+    }
+    if ((Msr & UART_MSR_DCD) != 0) {
+        *Control |= EFI_SERIAL_CARRIER_DETECT;
+    }
+
+    Mcr = MmioRead32 (DW_UART_REG (UART_MCR));
+    if ((Mcr & UART_MCR_DTR) != 0) {
+        *Control |= EFI_SERIAL_DATA_TERMINAL_READY;
+    }
+    if ((Mcr & UART_MCR_RTS) != 0) {
+        *Control |= EFI_SERIAL_REQUEST_TO_SEND;
+    }
+    if ((Mcr & UART_MCR_LOOPBACK) != 0) {
+        *Control |= EFI_SERIAL_HARDWARE_LOOPBACK_ENABLE;
+    }
+
+    if (!SerialPortPoll ()) {
+        *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+    }
+    if (DwUartTxEmpty ()) {
+        *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+    }
+
+    return RETURN_SUCCESS;
+}
+
+/**
+  Sets the baud rate, receive FIFO depth, transmit/receice time out, parity,
+  data bits, and stop bits on a serial device.
+
+  @param BaudRate           The requested baud rate. A BaudRate value of 0 will use the
+                            device's default interface speed.
+                            On output, the value actually set.
+  @param ReveiveFifoDepth   The requested depth of the FIFO on the receive side of the
+                            serial interface. A ReceiveFifoDepth value of 0 will use
+                            the device's default FIFO depth.
+                            On output, the value actually set.
+  @param Timeout            The requested time out for a single character in microseconds.
+                            This timeout applies to both the transmit and receive side of the
+                            interface. A Timeout value of 0 will use the device's default time
+                            out value.
+                            On output, the value actually set.
+  @param Parity             The type of parity to use on this serial device. A Parity value of
+                            DefaultParity will use the device's default parity value.
+                            On output, the value actually set.
+  @param DataBits           The number of data bits to use on the serial device. A DataBits
+                            vaule of 0 will use the device's default data bit setting.
+                            On output, the value actually set.
+  @param StopBits           The number of stop bits to use on this serial device. A StopBits
+                            value of DefaultStopBits will use the device's default number of
+                            stop bits.
+                            On output, the value actually set.
+
+  @retval RETURN_SUCCESS            The new attributes were set on the serial device.
+  @retval RETURN_UNSUPPORTED        The serial device does not support this operation.
+  @retval RETURN_INVALID_PARAMETER  One or more of the attributes has an unsupported value.
+  @retval RETURN_DEVICE_ERROR       The serial device is not functioning correctly.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortSetAttributes (
+    IN OUT UINT64               *BaudRate,
+    IN OUT UINT32               *ReceiveFifoDepth,
+    IN OUT UINT32               *Timeout,
+    IN OUT EFI_PARITY_TYPE      *Parity,
+    IN OUT UINT8                *DataBits,
+    IN OUT EFI_STOP_BITS_TYPE   *StopBits
+    )
+{
+    RETURN_STATUS   Status;
+    UINT8           Lcr;
+
+    if (*BaudRate == 0) {
+        *BaudRate = FixedPcdGet64 (PcdUartDefaultBaudRate);
+    }
+    if (*ReceiveFifoDepth == 0) {
+        *ReceiveFifoDepth = UART_FIFO_DEPTH;
+    }
+    if (*Parity == DefaultParity) {
+        *Parity = (EFI_PARITY_TYPE)FixedPcdGet8 (PcdUartDefaultParity);
+    }
+    if (*DataBits == 0) {
+        *DataBits = FixedPcdGet8 (PcdUartDefaultDataBits);
+    }
+    if (*StopBits == DefaultStopBits) {
+        *StopBits = (EFI_STOP_BITS_TYPE)FixedPcdGet8 (PcdUartDefaultStopBits);
+    }
+
+    Status = DwUartGetLcr (*Parity, *DataBits, *StopBits, &Lcr);
+    if (RETURN_ERROR (Status)) {
+        return Status;
+    }
+
+    return DwUartConfigure (*BaudRate, Lcr);
+}
@@ -0,0 +1,78 @@
+/** @file
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef DWUARTSERIALPORTLIBINTERNAL_H__
+#define DWUARTSERIALPORTLIBINTERNAL_H__
+
+#define DW_UART_BASE            ((UINTN)FixedPcdGet64 (PcdSerialRegisterBase))
+#define DW_UART_INDEX           UART_INDEX (DW_UART_BASE)
+#define DW_UART_REG(Reg)        (DW_UART_BASE + (Reg))
+
+#define DW_UART_MAX_BAUD_RATE   1500000
+
+/*
+ * Scratch register markers. The UART is reset along with the rest of the SoC,
+ * so neither survives into the next boot.
+ */
+#define DW_UART_SCR_CONFIGURED  0x3C    /* Programmed with the default settings */
+#define DW_UART_SCR_TX_RING     0xC3    /* Also buffering output in the TX ring */
+
+/**
+  Program the UART clock, divisor and line settings, unless it already uses
+  them. Output still in flight is sent first.
+**/
+RETURN_STATUS
+DwUartConfigure (
+    IN UINT64   BaudRate,
+    IN UINT8    Lcr
+    );
+
+/**
+  Program the UART with the PcdUartDefault* settings.
+**/
+RETURN_STATUS
+DwUartConfigureDefault (
+    VOID
+    );
+
+/**
+  Wait for the transmit FIFO and shift register to empty.
+**/
+VOID
+DwUartWaitForTransmitter (
+    VOID
+    );
+
+/**
+  Write bytes to the transmit FIFO, waiting for room as needed.
+**/
+UINTN
+DwUartWritePolled (
+    IN UINT8    *Buffer,
+    IN UINTN    NumberOfBytes
+    );
+
+/**
+  Send all pending output. Implemented by each library instance, called with
+  interrupts disabled.
+**/
+VOID
+DwUartFlush (
+    VOID
+    );
+
+/**
+  Report whether all output has left the UART. Implemented by each library
+  instance.
+**/
+BOOLEAN
+DwUartTxEmpty (
+    VOID
+    );
+
+#endif /* DWUARTSERIALPORTLIBINTERNAL_H__ */
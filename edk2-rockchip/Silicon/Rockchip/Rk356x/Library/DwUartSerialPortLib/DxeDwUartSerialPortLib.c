@@ -0,0 +1,294 @@
+/** @file
+ *
+ *  RK3566/RK3568 DesignWare APB UART serial port library, DXE instance.
+ *
+ *  Once DwUartTxDxe starts the TX ring, SerialPortWrite () only copies output
+ *  into the ring and tops up the transmit FIFO. The THRE interrupt sends the
+ *  rest. Callers running with interrupts disabled, and CPUs other than the
+ *  one that started the ring, still write synchronously.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Base.h>
+#include <Library/ArmLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DwUartSerialPortLib.h>
+#include <Library/IoLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SerialPortLib.h>
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xUart.h>
+
+#include "DwUartSerialPortLibInternal.h"
+
+/*
+ * The ring lives in a fixed reserved region rather than in allocated memory,
+ * so that every module linking this library finds it at the same place.
+ */
+typedef struct {
+    UINT64          Mpidr;      /* CPU that owns the ring */
+    volatile UINT32 Head;       /* Next byte to fill */
+    volatile UINT32 Tail;       /* Next byte to send */
+    UINT8           Data[];
+} DW_UART_TX_RING;
+
+#define TX_RING         ((DW_UART_TX_RING *)(UINTN)FixedPcdGet64 (PcdUartTxRingBase))
+#define TX_RING_SIZE    (FixedPcdGet32 (PcdUartTxRingSize) - OFFSET_OF (DW_UART_TX_RING, Data))
+
+STATIC
+BOOLEAN
+DwUartTxRingActive (
+    VOID
+    )
+{
+    if (MmioRead32 (DW_UART_REG (UART_SCR)) != DW_UART_SCR_TX_RING) {
+        return FALSE;
+    }
+    return TX_RING->Mpidr == ArmReadMpidr ();
+}
+
+STATIC
+UINT32
+DwUartTxRingNext (
+    IN UINT32   Index
+    )
+{
+    return Index + 1 == TX_RING_SIZE ? 0 : Index + 1;
+}
+
+/* Move as much of the ring into the transmit FIFO as it takes. */
+STATIC
+VOID
+DwUartTxRingPump (
+    VOID
+    )
+{
+    DW_UART_TX_RING *Ring = TX_RING;
+    UINT32          Tail = Ring->Tail;
+
+    while (Tail != Ring->Head &&
+           (MmioRead32 (DW_UART_REG (UART_USR)) & UART_USR_TFNF) != 0) {
+        MmioWrite32 (DW_UART_REG (UART_THR), Ring->Data[Tail]);
+        Tail = DwUartTxRingNext (Tail);
+    }
+    Ring->Tail = Tail;
+}
+
+STATIC
+VOID
+DwUartTxRingDrain (
+    VOID
+    )
+{
+    while (TX_RING->Tail != TX_RING->Head) {
+        DwUartTxRingPump ();
+    }
+}
+
+VOID
+DwUartFlush (
+    VOID
+    )
+{
+    if (DwUartTxRingActive ()) {
+        DwUartTxRingDrain ();
+    }
+    DwUartWaitForTransmitter ();
+}
+
+BOOLEAN
+DwUartTxEmpty (
+    VOID
+    )
+{
+    if (DwUartTxRingActive () && TX_RING->Tail != TX_RING->Head) {
+        return FALSE;
+    }
+    return (MmioRead32 (DW_UART_REG (UART_LSR)) & UART_LSR_TEMT) != 0;
+}
+
+/**
+  Initialize the serial device hardware.
+
+  The UART is normally set up by the time DXE runs, and reprogramming it
+  would have to wait for output in flight, so it is left alone then.
+
+  @retval RETURN_SUCCESS        The serial device was initialized.
+  @retval RETURN_DEVICE_ERROR   The serial device could not be initialized.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortInitialize (
+    VOID
+    )
+{
+    RETURN_STATUS   Status;
+    UINT32          Scr;
+
+    Scr = MmioRead32 (DW_UART_REG (UART_SCR));
+    if (Scr == DW_UART_SCR_CONFIGURED || Scr == DW_UART_SCR_TX_RING) {
+        return RETURN_SUCCESS;
+    }
+
+    Status = DwUartConfigureDefault ();
+    if (RETURN_ERROR (Status)) {
+        return RETURN_DEVICE_ERROR;
+    }
+
+    MmioWrite32 (DW_UART_REG (UART_SCR), DW_UART_SCR_CONFIGURED);
+
+    return RETURN_SUCCESS;
+}
+
+/**
+  Write data from buffer to serial device.
+
+  A NumberOfBytes of 0 waits for earlier output, buffered or not, to leave
+  the UART. Buffer may be NULL in that case.
+
+  @param  Buffer           Point of data buffer which need to be written.
+  @param  NumberOfBytes    Number of output bytes which are cached in Buffer.
+
+  @retval 0                Write data failed.
+  @retval !0               Actual number of bytes written to serial device.
+
+**/
+UINTN
+EFIAPI
+SerialPortWrite (
+    IN UINT8    *Buffer,
+    IN UINTN    NumberOfBytes
+    )
+{
+    DW_UART_TX_RING *Ring = TX_RING;
+    BOOLEAN         InterruptState;
+    UINTN           Index;
+    UINT32          Next;
+
+    InterruptState = SaveAndDisableInterrupts ();
+
+    if (NumberOfBytes == 0) {
+        DwUartFlush ();
+        SetInterruptState (InterruptState);
+        return 0;
+    }
+
+    if (!DwUartTxRingActive ()) {
+        SetInterruptState (InterruptState);
+        return DwUartWritePolled (Buffer, NumberOfBytes);
+    }
+
+    if (Buffer == NULL) {
+        SetInterruptState (InterruptState);
+        return 0;
+    }
+
+    for (Index = 0; Index < NumberOfBytes; Index++) {
+        Next = DwUartTxRingNext (Ring->Head);
+        while (Next == Ring->Tail) {
+            /* Full, fall back to feeding the FIFO directly */
+            DwUartTxRingPump ();
+        }
+        Ring->Data[Ring->Head] = Buffer[Index];
+        Ring->Head = Next;
+    }
+
+    DwUartTxRingPump ();
+
+    if (!InterruptState) {
+        /*
+         * Nothing will take the THRE interrupt before the caller enables
+         * interrupts again, and it may never do that (exceptions, ASSERTs).
+         */
+        DwUartTxRingDrain ();
+    } else if (Ring->Tail != Ring->Head) {
+        MmioOr32 (DW_UART_REG (UART_IER), UART_IER_ETBEI);
+    }
+
+    SetInterruptState (InterruptState);
+
+    return NumberOfBytes;
+}
+
+/**
+  Start buffering SerialPortWrite () output in the transmit ring. The caller
+  must be ready to call DwUartTxRingInterrupt () from the UART interrupt.
+
+  @retval RETURN_SUCCESS           The ring is in use.
+  @retval RETURN_BUFFER_TOO_SMALL  PcdUartTxRingSize leaves no room for data.
+**/
+RETURN_STATUS
+EFIAPI
+DwUartTxRingStart (
+    VOID
+    )
+{
+    BOOLEAN InterruptState;
+
+    if (FixedPcdGet32 (PcdUartTxRingSize) < OFFSET_OF (DW_UART_TX_RING, Data) + 2) {
+        return RETURN_BUFFER_TOO_SMALL;
+    }
+
+    InterruptState = SaveAndDisableInterrupts ();
+
+    TX_RING->Mpidr = ArmReadMpidr ();
+    TX_RING->Head = 0;
+    TX_RING->Tail = 0;
+    MmioWrite32 (DW_UART_REG (UART_SCR), DW_UART_SCR_TX_RING);
+
+    SetInterruptState (InterruptState);
+
+    return RETURN_SUCCESS;
+}
+
+/**
+  Send everything still in the ring and go back to polled output.
+**/
+VOID
+EFIAPI
+DwUartTxRingStop (
+    VOID
+    )
+{
+    BOOLEAN InterruptState;
+
+    InterruptState = SaveAndDisableInterrupts ();
+
+    if (DwUartTxRingActive ()) {
+        DwUartTxRingDrain ();
+        MmioAnd32 (DW_UART_REG (UART_IER), ~(UINT32)UART_IER_ETBEI);
+        MmioWrite32 (DW_UART_REG (UART_SCR), DW_UART_SCR_CONFIGURED);
+    }
+
+    SetInterruptState (InterruptState);
+}
+
+/**
+  Refill the transmit FIFO from the ring. Called with interrupts disabled from
+  the UART interrupt handler.
+**/
+VOID
+EFIAPI
+DwUartTxRingInterrupt (
+    VOID
+    )
+{
+    /* Reading IIR acks THRE, reading USR acks a busy detect */
+    if ((MmioRead32 (DW_UART_REG (UART_IIR)) & UART_IIR_IID_MASK) == UART_IIR_IID_BUSY) {
+        MmioRead32 (DW_UART_REG (UART_USR));
+    }
+
+    if (DwUartTxRingActive ()) {
+        DwUartTxRingPump ();
+        if (TX_RING->Tail != TX_RING->Head) {
+            return;
+        }
+    }
+
+    MmioAnd32 (DW_UART_REG (UART_IER), ~(UINT32)UART_IER_ETBEI);
+}
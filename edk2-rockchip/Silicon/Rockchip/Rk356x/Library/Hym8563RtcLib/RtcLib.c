@@ -10,10 +10,13 @@
 #include <Uefi.h>
 
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/DxeServicesTableLib.h>
 #include <Library/RealTimeClockLib.h>
 #include <Library/I2cLib.h>
+#include <Library/TimeBaseLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeLib.h>
 
@@ -38,21 +41,20 @@
 #define  RTC_CENTURY_MASK       0x80
 #define RTC_YEARS               0x08
 
+// Seconds through years, read in a single auto-incrementing burst
+#define RTC_TIME_REGS           (RTC_YEARS - RTC_SECONDS + 1)
+#define RTC_TIME_REG(Regs, Reg) ((Regs)[(Reg) - RTC_SECONDS])
+
+// How long GetTime is served from the arch timer before re-reading the RTC
+#define RTC_RESYNC_INTERVAL     60
+
 STATIC UINTN                    mRtcI2cBusBase = FixedPcdGet32 (PcdRtcI2cBusBase);
 STATIC EFI_EVENT                mVirtualAddressChangeEvent = NULL;
 STATIC BOOLEAN                  mRuntimeEnable = FALSE;
 
-STATIC
-EFI_STATUS
-RtcRead (
-    IN UINT8    Register,
-    OUT UINT8   *Value
-    )
-{
-    return I2cRead (mRtcI2cBusBase, RTC_I2C_ADDR,
-                    &Register, sizeof (Register),
-                    Value, sizeof (*Value));
-}
+STATIC BOOLEAN                  mTimeCacheValid = FALSE;
+STATIC UINTN                    mTimeCacheEpoch;
+STATIC UINT64                   mTimeCacheCounter;
 
 STATIC
 EFI_STATUS
@@ -66,51 +68,42 @@ RtcWrite (
                      &Value, sizeof (Value));
 }
 
+STATIC
 EFI_STATUS
-EFIAPI
-LibGetTime (
-    OUT EFI_TIME                *Time,
-    OUT EFI_TIME_CAPABILITIES   *Capabilities
+RtcReadTime (
+    OUT EFI_TIME    *Time
     )
 {
     EFI_STATUS Status;
-    UINT8 Seconds, Minutes, Hours, Days, MonCentury, Years;
+    UINT8 Register;
+    UINT8 Regs[RTC_TIME_REGS];
 
-    Status = RtcRead (RTC_SECONDS, &Seconds);
-    if (!EFI_ERROR (Status)) {
-        Status = RtcRead (RTC_MINUTES, &Minutes);
-    }
-    if (!EFI_ERROR (Status)) {
-        Status = RtcRead (RTC_HOURS, &Hours);
-    }
-    if (!EFI_ERROR (Status)) {
-        Status = RtcRead (RTC_DAYS, &Days);
-    }
-    if (!EFI_ERROR (Status)) {
-        Status = RtcRead (RTC_MON_CENTURY, &MonCentury);
-    }
-    if (!EFI_ERROR (Status)) {
-        Status = RtcRead (RTC_YEARS, &Years);
-    }
+    //
+    // The time registers are latched for the duration of a burst read, so
+    // reading them all at once can't return a torn time across a rollover.
+    //
+    Register = RTC_SECONDS;
+    Status = I2cRead (mRtcI2cBusBase, RTC_I2C_ADDR,
+                      &Register, sizeof (Register),
+                      Regs, sizeof (Regs));
     if (EFI_ERROR (Status)) {
         DEBUG ((DEBUG_WARN, "RTC read failed: %r\n", Status));
         return EFI_DEVICE_ERROR;
     }
 
-    if ((Seconds & RTC_SECONDS_DL) != 0) {
+    if ((RTC_TIME_REG (Regs, RTC_SECONDS) & RTC_SECONDS_DL) != 0) {
         DEBUG ((DEBUG_WARN, "RTC voltage-low detect bit set; clock integrity not guaranteed.\n"));
-        RtcWrite (RTC_SECONDS, Seconds & ~RTC_SECONDS_DL);
+        RtcWrite (RTC_SECONDS, RTC_TIME_REG (Regs, RTC_SECONDS) & ~RTC_SECONDS_DL);
         return EFI_DEVICE_ERROR;
     }
 
-    Time->Year = 2000 + BcdToDecimal8 (Years);
-    Time->Month = BcdToDecimal8 (MonCentury & RTC_MON_MASK);
-    Time->Day = BcdToDecimal8 (Days & RTC_DAYS_MASK);
-    Time->Hour = BcdToDecimal8 (Hours & RTC_HOURS_MASK);
-    Time->Minute = BcdToDecimal8 (Minutes & RTC_MINUTES_MASK);
-    Time->Second = BcdToDecimal8 (Seconds & RTC_SECONDS_MASK);
-    Time->TimeZone = EFI_UNSPECIFIED_TIMEZONE;
-    Time->Daylight = 0;
+    ZeroMem (Time, sizeof (*Time));
+    Time->Year = 2000 + BcdToDecimal8 (RTC_TIME_REG (Regs, RTC_YEARS));
+    Time->Month = BcdToDecimal8 (RTC_TIME_REG (Regs, RTC_MON_CENTURY) & RTC_MON_MASK);
+    Time->Day = BcdToDecimal8 (RTC_TIME_REG (Regs, RTC_DAYS) & RTC_DAYS_MASK);
+    Time->Hour = BcdToDecimal8 (RTC_TIME_REG (Regs, RTC_HOURS) & RTC_HOURS_MASK);
+    Time->Minute = BcdToDecimal8 (RTC_TIME_REG (Regs, RTC_MINUTES) & RTC_MINUTES_MASK);
+    Time->Second = BcdToDecimal8 (RTC_TIME_REG (Regs, RTC_SECONDS) & RTC_SECONDS_MASK);
 
     if (Time->Month == 0) {
         Time->Month = 1;
@@ -122,6 +115,50 @@ LibGetTime (
     return EFI_SUCCESS;
 }
 
+EFI_STATUS
+EFIAPI
+LibGetTime (
+    OUT EFI_TIME                *Time,
+    OUT EFI_TIME_CAPABILITIES   *Capabilities
+    )
+{
+    EFI_STATUS Status;
+    UINT64 Counter;
+    UINT64 Elapsed;
+
+    //
+    // Serve the time from the arch timer while the last RTC read is
+    // recent, to avoid an I2C transaction on every call. Only for boot
+    // time callers: the cached time can be up to a second behind, and the
+    // OS may suspend with the counter stopped.
+    //
+    Counter = GetPerformanceCounter ();
+    Elapsed = RTC_RESYNC_INTERVAL;
+    if (mTimeCacheValid && !EfiAtRuntime ()) {
+        Elapsed = DivU64x32 (GetTimeInNanoSecond (Counter - mTimeCacheCounter), 1000000000);
+    }
+
+    if (Elapsed < RTC_RESYNC_INTERVAL) {
+        EpochToEfiTime (mTimeCacheEpoch + (UINTN)Elapsed, Time);
+    } else {
+        Status = RtcReadTime (Time);
+        if (EFI_ERROR (Status)) {
+            mTimeCacheValid = FALSE;
+            return Status;
+        }
+
+        mTimeCacheEpoch = EfiTimeToEpoch (Time);
+        mTimeCacheCounter = Counter;
+        mTimeCacheValid = TRUE;
+    }
+
+    Time->Nanosecond = 0;
+    Time->TimeZone = EFI_UNSPECIFIED_TIMEZONE;
+    Time->Daylight = 0;
+
+    return EFI_SUCCESS;
+}
+
 EFI_STATUS
 EFIAPI
 LibSetTime (
@@ -157,6 +194,8 @@ LibSetTime (
         return EFI_DEVICE_ERROR;
     }
 
+    mTimeCacheValid = FALSE;
+
     return EFI_SUCCESS;
 }
 
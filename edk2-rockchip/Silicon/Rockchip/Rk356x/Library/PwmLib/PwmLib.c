@@ -0,0 +1,148 @@
+/** @file
+ *
+ *  RK3566/RK3568 PWM Library.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/IoLib.h>
+#include <Library/PwmLib.h>
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xCru.h>
+
+#define PWM_CHANNEL_BASE(c, n)      (PWM_BASE (c) + (n) * 0x10)
+#define PWM_CNT(c, n)               (PWM_CHANNEL_BASE (c, n) + 0x0)
+#define PWM_PERIOD_HPR(c, n)        (PWM_CHANNEL_BASE (c, n) + 0x4)
+#define PWM_DUTY_LPR(c, n)          (PWM_CHANNEL_BASE (c, n) + 0x8)
+#define PWM_CTRL(c, n)              (PWM_CHANNEL_BASE (c, n) + 0xC)
+#define  PWM_ENABLE                 BIT0
+#define  PWM_MODE_CONTINUOUS        (1U << 1)
+#define  PWM_DUTY_POSITIVE          BIT3
+#define  PWM_INACTIVE_POSITIVE      BIT4
+#define  PWM_LOCK_EN                BIT6
+
+/*
+ * All PWM controllers are switched to the 24 MHz oscillator so that the
+ * period and duty calculations do not depend on PLL setup.
+ */
+#define PWM_CLOCK_RATE              24000000U
+
+/* PMUCRU: clk_pwm0 source select (0 = xin24m) and divider */
+#define PMUCRU_PMUCLKSEL_CON06_CLK_PWM0_SEL_MASK  (1U << 7)
+#define PMUCRU_PMUCLKSEL_CON06_CLK_PWM0_DIV_MASK  0x7FU
+
+/* CRU: clk_pwm1/2/3 source select (1 = xin24m) */
+#define CRU_CLKSEL_CON31_CLK_PWM_SEL_SHIFT(c)     (10 + ((c) - 1) * 2)
+#define CRU_CLKSEL_CON31_CLK_PWM_SEL_MASK(c)      (0x3U << CRU_CLKSEL_CON31_CLK_PWM_SEL_SHIFT (c))
+#define CRU_CLKSEL_CON31_CLK_PWM_SEL_XIN24M       1
+
+STATIC
+VOID
+PwmSetClockSource (
+  IN UINT8 Controller
+  )
+{
+  UINT32 Mask;
+
+  if (Controller == 0) {
+    Mask = PMUCRU_PMUCLKSEL_CON06_CLK_PWM0_SEL_MASK | PMUCRU_PMUCLKSEL_CON06_CLK_PWM0_DIV_MASK;
+    MmioWrite32 (PMUCRU_PMUCLKSEL_CON (6), Mask << 16);
+  } else {
+    Mask = CRU_CLKSEL_CON31_CLK_PWM_SEL_MASK (Controller);
+    MmioWrite32 (CRU_CLKSEL_CON (31),
+                 (Mask << 16) |
+                 (CRU_CLKSEL_CON31_CLK_PWM_SEL_XIN24M << CRU_CLKSEL_CON31_CLK_PWM_SEL_SHIFT (Controller)));
+  }
+}
+
+STATIC
+UINT32
+PwmNsToCycles (
+  IN UINT32 Ns
+  )
+{
+  return (UINT32)DivU64x32 (MultU64x32 (Ns, PWM_CLOCK_RATE), 1000000000U);
+}
+
+EFI_STATUS
+PwmConfigure (
+  IN UINT8   Controller,
+  IN UINT8   Channel,
+  IN UINT32  PeriodNs,
+  IN UINT32  DutyNs,
+  IN BOOLEAN Inverted
+  )
+{
+  UINT32 Ctrl;
+
+  if (Controller >= PWM_NCONTROLLERS || Channel >= PWM_NCHANNELS ||
+      PeriodNs == 0 || DutyNs > PeriodNs) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PwmSetClockSource (Controller);
+
+  Ctrl = PWM_MODE_CONTINUOUS;
+  if (Inverted) {
+    Ctrl |= PWM_INACTIVE_POSITIVE;
+  } else {
+    Ctrl |= PWM_DUTY_POSITIVE;
+  }
+
+  /* Lock so the new period and duty take effect together */
+  MmioWrite32 (PWM_CTRL (Controller, Channel), Ctrl | PWM_LOCK_EN);
+  MmioWrite32 (PWM_PERIOD_HPR (Controller, Channel), PwmNsToCycles (PeriodNs));
+  MmioWrite32 (PWM_DUTY_LPR (Controller, Channel), PwmNsToCycles (DutyNs));
+  MmioWrite32 (PWM_CTRL (Controller, Channel), Ctrl | PWM_ENABLE);
+
+  DEBUG ((DEBUG_INFO, "PWM%u: period %u ns, duty %u ns\n",
+          Controller * PWM_NCHANNELS + Channel, PeriodNs, DutyNs));
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+PwmSetDuty (
+  IN UINT8   Controller,
+  IN UINT8   Channel,
+  IN UINT32  DutyNs
+  )
+{
+  UINT32 Period;
+  UINT32 Duty;
+
+  if (Controller >= PWM_NCONTROLLERS || Channel >= PWM_NCHANNELS) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Period = MmioRead32 (PWM_PERIOD_HPR (Controller, Channel));
+  Duty = PwmNsToCycles (DutyNs);
+  if (Period == 0 || Duty > Period) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MmioOr32 (PWM_CTRL (Controller, Channel), PWM_LOCK_EN);
+  MmioWrite32 (PWM_DUTY_LPR (Controller, Channel), Duty);
+  MmioAnd32 (PWM_CTRL (Controller, Channel), ~PWM_LOCK_EN);
+
+  return EFI_SUCCESS;
+}
+
+VOID
+PwmDisable (
+  IN UINT8   Controller,
+  IN UINT8   Channel
+  )
+{
+  if (Controller >= PWM_NCONTROLLERS || Channel >= PWM_NCHANNELS) {
+    return;
+  }
+
+  MmioAnd32 (PWM_CTRL (Controller, Channel), ~PWM_ENABLE);
+}
@@ -11,8 +11,13 @@
 #include <Library/PciHostBridgeLib.h>
 #include <Library/DebugLib.h>
 #include <Library/DevicePathLib.h>
+#include <Library/DxeServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <IndustryStandard/Rk356xPcie.h>
 
 #include <Protocol/PciRootBridgeIo.h>
 #include <Protocol/PciHostBridgeResourceAllocation.h>
@@ -56,6 +61,128 @@ CHAR16 *mPciHostBridgeLibAcpiAddressSpaceTypeStr[] = {
   L"Mem", L"I/O", L"Bus"
 };
 
+STATIC VOID                                           *mRootBridgeIoRegistration;
+STATIC EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL_SET_ATTRIBUTES mRootBridgeIoSetAttributes;
+
+/**
+  Map a range of the PCI MMIO windows write-combining (Normal Non-cacheable).
+**/
+STATIC
+EFI_STATUS
+PciSetWriteCombine (
+  IN UINT64   Base,
+  IN UINT64   Length
+  )
+{
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR Descriptor;
+  EFI_STATUS                      Status;
+
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = gDS->GetMemorySpaceDescriptor (Base, &Descriptor);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  if (Descriptor.GcdMemoryType != EfiGcdMemoryTypeMemoryMappedIo ||
+      Base + Length > Descriptor.BaseAddress + Descriptor.Length) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((Descriptor.Capabilities & EFI_MEMORY_WC) == 0) {
+    Status = gDS->SetMemorySpaceCapabilities (Descriptor.BaseAddress, Descriptor.Length,
+                                              Descriptor.Capabilities | EFI_MEMORY_WC);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return gDS->SetMemorySpaceAttributes (Base, Length,
+                                        (Descriptor.Attributes & ~EFI_MEMORY_CACHETYPE_MASK) |
+                                        EFI_MEMORY_WC);
+}
+
+/**
+  EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL.SetAttributes() wrapper. The generic root
+  bridge driver only records the attributes, so apply a write-combining
+  request to the page tables here.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+PciRootBridgeIoSetAttributes (
+  IN     EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL *This,
+  IN     UINT64                          Attributes,
+  IN OUT UINT64                          *ResourceBase OPTIONAL,
+  IN OUT UINT64                          *ResourceLength OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      Base;
+  UINT64      Limit;
+
+  Status = mRootBridgeIoSetAttributes (This, Attributes, ResourceBase, ResourceLength);
+  if (EFI_ERROR (Status) ||
+      (Attributes & EFI_PCI_ATTRIBUTE_MEMORY_WRITE_COMBINE) == 0 ||
+      ResourceBase == NULL || ResourceLength == NULL || *ResourceLength == 0) {
+    return Status;
+  }
+
+  Base  = *ResourceBase & ~(UINT64)EFI_PAGE_MASK;
+  Limit = ALIGN_VALUE (*ResourceBase + *ResourceLength, EFI_PAGE_SIZE);
+
+  Status = PciSetWriteCombine (Base, Limit - Base);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "PCIe: Failed to map 0x%lx-0x%lx write-combining: %r\n",
+            Base, Limit - 1, Status));
+    return EFI_UNSUPPORTED;
+  }
+
+  *ResourceBase   = Base;
+  *ResourceLength = Limit - Base;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  PciHostBridgeDxe maps every aperture uncached before it installs the root
+  bridge I/O protocol. Restore write-combining on the prefetchable windows
+  and hook SetAttributes() so that drivers can ask for it elsewhere.
+**/
+STATIC
+VOID
+EFIAPI
+PciRootBridgeIoInstalled (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL *RootBridgeIo;
+  EFI_STATUS                      Status;
+
+  Status = gBS->LocateProtocol (&gEfiPciRootBridgeIoProtocolGuid,
+                                mRootBridgeIoRegistration,
+                                (VOID **)&RootBridgeIo);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  gBS->CloseEvent (Event);
+
+  Status = PciSetWriteCombine (PCIE_PMEM32_BASE, PCIE_PMEM32_SIZE);
+  if (!EFI_ERROR (Status)) {
+    Status = PciSetWriteCombine (PCIE_PMEM64_BASE, PCIE_PMEM64_SIZE);
+  }
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "PCIe: Failed to map prefetchable windows write-combining: %r\n",
+            Status));
+  }
+
+  mRootBridgeIoSetAttributes = RootBridgeIo->SetAttributes;
+  RootBridgeIo->SetAttributes = PciRootBridgeIoSetAttributes;
+}
+
 /**
   Return all the root bridge instances in an array.
 
@@ -91,39 +218,55 @@ PciHostBridgeGetRootBridges (
                             EFI_PCI_ATTRIBUTE_ISA_MOTHERBOARD_IO | \
                             EFI_PCI_ATTRIBUTE_VGA_MEMORY | \
                             EFI_PCI_ATTRIBUTE_VGA_IO_16  | \
-                            EFI_PCI_ATTRIBUTE_VGA_PALETTE_IO_16;
-  RootBridge->Attributes  = RootBridge->Supports;
+                            EFI_PCI_ATTRIBUTE_VGA_PALETTE_IO_16 | \
+                            EFI_PCI_ATTRIBUTE_MEMORY_WRITE_COMBINE;
+  RootBridge->Attributes  = RootBridge->Supports & ~EFI_PCI_ATTRIBUTE_MEMORY_WRITE_COMBINE;
 
   RootBridge->DmaAbove4G            = TRUE;
   RootBridge->ResourceAssigned      = FALSE;
   RootBridge->NoExtendedConfigSpace = FALSE;
 
-  RootBridge->AllocationAttributes  = EFI_PCI_HOST_BRIDGE_COMBINE_MEM_PMEM |
-                                      EFI_PCI_HOST_BRIDGE_MEM64_DECODE;
+  RootBridge->AllocationAttributes  = EFI_PCI_HOST_BRIDGE_MEM64_DECODE;
 
   RootBridge->Bus.Base              = PcdGet32 (PcdPciBusMin);
   RootBridge->Bus.Limit             = PcdGet32 (PcdPciBusMax);
   RootBridge->Io.Base               = PcdGet64 (PcdPciIoBase);
   RootBridge->Io.Limit              = PcdGet64 (PcdPciIoBase) + PcdGet64 (PcdPciIoSize) - 1;
   RootBridge->Io.Translation        = MAX_UINT64 - PcdGet64 (PcdPciIoTranslation) + 1;
-  RootBridge->Mem.Base              = PcdGet32 (PcdPciMmio32Base);
-  RootBridge->Mem.Limit             = PcdGet32 (PcdPciMmio32Base) + PcdGet32 (PcdPciMmio32Size) - 1;
-  RootBridge->MemAbove4G.Base       = PcdGet64 (PcdPciMmio64Base);
-  RootBridge->MemAbove4G.Limit      = PcdGet64 (PcdPciMmio64Base) + PcdGet64 (PcdPciMmio64Size) - 1;
+  RootBridge->Mem.Base              = PCIE_MEM32_BASE;
+  RootBridge->Mem.Limit             = PCIE_MEM32_BASE + PCIE_MEM32_SIZE - 1;
+  RootBridge->MemAbove4G.Base       = PCIE_MEM64_BASE;
+  RootBridge->MemAbove4G.Limit      = PCIE_MEM64_BASE + PCIE_MEM64_SIZE - 1;
 
   //
-  // No separate ranges for prefetchable and non-prefetchable BARs
+  // Prefetchable BARs go to the write-combining windows, see Rk356xPcie.h
   //
-  RootBridge->PMem.Base             = MAX_UINT64;
-  RootBridge->PMem.Limit            = 0;
-  RootBridge->PMemAbove4G.Base      = MAX_UINT64;
-  RootBridge->PMemAbove4G.Limit     = 0;
+  if (PCIE_PMEM32_SIZE != 0) {
+    RootBridge->PMem.Base           = PCIE_PMEM32_BASE;
+    RootBridge->PMem.Limit          = PCIE_PMEM32_BASE + PCIE_PMEM32_SIZE - 1;
+  } else {
+    RootBridge->PMem.Base           = MAX_UINT64;
+    RootBridge->PMem.Limit          = 0;
+  }
+  if (PCIE_PMEM64_SIZE != 0) {
+    RootBridge->PMemAbove4G.Base    = PCIE_PMEM64_BASE;
+    RootBridge->PMemAbove4G.Limit   = PCIE_PMEM64_BASE + PCIE_PMEM64_SIZE - 1;
+  } else {
+    RootBridge->PMemAbove4G.Base    = MAX_UINT64;
+    RootBridge->PMemAbove4G.Limit   = 0;
+  }
 
   ASSERT (FixedPcdGet64 (PcdPciMmio32Translation) == 0);
   ASSERT (FixedPcdGet64 (PcdPciMmio64Translation) == 0);
 
   RootBridge->DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)&mEfiPciRootBridgeDevicePath;
 
+  EfiCreateProtocolNotifyEvent (&gEfiPciRootBridgeIoProtocolGuid,
+                                TPL_CALLBACK,
+                                PciRootBridgeIoInstalled,
+                                NULL,
+                                &mRootBridgeIoRegistration);
+
   return RootBridge;
 }
 
@@ -97,6 +97,7 @@ CpuVoltageSet (
     )
 {
     EFI_STATUS  Status;
+    EFI_TPL     OldTpl;
     UINT8       Value, OldValue;
     UINT32      CurUVol;
     UINT32      NewUVol;
@@ -107,6 +108,12 @@ CpuVoltageSet (
         return Status;
     }
 
+    /*
+     * The thermal governor calls this from a timer callback. Keep the
+     * read-modify-write of VSEL and the ramp delay in one piece.
+     */
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
     Status = CpuVoltageReadReg (VSEL_REG, &OldValue);
     ASSERT (Status == EFI_SUCCESS);
 
@@ -114,6 +121,7 @@ CpuVoltageSet (
     DEBUG ((DEBUG_INFO, "CpuVoltageSet: %u uV -> %u uV\n", CurUVol, NewUVol));
 
     if (CurUVol == NewUVol) {
+        gBS->RestoreTPL (OldTpl);
         return EFI_SUCCESS;
     }
 
@@ -129,6 +137,8 @@ CpuVoltageSet (
         }
     }
 
+    gBS->RestoreTPL (OldTpl);
+
     return EFI_SUCCESS;
 }
 
@@ -0,0 +1,483 @@
+/** @file
+ *
+ *  Runs AhciNcqDxe's port, queue and Block I/O code on the build host
+ *  against FakeHba.c, for testahcincq.py. Covers slot allocation up to the
+ *  queue depth, tag to slot mapping, out of order completion, flush
+ *  ordering, and recovery from device errors and timeouts.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "FakeHba.h"
+
+#define CHECK(Cond)                                                         \
+    do {                                                                    \
+        if (!(Cond)) {                                                      \
+            __builtin_printf ("  %s:%d: %s\n", __FILE__, __LINE__, #Cond);  \
+            mFailed = TRUE;                                                 \
+        }                                                                   \
+    } while (FALSE)
+
+#define BLOCK_BYTES(Lba)    (mHba.Disk + (Lba) * FAKE_BLOCK_SIZE)
+
+typedef struct {
+    EFI_BLOCK_IO2_TOKEN Token;
+    UINTN               Signalled;
+} TEST_TOKEN;
+
+STATIC AHCI_NCQ_DEVICE mDev;
+STATIC BOOLEAN mFailed;
+STATIC UINT8 mBuffer[SIZE_64KB] __attribute__ ((aligned (16)));
+STATIC UINT8 mBuffer2[SIZE_64KB] __attribute__ ((aligned (16)));
+
+STATIC
+VOID
+StartDevice (
+    IN  UINT16  QueueDepth
+    )
+{
+    FakeHbaInit ();
+    mHba.QueueDepth = QueueDepth;
+
+    ZeroMem (&mDev, sizeof (mDev));
+    mDev.Signature = AHCI_NCQ_SIGNATURE;
+    mDev.PciIo = &mHba.PciIo;
+    InitializeListHead (&mDev.Queue);
+
+    CHECK (AhciAllocateDma (&mDev) == EFI_SUCCESS);
+    CHECK (AhciPortInit (&mDev) == EFI_SUCCESS);
+    mHba.AutoComplete = TRUE;
+    CHECK (AhciIdentify (&mDev) == EFI_SUCCESS);
+    mHba.AutoComplete = FALSE;
+    AhciBlockIoInit (&mDev);
+
+    mHba.LogCount = 0;
+    mHba.MaxPending = 0;
+}
+
+/* What the periodic timer does */
+STATIC
+VOID
+Poll (
+    VOID
+    )
+{
+    EFI_TPL OldTpl;
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    AhciPollEvent (NULL, &mDev);
+    gBS->RestoreTPL (OldTpl);
+}
+
+STATIC
+EFI_BLOCK_IO2_TOKEN *
+TokenInit (
+    OUT TEST_TOKEN  *Token
+    )
+{
+    Token->Signalled = 0;
+    Token->Token.Event = (EFI_EVENT)&Token->Signalled;
+    Token->Token.TransactionStatus = EFI_NOT_READY;
+    return &Token->Token;
+}
+
+STATIC
+EFI_STATUS
+ReadAsync (
+    IN  EFI_LBA     Lba,
+    IN  UINTN       Size,
+    OUT VOID        *Buffer,
+    OUT TEST_TOKEN  *Token
+    )
+{
+    return mDev.BlockIo2.ReadBlocksEx (&mDev.BlockIo2, 0, Lba, TokenInit (Token), Size, Buffer);
+}
+
+STATIC
+EFI_STATUS
+WriteAsync (
+    IN  EFI_LBA     Lba,
+    IN  UINTN       Size,
+    IN  VOID        *Buffer,
+    OUT TEST_TOKEN  *Token
+    )
+{
+    return mDev.BlockIo2.WriteBlocksEx (&mDev.BlockIo2, 0, Lba, TokenInit (Token), Size, Buffer);
+}
+
+/* Port stopped and restarted, nothing left behind */
+STATIC
+VOID
+CheckRecovered (
+    IN  UINTN   ComResets
+    )
+{
+    UINT32 Cmd;
+    UINT32 Is;
+
+    mDev.PciIo->Mem.Read (mDev.PciIo, EfiPciIoWidthUint32, AHCI_BAR_INDEX, SATA_CMD, 1, &Cmd);
+    mDev.PciIo->Mem.Read (mDev.PciIo, EfiPciIoWidthUint32, AHCI_BAR_INDEX, SATA_PIS, 1, &Is);
+    CHECK (mHba.ComResets == ComResets);
+    CHECK ((Cmd & SATA_CMD_ST) != 0);
+    CHECK ((Is & SATA_PIS_ERRORS) == 0);
+    CHECK (mDev.ActiveSlots == 0);
+    CHECK (!mDev.NonQueuedActive);
+    CHECK (mHba.Mappings == 0);
+}
+
+STATIC
+VOID
+TestIdentify (
+    VOID
+    )
+{
+    StartDevice (AHCI_MAX_SLOTS);
+    CHECK (mDev.QueueDepth == AHCI_MAX_SLOTS);
+    CHECK (mDev.Media.BlockSize == FAKE_BLOCK_SIZE);
+    CHECK (mDev.Media.LastBlock == FAKE_DISK_BLOCKS - 1);
+    CHECK (mHba.ComResets == 1);
+
+    /* The shallower of the HBA and the device wins */
+    StartDevice (4);
+    CHECK (mDev.QueueDepth == 4);
+}
+
+STATIC
+VOID
+TestBlockingIo (
+    VOID
+    )
+{
+    UINTN Index;
+
+    StartDevice (AHCI_MAX_SLOTS);
+    mHba.AutoComplete = TRUE;
+    mHba.MapLimit = SIZE_4KB;
+
+    for (Index = 0; Index < sizeof (mBuffer); Index++) {
+        mBuffer[Index] = (UINT8)(Index * 7);
+    }
+    CHECK (mDev.BlockIo.WriteBlocks (&mDev.BlockIo, 0, 100, sizeof (mBuffer), mBuffer) == EFI_SUCCESS);
+    CHECK (CompareMem (BLOCK_BYTES (100), mBuffer, sizeof (mBuffer)) == 0);
+    /* The whole request is queued at once, one command per mapped chunk */
+    CHECK (mHba.MaxPending == sizeof (mBuffer) / SIZE_4KB);
+
+    CHECK (mDev.BlockIo.ReadBlocks (&mDev.BlockIo, 0, 100, sizeof (mBuffer2), mBuffer2) == EFI_SUCCESS);
+    CHECK (CompareMem (mBuffer2, mBuffer, sizeof (mBuffer)) == 0);
+
+    CHECK (mDev.BlockIo.FlushBlocks (&mDev.BlockIo) == EFI_SUCCESS);
+    CHECK (mHba.Log[mHba.LogCount - 1].Command == AHCI_ATA_CMD_FLUSH_CACHE_EXT);
+
+    CHECK (mHba.Pending == 0);
+    CHECK (mHba.Mappings == 0);
+}
+
+STATIC
+VOID
+TestQueueDepth (
+    VOID
+    )
+{
+    TEST_TOKEN Token;
+    UINTN Index;
+
+    StartDevice (4);
+    mHba.MapLimit = SIZE_4KB;
+
+    CHECK (ReadAsync (64, sizeof (mBuffer), mBuffer, &Token) == EFI_SUCCESS);
+    CHECK (mHba.Pending == 0xF);
+    CHECK (mDev.ActiveSlots == 0xF);
+
+    /* Newest first, each freed slot takes the next chunk */
+    while (mHba.Pending != 0) {
+        CHECK (Token.Signalled == 0);
+        FakeHbaComplete (31 - __builtin_clz (mHba.Pending));
+        Poll ();
+        CHECK (FakeHbaPendingCount () <= 4);
+    }
+
+    CHECK (Token.Signalled == 1);
+    CHECK (Token.Token.TransactionStatus == EFI_SUCCESS);
+    CHECK (CompareMem (mBuffer, BLOCK_BYTES (64), sizeof (mBuffer)) == 0);
+    CHECK (mHba.MaxPending == 4);
+    CHECK (mHba.LogCount == sizeof (mBuffer) / SIZE_4KB);
+    for (Index = 0; Index < mHba.LogCount; Index++) {
+        CHECK (mHba.Log[Index].Lba == 64 + Index * (SIZE_4KB / FAKE_BLOCK_SIZE));
+        CHECK (mHba.Log[Index].Blocks == SIZE_4KB / FAKE_BLOCK_SIZE);
+        CHECK (mHba.Log[Index].Slot < 4);
+    }
+    CHECK (mHba.Mappings == 0);
+}
+
+STATIC
+VOID
+TestCompletionOrder (
+    VOID
+    )
+{
+    TEST_TOKEN First;
+    TEST_TOKEN Second;
+
+    StartDevice (AHCI_MAX_SLOTS);
+
+    CHECK (ReadAsync (0, SIZE_4KB, mBuffer, &First) == EFI_SUCCESS);
+    CHECK (ReadAsync (8, SIZE_4KB, mBuffer2, &Second) == EFI_SUCCESS);
+    CHECK (mHba.Pending == 0x3);
+    CHECK (mHba.Log[0].Lba == 0 && mHba.Log[0].Tag == 0);
+    CHECK (mHba.Log[1].Lba == 8 && mHba.Log[1].Tag == 1);
+
+    FakeHbaComplete (1);
+    Poll ();
+    CHECK (First.Signalled == 0);
+    CHECK (Second.Signalled == 1);
+    CHECK (Second.Token.TransactionStatus == EFI_SUCCESS);
+    CHECK (CompareMem (mBuffer2, BLOCK_BYTES (8), SIZE_4KB) == 0);
+
+    FakeHbaComplete (0);
+    Poll ();
+    CHECK (First.Signalled == 1);
+    CHECK (First.Token.TransactionStatus == EFI_SUCCESS);
+    CHECK (CompareMem (mBuffer, BLOCK_BYTES (0), SIZE_4KB) == 0);
+}
+
+STATIC
+VOID
+TestFlushOrdering (
+    VOID
+    )
+{
+    TEST_TOKEN Before;
+    TEST_TOKEN Flush;
+    TEST_TOKEN After;
+
+    StartDevice (AHCI_MAX_SLOTS);
+    mHba.MapLimit = SIZE_4KB;
+
+    CHECK (ReadAsync (0, SIZE_8KB, mBuffer, &Before) == EFI_SUCCESS);
+    CHECK (mDev.BlockIo2.FlushBlocksEx (&mDev.BlockIo2, TokenInit (&Flush)) == EFI_SUCCESS);
+    CHECK (ReadAsync (16, SIZE_4KB, mBuffer2, &After) == EFI_SUCCESS);
+
+    /* The flush waits for the queue to drain and holds back what follows */
+    CHECK (mHba.Pending == 0x3);
+    CHECK (mHba.LogCount == 2);
+    FakeHbaComplete (0);
+    Poll ();
+    CHECK (mHba.LogCount == 2);
+
+    FakeHbaComplete (1);
+    Poll ();
+    CHECK (Before.Signalled == 1);
+    CHECK (mHba.LogCount == 3);
+    CHECK (mHba.Log[2].Command == AHCI_ATA_CMD_FLUSH_CACHE_EXT);
+    CHECK (mHba.Pending == 0x1);
+
+    FakeHbaComplete (0);
+    Poll ();
+    CHECK (Flush.Signalled == 1);
+    CHECK (Flush.Token.TransactionStatus == EFI_SUCCESS);
+    CHECK (mHba.LogCount == 4);
+    CHECK (mHba.Log[3].Command == AHCI_ATA_CMD_READ_FPDMA_QUEUED && mHba.Log[3].Lba == 16);
+
+    FakeHbaComplete (0);
+    Poll ();
+    CHECK (After.Signalled == 1);
+    CHECK (After.Token.TransactionStatus == EFI_SUCCESS);
+    CHECK (mHba.Mappings == 0);
+}
+
+STATIC
+VOID
+TestDeviceError (
+    VOID
+    )
+{
+    TEST_TOKEN Failing;
+    TEST_TOKEN Queued;
+
+    StartDevice (2);
+    mHba.MapLimit = SIZE_4KB;
+
+    /* Two of four chunks issued, the second request still waiting for a slot */
+    CHECK (ReadAsync (0, SIZE_16KB, mBuffer, &Failing) == EFI_SUCCESS);
+    CHECK (WriteAsync (64, SIZE_4KB, mBuffer2, &Queued) == EFI_SUCCESS);
+    CHECK (mHba.Pending == 0x3);
+
+    FakeHbaComplete (1);
+    FakeHbaFail ();
+    Poll ();
+
+    /* Everything outstanding fails; nothing more of that request is issued */
+    CHECK (Failing.Signalled == 1);
+    CHECK (Failing.Token.TransactionStatus == EFI_DEVICE_ERROR);
+    CHECK (Queued.Signalled == 0);
+    CHECK (mHba.ComResets == 2);
+    CHECK (mHba.LogCount == 3);
+    CHECK (mHba.Log[2].Command == AHCI_ATA_CMD_WRITE_FPDMA_QUEUED && mHba.Log[2].Lba == 64);
+
+    /* Requests that hadn't been issued run once the port is back */
+    FakeHbaComplete (mHba.Log[2].Slot);
+    Poll ();
+    CHECK (Queued.Signalled == 1);
+    CHECK (Queued.Token.TransactionStatus == EFI_SUCCESS);
+    CHECK (CompareMem (BLOCK_BYTES (64), mBuffer2, SIZE_4KB) == 0);
+    CheckRecovered (2);
+
+    mHba.AutoComplete = TRUE;
+    CHECK (mDev.BlockIo.ReadBlocks (&mDev.BlockIo, 0, 0, SIZE_8KB, mBuffer) == EFI_SUCCESS);
+    CHECK (CompareMem (mBuffer, BLOCK_BYTES (0), SIZE_8KB) == 0);
+}
+
+STATIC
+VOID
+TestFlushError (
+    VOID
+    )
+{
+    TEST_TOKEN Flush;
+
+    StartDevice (AHCI_MAX_SLOTS);
+
+    CHECK (mDev.BlockIo2.FlushBlocksEx (&mDev.BlockIo2, TokenInit (&Flush)) == EFI_SUCCESS);
+    CHECK (mDev.NonQueuedActive);
+    FakeHbaFail ();
+    Poll ();
+
+    CHECK (Flush.Signalled == 1);
+    CHECK (Flush.Token.TransactionStatus == EFI_DEVICE_ERROR);
+    CheckRecovered (2);
+}
+
+STATIC
+VOID
+TestTimeout (
+    VOID
+    )
+{
+    TEST_TOKEN Token;
+
+    StartDevice (AHCI_MAX_SLOTS);
+
+    CHECK (ReadAsync (0, SIZE_4KB, mBuffer, &Token) == EFI_SUCCESS);
+    mNowNs += AHCI_COMMAND_TIMEOUT_NS - 1000000;
+    Poll ();
+    CHECK (Token.Signalled == 0);
+    CHECK (mHba.Pending == 0x1);
+
+    mNowNs += 2000000;
+    Poll ();
+    CHECK (Token.Signalled == 1);
+    CHECK (Token.Token.TransactionStatus == EFI_TIMEOUT);
+    CHECK (mHba.Pending == 0);
+    CheckRecovered (2);
+}
+
+STATIC
+VOID
+TestReset (
+    VOID
+    )
+{
+    TEST_TOKEN Issued;
+    TEST_TOKEN Queued;
+
+    StartDevice (1);
+
+    CHECK (ReadAsync (0, SIZE_4KB, mBuffer, &Issued) == EFI_SUCCESS);
+    CHECK (ReadAsync (8, SIZE_4KB, mBuffer2, &Queued) == EFI_SUCCESS);
+    CHECK (mHba.Pending == 0x1);
+
+    CHECK (mDev.BlockIo2.Reset (&mDev.BlockIo2, FALSE) == EFI_SUCCESS);
+    CHECK (Issued.Signalled == 1);
+    CHECK (Issued.Token.TransactionStatus == EFI_ABORTED);
+    CHECK (Queued.Signalled == 1);
+    CHECK (Queued.Token.TransactionStatus == EFI_ABORTED);
+    CHECK (IsListEmpty (&mDev.Queue));
+    CheckRecovered (2);
+}
+
+STATIC
+VOID
+TestMapExhausted (
+    VOID
+    )
+{
+    TEST_TOKEN First;
+    TEST_TOKEN Second;
+
+    StartDevice (AHCI_MAX_SLOTS);
+
+    /* Out of bounce buffers with commands in flight: retried on completion */
+    CHECK (ReadAsync (0, SIZE_4KB, mBuffer, &First) == EFI_SUCCESS);
+    mHba.MapFail = TRUE;
+    CHECK (ReadAsync (8, SIZE_4KB, mBuffer2, &Second) == EFI_SUCCESS);
+    CHECK (mHba.Pending == 0x1);
+
+    mHba.MapFail = FALSE;
+    FakeHbaComplete (0);
+    Poll ();
+    CHECK (First.Signalled == 1);
+    CHECK (Second.Signalled == 0);
+    CHECK (mHba.Pending == 0x1);
+    CHECK (mHba.Log[1].Lba == 8);
+
+    FakeHbaComplete (0);
+    Poll ();
+    CHECK (Second.Signalled == 1);
+    CHECK (Second.Token.TransactionStatus == EFI_SUCCESS);
+
+    /* With nothing in flight there is nothing to wait for */
+    mHba.MapFail = TRUE;
+    CHECK (mDev.BlockIo.ReadBlocks (&mDev.BlockIo, 0, 0, SIZE_4KB, mBuffer) == EFI_OUT_OF_RESOURCES);
+    CHECK (mHba.Mappings == 0);
+}
+
+typedef struct {
+    CONST CHAR8 *Name;
+    VOID        (*Run)(VOID);
+} TEST_CASE;
+
+STATIC CONST TEST_CASE mTests[] = {
+    { "Identify",           TestIdentify },
+    { "BlockingIo",         TestBlockingIo },
+    { "QueueDepth",         TestQueueDepth },
+    { "CompletionOrder",    TestCompletionOrder },
+    { "FlushOrdering",      TestFlushOrdering },
+    { "DeviceError",        TestDeviceError },
+    { "FlushError",         TestFlushError },
+    { "Timeout",            TestTimeout },
+    { "Reset",              TestReset },
+    { "MapExhausted",       TestMapExhausted },
+};
+
+int
+main (
+    VOID
+    )
+{
+    UINTN Index;
+    UINTN Failures = 0;
+
+    for (Index = 0; Index < ARRAY_SIZE (mTests); Index++) {
+        mFailed = FALSE;
+        mTests[Index].Run ();
+        if (mHba.Violations != 0) {
+            mFailed = TRUE;
+        }
+        __builtin_printf ("%s %s\n", mFailed ? "FAIL" : "ok  ", mTests[Index].Name);
+        if (mFailed) {
+            Failures++;
+        }
+    }
+
+    __builtin_printf ("%u of %u tests failed\n", (unsigned)Failures, (unsigned)ARRAY_SIZE (mTests));
+    return Failures != 0;
+}
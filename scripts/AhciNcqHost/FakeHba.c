@@ -0,0 +1,656 @@
+/** @file
+ *
+ *  Simulated AHCI port and disk behind a fake PciIo, and the few library
+ *  functions and boot services that AhciNcqDxe uses. Anything the driver
+ *  does that real hardware would reject counts as a violation.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "FakeHba.h"
+
+#define HBA_REG(Offset)         mHba.Regs[(Offset) / 4]
+#define HBA_TFD_IDLE            0x50    /* DRDY | DSC */
+#define HBA_TFD_ERROR           0x41    /* DRDY | ERR */
+#define HBA_PIS_DHRS            BIT0
+#define HBA_PIS_SDBS            BIT3
+
+#define HBA_CHECK(Cond, Message)                                    \
+    do {                                                            \
+        if (!(Cond)) {                                              \
+            __builtin_printf ("  fake HBA: %s\n", Message);         \
+            mHba.Violations++;                                      \
+        }                                                           \
+    } while (FALSE)
+
+FAKE_HBA mHba;
+UINT64 mNowNs;
+
+EFI_GUID gEfiDiskInfoAhciInterfaceGuid = {
+    0x9E498932, 0x4ABC, 0x45AF, { 0xA3, 0x4D, 0x02, 0x47, 0x78, 0x7B, 0xE7, 0xC6 }
+};
+
+STATIC EFI_BOOT_SERVICES mBootServices;
+EFI_BOOT_SERVICES *gBS = &mBootServices;
+STATIC EFI_TPL mTpl;
+
+STATIC UINT8 mDmaBuffer[EFI_PAGES_TO_SIZE (4)] __attribute__ ((aligned (EFI_PAGE_SIZE)));
+STATIC UINT32 mNonQueued;
+
+/* BaseLib, BaseMemoryLib, MemoryAllocationLib */
+
+LIST_ENTRY *
+EFIAPI
+InitializeListHead (
+    IN OUT  LIST_ENTRY  *ListHead
+    )
+{
+    ListHead->ForwardLink = ListHead;
+    ListHead->BackLink = ListHead;
+    return ListHead;
+}
+
+LIST_ENTRY *
+EFIAPI
+InsertTailList (
+    IN OUT  LIST_ENTRY  *ListHead,
+    IN OUT  LIST_ENTRY  *Entry
+    )
+{
+    Entry->ForwardLink = ListHead;
+    Entry->BackLink = ListHead->BackLink;
+    Entry->BackLink->ForwardLink = Entry;
+    ListHead->BackLink = Entry;
+    return ListHead;
+}
+
+LIST_ENTRY *
+EFIAPI
+GetFirstNode (
+    IN  CONST LIST_ENTRY    *List
+    )
+{
+    return List->ForwardLink;
+}
+
+BOOLEAN
+EFIAPI
+IsListEmpty (
+    IN  CONST LIST_ENTRY    *ListHead
+    )
+{
+    return (BOOLEAN)(ListHead->ForwardLink == ListHead);
+}
+
+LIST_ENTRY *
+EFIAPI
+RemoveEntryList (
+    IN  CONST LIST_ENTRY    *Entry
+    )
+{
+    Entry->ForwardLink->BackLink = Entry->BackLink;
+    Entry->BackLink->ForwardLink = Entry->ForwardLink;
+    return Entry->ForwardLink;
+}
+
+INTN
+EFIAPI
+LowBitSet32 (
+    IN  UINT32  Operand
+    )
+{
+    return Operand == 0 ? -1 : __builtin_ctz (Operand);
+}
+
+UINT64
+EFIAPI
+RShiftU64 (
+    IN  UINT64  Operand,
+    IN  UINTN   Count
+    )
+{
+    return Operand >> Count;
+}
+
+UINT64
+EFIAPI
+LShiftU64 (
+    IN  UINT64  Operand,
+    IN  UINTN   Count
+    )
+{
+    return Operand << Count;
+}
+
+VOID
+EFIAPI
+MemoryFence (
+    VOID
+    )
+{
+    __sync_synchronize ();
+}
+
+VOID *
+EFIAPI
+CopyMem (
+    OUT VOID        *DestinationBuffer,
+    IN  CONST VOID  *SourceBuffer,
+    IN  UINTN       Length
+    )
+{
+    return __builtin_memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+ZeroMem (
+    OUT VOID    *Buffer,
+    IN  UINTN   Length
+    )
+{
+    return __builtin_memset (Buffer, 0, Length);
+}
+
+INTN
+EFIAPI
+CompareMem (
+    IN  CONST VOID  *DestinationBuffer,
+    IN  CONST VOID  *SourceBuffer,
+    IN  UINTN       Length
+    )
+{
+    return __builtin_memcmp (DestinationBuffer, SourceBuffer, Length);
+}
+
+GUID *
+EFIAPI
+CopyGuid (
+    OUT GUID        *DestinationGuid,
+    IN  CONST GUID  *SourceGuid
+    )
+{
+    return CopyMem (DestinationGuid, SourceGuid, sizeof (GUID));
+}
+
+VOID *
+EFIAPI
+AllocateZeroPool (
+    IN  UINTN   AllocationSize
+    )
+{
+    return __builtin_calloc (1, AllocationSize);
+}
+
+VOID
+EFIAPI
+FreePool (
+    IN  VOID    *Buffer
+    )
+{
+    __builtin_free (Buffer);
+}
+
+/* TimerLib: time only passes when the driver waits, one tick per nanosecond */
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+    VOID
+    )
+{
+    return mNowNs;
+}
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+    IN  UINT64  Ticks
+    )
+{
+    return Ticks;
+}
+
+UINTN
+EFIAPI
+MicroSecondDelay (
+    IN  UINTN   MicroSeconds
+    )
+{
+    mNowNs += (UINT64)MicroSeconds * 1000;
+    if (mHba.AutoComplete && mHba.Pending != 0) {
+        FakeHbaComplete (31 - __builtin_clz (mHba.Pending));
+    }
+    return MicroSeconds;
+}
+
+/* Boot services */
+
+STATIC
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+    IN  EFI_TPL NewTpl
+    )
+{
+    EFI_TPL OldTpl = mTpl;
+
+    HBA_CHECK (NewTpl >= mTpl, "RaiseTPL to a lower TPL");
+    mTpl = NewTpl;
+    return OldTpl;
+}
+
+STATIC
+VOID
+EFIAPI
+FakeRestoreTpl (
+    IN  EFI_TPL OldTpl
+    )
+{
+    HBA_CHECK (OldTpl <= mTpl, "RestoreTPL to a higher TPL");
+    mTpl = OldTpl;
+}
+
+/* Events are counters owned by the test */
+STATIC
+EFI_STATUS
+EFIAPI
+FakeSignalEvent (
+    IN  EFI_EVENT   Event
+    )
+{
+    (*(UINTN *)Event)++;
+    return EFI_SUCCESS;
+}
+
+/* The port */
+
+STATIC
+VOID *
+FakeHbaHost (
+    IN  UINT32  Low,
+    IN  UINT32  High
+    )
+{
+    /* Identity mapped, device addresses are host pointers */
+    return (VOID *)(UINTN)(((UINT64)High << 32) | Low);
+}
+
+STATIC
+AHCI_CMD_HEADER *
+FakeHbaHeader (
+    IN  UINT32  Slot
+    )
+{
+    return (AHCI_CMD_HEADER *)FakeHbaHost (HBA_REG (SATA_CLB), HBA_REG (SATA_CLBU)) + Slot;
+}
+
+STATIC
+VOID
+FakeHbaIssue (
+    IN  UINT32  Slot
+    )
+{
+    AHCI_CMD_HEADER *Header = FakeHbaHeader (Slot);
+    AHCI_CMD_TABLE *Table = FakeHbaHost (Header->Ctba, Header->Ctbau);
+    FAKE_COMMAND *Command = &mHba.Commands[Slot];
+    UINT8 *Fis = Table->Cfis;
+    UINT32 Bit = 1U << Slot;
+    UINT32 Length;
+
+    HBA_CHECK ((HBA_REG (SATA_CMD) & SATA_CMD_ST) != 0, "command issued to a stopped port");
+    HBA_CHECK ((mHba.Pending & Bit) == 0, "slot reused before it completed");
+    HBA_CHECK (Fis[0] == AHCI_FIS_H2D && (Fis[1] & AHCI_FIS_H2D_C) != 0, "not a command FIS");
+    HBA_CHECK (AHCI_CMD_HEADER_CFL (Header->Flags) == AHCI_FIS_H2D_LENGTH, "bad FIS length");
+    HBA_CHECK (mNonQueued == 0, "command issued while a non-queued command is active");
+
+    ZeroMem (Command, sizeof (*Command));
+    Command->Command = Fis[2];
+    Command->Slot = Slot;
+    Command->Tag = MAX_UINT32;
+    Command->Lba = Fis[4] | ((UINT64)Fis[5] << 8) | ((UINT64)Fis[6] << 16) |
+                   ((UINT64)Fis[8] << 24) | ((UINT64)Fis[9] << 32) | ((UINT64)Fis[10] << 40);
+    if ((Header->Flags >> 16) != 0) {
+        Command->Buffer = FakeHbaHost (Table->Prd.Dba, Table->Prd.Dbau);
+    }
+    Length = Table->Prd.Dbc + 1;
+
+    switch (Command->Command) {
+    case AHCI_ATA_CMD_READ_FPDMA_QUEUED:
+    case AHCI_ATA_CMD_WRITE_FPDMA_QUEUED:
+        Command->Tag = Fis[12] >> 3;
+        Command->Blocks = Fis[3] | ((UINT32)Fis[11] << 8);
+        if (Command->Blocks == 0) {
+            Command->Blocks = SIZE_64KB;
+        }
+        HBA_CHECK (mTpl == TPL_NOTIFY, "queued command issued below TPL_NOTIFY");
+        HBA_CHECK (Command->Tag == Slot, "NCQ tag differs from the command slot");
+        HBA_CHECK ((HBA_REG (SATA_SACT) & Bit) != 0, "CI set before SACT");
+        HBA_CHECK (((Header->Flags & AHCI_CMD_HEADER_W) != 0) ==
+                   (Command->Command == AHCI_ATA_CMD_WRITE_FPDMA_QUEUED), "W bit does not match the command");
+        HBA_CHECK ((Header->Flags >> 16) == 1, "expected a single PRD");
+        HBA_CHECK (Length == Command->Blocks * FAKE_BLOCK_SIZE, "PRD length differs from the sector count");
+        HBA_CHECK (((UINTN)Command->Buffer & 1) == 0, "PRD address not word aligned");
+        HBA_CHECK (Command->Lba + Command->Blocks <= FAKE_DISK_BLOCKS, "transfer past the end of the disk");
+        /* The device has the command once the FIS is sent, SACT tracks it from here */
+        HBA_REG (SATA_CI) &= ~Bit;
+        break;
+    case AHCI_ATA_CMD_IDENTIFY:
+        HBA_CHECK (Length == sizeof (ATA_IDENTIFY_DATA), "bad IDENTIFY length");
+        /* Fall through */
+    case AHCI_ATA_CMD_FLUSH_CACHE_EXT:
+        HBA_CHECK (mHba.Pending == 0 && HBA_REG (SATA_SACT) == 0,
+                   "non-queued command issued while queued commands are active");
+        mNonQueued |= Bit;
+        break;
+    default:
+        HBA_CHECK (FALSE, "unexpected command");
+        break;
+    }
+
+    mHba.Pending |= Bit;
+    if (FakeHbaPendingCount () > mHba.MaxPending) {
+        mHba.MaxPending = FakeHbaPendingCount ();
+    }
+    if (mHba.LogCount < FAKE_LOG_SIZE) {
+        mHba.Log[mHba.LogCount++] = *Command;
+    }
+}
+
+STATIC
+VOID
+FakeHbaIdentify (
+    OUT UINT16  *Id
+    )
+{
+    ZeroMem (Id, sizeof (ATA_IDENTIFY_DATA));
+    Id[75] = mHba.QueueDepth - 1;
+    Id[76] = AHCI_ID_SATA_CAP_NCQ;
+    Id[83] = AHCI_ID_CMD_SET_LBA48;
+    Id[100] = FAKE_DISK_BLOCKS;
+    /* Word 106 valid, 512 byte logical and physical sectors */
+    Id[106] = BIT14;
+}
+
+VOID
+FakeHbaComplete (
+    IN  UINT32  Slot
+    )
+{
+    FAKE_COMMAND *Command = &mHba.Commands[Slot];
+    UINT32 Bit = 1U << Slot;
+    UINT32 Length = Command->Blocks * FAKE_BLOCK_SIZE;
+
+    HBA_CHECK ((mHba.Pending & Bit) != 0, "completing a slot that is not active");
+    if ((mHba.Pending & Bit) == 0) {
+        return;
+    }
+
+    switch (Command->Command) {
+    case AHCI_ATA_CMD_IDENTIFY:
+        FakeHbaIdentify ((UINT16 *)Command->Buffer);
+        Length = sizeof (ATA_IDENTIFY_DATA);
+        break;
+    case AHCI_ATA_CMD_READ_FPDMA_QUEUED:
+        CopyMem (Command->Buffer, mHba.Disk + Command->Lba * FAKE_BLOCK_SIZE, Length);
+        break;
+    case AHCI_ATA_CMD_WRITE_FPDMA_QUEUED:
+        CopyMem (mHba.Disk + Command->Lba * FAKE_BLOCK_SIZE, Command->Buffer, Length);
+        break;
+    default:
+        break;
+    }
+    FakeHbaHeader (Slot)->Prdbc = Length;
+
+    mHba.Pending &= ~Bit;
+    HBA_REG (SATA_SACT) &= ~Bit;
+    HBA_REG (SATA_CI) &= ~Bit;
+    HBA_REG (SATA_PIS) |= (mNonQueued & Bit) != 0 ? HBA_PIS_DHRS : HBA_PIS_SDBS;
+    mNonQueued &= ~Bit;
+}
+
+VOID
+FakeHbaFail (
+    VOID
+    )
+{
+    HBA_REG (SATA_TFD) = HBA_TFD_ERROR;
+    HBA_REG (SATA_PIS) |= SATA_PIS_TFES;
+}
+
+UINTN
+FakeHbaPendingCount (
+    VOID
+    )
+{
+    return __builtin_popcount (mHba.Pending);
+}
+
+STATIC
+VOID
+FakeHbaWrite (
+    IN  UINT32  Offset,
+    IN  UINT32  Data
+    )
+{
+    UINT32 Issued;
+
+    switch (Offset) {
+    case SATA_PIS:
+    case SATA_SERR:
+        HBA_REG (Offset) &= ~Data;
+        break;
+    case SATA_CMD:
+        if ((Data & SATA_CMD_ST) != 0) {
+            HBA_CHECK ((Data & SATA_CMD_FRE) != 0, "ST set without FRE");
+            HBA_CHECK ((HBA_REG (SATA_TFD) & (SATA_TFD_BSY | SATA_TFD_DRQ)) == 0, "ST set while busy");
+            Data |= SATA_CMD_CR;
+        } else {
+            /* Stopping the command list engine drops everything outstanding */
+            Data &= ~SATA_CMD_CR;
+            HBA_REG (SATA_SACT) = 0;
+            HBA_REG (SATA_CI) = 0;
+            mHba.Pending = 0;
+            mNonQueued = 0;
+        }
+        if ((Data & SATA_CMD_FRE) != 0) {
+            Data |= SATA_CMD_FR;
+        } else {
+            Data &= ~SATA_CMD_FR;
+        }
+        HBA_REG (SATA_CMD) = Data;
+        break;
+    case SATA_SCTL:
+        HBA_REG (SATA_SCTL) = Data;
+        if ((Data & SATA_SCTL_DET_MASK) == SATA_SCTL_DET_COMRESET) {
+            HBA_CHECK ((HBA_REG (SATA_CMD) & SATA_CMD_ST) == 0, "COMRESET with the port running");
+            mHba.ComResets++;
+            HBA_REG (SATA_SSTS) = 0;
+        } else if ((HBA_REG (SATA_SSTS) & SATA_SSTS_DET_MASK) == 0 && mHba.LinkUp) {
+            HBA_REG (SATA_SSTS) = SATA_SSTS_DET_PHY | (SATA_SPEED_GEN3 << SATA_SSTS_SPD_SHIFT) |
+                                  (SATA_SSTS_IPM_ACTIVE << SATA_SSTS_IPM_SHIFT);
+            HBA_REG (SATA_TFD) = HBA_TFD_IDLE;
+            HBA_REG (SATA_SIG) = SATA_SIG_ATA;
+        }
+        break;
+    case SATA_SACT:
+        HBA_CHECK ((HBA_REG (SATA_CMD) & SATA_CMD_ST) != 0, "SACT set on a stopped port");
+        HBA_REG (SATA_SACT) |= Data;
+        break;
+    case SATA_CI:
+        Issued = Data & ~HBA_REG (SATA_CI);
+        HBA_REG (SATA_CI) |= Data;
+        while (Issued != 0) {
+            FakeHbaIssue (__builtin_ctz (Issued));
+            Issued &= Issued - 1;
+        }
+        break;
+    case SATA_CAP:
+    case SATA_TFD:
+    case SATA_SIG:
+    case SATA_SSTS:
+        HBA_CHECK (FALSE, "write to a read-only register");
+        break;
+    default:
+        HBA_REG (Offset) = Data;
+        break;
+    }
+}
+
+/* PciIo */
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePciIoMemRead (
+    IN      EFI_PCI_IO_PROTOCOL         *This,
+    IN      EFI_PCI_IO_PROTOCOL_WIDTH   Width,
+    IN      UINT8                       BarIndex,
+    IN      UINT64                      Offset,
+    IN      UINTN                       Count,
+    IN OUT  VOID                        *Buffer
+    )
+{
+    HBA_CHECK (Width == EfiPciIoWidthUint32 && BarIndex == AHCI_BAR_INDEX && Count == 1 &&
+               Offset < sizeof (mHba.Regs) && (Offset & 3) == 0, "bad register read");
+    *(UINT32 *)Buffer = HBA_REG (Offset);
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePciIoMemWrite (
+    IN      EFI_PCI_IO_PROTOCOL         *This,
+    IN      EFI_PCI_IO_PROTOCOL_WIDTH   Width,
+    IN      UINT8                       BarIndex,
+    IN      UINT64                      Offset,
+    IN      UINTN                       Count,
+    IN OUT  VOID                        *Buffer
+    )
+{
+    HBA_CHECK (Width == EfiPciIoWidthUint32 && BarIndex == AHCI_BAR_INDEX && Count == 1 &&
+               Offset < sizeof (mHba.Regs) && (Offset & 3) == 0, "bad register write");
+    FakeHbaWrite ((UINT32)Offset, *(UINT32 *)Buffer);
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePciIoMap (
+    IN      EFI_PCI_IO_PROTOCOL             *This,
+    IN      EFI_PCI_IO_PROTOCOL_OPERATION   Operation,
+    IN      VOID                            *HostAddress,
+    IN OUT  UINTN                           *NumberOfBytes,
+    OUT     EFI_PHYSICAL_ADDRESS            *DeviceAddress,
+    OUT     VOID                            **Mapping
+    )
+{
+    if (Operation != EfiPciIoOperationBusMasterCommonBuffer) {
+        if (mHba.MapFail) {
+            return EFI_OUT_OF_RESOURCES;
+        }
+        /* Like a bounce buffer that is smaller than the request */
+        if (mHba.MapLimit != 0 && *NumberOfBytes > mHba.MapLimit) {
+            *NumberOfBytes = mHba.MapLimit;
+        }
+        mHba.Mappings++;
+    }
+    *DeviceAddress = (UINTN)HostAddress;
+    *Mapping = HostAddress;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePciIoUnmap (
+    IN  EFI_PCI_IO_PROTOCOL *This,
+    IN  VOID                *Mapping
+    )
+{
+    if (Mapping != mDmaBuffer) {
+        HBA_CHECK (mHba.Mappings != 0, "unmapped more than was mapped");
+        mHba.Mappings--;
+    }
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePciIoAllocateBuffer (
+    IN  EFI_PCI_IO_PROTOCOL *This,
+    IN  EFI_ALLOCATE_TYPE   Type,
+    IN  EFI_MEMORY_TYPE     MemoryType,
+    IN  UINTN               Pages,
+    OUT VOID                **HostAddress,
+    IN  UINT64              Attributes
+    )
+{
+    if (Pages > EFI_SIZE_TO_PAGES (sizeof (mDmaBuffer))) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    *HostAddress = mDmaBuffer;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePciIoFreeBuffer (
+    IN  EFI_PCI_IO_PROTOCOL *This,
+    IN  UINTN               Pages,
+    IN  VOID                *HostAddress
+    )
+{
+    return EFI_SUCCESS;
+}
+
+VOID
+FakeHbaInit (
+    VOID
+    )
+{
+    UINTN Index;
+
+    ZeroMem (&mHba, sizeof (mHba));
+    mHba.PciIo.Mem.Read = FakePciIoMemRead;
+    mHba.PciIo.Mem.Write = FakePciIoMemWrite;
+    mHba.PciIo.Map = FakePciIoMap;
+    mHba.PciIo.Unmap = FakePciIoUnmap;
+    mHba.PciIo.AllocateBuffer = FakePciIoAllocateBuffer;
+    mHba.PciIo.FreeBuffer = FakePciIoFreeBuffer;
+    mHba.QueueDepth = AHCI_MAX_SLOTS;
+    mHba.LinkUp = TRUE;
+
+    HBA_REG (SATA_CAP) = SATA_CAP_S64A | SATA_CAP_SNCQ | ((AHCI_MAX_SLOTS - 1) << SATA_CAP_NCS_SHIFT);
+    HBA_REG (SATA_PI) = BIT0;
+    HBA_REG (SATA_TFD) = HBA_TFD_IDLE;
+    HBA_REG (SATA_SIG) = SATA_SIG_ATA;
+    HBA_REG (SATA_SSTS) = SATA_SSTS_DET_PHY;
+    mNonQueued = 0;
+
+    for (Index = 0; Index < sizeof (mHba.Disk); Index++) {
+        mHba.Disk[Index] = (UINT8)(Index ^ (Index >> 9));
+    }
+
+    ZeroMem (&mBootServices, sizeof (mBootServices));
+    mBootServices.RaiseTPL = FakeRaiseTpl;
+    mBootServices.RestoreTPL = FakeRestoreTpl;
+    mBootServices.SignalEvent = FakeSignalEvent;
+    mTpl = TPL_APPLICATION;
+    mNowNs = 0;
+}
@@ -0,0 +1,80 @@
+/** @file
+ *
+ *  A single port AHCI controller and disk simulated behind a fake
+ *  EFI_PCI_IO_PROTOCOL, for running AhciNcqDxe on the build host.
+ *
+ *  Commands are only parsed when they are issued. The test decides when
+ *  each one completes, or lets MicroSecondDelay complete them newest first,
+ *  so that completion order differs from issue order.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef FAKEHBA_H__
+#define FAKEHBA_H__
+
+#include "AhciNcqDxe.h"
+
+#define FAKE_DISK_BLOCKS        2048
+#define FAKE_BLOCK_SIZE         512
+#define FAKE_LOG_SIZE           256
+
+typedef struct {
+    UINT8       Command;
+    UINT32      Slot;
+    UINT32      Tag;
+    UINT64      Lba;
+    UINT32      Blocks;
+    UINT8       *Buffer;
+} FAKE_COMMAND;
+
+typedef struct {
+    EFI_PCI_IO_PROTOCOL PciIo;
+    UINT32              Regs[0x140 / 4];
+    UINT32              Pending;        /* issued and not completed */
+    FAKE_COMMAND        Commands[AHCI_MAX_SLOTS];
+    UINT8               Disk[FAKE_DISK_BLOCKS * FAKE_BLOCK_SIZE];
+
+    /* Knobs */
+    UINT16              QueueDepth;     /* IDENTIFY word 75 + 1 */
+    BOOLEAN             AutoComplete;   /* complete one command per MicroSecondDelay */
+    BOOLEAN             LinkUp;
+    UINTN               MapLimit;       /* 0 maps everything, else bytes per Map */
+    BOOLEAN             MapFail;        /* no bounce buffers left */
+
+    /* Observations */
+    FAKE_COMMAND        Log[FAKE_LOG_SIZE];
+    UINTN               LogCount;
+    UINTN               MaxPending;
+    UINTN               Mappings;       /* data buffers still mapped */
+    UINTN               ComResets;
+    UINTN               Violations;
+} FAKE_HBA;
+
+extern FAKE_HBA mHba;
+extern UINT64 mNowNs;
+
+VOID
+FakeHbaInit (
+    VOID
+    );
+
+VOID
+FakeHbaComplete (
+    IN  UINT32  Slot
+    );
+
+VOID
+FakeHbaFail (
+    VOID
+    );
+
+UINTN
+FakeHbaPendingCount (
+    VOID
+    );
+
+#endif /* FAKEHBA_H__ */
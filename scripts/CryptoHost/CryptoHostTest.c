@@ -0,0 +1,686 @@
+/** @file
+ *
+ *  Runs CryptoDxe's Hash2 protocol and engine code on the build host
+ *  against FakeCrypto.c, for testcrypto.py. Checks the FIPS 180-2 example
+ *  digests through the engine and the software paths, one-shot and split
+ *  into many parts, every split of short messages around the block size,
+ *  sharing the engine between callers and falling back to software when it
+ *  fails, then times the engine path against BaseCryptLib.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "FakeCrypto.h"
+
+#define CHECK(Cond)                                                         \
+    do {                                                                    \
+        if (!(Cond)) {                                                      \
+            __builtin_printf ("  %s:%d: %s\n", __FILE__, __LINE__, #Cond);  \
+            mFailed = TRUE;                                                 \
+        }                                                                   \
+    } while (FALSE)
+
+#define MESSAGE_SIZE        (SIZE_2MB + 16)
+/* More than three bounce buffers */
+#define ERROR_LENGTH        200000
+#define BENCH_SIZE          SIZE_1MB
+#define BENCH_ROUNDS        64
+
+/* From the host C library, for timing */
+typedef struct {
+    INT64   Sec;
+    INT64   Nsec;
+} HOST_TIMESPEC;
+
+int
+clock_gettime (
+    int             Clock,
+    HOST_TIMESPEC   *Time
+    );
+
+#define HOST_CLOCK_MONOTONIC    1
+
+EFI_STATUS
+EFIAPI
+InitializeCrypto (
+    IN EFI_HANDLE            ImageHandle,
+    IN EFI_SYSTEM_TABLE      *SystemTable
+    );
+
+/*
+ * FIPS 180-2 appendix examples, plus the empty message of the NIST SHAVS
+ * short message files. Digests in mCryptoHashAlgos order.
+ */
+typedef struct {
+    CONST CHAR8 *Pattern;
+    UINTN       Repeat;
+    UINT8       Digest[4][SHA512_DIGEST_SIZE];
+} HASH_VECTOR;
+
+STATIC CONST HASH_VECTOR mVectors[] = {
+    {
+        /* empty message */
+        "", 1,
+        {
+            {
+                0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55, 0xbf, 0xef,
+                0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09
+            },
+            {
+                0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8,
+                0x99, 0x6f, 0xb9, 0x24, 0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c,
+                0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55
+            },
+            {
+                0x38, 0xb0, 0x60, 0xa7, 0x51, 0xac, 0x96, 0x38, 0x4c, 0xd9, 0x32, 0x7e,
+                0xb1, 0xb1, 0xe3, 0x6a, 0x21, 0xfd, 0xb7, 0x11, 0x14, 0xbe, 0x07, 0x43,
+                0x4c, 0x0c, 0xc7, 0xbf, 0x63, 0xf6, 0xe1, 0xda, 0x27, 0x4e, 0xde, 0xbf,
+                0xe7, 0x6f, 0x65, 0xfb, 0xd5, 0x1a, 0xd2, 0xf1, 0x48, 0x98, 0xb9, 0x5b
+            },
+            {
+                0xcf, 0x83, 0xe1, 0x35, 0x7e, 0xef, 0xb8, 0xbd, 0xf1, 0x54, 0x28, 0x50,
+                0xd6, 0x6d, 0x80, 0x07, 0xd6, 0x20, 0xe4, 0x05, 0x0b, 0x57, 0x15, 0xdc,
+                0x83, 0xf4, 0xa9, 0x21, 0xd3, 0x6c, 0xe9, 0xce, 0x47, 0xd0, 0xd1, 0x3c,
+                0x5d, 0x85, 0xf2, 0xb0, 0xff, 0x83, 0x18, 0xd2, 0x87, 0x7e, 0xec, 0x2f,
+                0x63, 0xb9, 0x31, 0xbd, 0x47, 0x41, 0x7a, 0x81, 0xa5, 0x38, 0x32, 0x7a,
+                0xf9, 0x27, 0xda, 0x3e
+            }
+        }
+    },
+    {
+        /* one block */
+        "abc", 1,
+        {
+            {
+                0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e, 0x25, 0x71,
+                0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d
+            },
+            {
+                0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde,
+                0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+                0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+            },
+            {
+                0xcb, 0x00, 0x75, 0x3f, 0x45, 0xa3, 0x5e, 0x8b, 0xb5, 0xa0, 0x3d, 0x69,
+                0x9a, 0xc6, 0x50, 0x07, 0x27, 0x2c, 0x32, 0xab, 0x0e, 0xde, 0xd1, 0x63,
+                0x1a, 0x8b, 0x60, 0x5a, 0x43, 0xff, 0x5b, 0xed, 0x80, 0x86, 0x07, 0x2b,
+                0xa1, 0xe7, 0xcc, 0x23, 0x58, 0xba, 0xec, 0xa1, 0x34, 0xc8, 0x25, 0xa7
+            },
+            {
+                0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49,
+                0xae, 0x20, 0x41, 0x31, 0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+                0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a, 0x21, 0x92, 0x99, 0x2a,
+                0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+                0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f,
+                0xa5, 0x4c, 0xa4, 0x9f
+            }
+        }
+    },
+    {
+        /* 448 bits */
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+        {
+            {
+                0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae, 0x4a, 0xa1,
+                0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46, 0x70, 0xf1
+            },
+            {
+                0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93,
+                0x0c, 0x3e, 0x60, 0x39, 0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+                0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+            },
+            {
+                0x33, 0x91, 0xfd, 0xdd, 0xfc, 0x8d, 0xc7, 0x39, 0x37, 0x07, 0xa6, 0x5b,
+                0x1b, 0x47, 0x09, 0x39, 0x7c, 0xf8, 0xb1, 0xd1, 0x62, 0xaf, 0x05, 0xab,
+                0xfe, 0x8f, 0x45, 0x0d, 0xe5, 0xf3, 0x6b, 0xc6, 0xb0, 0x45, 0x5a, 0x85,
+                0x20, 0xbc, 0x4e, 0x6f, 0x5f, 0xe9, 0x5b, 0x1f, 0xe3, 0xc8, 0x45, 0x2b
+            },
+            {
+                0x20, 0x4a, 0x8f, 0xc6, 0xdd, 0xa8, 0x2f, 0x0a, 0x0c, 0xed, 0x7b, 0xeb,
+                0x8e, 0x08, 0xa4, 0x16, 0x57, 0xc1, 0x6e, 0xf4, 0x68, 0xb2, 0x28, 0xa8,
+                0x27, 0x9b, 0xe3, 0x31, 0xa7, 0x03, 0xc3, 0x35, 0x96, 0xfd, 0x15, 0xc1,
+                0x3b, 0x1b, 0x07, 0xf9, 0xaa, 0x1d, 0x3b, 0xea, 0x57, 0x78, 0x9c, 0xa0,
+                0x31, 0xad, 0x85, 0xc7, 0xa7, 0x1d, 0xd7, 0x03, 0x54, 0xec, 0x63, 0x12,
+                0x38, 0xca, 0x34, 0x45
+            }
+        }
+    },
+    {
+        /* 896 bits */
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+          "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", 1,
+        {
+            {
+                0xa4, 0x9b, 0x24, 0x46, 0xa0, 0x2c, 0x64, 0x5b, 0xf4, 0x19, 0xf9, 0x95,
+                0xb6, 0x70, 0x91, 0x25, 0x3a, 0x04, 0xa2, 0x59
+            },
+            {
+                0xcf, 0x5b, 0x16, 0xa7, 0x78, 0xaf, 0x83, 0x80, 0x03, 0x6c, 0xe5, 0x9e,
+                0x7b, 0x04, 0x92, 0x37, 0x0b, 0x24, 0x9b, 0x11, 0xe8, 0xf0, 0x7a, 0x51,
+                0xaf, 0xac, 0x45, 0x03, 0x7a, 0xfe, 0xe9, 0xd1
+            },
+            {
+                0x09, 0x33, 0x0c, 0x33, 0xf7, 0x11, 0x47, 0xe8, 0x3d, 0x19, 0x2f, 0xc7,
+                0x82, 0xcd, 0x1b, 0x47, 0x53, 0x11, 0x1b, 0x17, 0x3b, 0x3b, 0x05, 0xd2,
+                0x2f, 0xa0, 0x80, 0x86, 0xe3, 0xb0, 0xf7, 0x12, 0xfc, 0xc7, 0xc7, 0x1a,
+                0x55, 0x7e, 0x2d, 0xb9, 0x66, 0xc3, 0xe9, 0xfa, 0x91, 0x74, 0x60, 0x39
+            },
+            {
+                0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda, 0x8c, 0xf4, 0xf7, 0x28,
+                0x14, 0xfc, 0x14, 0x3f, 0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1,
+                0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18, 0x50, 0x1d, 0x28, 0x9e,
+                0x49, 0x00, 0xf7, 0xe4, 0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
+                0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54, 0x5e, 0x96, 0xe5, 0x5b,
+                0x87, 0x4b, 0xe9, 0x09
+            }
+        }
+    },
+    {
+        /* one million times 'a' */
+        "a", 1000000,
+        {
+            {
+                0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e, 0xeb, 0x2b,
+                0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f
+            },
+            {
+                0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2,
+                0x84, 0xd7, 0x3e, 0x67, 0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e,
+                0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+            },
+            {
+                0x9d, 0x0e, 0x18, 0x09, 0x71, 0x64, 0x74, 0xcb, 0x08, 0x6e, 0x83, 0x4e,
+                0x31, 0x0a, 0x4a, 0x1c, 0xed, 0x14, 0x9e, 0x9c, 0x00, 0xf2, 0x48, 0x52,
+                0x79, 0x72, 0xce, 0xc5, 0x70, 0x4c, 0x2a, 0x5b, 0x07, 0xb8, 0xb3, 0xdc,
+                0x38, 0xec, 0xc4, 0xeb, 0xae, 0x97, 0xdd, 0xd8, 0x7f, 0x3d, 0x89, 0x85
+            },
+            {
+                0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7,
+                0xbc, 0x15, 0xb4, 0x63, 0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28,
+                0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb, 0xde, 0x0f, 0xf2, 0x44,
+                0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
+                0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17,
+                0xad, 0x8c, 0xc0, 0x9b
+            }
+        }
+    },
+};
+
+/* Update sizes, used in turn until the message runs out */
+STATIC CONST UINTN mSplits[][4] = {
+    { 1, 1, 1, 1 },
+    { 3, 61, 64, 200 },
+    { 63, 1, 127, 129 },
+    { 64, 64, 128, 128 },
+    { 65, 191, 7, 1000 },
+    { SIZE_64KB - 1, 2, SIZE_64KB, 77 },
+    { SIZE_1MB + 1, 5, 100000, 1 },
+};
+
+STATIC BOOLEAN mFailed;
+STATIC UINTN mAllocations;
+STATIC UINT8 mMessage[MESSAGE_SIZE] __attribute__ ((aligned (8)));
+STATIC EFI_HANDLE mHandle[2];
+STATIC EFI_HASH2_PROTOCOL *mHash2[2];
+
+STATIC
+VOID
+Reference (
+    IN  UINTN       AlgoIndex,
+    IN  CONST UINT8 *Message,
+    IN  UINTN       Length,
+    OUT UINT8       *Digest
+    )
+{
+    HOST_SHA_CONTEXT Context;
+
+    HostShaInit (&Context, AlgoIndex);
+    HostShaUpdate (&Context, Message, Length);
+    HostShaFinal (&Context, Digest);
+}
+
+STATIC
+UINTN
+FillVector (
+    IN  CONST HASH_VECTOR   *Vector
+    )
+{
+    UINTN Length = __builtin_strlen (Vector->Pattern);
+    UINTN Index;
+
+    for (Index = 0; Index < Vector->Repeat; Index++) {
+        CopyMem (&mMessage[Index * Length], Vector->Pattern, Length);
+    }
+    return Length * Vector->Repeat;
+}
+
+STATIC
+EFI_STATUS
+HashMultiPart (
+    IN  EFI_HASH2_PROTOCOL  *Hash2,
+    IN  UINTN               AlgoIndex,
+    IN  CONST UINT8         *Message,
+    IN  UINTN               Length,
+    IN  CONST UINTN         *Split,
+    OUT UINT8               *Digest
+    )
+{
+    EFI_STATUS Status;
+    UINTN Index;
+    UINTN Part;
+
+    Status = Hash2->HashInit (Hash2, mCryptoHashAlgos[AlgoIndex].Guid);
+    for (Index = 0; !EFI_ERROR (Status) && Length > 0; Index++) {
+        Part = MIN (Length, Split[Index % 4]);
+        Status = Hash2->HashUpdate (Hash2, Message, Part);
+        Message += Part;
+        Length -= Part;
+    }
+    if (!EFI_ERROR (Status)) {
+        Status = Hash2->HashFinal (Hash2, (EFI_HASH2_OUTPUT *)Digest);
+    }
+    return Status;
+}
+
+/* Reference digests, checked against the FIPS examples */
+STATIC
+VOID
+TestHostSha (
+    VOID
+    )
+{
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    UINTN Vector;
+    UINTN Algo;
+    UINTN Length;
+
+    for (Vector = 0; Vector < ARRAY_SIZE (mVectors); Vector++) {
+        Length = FillVector (&mVectors[Vector]);
+        for (Algo = 0; Algo < mCryptoHashAlgoCount; Algo++) {
+            Reference (Algo, mMessage, Length, Digest);
+            CHECK (CompareMem (Digest, mVectors[Vector].Digest[Algo], mCryptoHashAlgos[Algo].DigestSize) == 0);
+        }
+    }
+}
+
+/* The driver's own known answer and multi-part tests pass on the engine */
+STATIC
+VOID
+TestLoad (
+    VOID
+    )
+{
+    EFI_HANDLE ImageHandle = NULL;
+    UINTN Index;
+
+    FakeCryptoInit ();
+    CHECK (InitializeCrypto (ImageHandle, NULL) == EFI_SUCCESS);
+    for (Index = 0; Index < mCryptoHashAlgoCount; Index++) {
+        CHECK (mCryptoHashAlgos[Index].HwUsable);
+    }
+    CHECK (mEngine.Strings == 2 * mCryptoHashAlgoCount);
+    CHECK (!mEngine.Enabled);
+
+    for (Index = 0; Index < ARRAY_SIZE (mHandle); Index++) {
+        mHandle[Index] = NULL;
+        CHECK (mCryptoHash2ServiceBinding.CreateChild (&mCryptoHash2ServiceBinding, &mHandle[Index]) == EFI_SUCCESS);
+        CHECK (gBS->HandleProtocol (mHandle[Index], &gEfiHash2ProtocolGuid, (VOID **)&mHash2[Index]) == EFI_SUCCESS);
+    }
+
+    /* Engine pages, the service binding and the two children stay */
+    mAllocations = FakeCryptoAllocations ();
+}
+
+STATIC
+VOID
+TestVectors (
+    VOID
+    )
+{
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    CRYPTO_HASH_ALGO *Algo;
+    UINTN Strings;
+    UINTN Vector;
+    UINTN Index;
+    UINTN Length;
+    UINTN Split;
+    UINTN Hw;
+
+    for (Vector = 0; Vector < ARRAY_SIZE (mVectors); Vector++) {
+        Length = FillVector (&mVectors[Vector]);
+        for (Index = 0; Index < mCryptoHashAlgoCount; Index++) {
+            Algo = &mCryptoHashAlgos[Index];
+            for (Hw = 0; Hw < 2; Hw++) {
+                Algo->HwUsable = (BOOLEAN)Hw;
+
+                Strings = mEngine.Strings;
+                CHECK (mHash2[0]->Hash (mHash2[0], Algo->Guid, mMessage, Length,
+                                        (EFI_HASH2_OUTPUT *)Digest) == EFI_SUCCESS);
+                CHECK (CompareMem (Digest, mVectors[Vector].Digest[Index], Algo->DigestSize) == 0);
+                /* The engine can't hash an empty message */
+                CHECK (mEngine.Strings == Strings + (Hw && Length > 0));
+
+                for (Split = 0; Split < ARRAY_SIZE (mSplits); Split++) {
+                    Strings = mEngine.Strings;
+                    CHECK (HashMultiPart (mHash2[0], Index, mMessage, Length, mSplits[Split], Digest) == EFI_SUCCESS);
+                    CHECK (CompareMem (Digest, mVectors[Vector].Digest[Index], Algo->DigestSize) == 0);
+                    CHECK (mEngine.Strings == Strings + (Hw && Length > 0));
+                }
+            }
+            Algo->HwUsable = TRUE;
+        }
+    }
+}
+
+/*
+ * Every length up to three of the largest blocks, split every way in
+ * mSplits, from aligned and unaligned buffers so that both the in place
+ * and the bounce buffer transfers are used.
+ */
+STATIC
+VOID
+TestSplits (
+    VOID
+    )
+{
+    STATIC CONST UINTN Offsets[] = { 0, 1, 4, 8 };
+    STATIC CONST UINTN Long[] = { SIZE_64KB - 1, SIZE_64KB + 129, SIZE_1MB + 77, SIZE_2MB };
+    UINT8 Expected[SHA512_DIGEST_SIZE];
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    UINTN Algo;
+    UINTN Length;
+    UINTN Offset;
+    UINTN Split;
+    UINTN Index;
+
+    for (Index = 0; Index < MESSAGE_SIZE; Index++) {
+        mMessage[Index] = (UINT8)(Index * 131 + (Index >> 9));
+    }
+
+    for (Algo = 0; Algo < mCryptoHashAlgoCount; Algo++) {
+        for (Offset = 0; Offset < ARRAY_SIZE (Offsets); Offset++) {
+            for (Length = 0; Length <= 3 * CRYPTO_MAX_BLOCK_SIZE + 2; Length++) {
+                Reference (Algo, mMessage + Offsets[Offset], Length, Expected);
+                for (Split = 0; Split < 5; Split++) {
+                    CHECK (HashMultiPart (mHash2[0], Algo, mMessage + Offsets[Offset], Length,
+                                          mSplits[Split], Digest) == EFI_SUCCESS);
+                    CHECK (CompareMem (Digest, Expected, mCryptoHashAlgos[Algo].DigestSize) == 0);
+                }
+            }
+
+            for (Length = 0; Length < ARRAY_SIZE (Long); Length++) {
+                Reference (Algo, mMessage + Offsets[Offset], Long[Length], Expected);
+                CHECK (mHash2[0]->Hash (mHash2[0], mCryptoHashAlgos[Algo].Guid, mMessage + Offsets[Offset],
+                                        Long[Length], (EFI_HASH2_OUTPUT *)Digest) == EFI_SUCCESS);
+                CHECK (CompareMem (Digest, Expected, mCryptoHashAlgos[Algo].DigestSize) == 0);
+                for (Split = 3; Split < ARRAY_SIZE (mSplits); Split++) {
+                    CHECK (HashMultiPart (mHash2[0], Algo, mMessage + Offsets[Offset], Long[Length],
+                                          mSplits[Split], Digest) == EFI_SUCCESS);
+                    CHECK (CompareMem (Digest, Expected, mCryptoHashAlgos[Algo].DigestSize) == 0);
+                }
+            }
+        }
+    }
+    CHECK (mEngine.Bytes > 0);
+}
+
+/* Whoever finds the engine taken hashes in software, interleaved with it */
+STATIC
+VOID
+TestBusy (
+    VOID
+    )
+{
+    CRYPTO_HASH_ALGO *Algo = &mCryptoHashAlgos[1];
+    UINT8 Expected[SHA512_DIGEST_SIZE];
+    UINT8 Digest[2][SHA512_DIGEST_SIZE];
+    UINT64 Bytes;
+    UINTN Offset;
+    UINTN Index;
+
+    Reference (1, mMessage, 10000, Expected);
+
+    CHECK (mHash2[0]->HashInit (mHash2[0], Algo->Guid) == EFI_SUCCESS);
+    CHECK (mEngine.Enabled);
+    Bytes = mEngine.Bytes;
+    CHECK (mHash2[1]->HashInit (mHash2[1], Algo->Guid) == EFI_SUCCESS);
+    for (Offset = 0; Offset < 10000; Offset += 100) {
+        for (Index = 0; Index < 2; Index++) {
+            CHECK (mHash2[Index]->HashUpdate (mHash2[Index], mMessage + Offset, 100) == EFI_SUCCESS);
+        }
+    }
+
+    /* A one-shot hash meanwhile goes to software too */
+    CHECK (mHash2[1]->Hash (mHash2[1], Algo->Guid, mMessage, 10000, (EFI_HASH2_OUTPUT *)Digest[1]) == EFI_SUCCESS);
+    CHECK (CompareMem (Digest[1], Expected, Algo->DigestSize) == 0);
+
+    CHECK (mHash2[1]->HashFinal (mHash2[1], (EFI_HASH2_OUTPUT *)Digest[1]) == EFI_SUCCESS);
+    CHECK (mHash2[0]->HashFinal (mHash2[0], (EFI_HASH2_OUTPUT *)Digest[0]) == EFI_SUCCESS);
+    CHECK (CompareMem (Digest[0], Expected, Algo->DigestSize) == 0);
+    CHECK (CompareMem (Digest[1], Expected, Algo->DigestSize) == 0);
+    /* Only the first caller's data went through the engine */
+    CHECK (mEngine.Bytes - Bytes == 10000);
+    CHECK (!mEngine.Enabled);
+
+    /* Released by HashFinal (), so the other child gets it now */
+    CHECK (mHash2[1]->HashInit (mHash2[1], Algo->Guid) == EFI_SUCCESS);
+    CHECK (mEngine.Enabled);
+    CHECK (mHash2[1]->HashUpdate (mHash2[1], mMessage, 10000) == EFI_SUCCESS);
+    CHECK (mHash2[1]->HashFinal (mHash2[1], (EFI_HASH2_OUTPUT *)Digest[1]) == EFI_SUCCESS);
+    CHECK (CompareMem (Digest[1], Expected, Algo->DigestSize) == 0);
+}
+
+/*
+ * A one-shot hash still has the message when the engine fails, so it is
+ * retried in software. A multi-part hash can't be, but the callers after it
+ * must not be sent to the engine that failed.
+ */
+STATIC
+VOID
+TestEngineErrors (
+    VOID
+    )
+{
+    UINT8 Expected[SHA512_DIGEST_SIZE];
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    CRYPTO_HASH_ALGO *Algo;
+    UINTN Index;
+    UINTN Case;
+
+    for (Index = 0; Index < mCryptoHashAlgoCount; Index++) {
+        Algo = &mCryptoHashAlgos[Index];
+        Reference (Index, mMessage + 1, ERROR_LENGTH, Expected);
+
+        /* DMA error on the first or a later bounce buffer transfer, or no digest */
+        for (Case = 0; Case < 3; Case++) {
+            mEngine.FailTransfer = Case < 2 ? Case * 2 + 1 : 0;
+            mEngine.NoDigest = Case == 2;
+            CHECK (mHash2[0]->Hash (mHash2[0], Algo->Guid, mMessage + 1, ERROR_LENGTH,
+                                    (EFI_HASH2_OUTPUT *)Digest) == EFI_SUCCESS);
+            CHECK (CompareMem (Digest, Expected, Algo->DigestSize) == 0);
+            CHECK (!Algo->HwUsable);
+            CHECK (!mEngine.Enabled);
+            Algo->HwUsable = TRUE;
+
+            mEngine.FailTransfer = Case < 2 ? Case * 2 + 1 : 0;
+            CHECK (mHash2[0]->HashInit (mHash2[0], Algo->Guid) == EFI_SUCCESS);
+            if (Case < 2) {
+                CHECK (mHash2[0]->HashUpdate (mHash2[0], mMessage + 1, ERROR_LENGTH) == EFI_DEVICE_ERROR);
+                CHECK (mHash2[0]->HashUpdate (mHash2[0], mMessage, 1) == EFI_NOT_READY);
+                CHECK (mHash2[0]->HashFinal (mHash2[0], (EFI_HASH2_OUTPUT *)Digest) == EFI_NOT_READY);
+            } else {
+                CHECK (mHash2[0]->HashUpdate (mHash2[0], mMessage + 1, ERROR_LENGTH) == EFI_SUCCESS);
+                CHECK (mHash2[0]->HashFinal (mHash2[0], (EFI_HASH2_OUTPUT *)Digest) == EFI_TIMEOUT);
+            }
+            CHECK (!Algo->HwUsable);
+            CHECK (!mEngine.Enabled);
+
+            /* The next caller is served in software */
+            mEngine.FailTransfer = 0;
+            mEngine.NoDigest = FALSE;
+            CHECK (HashMultiPart (mHash2[1], Index, mMessage + 1, ERROR_LENGTH, mSplits[1], Digest) == EFI_SUCCESS);
+            CHECK (CompareMem (Digest, Expected, Algo->DigestSize) == 0);
+            CHECK (!mEngine.Enabled);
+            Algo->HwUsable = TRUE;
+        }
+    }
+}
+
+STATIC
+VOID
+TestProtocol (
+    VOID
+    )
+{
+    UINT8 Expected[SHA512_DIGEST_SIZE];
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    EFI_HANDLE Handle;
+    EFI_HASH2_PROTOCOL *Hash2;
+    UINTN Size;
+    UINTN Index;
+
+    for (Index = 0; Index < mCryptoHashAlgoCount; Index++) {
+        CHECK (mHash2[0]->GetHashSize (mHash2[0], mCryptoHashAlgos[Index].Guid, &Size) == EFI_SUCCESS);
+        CHECK (Size == mCryptoHashAlgos[Index].DigestSize);
+    }
+    CHECK (mHash2[0]->GetHashSize (mHash2[0], &gEfiHashAlgorithmMD5Guid, &Size) == EFI_UNSUPPORTED);
+    CHECK (mHash2[0]->GetHashSize (mHash2[0], NULL, &Size) == EFI_INVALID_PARAMETER);
+    CHECK (mHash2[0]->Hash (mHash2[0], &gEfiHashAlgorithmMD5Guid, mMessage, 3, (EFI_HASH2_OUTPUT *)Digest) == EFI_UNSUPPORTED);
+    CHECK (mHash2[0]->Hash (mHash2[0], &gEfiHashAlgorithmSha256Guid, NULL, 3, (EFI_HASH2_OUTPUT *)Digest) == EFI_INVALID_PARAMETER);
+    CHECK (mHash2[0]->HashInit (mHash2[0], &gEfiHashAlgorithmMD5Guid) == EFI_UNSUPPORTED);
+
+    CHECK (mHash2[0]->HashUpdate (mHash2[0], mMessage, 3) == EFI_NOT_READY);
+    CHECK (mHash2[0]->HashFinal (mHash2[0], (EFI_HASH2_OUTPUT *)Digest) == EFI_NOT_READY);
+    CHECK (mHash2[0]->HashInit (mHash2[0], &gEfiHashAlgorithmSha256Guid) == EFI_SUCCESS);
+    CHECK (mHash2[0]->HashInit (mHash2[0], &gEfiHashAlgorithmSha256Guid) == EFI_ALREADY_STARTED);
+    CHECK (mHash2[0]->HashUpdate (mHash2[0], NULL, 3) == EFI_INVALID_PARAMETER);
+    CHECK (mHash2[0]->HashUpdate (mHash2[0], NULL, 0) == EFI_SUCCESS);
+    CHECK (mHash2[0]->HashFinal (mHash2[0], NULL) == EFI_INVALID_PARAMETER);
+
+    /* Nothing went to the engine, the empty message comes from software */
+    CHECK (mHash2[0]->HashFinal (mHash2[0], (EFI_HASH2_OUTPUT *)Digest) == EFI_SUCCESS);
+    Reference (1, mMessage, 0, Expected);
+    CHECK (CompareMem (Digest, Expected, SHA256_DIGEST_SIZE) == 0);
+    CHECK (!mEngine.Enabled);
+
+    /* Destroying a child in the middle of a hash gives the engine back */
+    Handle = NULL;
+    CHECK (mCryptoHash2ServiceBinding.CreateChild (&mCryptoHash2ServiceBinding, &Handle) == EFI_SUCCESS);
+    CHECK (gBS->HandleProtocol (Handle, &gEfiHash2ProtocolGuid, (VOID **)&Hash2) == EFI_SUCCESS);
+    CHECK (Hash2->HashInit (Hash2, &gEfiHashAlgorithmSha512Guid) == EFI_SUCCESS);
+    CHECK (Hash2->HashUpdate (Hash2, mMessage, 1000) == EFI_SUCCESS);
+    CHECK (mEngine.Enabled);
+    CHECK (mCryptoHash2ServiceBinding.DestroyChild (&mCryptoHash2ServiceBinding, Handle) == EFI_SUCCESS);
+    CHECK (!mEngine.Enabled);
+    CHECK (mCryptoHash2ServiceBinding.DestroyChild (&mCryptoHash2ServiceBinding, Handle) == EFI_UNSUPPORTED);
+
+    Reference (3, mMessage, 1000, Expected);
+    CHECK (HashMultiPart (mHash2[0], 3, mMessage, 1000, mSplits[2], Digest) == EFI_SUCCESS);
+    CHECK (CompareMem (Digest, Expected, SHA512_DIGEST_SIZE) == 0);
+}
+
+STATIC
+UINTN
+MegabytesPerSecond (
+    IN  CRYPTO_HASH_ALGO    *Algo,
+    IN  BOOLEAN             UseHw,
+    IN  CONST UINT8         *Message
+    )
+{
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    HOST_TIMESPEC Start;
+    HOST_TIMESPEC End;
+    UINT64 Ns;
+    UINTN Round;
+
+    clock_gettime (HOST_CLOCK_MONOTONIC, &Start);
+    for (Round = 0; Round < BENCH_ROUNDS; Round++) {
+        CHECK (CryptoHashOneShot (Algo, UseHw, Message, BENCH_SIZE, Digest) == EFI_SUCCESS);
+    }
+    clock_gettime (HOST_CLOCK_MONOTONIC, &End);
+
+    Ns = (UINT64)(End.Sec - Start.Sec) * 1000000000ULL + End.Nsec - Start.Nsec;
+    return (UINTN)((UINT64)BENCH_ROUNDS * BENCH_SIZE * 1000ULL / Ns);
+}
+
+/*
+ * Times the driver's engine path, in place and through the bounce buffer,
+ * against software. The fake engine hashes with the same C code as the
+ * software path, so this shows what the driver adds per megabyte on the
+ * host, not what the engine gains on the board; a DEBUG build logs that.
+ */
+STATIC
+VOID
+Benchmark (
+    VOID
+    )
+{
+    CRYPTO_HASH_ALGO *Algo;
+    UINTN Bytes;
+    UINTN Index;
+
+    for (Index = 1; Index < mCryptoHashAlgoCount; Index += 2) {
+        Algo = &mCryptoHashAlgos[Index];
+        Bytes = mEngine.Bytes;
+        __builtin_printf ("     %s: engine path %u MB/s, bounced %u MB/s, software %u MB/s\n", Algo->Name,
+                          (unsigned)MegabytesPerSecond (Algo, TRUE, mMessage),
+                          (unsigned)MegabytesPerSecond (Algo, TRUE, mMessage + 1),
+                          (unsigned)MegabytesPerSecond (Algo, FALSE, mMessage));
+        CHECK (mEngine.Bytes - Bytes == 2ULL * BENCH_ROUNDS * BENCH_SIZE);
+    }
+}
+
+typedef struct {
+    CONST CHAR8 *Name;
+    VOID        (*Run)(VOID);
+} TEST_CASE;
+
+STATIC CONST TEST_CASE mTests[] = {
+    { "HostSha",            TestHostSha },
+    { "Load",               TestLoad },
+    { "Vectors",            TestVectors },
+    { "Splits",             TestSplits },
+    { "Busy",               TestBusy },
+    { "EngineErrors",       TestEngineErrors },
+    { "Protocol",           TestProtocol },
+    { "Benchmark",          Benchmark },
+};
+
+int
+main (
+    VOID
+    )
+{
+    UINTN Index;
+    UINTN Failures = 0;
+
+    for (Index = 0; Index < ARRAY_SIZE (mTests); Index++) {
+        mFailed = FALSE;
+        mTests[Index].Run ();
+        if (mEngine.Violations != 0 || mEngine.Enabled) {
+            mFailed = TRUE;
+        }
+        if (mAllocations != 0 && FakeCryptoAllocations () != mAllocations) {
+            __builtin_printf ("  %u allocations outstanding, expected %u\n",
+                              (unsigned)FakeCryptoAllocations (), (unsigned)mAllocations);
+            mFailed = TRUE;
+        }
+        __builtin_printf ("%s %s\n", mFailed ? "FAIL" : "ok  ", mTests[Index].Name);
+        if (mFailed) {
+            Failures++;
+        }
+    }
+
+    __builtin_printf ("%u of %u tests failed\n", (unsigned)Failures, (unsigned)ARRAY_SIZE (mTests));
+    return Failures != 0;
+}
@@ -0,0 +1,689 @@
+/** @file
+ *
+ *  Simulated crypto engine, and the few library functions and boot
+ *  services that CryptoDxe uses. Anything the driver does that the engine
+ *  would reject, or that would hash the wrong bytes, counts as a violation.
+ *
+ *  The engine only takes 32-bit addresses. Its pages come from a static
+ *  buffer, which testcrypto.py keeps below 4 GiB by linking without PIE,
+ *  and a transfer is only read if the driver cleaned exactly that range, so
+ *  a truncated high address is caught instead of dereferenced.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "FakeCrypto.h"
+
+#define ENGINE_REG(Address)     mEngine.Regs[((Address) - CRYPTO_BASE) / 4]
+
+#define FAKE_PAGES_SIZE         SIZE_128KB
+#define FAKE_HANDLES            8
+
+#define ENGINE_CHECK(Cond, Message)                                 \
+    do {                                                            \
+        if (!(Cond)) {                                              \
+            __builtin_printf ("  fake engine: %s\n", Message);      \
+            mEngine.Violations++;                                   \
+        }                                                           \
+    } while (FALSE)
+
+FAKE_CRYPTO mEngine;
+UINT64 mNowNs;
+
+EFI_GUID gEfiHashAlgorithmSha1Guid = EFI_HASH_ALGORITHM_SHA1_GUID;
+EFI_GUID gEfiHashAlgorithmSha256Guid = EFI_HASH_ALGORITHM_SHA256_GUID;
+EFI_GUID gEfiHashAlgorithmSha384Guid = EFI_HASH_ALGORITHM_SHA384_GUID;
+EFI_GUID gEfiHashAlgorithmSha512Guid = EFI_HASH_ALGORITHM_SHA512_GUID;
+EFI_GUID gEfiHashAlgorithmMD5Guid = EFI_HASH_ALGORITHM_MD5_GUID;
+EFI_GUID gEfiHash2ProtocolGuid = EFI_HASH2_PROTOCOL_GUID;
+EFI_GUID gEfiHash2ServiceBindingProtocolGuid = EFI_HASH2_SERVICE_BINDING_PROTOCOL_GUID;
+
+STATIC EFI_BOOT_SERVICES mBootServices;
+EFI_BOOT_SERVICES *gBS = &mBootServices;
+STATIC EFI_TPL mTpl;
+
+STATIC UINT8 mPageMemory[FAKE_PAGES_SIZE] __attribute__ ((aligned (EFI_PAGE_SIZE)));
+STATIC UINTN mPages;
+STATIC UINTN mPoolCount;
+
+/* A handle carries one protocol, which is all the driver installs on each */
+STATIC struct {
+    BOOLEAN     Used;
+    EFI_GUID    *Protocol;
+    VOID        *Interface;
+} mHandles[FAKE_HANDLES];
+
+/* BaseLib, BaseMemoryLib, MemoryAllocationLib */
+
+BOOLEAN
+EFIAPI
+CompareGuid (
+    IN  CONST GUID  *Guid1,
+    IN  CONST GUID  *Guid2
+    )
+{
+    return __builtin_memcmp (Guid1, Guid2, sizeof (GUID)) == 0;
+}
+
+UINT32
+EFIAPI
+SwapBytes32 (
+    IN  UINT32  Value
+    )
+{
+    return __builtin_bswap32 (Value);
+}
+
+UINT64
+EFIAPI
+DivU64x64Remainder (
+    IN  UINT64  Dividend,
+    IN  UINT64  Divisor,
+    OUT UINT64  *Remainder OPTIONAL
+    )
+{
+    if (Remainder != NULL) {
+        *Remainder = Dividend % Divisor;
+    }
+    return Dividend / Divisor;
+}
+
+LIST_ENTRY *
+EFIAPI
+InsertTailList (
+    IN OUT  LIST_ENTRY  *ListHead,
+    IN OUT  LIST_ENTRY  *Entry
+    )
+{
+    Entry->ForwardLink = ListHead;
+    Entry->BackLink = ListHead->BackLink;
+    Entry->BackLink->ForwardLink = Entry;
+    ListHead->BackLink = Entry;
+    return ListHead;
+}
+
+LIST_ENTRY *
+EFIAPI
+RemoveEntryList (
+    IN  CONST LIST_ENTRY    *Entry
+    )
+{
+    Entry->ForwardLink->BackLink = Entry->BackLink;
+    Entry->BackLink->ForwardLink = Entry->ForwardLink;
+    return Entry->ForwardLink;
+}
+
+LIST_ENTRY *
+EFIAPI
+GetFirstNode (
+    IN  CONST LIST_ENTRY    *List
+    )
+{
+    return List->ForwardLink;
+}
+
+LIST_ENTRY *
+EFIAPI
+GetNextNode (
+    IN  CONST LIST_ENTRY    *List,
+    IN  CONST LIST_ENTRY    *Node
+    )
+{
+    return Node->ForwardLink;
+}
+
+BOOLEAN
+EFIAPI
+IsNull (
+    IN  CONST LIST_ENTRY    *List,
+    IN  CONST LIST_ENTRY    *Node
+    )
+{
+    return List == Node;
+}
+
+VOID *
+EFIAPI
+CopyMem (
+    OUT VOID        *DestinationBuffer,
+    IN  CONST VOID  *SourceBuffer,
+    IN  UINTN       Length
+    )
+{
+    return __builtin_memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+ZeroMem (
+    OUT VOID    *Buffer,
+    IN  UINTN   Length
+    )
+{
+    return __builtin_memset (Buffer, 0, Length);
+}
+
+INTN
+EFIAPI
+CompareMem (
+    IN  CONST VOID  *DestinationBuffer,
+    IN  CONST VOID  *SourceBuffer,
+    IN  UINTN       Length
+    )
+{
+    return __builtin_memcmp (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+AllocatePool (
+    IN  UINTN   AllocationSize
+    )
+{
+    mPoolCount++;
+    return __builtin_malloc (AllocationSize);
+}
+
+VOID *
+EFIAPI
+AllocateZeroPool (
+    IN  UINTN   AllocationSize
+    )
+{
+    mPoolCount++;
+    return __builtin_calloc (1, AllocationSize);
+}
+
+VOID
+EFIAPI
+FreePool (
+    IN  VOID    *Buffer
+    )
+{
+    ENGINE_CHECK (Buffer != NULL && mPoolCount > 0, "FreePool without an allocation");
+    mPoolCount--;
+    __builtin_free (Buffer);
+}
+
+/* CacheMaintenanceLib: the host is coherent, remember what was cleaned */
+
+VOID *
+EFIAPI
+WriteBackDataCacheRange (
+    IN  VOID    *Address,
+    IN  UINTN   Length
+    )
+{
+    if (mEngine.CleanCount == FAKE_CLEAN_RANGES) {
+        __builtin_memmove (&mEngine.Clean[0], &mEngine.Clean[1],
+                           sizeof (mEngine.Clean[0]) * (FAKE_CLEAN_RANGES - 1));
+        mEngine.CleanCount--;
+    }
+    mEngine.Clean[mEngine.CleanCount].Start = (UINTN)Address;
+    mEngine.Clean[mEngine.CleanCount].End = (UINTN)Address + Length;
+    mEngine.CleanCount++;
+    return Address;
+}
+
+/* TimerLib: time only passes when the driver waits, one tick per nanosecond */
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+    VOID
+    )
+{
+    return mNowNs;
+}
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+    IN  UINT64  Ticks
+    )
+{
+    return Ticks;
+}
+
+UINTN
+EFIAPI
+MicroSecondDelay (
+    IN  UINTN   MicroSeconds
+    )
+{
+    mNowNs += (UINT64)MicroSeconds * 1000;
+    return MicroSeconds;
+}
+
+/* Boot services */
+
+STATIC
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+    IN  EFI_TPL NewTpl
+    )
+{
+    EFI_TPL OldTpl = mTpl;
+
+    ENGINE_CHECK (NewTpl >= mTpl, "RaiseTPL to a lower TPL");
+    mTpl = NewTpl;
+    return OldTpl;
+}
+
+STATIC
+VOID
+EFIAPI
+FakeRestoreTpl (
+    IN  EFI_TPL OldTpl
+    )
+{
+    ENGINE_CHECK (OldTpl <= mTpl, "RestoreTPL to a higher TPL");
+    mTpl = OldTpl;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeAllocatePages (
+    IN      EFI_ALLOCATE_TYPE       Type,
+    IN      EFI_MEMORY_TYPE         MemoryType,
+    IN      UINTN                   Pages,
+    IN OUT  EFI_PHYSICAL_ADDRESS    *Memory
+    )
+{
+    ENGINE_CHECK (mPages == 0, "more than one page allocation");
+    if (mPages != 0 || EFI_PAGES_TO_SIZE (Pages) > sizeof (mPageMemory)) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    ENGINE_CHECK (Type == AllocateMaxAddress && *Memory < BASE_4GB, "pages may be above 4 GiB");
+    ENGINE_CHECK ((UINTN)mPageMemory + EFI_PAGES_TO_SIZE (Pages) - 1 <= *Memory,
+                  "host page buffer above the requested limit");
+
+    mPages = Pages;
+    *Memory = (UINTN)mPageMemory;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeFreePages (
+    IN  EFI_PHYSICAL_ADDRESS    Memory,
+    IN  UINTN                   Pages
+    )
+{
+    ENGINE_CHECK (Memory == (UINTN)mPageMemory && Pages == mPages,
+                  "pages freed with the wrong address or count");
+    mPages = 0;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeInstallMultipleProtocolInterfaces (
+    IN OUT  EFI_HANDLE  *Handle,
+    ...
+    )
+{
+    EFI_GUID *Protocol;
+    VOID *Interface;
+    VA_LIST Args;
+    UINTN Index;
+
+    VA_START (Args, Handle);
+    Protocol = VA_ARG (Args, EFI_GUID *);
+    Interface = VA_ARG (Args, VOID *);
+    ENGINE_CHECK (Protocol != NULL && VA_ARG (Args, EFI_GUID *) == NULL,
+                  "the fake takes one protocol per handle");
+    VA_END (Args);
+
+    ENGINE_CHECK (*Handle == NULL, "protocol installed on an existing handle");
+    for (Index = 0; Index < FAKE_HANDLES; Index++) {
+        if (!mHandles[Index].Used) {
+            mHandles[Index].Used = TRUE;
+            mHandles[Index].Protocol = Protocol;
+            mHandles[Index].Interface = Interface;
+            *Handle = &mHandles[Index];
+            return EFI_SUCCESS;
+        }
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeUninstallMultipleProtocolInterfaces (
+    IN  EFI_HANDLE  Handle,
+    ...
+    )
+{
+    EFI_GUID *Protocol;
+    VOID *Interface;
+    VA_LIST Args;
+    UINTN Index;
+
+    VA_START (Args, Handle);
+    Protocol = VA_ARG (Args, EFI_GUID *);
+    Interface = VA_ARG (Args, VOID *);
+    VA_END (Args);
+
+    for (Index = 0; Index < FAKE_HANDLES; Index++) {
+        if (Handle == &mHandles[Index] && mHandles[Index].Used &&
+            CompareGuid (mHandles[Index].Protocol, Protocol) &&
+            mHandles[Index].Interface == Interface) {
+            mHandles[Index].Used = FALSE;
+            return EFI_SUCCESS;
+        }
+    }
+
+    return EFI_NOT_FOUND;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeHandleProtocol (
+    IN  EFI_HANDLE  Handle,
+    IN  EFI_GUID    *Protocol,
+    OUT VOID        **Interface
+    )
+{
+    UINTN Index;
+
+    for (Index = 0; Index < FAKE_HANDLES; Index++) {
+        if (Handle == &mHandles[Index] && mHandles[Index].Used &&
+            CompareGuid (mHandles[Index].Protocol, Protocol)) {
+            *Interface = mHandles[Index].Interface;
+            return EFI_SUCCESS;
+        }
+    }
+
+    return EFI_UNSUPPORTED;
+}
+
+UINTN
+FakeCryptoAllocations (
+    VOID
+    )
+{
+    UINTN Count = mPoolCount + (mPages != 0);
+    UINTN Index;
+
+    for (Index = 0; Index < FAKE_HANDLES; Index++) {
+        Count += mHandles[Index].Used;
+    }
+    return Count;
+}
+
+/* The engine */
+
+STATIC
+UINTN
+FakeCryptoAlgo (
+    IN  UINT32  HashCtl
+    )
+{
+    switch (HashCtl & CRYPTO_HASH_CTL_ALGO_MASK) {
+    case CRYPTO_HASH_CTL_ALGO_SHA1:
+        return HOST_SHA1;
+    case CRYPTO_HASH_CTL_ALGO_SHA256:
+        return HOST_SHA256;
+    case CRYPTO_HASH_CTL_ALGO_SHA384:
+        return HOST_SHA384;
+    case CRYPTO_HASH_CTL_ALGO_SHA512:
+        return HOST_SHA512;
+    default:
+        ENGINE_CHECK (FALSE, "hash enabled for an unknown algorithm");
+        return HOST_SHA256;
+    }
+}
+
+/* Whether the driver cleaned this range since the last transfer */
+STATIC
+BOOLEAN
+FakeCryptoCleaned (
+    IN  UINTN   Start,
+    IN  UINTN   Length
+    )
+{
+    UINTN Index;
+
+    for (Index = 0; Index < mEngine.CleanCount; Index++) {
+        if (Start >= mEngine.Clean[Index].Start && Start + Length <= mEngine.Clean[Index].End) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+STATIC
+VOID
+FakeCryptoStop (
+    VOID
+    )
+{
+    mEngine.Enabled = FALSE;
+    mEngine.Started = FALSE;
+    mEngine.Paused = FALSE;
+    ENGINE_REG (CRYPTO_HASH_VALID) = 0;
+}
+
+STATIC
+VOID
+FakeCryptoDigest (
+    VOID
+    )
+{
+    UINT8 Digest[SHA512_DIGEST_SIZE];
+    UINTN Size;
+    UINTN Index;
+
+    Size = HostShaFinal (&mEngine.Sha, Digest);
+    for (Index = 0; Index < Size / 4; Index++) {
+        ENGINE_REG (CRYPTO_HASH_DOUT (Index)) = ((UINT32)Digest[Index * 4] << 24) |
+                                                ((UINT32)Digest[Index * 4 + 1] << 16) |
+                                                ((UINT32)Digest[Index * 4 + 2] << 8) |
+                                                Digest[Index * 4 + 3];
+    }
+    if (!mEngine.NoDigest) {
+        ENGINE_REG (CRYPTO_HASH_VALID) = CRYPTO_HASH_VALID_IS_VALID;
+    }
+    mEngine.Strings++;
+}
+
+/* Fetch a descriptor and hash what it points at */
+STATIC
+VOID
+FakeCryptoTransfer (
+    IN  UINT32  LliAddr,
+    IN  BOOLEAN Start
+    )
+{
+    CRYPTO_LLI_DESC *Lli;
+    BOOLEAN StringStart;
+    BOOLEAN StringLast;
+    UINT32 Error = 0;
+
+    mEngine.Transfers++;
+    mEngine.Paused = FALSE;
+
+    ENGINE_CHECK (mEngine.Enabled, "DMA started with the hash disabled");
+    ENGINE_CHECK (!Start || !mEngine.Started, "DMA started again in the middle of a string");
+    ENGINE_CHECK (FakeCryptoCleaned (LliAddr, sizeof (*Lli)), "descriptor not cleaned before the transfer");
+    if (!mEngine.Enabled || !FakeCryptoCleaned (LliAddr, sizeof (*Lli))) {
+        ENGINE_REG (CRYPTO_DMA_INT_ST) |= CRYPTO_DMA_INT_LIST_ERR;
+        return;
+    }
+    Lli = (CRYPTO_LLI_DESC *)(UINTN)LliAddr;
+
+    StringStart = (Lli->UserDefine & CRYPTO_LLI_USER_STRING_START) != 0;
+    StringLast = (Lli->UserDefine & CRYPTO_LLI_USER_STRING_LAST) != 0;
+    ENGINE_CHECK (StringStart == !mEngine.Started,
+                  StringStart ? "string start in the middle of a string" : "first transfer without string start");
+    ENGINE_CHECK (StringLast == ((Lli->DmaCtrl & CRYPTO_LLI_DMA_CTRL_LAST) != 0),
+                  "end of the string and end of the list disagree");
+    ENGINE_CHECK (StringLast || (Lli->DmaCtrl & CRYPTO_LLI_DMA_CTRL_PAUSE) != 0,
+                  "descriptor neither ends the list nor pauses");
+    ENGINE_CHECK ((Lli->SrcAddr & 0x7) == 0, "source not 8 byte aligned");
+
+    if (mEngine.FailTransfer != 0 && --mEngine.FailTransfer == 0) {
+        Error = CRYPTO_DMA_INT_SRC_ERR;
+    } else if (Lli->SrcLen == 0) {
+        Error = CRYPTO_DMA_INT_ZERO_LEN;
+    } else if (!FakeCryptoCleaned (Lli->SrcAddr, Lli->SrcLen)) {
+        ENGINE_CHECK (FALSE, "source not cleaned before the transfer");
+        Error = CRYPTO_DMA_INT_SRC_ERR;
+    }
+    mEngine.CleanCount = 0;
+    if (Error != 0) {
+        ENGINE_REG (CRYPTO_DMA_INT_ST) |= Error;
+        return;
+    }
+
+    ENGINE_CHECK (StringLast || (Lli->SrcLen % HostShaBlockSize (mEngine.Sha.Algo)) == 0,
+                  "partial block before the end of the string");
+    HostShaUpdate (&mEngine.Sha, (VOID *)(UINTN)Lli->SrcAddr, Lli->SrcLen);
+    mEngine.Bytes += Lli->SrcLen;
+    mEngine.Started = TRUE;
+    ENGINE_REG (CRYPTO_DMA_INT_ST) |= CRYPTO_DMA_INT_SRC_ITEM_DONE;
+
+    if (StringLast) {
+        mEngine.Started = FALSE;
+        ENGINE_REG (CRYPTO_DMA_INT_ST) |= CRYPTO_DMA_INT_LIST_DONE;
+        FakeCryptoDigest ();
+    } else {
+        mEngine.Paused = TRUE;
+        mEngine.Next = Lli->NextAddr;
+    }
+}
+
+STATIC
+VOID
+FakeCryptoHashCtl (
+    IN  UINT32  Value
+    )
+{
+    UINT32 Mask = Value >> 16;
+    UINT32 HashCtl;
+
+    HashCtl = (ENGINE_REG (CRYPTO_HASH_CTL) & ~Mask) | (Value & Mask & 0xFFFF);
+    if ((HashCtl & CRYPTO_HASH_CTL_ENABLE) == 0) {
+        FakeCryptoStop ();
+    } else {
+        ENGINE_CHECK (!mEngine.Enabled, "hash restarted without disabling it first");
+        ENGINE_CHECK ((HashCtl & CRYPTO_HASH_CTL_HW_PAD) != 0, "hash enabled without hardware padding");
+        HostShaInit (&mEngine.Sha, FakeCryptoAlgo (HashCtl));
+        mEngine.Enabled = TRUE;
+        mEngine.Started = FALSE;
+        mEngine.Paused = FALSE;
+        ENGINE_REG (CRYPTO_HASH_VALID) = 0;
+    }
+    ENGINE_REG (CRYPTO_HASH_CTL) = HashCtl;
+}
+
+UINT32
+EFIAPI
+MmioRead32 (
+    IN  UINTN   Address
+    )
+{
+    ENGINE_CHECK (Address >= CRYPTO_BASE && Address < CRYPTO_BASE + FAKE_CRYPTO_REG_SIZE &&
+                  (Address & 3) == 0, "read outside the engine");
+
+    if (Address >= CRYPTO_HASH_DOUT (0) && Address <= CRYPTO_HASH_DOUT (15)) {
+        ENGINE_CHECK ((ENGINE_REG (CRYPTO_HASH_VALID) & CRYPTO_HASH_VALID_IS_VALID) != 0,
+                      "digest read before it was valid");
+    }
+    return ENGINE_REG (Address);
+}
+
+UINT32
+EFIAPI
+MmioWrite32 (
+    IN  UINTN   Address,
+    IN  UINT32  Value
+    )
+{
+    UINT32 Set = (Value >> 16) & Value;
+
+    ENGINE_CHECK (Address >= CRYPTO_BASE && Address < CRYPTO_BASE + FAKE_CRYPTO_REG_SIZE &&
+                  (Address & 3) == 0, "write outside the engine");
+
+    switch (Address) {
+    case CRYPTO_RST_CTL:
+        /* Reset completes at once, so the bit always reads back clear */
+        if ((Set & CRYPTO_RST_CTL_SW_CC_RESET) != 0) {
+            FakeCryptoStop ();
+            ENGINE_REG (CRYPTO_HASH_CTL) = 0;
+            ENGINE_REG (CRYPTO_DMA_INT_ST) = 0;
+        }
+        break;
+    case CRYPTO_DMA_INT_EN:
+        ENGINE_REG (Address) = (ENGINE_REG (Address) & ~(Value >> 16)) | Set;
+        break;
+    case CRYPTO_DMA_INT_ST:
+        ENGINE_REG (Address) &= ~Value;
+        break;
+    case CRYPTO_DMA_LLI_ADDR:
+        ENGINE_CHECK (!mEngine.Started, "list address changed in the middle of a string");
+        ENGINE_REG (Address) = Value;
+        break;
+    case CRYPTO_DMA_CTL:
+        ENGINE_CHECK ((ENGINE_REG (CRYPTO_DMA_INT_ST) & (CRYPTO_DMA_INT_SRC_ITEM_DONE | CRYPTO_DMA_INT_ERRORS)) == 0,
+                      "DMA started with the previous status still set");
+        if ((Set & CRYPTO_DMA_CTL_START) != 0) {
+            FakeCryptoTransfer (ENGINE_REG (CRYPTO_DMA_LLI_ADDR), TRUE);
+        } else if ((Set & CRYPTO_DMA_CTL_RESTART) != 0) {
+            ENGINE_CHECK (mEngine.Paused, "DMA restarted while not paused");
+            if (mEngine.Paused) {
+                FakeCryptoTransfer (mEngine.Next, FALSE);
+            }
+        }
+        break;
+    case CRYPTO_HASH_CTL:
+        FakeCryptoHashCtl (Value);
+        break;
+    case CRYPTO_HASH_VALID:
+        ENGINE_REG (Address) &= ~Value;
+        break;
+    default:
+        ENGINE_CHECK (FALSE, "write to a register the fake doesn't know");
+        break;
+    }
+
+    return Value;
+}
+
+VOID
+FakeCryptoInit (
+    VOID
+    )
+{
+    ZeroMem (&mEngine, sizeof (mEngine));
+
+    mBootServices.RaiseTPL = FakeRaiseTpl;
+    mBootServices.RestoreTPL = FakeRestoreTpl;
+    mBootServices.AllocatePages = FakeAllocatePages;
+    mBootServices.FreePages = FakeFreePages;
+    mBootServices.InstallMultipleProtocolInterfaces = FakeInstallMultipleProtocolInterfaces;
+    mBootServices.UninstallMultipleProtocolInterfaces = FakeUninstallMultipleProtocolInterfaces;
+    mBootServices.HandleProtocol = FakeHandleProtocol;
+}
@@ -0,0 +1,110 @@
+/** @file
+ *
+ *  The RK356x crypto v2 hash engine simulated on the build host, for
+ *  running CryptoDxe's Hash2 and DMA code. The engine fetches its link list
+ *  descriptors from memory, hashes what they point at with HostCryptLib.c
+ *  and pads the message itself at the end of the string.
+ *
+ *  Between transfers the DMA pauses on a descriptor and a restart fetches
+ *  the next one it links to. Only whole blocks may be hashed before the end
+ *  of the string, and the descriptor and data must have been cleaned from
+ *  the cache before each transfer is started.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef FAKECRYPTO_H__
+#define FAKECRYPTO_H__
+
+#include "CryptoDxe.h"
+
+#define FAKE_CRYPTO_REG_SIZE    0x400
+#define FAKE_CLEAN_RANGES       4
+
+/* HostCryptLib.c, the reference SHA-1 and SHA-2 behind BaseCryptLib and the engine */
+#define HOST_SHA1               0
+#define HOST_SHA256             1
+#define HOST_SHA384             2
+#define HOST_SHA512             3
+
+typedef struct {
+    UINTN               Algo;           /* HOST_SHA* */
+    union {
+        UINT32          W32[8];
+        UINT64          W64[8];
+    } State;
+    UINT64              Length;         /* bytes hashed so far */
+    UINT8               Block[128];
+    UINTN               Used;           /* bytes of Block filled */
+} HOST_SHA_CONTEXT;
+
+VOID
+HostShaInit (
+    OUT HOST_SHA_CONTEXT    *Context,
+    IN  UINTN               Algo
+    );
+
+VOID
+HostShaUpdate (
+    IN OUT  HOST_SHA_CONTEXT    *Context,
+    IN      CONST VOID          *Data,
+    IN      UINTN               Length
+    );
+
+UINTN
+HostShaFinal (
+    IN OUT  HOST_SHA_CONTEXT    *Context,
+    OUT     UINT8               *Digest
+    );
+
+UINTN
+HostShaBlockSize (
+    IN  UINTN   Algo
+    );
+
+/* FakeCrypto.c */
+typedef struct {
+    UINT32              Regs[FAKE_CRYPTO_REG_SIZE / 4];
+
+    /* Engine state */
+    BOOLEAN             Enabled;        /* HASH_CTL enabled for an algorithm */
+    BOOLEAN             Started;        /* string start seen, string end not yet */
+    BOOLEAN             Paused;         /* DMA waiting for a restart */
+    UINT32              Next;           /* descriptor a restart fetches */
+    HOST_SHA_CONTEXT    Sha;
+    struct {
+        UINTN           Start;
+        UINTN           End;
+    } Clean[FAKE_CLEAN_RANGES];         /* ranges cleaned since the last transfer */
+    UINTN               CleanCount;
+
+    /* Knobs */
+    UINTN               FailTransfer;   /* fail the Nth transfer from now, 0 for never */
+    BOOLEAN             NoDigest;       /* never signal the digest valid */
+
+    /* Observations */
+    UINTN               Transfers;
+    UINT64              Bytes;
+    UINTN               Strings;        /* digests produced */
+    UINTN               Violations;
+} FAKE_CRYPTO;
+
+extern FAKE_CRYPTO mEngine;
+extern UINT64 mNowNs;
+extern EFI_GUID gEfiHashAlgorithmMD5Guid;
+
+VOID
+FakeCryptoInit (
+    VOID
+    );
+
+/* Outstanding pool allocations, pages and protocol interfaces */
+UINTN
+FakeCryptoAllocations (
+    VOID
+    );
+
+#endif /* FAKECRYPTO_H__ */
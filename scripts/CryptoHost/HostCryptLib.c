@@ -0,0 +1,410 @@
+/** @file
+ *
+ *  A plain C SHA-1, SHA-256, SHA-384 and SHA-512, standing in for
+ *  BaseCryptLib on the build host. The fake engine hashes with it too, so
+ *  CryptoHostTest.c checks it against the FIPS 180-2 examples first.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseCryptLib.h>
+
+#include "FakeCrypto.h"
+
+#define ROR32(x, n)     (((x) >> (n)) | ((x) << (32 - (n))))
+#define ROL32(x, n)     (((x) << (n)) | ((x) >> (32 - (n))))
+#define ROR64(x, n)     (((x) >> (n)) | ((x) << (64 - (n))))
+
+STATIC CONST UINT32 mSha1Init[5] = {
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
+
+STATIC CONST UINT32 mSha256Init[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+STATIC CONST UINT64 mSha384Init[8] = {
+    0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+    0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+};
+
+STATIC CONST UINT64 mSha512Init[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+STATIC CONST UINT32 mSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+STATIC CONST UINT64 mSha512K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+STATIC
+UINT32
+HostBe32 (
+    IN  CONST UINT8 *Data
+    )
+{
+    return ((UINT32)Data[0] << 24) | ((UINT32)Data[1] << 16) | ((UINT32)Data[2] << 8) | Data[3];
+}
+
+STATIC
+UINT64
+HostBe64 (
+    IN  CONST UINT8 *Data
+    )
+{
+    return ((UINT64)HostBe32 (Data) << 32) | HostBe32 (Data + 4);
+}
+
+STATIC
+VOID
+HostSha1Block (
+    IN OUT  UINT32      *State,
+    IN      CONST UINT8 *Block
+    )
+{
+    UINT32 W[80];
+    UINT32 A, B, C, D, E, F, K, T;
+    UINTN Index;
+
+    for (Index = 0; Index < 16; Index++) {
+        W[Index] = HostBe32 (&Block[Index * 4]);
+    }
+    for (; Index < 80; Index++) {
+        W[Index] = ROL32 (W[Index - 3] ^ W[Index - 8] ^ W[Index - 14] ^ W[Index - 16], 1);
+    }
+
+    A = State[0];
+    B = State[1];
+    C = State[2];
+    D = State[3];
+    E = State[4];
+    for (Index = 0; Index < 80; Index++) {
+        if (Index < 20) {
+            F = (B & C) | (~B & D);
+            K = 0x5a827999;
+        } else if (Index < 40) {
+            F = B ^ C ^ D;
+            K = 0x6ed9eba1;
+        } else if (Index < 60) {
+            F = (B & C) | (B & D) | (C & D);
+            K = 0x8f1bbcdc;
+        } else {
+            F = B ^ C ^ D;
+            K = 0xca62c1d6;
+        }
+        T = ROL32 (A, 5) + F + E + K + W[Index];
+        E = D;
+        D = C;
+        C = ROL32 (B, 30);
+        B = A;
+        A = T;
+    }
+    State[0] += A;
+    State[1] += B;
+    State[2] += C;
+    State[3] += D;
+    State[4] += E;
+}
+
+STATIC
+VOID
+HostSha256Block (
+    IN OUT  UINT32      *State,
+    IN      CONST UINT8 *Block
+    )
+{
+    UINT32 W[64];
+    UINT32 S[8];
+    UINT32 T1, T2;
+    UINTN Index;
+
+    for (Index = 0; Index < 16; Index++) {
+        W[Index] = HostBe32 (&Block[Index * 4]);
+    }
+    for (; Index < 64; Index++) {
+        W[Index] = (ROR32 (W[Index - 2], 17) ^ ROR32 (W[Index - 2], 19) ^ (W[Index - 2] >> 10)) +
+                   W[Index - 7] +
+                   (ROR32 (W[Index - 15], 7) ^ ROR32 (W[Index - 15], 18) ^ (W[Index - 15] >> 3)) +
+                   W[Index - 16];
+    }
+
+    for (Index = 0; Index < 8; Index++) {
+        S[Index] = State[Index];
+    }
+    for (Index = 0; Index < 64; Index++) {
+        T1 = S[7] + (ROR32 (S[4], 6) ^ ROR32 (S[4], 11) ^ ROR32 (S[4], 25)) +
+             ((S[4] & S[5]) ^ (~S[4] & S[6])) + mSha256K[Index] + W[Index];
+        T2 = (ROR32 (S[0], 2) ^ ROR32 (S[0], 13) ^ ROR32 (S[0], 22)) +
+             ((S[0] & S[1]) ^ (S[0] & S[2]) ^ (S[1] & S[2]));
+        S[7] = S[6];
+        S[6] = S[5];
+        S[5] = S[4];
+        S[4] = S[3] + T1;
+        S[3] = S[2];
+        S[2] = S[1];
+        S[1] = S[0];
+        S[0] = T1 + T2;
+    }
+    for (Index = 0; Index < 8; Index++) {
+        State[Index] += S[Index];
+    }
+}
+
+STATIC
+VOID
+HostSha512Block (
+    IN OUT  UINT64      *State,
+    IN      CONST UINT8 *Block
+    )
+{
+    UINT64 W[80];
+    UINT64 S[8];
+    UINT64 T1, T2;
+    UINTN Index;
+
+    for (Index = 0; Index < 16; Index++) {
+        W[Index] = HostBe64 (&Block[Index * 8]);
+    }
+    for (; Index < 80; Index++) {
+        W[Index] = (ROR64 (W[Index - 2], 19) ^ ROR64 (W[Index - 2], 61) ^ (W[Index - 2] >> 6)) +
+                   W[Index - 7] +
+                   (ROR64 (W[Index - 15], 1) ^ ROR64 (W[Index - 15], 8) ^ (W[Index - 15] >> 7)) +
+                   W[Index - 16];
+    }
+
+    for (Index = 0; Index < 8; Index++) {
+        S[Index] = State[Index];
+    }
+    for (Index = 0; Index < 80; Index++) {
+        T1 = S[7] + (ROR64 (S[4], 14) ^ ROR64 (S[4], 18) ^ ROR64 (S[4], 41)) +
+             ((S[4] & S[5]) ^ (~S[4] & S[6])) + mSha512K[Index] + W[Index];
+        T2 = (ROR64 (S[0], 28) ^ ROR64 (S[0], 34) ^ ROR64 (S[0], 39)) +
+             ((S[0] & S[1]) ^ (S[0] & S[2]) ^ (S[1] & S[2]));
+        S[7] = S[6];
+        S[6] = S[5];
+        S[5] = S[4];
+        S[4] = S[3] + T1;
+        S[3] = S[2];
+        S[2] = S[1];
+        S[1] = S[0];
+        S[0] = T1 + T2;
+    }
+    for (Index = 0; Index < 8; Index++) {
+        State[Index] += S[Index];
+    }
+}
+
+STATIC
+VOID
+HostShaBlock (
+    IN OUT  HOST_SHA_CONTEXT    *Context,
+    IN      CONST UINT8         *Block
+    )
+{
+    switch (Context->Algo) {
+    case HOST_SHA1:
+        HostSha1Block (Context->State.W32, Block);
+        break;
+    case HOST_SHA256:
+        HostSha256Block (Context->State.W32, Block);
+        break;
+    default:
+        HostSha512Block (Context->State.W64, Block);
+        break;
+    }
+}
+
+UINTN
+HostShaBlockSize (
+    IN  UINTN   Algo
+    )
+{
+    return Algo == HOST_SHA1 || Algo == HOST_SHA256 ? 64 : 128;
+}
+
+VOID
+HostShaInit (
+    OUT HOST_SHA_CONTEXT    *Context,
+    IN  UINTN               Algo
+    )
+{
+    __builtin_memset (Context, 0, sizeof (*Context));
+    Context->Algo = Algo;
+    switch (Algo) {
+    case HOST_SHA1:
+        __builtin_memcpy (Context->State.W32, mSha1Init, sizeof (mSha1Init));
+        break;
+    case HOST_SHA256:
+        __builtin_memcpy (Context->State.W32, mSha256Init, sizeof (mSha256Init));
+        break;
+    case HOST_SHA384:
+        __builtin_memcpy (Context->State.W64, mSha384Init, sizeof (mSha384Init));
+        break;
+    default:
+        __builtin_memcpy (Context->State.W64, mSha512Init, sizeof (mSha512Init));
+        break;
+    }
+}
+
+VOID
+HostShaUpdate (
+    IN OUT  HOST_SHA_CONTEXT    *Context,
+    IN      CONST VOID          *Data,
+    IN      UINTN               Length
+    )
+{
+    CONST UINT8 *Bytes = Data;
+    UINTN BlockSize = HostShaBlockSize (Context->Algo);
+    UINTN Fill;
+
+    Context->Length += Length;
+
+    if (Context->Used > 0) {
+        Fill = MIN (Length, BlockSize - Context->Used);
+        __builtin_memcpy (&Context->Block[Context->Used], Bytes, Fill);
+        Context->Used += Fill;
+        Bytes += Fill;
+        Length -= Fill;
+        if (Context->Used < BlockSize) {
+            return;
+        }
+        HostShaBlock (Context, Context->Block);
+        Context->Used = 0;
+    }
+
+    for (; Length >= BlockSize; Bytes += BlockSize, Length -= BlockSize) {
+        HostShaBlock (Context, Bytes);
+    }
+
+    __builtin_memcpy (Context->Block, Bytes, Length);
+    Context->Used = Length;
+}
+
+/* Pads the message and writes the digest, returns its size */
+UINTN
+HostShaFinal (
+    IN OUT  HOST_SHA_CONTEXT    *Context,
+    OUT     UINT8               *Digest
+    )
+{
+    UINTN BlockSize = HostShaBlockSize (Context->Algo);
+    UINTN LengthSize = BlockSize / 8;       /* 64 or 128 bit length field */
+    UINT64 Bits = Context->Length * 8;
+    UINTN DigestSize;
+    UINTN Index;
+
+    Context->Block[Context->Used++] = 0x80;
+    if (Context->Used > BlockSize - LengthSize) {
+        __builtin_memset (&Context->Block[Context->Used], 0, BlockSize - Context->Used);
+        HostShaBlock (Context, Context->Block);
+        Context->Used = 0;
+    }
+    __builtin_memset (&Context->Block[Context->Used], 0, BlockSize - Context->Used);
+    for (Index = 0; Index < 8; Index++) {
+        Context->Block[BlockSize - 1 - Index] = (UINT8)(Bits >> (Index * 8));
+    }
+    HostShaBlock (Context, Context->Block);
+
+    switch (Context->Algo) {
+    case HOST_SHA1:
+        DigestSize = SHA1_DIGEST_SIZE;
+        break;
+    case HOST_SHA256:
+        DigestSize = SHA256_DIGEST_SIZE;
+        break;
+    case HOST_SHA384:
+        DigestSize = SHA384_DIGEST_SIZE;
+        break;
+    default:
+        DigestSize = SHA512_DIGEST_SIZE;
+        break;
+    }
+
+    for (Index = 0; Index < DigestSize; Index++) {
+        if (Context->Algo == HOST_SHA1 || Context->Algo == HOST_SHA256) {
+            Digest[Index] = (UINT8)(Context->State.W32[Index / 4] >> (24 - (Index % 4) * 8));
+        } else {
+            Digest[Index] = (UINT8)(Context->State.W64[Index / 8] >> (56 - (Index % 8) * 8));
+        }
+    }
+
+    return DigestSize;
+}
+
+/* BaseCryptLib */
+
+#define HOST_CRYPT_LIB_SHA(Name, Id)                                          \
+    UINTN EFIAPI Name##GetContextSize (VOID)                                    \
+    {                                                                           \
+        return sizeof (HOST_SHA_CONTEXT);                                       \
+    }                                                                           \
+                                                                                \
+    BOOLEAN EFIAPI Name##Init (OUT VOID *Context)                               \
+    {                                                                           \
+        if (Context == NULL) {                                                  \
+            return FALSE;                                                       \
+        }                                                                       \
+        HostShaInit (Context, Id);                                              \
+        return TRUE;                                                            \
+    }                                                                           \
+                                                                                \
+    BOOLEAN EFIAPI Name##Update (IN OUT VOID *Context, IN CONST VOID *Data,     \
+                                 IN UINTN DataSize)                             \
+    {                                                                           \
+        if (Context == NULL || (Data == NULL && DataSize != 0) ||               \
+            ((HOST_SHA_CONTEXT *)Context)->Algo != Id) {                        \
+            return FALSE;                                                       \
+        }                                                                       \
+        HostShaUpdate (Context, Data, DataSize);                                \
+        return TRUE;                                                            \
+    }                                                                           \
+                                                                                \
+    BOOLEAN EFIAPI Name##Final (IN OUT VOID *Context, OUT UINT8 *HashValue)     \
+    {                                                                           \
+        if (Context == NULL || HashValue == NULL ||                             \
+            ((HOST_SHA_CONTEXT *)Context)->Algo != Id) {                        \
+            return FALSE;                                                       \
+        }                                                                       \
+        HostShaFinal (Context, HashValue);                                      \
+        return TRUE;                                                            \
+    }
+
+HOST_CRYPT_LIB_SHA (Sha1, HOST_SHA1)
+HOST_CRYPT_LIB_SHA (Sha256, HOST_SHA256)
+HOST_CRYPT_LIB_SHA (Sha384, HOST_SHA384)
+HOST_CRYPT_LIB_SHA (Sha512, HOST_SHA512)
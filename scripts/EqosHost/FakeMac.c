@@ -0,0 +1,737 @@
+/** @file
+ *
+ *  Simulated GMAC, PHY and DMA pool, and the few library functions and
+ *  boot services that EqosDxe uses. Anything the driver does that real
+ *  hardware would reject, or that would stall it, counts as a violation.
+ *
+ *  Descriptors hold 32-bit bus addresses, so DMA memory comes from a static
+ *  buffer, which testeqos.py keeps below 4 GiB by linking without PIE.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/IoLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <IndustryStandard/Rk356x.h>
+#include <IndustryStandard/Rk356xCru.h>
+
+#include "FakeMac.h"
+
+#define MAC_REG(Offset)         mMac.Regs[(Offset) / 4]
+#define MAC_CRU_CLKSEL          CRU_CLKSEL_CON (CRU_CLKSEL_GMAC_CON (0))
+
+/* Descriptor fields the driver doesn't need names for */
+#define FAKE_TDES2_B1L_MASK     0x3FFFU
+#define FAKE_TDES3_FL_MASK      0x7FFFU
+#define FAKE_TDES3_CIC_MASK     (3U << EQOS_TDES3_CIC_SHIFT)
+#define FAKE_RX_RBSZ_MASK       0x3FFFU
+
+/* Pool blocks and pages each have a fixed place in the DMA buffer */
+#define FAKE_POOL_BLOCK_SIZE    SIZE_4KB
+#define FAKE_POOL_BLOCKS        2
+#define FAKE_PAGES_OFFSET       (FAKE_POOL_BLOCK_SIZE * FAKE_POOL_BLOCKS)
+
+#define MAC_CHECK(Cond, Message)                                    \
+    do {                                                            \
+        if (!(Cond)) {                                              \
+            __builtin_printf ("  fake MAC: %s\n", Message);         \
+            mMac.Violations++;                                      \
+        }                                                           \
+    } while (FALSE)
+
+FAKE_MAC mMac;
+UINT64 mNowNs;
+
+EFI_GUID gRk356xDmaPoolProtocolGuid = RK356X_DMA_POOL_PROTOCOL_GUID;
+
+STATIC EFI_BOOT_SERVICES mBootServices;
+EFI_BOOT_SERVICES *gBS = &mBootServices;
+STATIC EFI_TPL mTpl;
+STATIC UINTN mEvent;
+
+STATIC UINT8 mDmaMemory[FAKE_DMA_SIZE] __attribute__ ((aligned (EFI_PAGE_SIZE)));
+STATIC UINTN mPoolSize[FAKE_POOL_BLOCKS];
+STATIC UINTN mPages;
+
+/* BaseLib, BaseMemoryLib, CacheMaintenanceLib */
+
+UINT32
+EFIAPI
+CalculateCrc32 (
+    IN  VOID    *Buffer,
+    IN  UINTN   Length
+    )
+{
+    CONST UINT8 *Data = Buffer;
+    UINT32 Crc = 0xFFFFFFFF;
+    UINTN Bit;
+
+    while (Length-- > 0) {
+        Crc ^= *Data++;
+        for (Bit = 0; Bit < 8; Bit++) {
+            Crc = (Crc >> 1) ^ ((Crc & 1) != 0 ? 0xEDB88320 : 0);
+        }
+    }
+
+    return ~Crc;
+}
+
+VOID
+EFIAPI
+MemoryFence (
+    VOID
+    )
+{
+    __sync_synchronize ();
+}
+
+VOID *
+EFIAPI
+CopyMem (
+    OUT VOID        *DestinationBuffer,
+    IN  CONST VOID  *SourceBuffer,
+    IN  UINTN       Length
+    )
+{
+    return __builtin_memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+ZeroMem (
+    OUT VOID    *Buffer,
+    IN  UINTN   Length
+    )
+{
+    return __builtin_memset (Buffer, 0, Length);
+}
+
+VOID *
+EFIAPI
+SetMem (
+    OUT VOID    *Buffer,
+    IN  UINTN   Length,
+    IN  UINT8   Value
+    )
+{
+    return __builtin_memset (Buffer, Value, Length);
+}
+
+INTN
+EFIAPI
+CompareMem (
+    IN  CONST VOID  *DestinationBuffer,
+    IN  CONST VOID  *SourceBuffer,
+    IN  UINTN       Length
+    )
+{
+    return __builtin_memcmp (DestinationBuffer, SourceBuffer, Length);
+}
+
+/* The host is cache coherent, only check that the range is DMA memory */
+
+STATIC
+VOID *
+FakeCacheOp (
+    IN  VOID    *Address,
+    IN  UINTN   Length
+    )
+{
+    MAC_CHECK ((UINT8 *)Address >= mDmaMemory &&
+               (UINT8 *)Address + Length <= mDmaMemory + sizeof (mDmaMemory),
+               "cache maintenance outside DMA memory");
+    return Address;
+}
+
+VOID *
+EFIAPI
+WriteBackDataCacheRange (
+    IN  VOID    *Address,
+    IN  UINTN   Length
+    )
+{
+    return FakeCacheOp (Address, Length);
+}
+
+VOID *
+EFIAPI
+InvalidateDataCacheRange (
+    IN  VOID    *Address,
+    IN  UINTN   Length
+    )
+{
+    return FakeCacheOp (Address, Length);
+}
+
+VOID *
+EFIAPI
+WriteBackInvalidateDataCacheRange (
+    IN  VOID    *Address,
+    IN  UINTN   Length
+    )
+{
+    return FakeCacheOp (Address, Length);
+}
+
+/* TimerLib: time only passes when the driver waits, one tick per nanosecond */
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+    VOID
+    )
+{
+    return mNowNs;
+}
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+    IN  UINT64  Ticks
+    )
+{
+    return Ticks;
+}
+
+UINTN
+EFIAPI
+MicroSecondDelay (
+    IN  UINTN   MicroSeconds
+    )
+{
+    mNowNs += (UINT64)MicroSeconds * 1000;
+    return MicroSeconds;
+}
+
+/* DMA pool and boot services */
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePoolAllocate (
+    IN  RK356X_DMA_POOL_PROTOCOL    *This,
+    IN  UINTN                       Size,
+    IN  UINTN                       Alignment,
+    OUT VOID                        **HostAddress,
+    OUT EFI_PHYSICAL_ADDRESS        *DeviceAddress
+    )
+{
+    UINTN Index;
+
+    MAC_CHECK (Size <= FAKE_POOL_BLOCK_SIZE, "pool allocation too large for the fake");
+    for (Index = 0; Index < FAKE_POOL_BLOCKS; Index++) {
+        if (mPoolSize[Index] == 0) {
+            mPoolSize[Index] = Size;
+            *HostAddress = mDmaMemory + Index * FAKE_POOL_BLOCK_SIZE;
+            ZeroMem (*HostAddress, Size);
+            *DeviceAddress = (UINTN)*HostAddress;
+            return EFI_SUCCESS;
+        }
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakePoolFree (
+    IN  RK356X_DMA_POOL_PROTOCOL    *This,
+    IN  VOID                        *HostAddress,
+    IN  UINTN                       Size,
+    IN  UINTN                       Alignment
+    )
+{
+    UINTN Index;
+
+    Index = ((UINT8 *)HostAddress - mDmaMemory) / FAKE_POOL_BLOCK_SIZE;
+    MAC_CHECK (Index < FAKE_POOL_BLOCKS && HostAddress == mDmaMemory + Index * FAKE_POOL_BLOCK_SIZE &&
+               mPoolSize[Index] == Size, "pool block freed with the wrong address or size");
+    if (Index < FAKE_POOL_BLOCKS) {
+        mPoolSize[Index] = 0;
+    }
+    return EFI_SUCCESS;
+}
+
+STATIC RK356X_DMA_POOL_PROTOCOL mDmaPool = {
+    FakePoolAllocate,
+    FakePoolFree
+};
+
+STATIC
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+    IN  EFI_TPL NewTpl
+    )
+{
+    EFI_TPL OldTpl = mTpl;
+
+    MAC_CHECK (NewTpl >= mTpl, "RaiseTPL to a lower TPL");
+    mTpl = NewTpl;
+    return OldTpl;
+}
+
+STATIC
+VOID
+EFIAPI
+FakeRestoreTpl (
+    IN  EFI_TPL OldTpl
+    )
+{
+    MAC_CHECK (OldTpl <= mTpl, "RestoreTPL to a higher TPL");
+    mTpl = OldTpl;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeLocateProtocol (
+    IN  EFI_GUID    *Protocol,
+    IN  VOID        *Registration OPTIONAL,
+    OUT VOID        **Interface
+    )
+{
+    if (CompareMem (Protocol, &gRk356xDmaPoolProtocolGuid, sizeof (EFI_GUID)) != 0) {
+        return EFI_NOT_FOUND;
+    }
+    *Interface = &mDmaPool;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeAllocatePages (
+    IN      EFI_ALLOCATE_TYPE       Type,
+    IN      EFI_MEMORY_TYPE         MemoryType,
+    IN      UINTN                   Pages,
+    IN OUT  EFI_PHYSICAL_ADDRESS    *Memory
+    )
+{
+    EFI_PHYSICAL_ADDRESS Base = (UINTN)mDmaMemory + FAKE_PAGES_OFFSET;
+
+    MAC_CHECK (mPages == 0, "more than one page allocation");
+    if (mPages != 0 || EFI_PAGES_TO_SIZE (Pages) > sizeof (mDmaMemory) - FAKE_PAGES_OFFSET) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    MAC_CHECK (Type == AllocateMaxAddress && *Memory < BASE_4GB, "pages may be above 4 GiB");
+    MAC_CHECK (Base + EFI_PAGES_TO_SIZE (Pages) - 1 <= *Memory, "host DMA buffer above the requested limit");
+
+    mPages = Pages;
+    *Memory = Base;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeFreePages (
+    IN  EFI_PHYSICAL_ADDRESS    Memory,
+    IN  UINTN                   Pages
+    )
+{
+    MAC_CHECK (Memory == (UINTN)mDmaMemory + FAKE_PAGES_OFFSET && Pages == mPages,
+               "pages freed with the wrong address or count");
+    mPages = 0;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeCreateEvent (
+    IN  UINT32              Type,
+    IN  EFI_TPL             NotifyTpl,
+    IN  EFI_EVENT_NOTIFY    NotifyFunction,
+    IN  VOID                *NotifyContext,
+    OUT EFI_EVENT           *Event
+    )
+{
+    *Event = &mEvent;
+    return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeSignalEvent (
+    IN  EFI_EVENT   Event
+    )
+{
+    (*(UINTN *)Event)++;
+    return EFI_SUCCESS;
+}
+
+/* The MAC */
+
+STATIC
+VOID *
+FakeMacHost (
+    IN  UINT32  Address
+    )
+{
+    MAC_CHECK ((UINT8 *)(UINTN)Address >= mDmaMemory &&
+               (UINT8 *)(UINTN)Address < mDmaMemory + sizeof (mDmaMemory),
+               "DMA outside DMA memory");
+    return (VOID *)(UINTN)Address;
+}
+
+STATIC
+EQOS_DMA_DESC *
+FakeMacDesc (
+    IN  UINT32  RingBase,
+    IN  UINT32  Index
+    )
+{
+    return (EQOS_DMA_DESC *)FakeMacHost (MAC_REG (RingBase)) + Index;
+}
+
+/* Ring index of a tail pointer, checked against the programmed ring */
+STATIC
+UINT32
+FakeMacTailIndex (
+    IN  UINT32  RingBase,
+    IN  UINT32  RingLen,
+    IN  UINT32  Tail
+    )
+{
+    UINT32 Offset = Tail - MAC_REG (RingBase);
+
+    MAC_CHECK ((Offset % sizeof (EQOS_DMA_DESC)) == 0 &&
+               Offset / sizeof (EQOS_DMA_DESC) <= MAC_REG (RingLen),
+               "tail pointer outside the ring");
+    return Offset / sizeof (EQOS_DMA_DESC);
+}
+
+STATIC
+VOID
+FakeMacReset (
+    VOID
+    )
+{
+    ZeroMem (mMac.Regs, sizeof (mMac.Regs));
+    MAC_REG (GMAC_MAC_VERSION) = 0x51;
+    /* 4 KiB TX and RX FIFOs */
+    MAC_REG (GMAC_MAC_HW_FEATURE1) = (5 << GMAC_MAC_HW_FEATURE1_TXFIFOSIZE_SHIFT) | 5;
+    MAC_REG (GMAC_MAC_ADDRESS0_HIGH) = 0x8000FFFF;
+    MAC_REG (GMAC_MAC_ADDRESS0_LOW) = 0xFFFFFFFF;
+    mMac.TxCur = 0;
+    mMac.RxCur = 0;
+    mMac.Resets++;
+}
+
+STATIC
+BOOLEAN
+FakeMacAccept (
+    IN  CONST UINT8 *Frame
+    )
+{
+    UINT32 Filter = MAC_REG (GMAC_MAC_PACKET_FILTER);
+    UINT32 Low = MAC_REG (GMAC_MAC_ADDRESS0_LOW);
+    UINT32 High = MAC_REG (GMAC_MAC_ADDRESS0_HIGH);
+    UINT32 Crc;
+    UINT32 Hash;
+    UINTN Bit;
+
+    if ((Filter & GMAC_MAC_PACKET_FILTER_PR) != 0) {
+        return TRUE;
+    }
+    if ((Frame[0] & 1) == 0) {
+        return Frame[0] == (UINT8)Low && Frame[1] == (UINT8)(Low >> 8) &&
+               Frame[2] == (UINT8)(Low >> 16) && Frame[3] == (UINT8)(Low >> 24) &&
+               Frame[4] == (UINT8)High && Frame[5] == (UINT8)(High >> 8);
+    }
+    if ((Frame[0] & Frame[1] & Frame[2] & Frame[3] & Frame[4] & Frame[5]) == 0xFF) {
+        return (Filter & GMAC_MAC_PACKET_FILTER_DBF) == 0;
+    }
+    if ((Filter & GMAC_MAC_PACKET_FILTER_PM) != 0) {
+        return TRUE;
+    }
+    if ((Filter & GMAC_MAC_PACKET_FILTER_HMC) != 0) {
+        /* The upper 6 bits of the bit reversed CRC pick a bit in HT1:HT0 */
+        Crc = CalculateCrc32 ((VOID *)Frame, EQOS_ETHER_ADDR_LEN);
+        for (Hash = 0, Bit = 0; Bit < 6; Bit++) {
+            Hash = (Hash << 1) | ((Crc >> Bit) & 1);
+        }
+        return (MAC_REG (GMAC_MAC_HASH_TABLE_REG0 + (Hash >> 5) * 4) & (1U << (Hash & 0x1F))) != 0;
+    }
+
+    return FALSE;
+}
+
+/* Put a frame on the wire, which is looped back into the RX DMA */
+STATIC
+VOID
+FakeMacReceive (
+    IN  CONST UINT8 *Frame,
+    IN  UINT32      Length
+    )
+{
+    EQOS_DMA_DESC *Desc;
+    UINT32 BufferSize;
+
+    if ((MAC_REG (GMAC_MAC_CONFIGURATION) & GMAC_MAC_CONFIGURATION_RE) == 0 ||
+        (MAC_REG (GMAC_DMA_CHAN0_RX_CONTROL) & GMAC_DMA_CHAN0_RX_CONTROL_START) == 0) {
+        return;
+    }
+    if (!FakeMacAccept (Frame)) {
+        mMac.RxFiltered++;
+        return;
+    }
+
+    Desc = FakeMacDesc (GMAC_DMA_CHAN0_RX_BASE_ADDR, mMac.RxCur);
+    if ((Desc->Des3 & EQOS_RDES3_OWN) == 0) {
+        /* RX buffer unavailable, the MTL drops the frame */
+        mMac.RxNoDescriptor++;
+        return;
+    }
+
+    BufferSize = (MAC_REG (GMAC_DMA_CHAN0_RX_CONTROL) >> GMAC_DMA_CHAN0_RX_CONTROL_RBSZ_SHIFT) &
+                 FAKE_RX_RBSZ_MASK;
+    MAC_CHECK ((Desc->Des3 & EQOS_RDES3_BUF1V) != 0, "RX descriptor without a valid buffer");
+    MAC_CHECK (Length <= BufferSize, "frame larger than the RX buffer");
+    CopyMem (FakeMacHost (Desc->Des0), Frame, Length);
+
+    /* Write-back format */
+    Desc->Des0 = 0;
+    Desc->Des1 = mMac.RxIpHeaderError ? EQOS_RDES1_IPHE : 0;
+    Desc->Des2 = 0;
+    MemoryFence ();
+    Desc->Des3 = EQOS_RDES3_FD | EQOS_RDES3_LD | EQOS_RDES3_RS1V | Length |
+                 (mMac.RxError ? EQOS_RDES3_ES : 0);
+    mMac.RxError = FALSE;
+    mMac.RxIpHeaderError = FALSE;
+
+    mMac.RxFrames++;
+    mMac.RxCur = (mMac.RxCur + 1) % (MAC_REG (GMAC_DMA_CHAN0_RX_RING_LEN) + 1);
+}
+
+VOID
+FakeMacRunTx (
+    VOID
+    )
+{
+    EQOS_DMA_DESC *Desc;
+    UINT32 Tail;
+    UINT32 Length;
+
+    if ((MAC_REG (GMAC_DMA_CHAN0_TX_CONTROL) & GMAC_DMA_CHAN0_TX_CONTROL_START) == 0 ||
+        (MAC_REG (GMAC_MAC_CONFIGURATION) & GMAC_MAC_CONFIGURATION_TE) == 0) {
+        return;
+    }
+
+    Tail = FakeMacTailIndex (GMAC_DMA_CHAN0_TX_BASE_ADDR, GMAC_DMA_CHAN0_TX_RING_LEN,
+                             MAC_REG (GMAC_DMA_CHAN0_TX_END_ADDR));
+    while (mMac.TxCur != Tail) {
+        Desc = FakeMacDesc (GMAC_DMA_CHAN0_TX_BASE_ADDR, mMac.TxCur);
+        if ((Desc->Des3 & EQOS_TDES3_OWN) == 0) {
+            MAC_CHECK (FALSE, "TX descriptor before the tail pointer not owned by the DMA");
+            break;
+        }
+
+        Length = Desc->Des3 & FAKE_TDES3_FL_MASK;
+        MAC_CHECK ((Desc->Des3 & (EQOS_TDES3_FD | EQOS_TDES3_LD)) == (EQOS_TDES3_FD | EQOS_TDES3_LD),
+                   "frame split across TX descriptors");
+        MAC_CHECK ((Desc->Des2 & FAKE_TDES2_B1L_MASK) == Length, "buffer length differs from the frame length");
+        MAC_CHECK (Length >= EQOS_ETHER_HEADER_SIZE && Length <= EQOS_ETHER_HEADER_SIZE + EQOS_ETHER_MTU,
+                   "bad frame length");
+        MAC_CHECK ((Desc->Des3 & FAKE_TDES3_CIC_MASK) == 0 ||
+                   (MAC_REG (GMAC_MTL_TXQ0_OPERATION_MODE) & GMAC_MTL_TXQ0_OPERATION_MODE_TSF) != 0,
+                   "checksum insertion without TX store-and-forward");
+
+        FakeMacReceive (FakeMacHost (Desc->Des0), Length);
+
+        /* Write-back format */
+        Desc->Des0 = 0;
+        Desc->Des1 = 0;
+        Desc->Des2 = 0;
+        MemoryFence ();
+        Desc->Des3 = EQOS_TDES3_FD | EQOS_TDES3_LD | (mMac.TxError ? EQOS_TDES3_ES : 0);
+        mMac.TxError = FALSE;
+
+        mMac.TxFrames++;
+        mMac.TxCur = (mMac.TxCur + 1) % (MAC_REG (GMAC_DMA_CHAN0_TX_RING_LEN) + 1);
+    }
+}
+
+STATIC
+VOID
+FakeMacWrite (
+    IN  UINT32  Offset,
+    IN  UINT32  Data
+    )
+{
+    UINT32 Tail;
+
+    switch (Offset) {
+    case GMAC_DMA_MODE:
+        if ((Data & GMAC_DMA_MODE_SWR) != 0) {
+            FakeMacReset ();
+        }
+        break;
+    case GMAC_MAC_MDIO_ADDRESS:
+        MAC_CHECK ((Data & GMAC_MAC_MDIO_ADDRESS_GB) != 0, "MDIO access without GB");
+        MAC_CHECK (((Data >> GMAC_MAC_MDIO_ADDRESS_PA_SHIFT) & 0x1F) == EQOS_PHY_ADDR, "MDIO access to another PHY");
+        if ((Data & GMAC_MAC_MDIO_ADDRESS_GOC_READ) == GMAC_MAC_MDIO_ADDRESS_GOC_READ) {
+            MAC_REG (GMAC_MAC_MDIO_DATA) = mMac.Phy[(Data >> GMAC_MAC_MDIO_ADDRESS_RDA_SHIFT) & 0x1F];
+        }
+        MAC_REG (Offset) = Data & ~GMAC_MAC_MDIO_ADDRESS_GB;
+        break;
+    case GMAC_MTL_TXQ0_OPERATION_MODE:
+        /* The flush completes at once */
+        MAC_REG (Offset) = Data & ~GMAC_MTL_TXQ0_OPERATION_MODE_FTQ;
+        break;
+    case GMAC_DMA_CHAN0_TX_BASE_ADDR_HI:
+    case GMAC_DMA_CHAN0_RX_BASE_ADDR_HI:
+        MAC_CHECK (Data == 0, "descriptor ring above 4 GiB");
+        break;
+    case GMAC_DMA_CHAN0_TX_BASE_ADDR:
+        MAC_CHECK ((MAC_REG (GMAC_DMA_CHAN0_TX_CONTROL) & GMAC_DMA_CHAN0_TX_CONTROL_START) == 0,
+                   "TX ring moved while the DMA runs");
+        MAC_REG (Offset) = Data;
+        mMac.TxCur = 0;
+        break;
+    case GMAC_DMA_CHAN0_RX_BASE_ADDR:
+        MAC_CHECK ((MAC_REG (GMAC_DMA_CHAN0_RX_CONTROL) & GMAC_DMA_CHAN0_RX_CONTROL_START) == 0,
+                   "RX ring moved while the DMA runs");
+        MAC_REG (Offset) = Data;
+        mMac.RxCur = 0;
+        break;
+    case GMAC_DMA_CHAN0_TX_END_ADDR:
+        Tail = FakeMacTailIndex (GMAC_DMA_CHAN0_TX_BASE_ADDR, GMAC_DMA_CHAN0_TX_RING_LEN, Data);
+        /* The DMA stops when it reaches the tail, so this would strand the whole ring */
+        MAC_CHECK (Tail != mMac.TxCur ||
+                   (FakeMacDesc (GMAC_DMA_CHAN0_TX_BASE_ADDR, Tail)->Des3 & EQOS_TDES3_OWN) == 0,
+                   "TX tail pointer makes a full ring look empty");
+        MAC_REG (Offset) = Data;
+        if (!mMac.TxHold) {
+            FakeMacRunTx ();
+        }
+        break;
+    case GMAC_DMA_CHAN0_RX_END_ADDR:
+        FakeMacTailIndex (GMAC_DMA_CHAN0_RX_BASE_ADDR, GMAC_DMA_CHAN0_RX_RING_LEN, Data);
+        MAC_REG (Offset) = Data;
+        break;
+    case GMAC_MAC_VERSION:
+    case GMAC_MAC_HW_FEATURE1:
+        MAC_CHECK (FALSE, "write to a read-only register");
+        break;
+    default:
+        MAC_REG (Offset) = Data;
+        break;
+    }
+}
+
+/* IoLib */
+
+UINT32
+EFIAPI
+MmioRead32 (
+    IN  UINTN   Address
+    )
+{
+    if (Address == MAC_CRU_CLKSEL) {
+        return mMac.RgmiiSpeed << CRU_CLKSEL_GMAC_RGMII_SPEED_SHIFT;
+    }
+    MAC_CHECK (Address >= FAKE_MAC_BASE && Address < FAKE_MAC_BASE + FAKE_MAC_REG_SIZE &&
+               (Address & 3) == 0, "bad register read");
+    return MAC_REG (Address - FAKE_MAC_BASE);
+}
+
+UINT32
+EFIAPI
+MmioWrite32 (
+    IN  UINTN   Address,
+    IN  UINT32  Value
+    )
+{
+    if (Address == MAC_CRU_CLKSEL) {
+        /* CRU registers take a write mask in the upper half */
+        MAC_CHECK ((Value >> 16) == CRU_CLKSEL_GMAC_RGMII_SPEED_MASK, "RGMII clock write with the wrong mask");
+        mMac.RgmiiSpeed = (Value & CRU_CLKSEL_GMAC_RGMII_SPEED_MASK) >> CRU_CLKSEL_GMAC_RGMII_SPEED_SHIFT;
+        return Value;
+    }
+    MAC_CHECK (Address >= FAKE_MAC_BASE && Address < FAKE_MAC_BASE + FAKE_MAC_REG_SIZE &&
+               (Address & 3) == 0, "bad register write");
+    FakeMacWrite ((UINT32)(Address - FAKE_MAC_BASE), Value);
+    return Value;
+}
+
+UINT32
+EFIAPI
+MmioOr32 (
+    IN  UINTN   Address,
+    IN  UINT32  OrData
+    )
+{
+    return MmioWrite32 (Address, MmioRead32 (Address) | OrData);
+}
+
+UINT32
+EFIAPI
+MmioAnd32 (
+    IN  UINTN   Address,
+    IN  UINT32  AndData
+    )
+{
+    return MmioWrite32 (Address, MmioRead32 (Address) & AndData);
+}
+
+UINT32
+EFIAPI
+MmioAndThenOr32 (
+    IN  UINTN   Address,
+    IN  UINT32  AndData,
+    IN  UINT32  OrData
+    )
+{
+    return MmioWrite32 (Address, (MmioRead32 (Address) & AndData) | OrData);
+}
+
+VOID
+FakeMacInit (
+    IN  CONST UINT8     *StationAddress
+    )
+{
+    ZeroMem (&mMac, sizeof (mMac));
+    FakeMacReset ();
+    mMac.Resets = 0;
+
+    /* As left by the boot loader */
+    MAC_REG (GMAC_MAC_ADDRESS0_LOW) = StationAddress[0] | (StationAddress[1] << 8) |
+                                      (StationAddress[2] << 16) | ((UINT32)StationAddress[3] << 24);
+    MAC_REG (GMAC_MAC_ADDRESS0_HIGH) = StationAddress[4] | (StationAddress[5] << 8);
+
+    /* Autonegotiated 1000 Mbps full duplex with a gigabit partner */
+    mMac.Phy[MII_BMSR] = MII_BMSR_LINK | MII_BMSR_ACOMP;
+    mMac.Phy[MII_ANAR] = MII_ANLPAR_100_FD | MII_ANLPAR_100_HD | MII_ANLPAR_10_FD | MII_ANLPAR_10_HD;
+    mMac.Phy[MII_ANLPAR] = mMac.Phy[MII_ANAR];
+    mMac.Phy[MII_GTCR] = MII_GTCR_ADV_1000_FD;
+    mMac.Phy[MII_GTSR] = MII_GTSR_LP_1000_FD;
+    mMac.RgmiiSpeed = CRU_CLKSEL_GMAC_RGMII_SPEED_2_5M;
+
+    ZeroMem (mPoolSize, sizeof (mPoolSize));
+    mPages = 0;
+
+    ZeroMem (&mBootServices, sizeof (mBootServices));
+    mBootServices.RaiseTPL = FakeRaiseTpl;
+    mBootServices.RestoreTPL = FakeRestoreTpl;
+    mBootServices.LocateProtocol = FakeLocateProtocol;
+    mBootServices.AllocatePages = FakeAllocatePages;
+    mBootServices.FreePages = FakeFreePages;
+    mBootServices.CreateEvent = FakeCreateEvent;
+    mBootServices.SignalEvent = FakeSignalEvent;
+    mTpl = TPL_APPLICATION;
+    mNowNs = 0;
+}
@@ -0,0 +1,62 @@
+/** @file
+ *
+ *  A GMAC, its PHY and the DMA pool simulated on the build host, for
+ *  running EqosDxe's SNP and ring code. Every frame transmitted is looped
+ *  back into the receive ring, through the station address filter.
+ *
+ *  The TX DMA walks the ring from its current descriptor up to the tail
+ *  pointer, as the hardware does, and stops at a descriptor it doesn't own.
+ *  The RX DMA takes the next descriptor it owns and drops the frame if
+ *  there is none.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef FAKEMAC_H__
+#define FAKEMAC_H__
+
+#include "EqosDxe.h"
+
+#define FAKE_MAC_BASE           0xFE2A0000UL
+#define FAKE_MAC_REG_SIZE       0x2000
+#define FAKE_DMA_SIZE           SIZE_1MB
+
+typedef struct {
+    UINT32              Regs[FAKE_MAC_REG_SIZE / 4];
+    UINT16              Phy[32];
+    UINT32              TxCur;          /* descriptor index the TX DMA fetches next */
+    UINT32              RxCur;
+    UINT32              RgmiiSpeed;     /* CRU_CLKSEL_GMAC_RGMII_SPEED_* */
+
+    /* Knobs */
+    BOOLEAN             TxHold;         /* TX DMA only runs in FakeMacRunTx () */
+    BOOLEAN             TxError;        /* report an error for the next frame sent */
+    BOOLEAN             RxError;        /* corrupt the next frame received */
+    BOOLEAN             RxIpHeaderError;
+
+    /* Observations */
+    UINTN               TxFrames;
+    UINTN               RxFrames;
+    UINTN               RxNoDescriptor; /* frames dropped, no descriptor owned by the DMA */
+    UINTN               RxFiltered;     /* frames the address filter rejected */
+    UINTN               Resets;
+    UINTN               Violations;
+} FAKE_MAC;
+
+extern FAKE_MAC mMac;
+extern UINT64 mNowNs;
+
+VOID
+FakeMacInit (
+    IN  CONST UINT8     *StationAddress
+    );
+
+VOID
+FakeMacRunTx (
+    VOID
+    );
+
+#endif /* FAKEMAC_H__ */
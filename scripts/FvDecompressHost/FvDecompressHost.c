@@ -0,0 +1,155 @@
+/** @file
+ *
+ *  Round trips a firmware volume through the firmware's LZ4 or LZMA
+ *  decoder on the build host and reports the fastest decode, for
+ *  benchfvcompress.py.
+ *
+ *    FvDecompressHost lz4 <Lz4Compress.py output> <original FV> <runs>
+ *    FvDecompressHost lzma <LzmaCompress output> <original FV> <runs>
+ *
+ *  Prints the best decode time in nanoseconds. Fails if the output doesn't
+ *  match the original FV. Both decoders are timed by the same loop, from
+ *  the compressed data already in memory.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Lz4DecompressShim.c
+size_t Lz4HostSectionHeaderSize (void);
+void Lz4HostMakeSection (void *Buffer, size_t DataSize);
+size_t Lz4HostGetInfo (const void *Section, uint32_t *OutputSize);
+size_t Lz4HostExtract (const void *Section, void *Output);
+
+// LzmaDecompressShim.c
+size_t LzmaHostGetInfo (const void *Data, size_t DataSize, uint32_t *OutputSize,
+                        uint32_t *ScratchSize);
+size_t LzmaHostExtract (const void *Data, size_t DataSize, void *Output, void *Scratch);
+
+static void *
+ReadFile (
+  const char *Path,
+  size_t     Offset,
+  size_t     *Size
+  )
+{
+  FILE  *File;
+  long  Length;
+  char  *Buffer;
+
+  File = fopen (Path, "rb");
+  if (File == NULL || fseek (File, 0, SEEK_END) != 0 || (Length = ftell (File)) < 0) {
+    perror (Path);
+    exit (1);
+  }
+  rewind (File);
+  Buffer = malloc (Offset + Length);
+  if (Buffer == NULL || fread (Buffer + Offset, 1, Length, File) != (size_t)Length) {
+    perror (Path);
+    exit (1);
+  }
+  fclose (File);
+
+  *Size = Length;
+  return Buffer;
+}
+
+static uint64_t
+NowNs (
+  void
+  )
+{
+  struct timespec Ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &Ts);
+  return (uint64_t)Ts.tv_sec * 1000000000 + Ts.tv_nsec;
+}
+
+int
+main (
+  int   argc,
+  char  **argv
+  )
+{
+  int       Lzma;
+  size_t    HeaderSize;
+  void      *Section;
+  size_t    DataSize;
+  void      *Scratch;
+  uint32_t  ScratchSize;
+  void      *Original;
+  size_t    OriginalSize;
+  void      *Output;
+  uint32_t  OutputSize;
+  int       Runs;
+  int       Run;
+  uint64_t  Start;
+  uint64_t  Elapsed;
+  uint64_t  Best;
+  size_t    Status;
+
+  if (argc != 5 || (strcmp (argv[1], "lz4") != 0 && strcmp (argv[1], "lzma") != 0) ||
+      (Runs = atoi (argv[4])) < 1) {
+    fprintf (stderr, "usage: %s lz4|lzma <compressed> <original> <runs>\n", argv[0]);
+    return 1;
+  }
+  Lzma = strcmp (argv[1], "lzma") == 0;
+
+  if (Lzma) {
+    Section = ReadFile (argv[2], 0, &DataSize);
+    Status = LzmaHostGetInfo (Section, DataSize, &OutputSize, &ScratchSize);
+  } else {
+    HeaderSize = Lz4HostSectionHeaderSize ();
+    Section = ReadFile (argv[2], HeaderSize, &DataSize);
+    Lz4HostMakeSection (Section, DataSize);
+    Status = Lz4HostGetInfo (Section, &OutputSize);
+    ScratchSize = 0;
+  }
+  Original = ReadFile (argv[3], 0, &OriginalSize);
+
+  if (Status != 0 || OutputSize != OriginalSize) {
+    fprintf (stderr, "%s: bad header (status 0x%zx, size %u, expected %zu)\n",
+             argv[2], Status, OutputSize, OriginalSize);
+    return 1;
+  }
+  Output = malloc (OutputSize);
+  Scratch = malloc (ScratchSize + 1);
+  if (Output == NULL || Scratch == NULL) {
+    perror ("malloc");
+    return 1;
+  }
+
+  Best = UINT64_MAX;
+  for (Run = 0; Run < Runs; Run++) {
+    memset (Output, 0, OutputSize);
+    Start = NowNs ();
+    if (Lzma) {
+      Status = LzmaHostExtract (Section, DataSize, Output, Scratch);
+    } else {
+      Status = Lz4HostExtract (Section, Output);
+    }
+    Elapsed = NowNs () - Start;
+    if (Status != 0) {
+      fprintf (stderr, "%s: decode failed (status 0x%zx)\n", argv[2], Status);
+      return 1;
+    }
+    if (memcmp (Output, Original, OriginalSize) != 0) {
+      fprintf (stderr, "%s: decoded data doesn't match %s\n", argv[2], argv[3]);
+      return 1;
+    }
+    if (Elapsed < Best) {
+      Best = Elapsed;
+    }
+  }
+
+  printf ("%llu\n", (unsigned long long)Best);
+  return 0;
+}
@@ -0,0 +1,70 @@
+/** @file
+ *
+ *  The few BaseLib, BaseMemoryLib and ExtractGuidedSectionLib functions
+ *  that the LZ4 and LZMA decoders use, for building them on the build host.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <PiPei.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *DestinationBuffer,
+  IN  CONST VOID *SourceBuffer,
+  IN  UINTN      Length
+  )
+{
+  return __builtin_memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+BOOLEAN
+EFIAPI
+CompareGuid (
+  IN CONST GUID  *Guid1,
+  IN CONST GUID  *Guid2
+  )
+{
+  return __builtin_memcmp (Guid1, Guid2, sizeof (GUID)) == 0;
+}
+
+UINT32
+EFIAPI
+ReadUnaligned32 (
+  IN CONST UINT32  *Buffer
+  )
+{
+  UINT32 Value;
+
+  __builtin_memcpy (&Value, Buffer, sizeof (Value));
+  return Value;
+}
+
+UINT64
+EFIAPI
+LShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  )
+{
+  return Operand << Count;
+}
+
+RETURN_STATUS
+EFIAPI
+ExtractGuidedSectionRegisterHandlers (
+  IN CONST GUID                                 *SectionGuid,
+  IN EXTRACT_GUIDED_SECTION_GET_INFO_HANDLER    GetInfoHandler,
+  IN EXTRACT_GUIDED_SECTION_DECODE_HANDLER      DecodeHandler
+  )
+{
+  return RETURN_SUCCESS;
+}
@@ -0,0 +1,82 @@
+/** @file
+ *
+ *  Builds Lz4CustomDecompressLib for the build host, against the MdePkg
+ *  headers, so that benchfvcompress.py times the firmware's own decoder.
+ *  The library functions it uses are in HostLib.c.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <PiPei.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+
+EFI_GUID gRk356xLz4CustomDecompressGuid = {
+  0xFB3B54EB, 0xA5CD, 0x489F, { 0x85, 0x90, 0x9E, 0x9B, 0xA0, 0xF0, 0x01, 0x8B }
+};
+
+#include "../../edk2-rockchip/Platform/Rockchip/Rk356x/Library/Lz4CustomDecompressLib/Lz4Decompress.c"
+
+//
+// Interface to FvDecompressHost.c, which uses the C library and so can't
+// see the EDK2 types. Sizes are in bytes, return values are RETURN_STATUS.
+//
+
+UINTN
+Lz4HostSectionHeaderSize (
+  VOID
+  )
+{
+  return sizeof (EFI_GUID_DEFINED_SECTION2);
+}
+
+/*
+ * Wraps the output of Lz4Compress.py, which the caller has placed right
+ * after the header, in the GUIDed section GenFds would put it in.
+ */
+VOID
+Lz4HostMakeSection (
+  OUT VOID   *Buffer,
+  IN  UINTN  DataSize
+  )
+{
+  EFI_GUID_DEFINED_SECTION2  *Section;
+
+  Section = Buffer;
+  Section->CommonHeader.Size[0] = 0xFF;
+  Section->CommonHeader.Size[1] = 0xFF;
+  Section->CommonHeader.Size[2] = 0xFF;
+  Section->CommonHeader.Type = EFI_SECTION_GUID_DEFINED;
+  Section->CommonHeader.ExtendedSize = (UINT32)(sizeof (*Section) + DataSize);
+  CopyMem (&Section->SectionDefinitionGuid, &gRk356xLz4CustomDecompressGuid, sizeof (EFI_GUID));
+  Section->DataOffset = sizeof (*Section);
+  Section->Attributes = EFI_GUIDED_SECTION_PROCESSING_REQUIRED;
+}
+
+UINTN
+Lz4HostGetInfo (
+  IN  CONST VOID  *Section,
+  OUT UINT32      *OutputSize
+  )
+{
+  UINT32  ScratchSize;
+  UINT16  Attributes;
+
+  return Lz4GuidedSectionGetInfo (Section, OutputSize, &ScratchSize, &Attributes);
+}
+
+UINTN
+Lz4HostExtract (
+  IN  CONST VOID  *Section,
+  OUT VOID        *Output
+  )
+{
+  UINT32  AuthenticationStatus;
+
+  return Lz4GuidedSectionExtraction (Section, &Output, NULL, &AuthenticationStatus);
+}
@@ -0,0 +1,44 @@
+/** @file
+ *
+ *  Builds the LzmaDec.c based decoder of LzmaCustomDecompressLib for the
+ *  build host, against the MdePkg headers, so that benchfvcompress.py
+ *  times the firmware's own LZMA decoder the same way as the LZ4 one.
+ *  The library functions it uses are in HostLib.c.
+ *
+ *  Copyright (c) 2026, agent <agent@local>
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <PiPei.h>
+
+#include "../../edk2/MdeModulePkg/Library/LzmaCustomDecompressLib/Sdk/C/LzmaDec.c"
+#include "../../edk2/MdeModulePkg/Library/LzmaCustomDecompressLib/LzmaDecompress.c"
+
+//
+// Interface to FvDecompressHost.c, as in Lz4DecompressShim.c. Data is the
+// body of the EE4E5898 GUIDed section, as written by LzmaCompress.
+//
+
+UINTN
+LzmaHostGetInfo (
+  IN  CONST VOID  *Data,
+  IN  UINTN       DataSize,
+  OUT UINT32      *OutputSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  return LzmaUefiDecompressGetInfo (Data, (UINT32)DataSize, OutputSize, ScratchSize);
+}
+
+UINTN
+LzmaHostExtract (
+  IN  CONST VOID  *Data,
+  IN  UINTN       DataSize,
+  OUT VOID        *Output,
+  IN  VOID        *Scratch
+  )
+{
+  return LzmaUefiDecompress (Data, DataSize, Output, Scratch);
+}
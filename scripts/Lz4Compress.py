@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+#
+# GUIDed section tool for LZ4 compressed firmware volumes, decoded in PrePi
+# by Lz4CustomDecompressLib. Called by GenFds as "Lz4Compress.py -e -o out in".
+#
+# Output format: decompressed size as a little endian UINT32, followed by an
+# LZ4 legacy format stream produced by the lz4 command line tool.
+#
+# apt install lz4
+
+import argparse
+import struct
+import subprocess
+import sys
+
+LZ4_LEVEL = '-12'
+
+def lz4(args, data):
+    try:
+        return subprocess.run(['lz4'] + args + ['-c', '-'], input=data,
+                              stdout=subprocess.PIPE, check=True).stdout
+    except FileNotFoundError:
+        sys.exit('Lz4Compress: lz4 not found, please install it')
+
+def compress(data):
+    return struct.pack('<I', len(data)) + lz4(['-l', LZ4_LEVEL], data)
+
+def decompress(data):
+    size, = struct.unpack_from('<I', data)
+    out = lz4(['-d'], data[4:])
+    if len(out) != size:
+        sys.exit('Lz4Compress: size mismatch, %u != %u' % (len(out), size))
+    return out
+
+def main():
+    parser = argparse.ArgumentParser()
+    mode = parser.add_mutually_exclusive_group(required=True)
+    mode.add_argument('-e', action='store_true', help='compress')
+    mode.add_argument('-d', action='store_true', help='decompress')
+    parser.add_argument('-o', required=True, metavar='OUTPUT')
+    parser.add_argument('input')
+    # Options GenFds passes to every GUIDed tool
+    parser.add_argument('-v', '--verbose', action='store_true')
+    parser.add_argument('-q', '--quiet', action='store_true')
+    parser.add_argument('--debug', type=int)
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    data = compress(data) if args.e else decompress(data)
+    with open(args.o, 'wb') as f:
+        f.write(data)
+
+main()
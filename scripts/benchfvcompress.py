@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+#
+# Compare LZMA and LZ4 compression of a firmware volume, e.g.
+#
+#   scripts/benchfvcompress.py Build/Quartz64/RELEASE_GCC5/FV/FVMAIN.Fv
+#
+# Reports the compressed size and the best of several decompression runs
+# for each algorithm, on the build host.
+#
+# Both are timed with the firmware's own decoders, Lz4CustomDecompressLib
+# and LzmaCustomDecompressLib (LzmaDec.c), built together for the host from
+# FvDecompressHost/ against the headers in the edk2 submodule. The same
+# in-process loop times both, and checks the decoded output against the
+# original FV.
+#
+# The image is compressed with Lz4Compress.py and with the LzmaCompress tool
+# from BaseTools, exactly as GenFds does, or with xz if BaseTools hasn't been
+# built.
+#
+# apt install lz4 xz-utils
+
+import os
+import platform
+import shlex
+import shutil
+import subprocess
+import struct
+import sys
+import tempfile
+
+RUNS = 10
+
+TOP = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HOST_SRC = os.path.join(TOP, 'scripts', 'FvDecompressHost')
+MDEPKG = os.path.join(TOP, 'edk2', 'MdePkg', 'Include')
+MDEMODULEPKG = os.path.join(TOP, 'edk2', 'MdeModulePkg', 'Include')
+ARCH = {'x86_64': 'X64', 'amd64': 'X64', 'aarch64': 'AArch64', 'arm64': 'AArch64'}
+
+def lzma_compress(path, out):
+    # Prefer the tool GenFds uses for the default EE4E5898 GUIDed section
+    tool = shutil.which('LzmaCompress')
+    if tool is not None:
+        subprocess.run([tool, '-e', '-o', out, path], check=True)
+    else:
+        with open(path, 'rb') as f:
+            data = subprocess.run(['xz', '--format=lzma', '-9', '-c', '-'], stdin=f,
+                                  stdout=subprocess.PIPE, check=True).stdout
+        # xz doesn't know the size when reading a pipe, LzmaCompress records it
+        data = data[:5] + struct.pack('<Q', os.path.getsize(path)) + data[13:]
+        with open(out, 'wb') as f:
+            f.write(data)
+    with open(out, 'rb') as f:
+        return f.read()
+
+def lz4_compress(path, out):
+    subprocess.run([os.path.join(os.path.dirname(__file__), 'Lz4Compress.py'),
+                    '-e', '-o', out, path], check=True)
+    with open(out, 'rb') as f:
+        return f.read()
+
+def host_build(tmp):
+    arch = ARCH.get(platform.machine().lower())
+    if arch is None:
+        sys.exit('no MdePkg ProcessorBind.h for %s' % platform.machine())
+    if not os.path.isdir(MDEPKG):
+        sys.exit('%s not found, run git submodule update --init' % MDEPKG)
+    tool = os.path.join(tmp, 'FvDecompressHost')
+    subprocess.run(shlex.split(os.environ.get('CC', 'cc')) + ['-O2', '-fshort-wchar', '-DMDEPKG_NDEBUG',
+                    '-I', MDEPKG, '-I', os.path.join(MDEPKG, arch), '-I', MDEMODULEPKG, '-o', tool,
+                    os.path.join(HOST_SRC, 'FvDecompressHost.c'),
+                    os.path.join(HOST_SRC, 'HostLib.c'),
+                    os.path.join(HOST_SRC, 'Lz4DecompressShim.c'),
+                    os.path.join(HOST_SRC, 'LzmaDecompressShim.c')], check=True)
+    return tool
+
+def best_time(tool, algo, compressed, path):
+    out = subprocess.run([tool, algo, compressed, path, str(RUNS)], stdout=subprocess.PIPE,
+                         check=True).stdout
+    return int(out) / 1e9
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit('usage: %s <FVMAIN.Fv>' % sys.argv[0])
+    path = sys.argv[1]
+    size = os.path.getsize(path)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        tool = host_build(tmp)
+        results = []
+        for name, compress in (('lzma', lzma_compress), ('lz4', lz4_compress)):
+            compressed = os.path.join(tmp, name)
+            length = len(compress(path, compressed))
+            results.append((name, length, best_time(tool, name, compressed, path)))
+
+    print('%s: %u bytes' % (path, size))
+    print('%-6s %10s %7s %10s %10s' % ('algo', 'size', 'ratio', 'ms', 'MB/s'))
+    for name, length, elapsed in results:
+        print('%-6s %10u %6.1f%% %10.2f %10.1f' % (name, length, 100.0 * length / size,
+                                                 elapsed * 1000, size / elapsed / 1e6))
+
+main()
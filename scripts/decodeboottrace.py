@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# Decode a boot trace saved with the "boottrace <file>" shell command (or
+# read from the reserved memory it lives in) into a per-boot timeline.
+#
+#   scripts/decodeboottrace.py trace.bin [-s edk2 edk2-rockchip ...]
+#
+# Event names come from BOOT_TRACE_ID in BootTraceLib.h. Driver GUIDs are
+# resolved to names by scanning the given source trees for INF files.
+
+import argparse
+import os
+import re
+import struct
+import uuid
+
+HEADER = struct.Struct('<IHHIIQQ')
+ENTRY = struct.Struct('<QIHHQQ')
+SIGNATURE = 0x54424b52  # 'RKBT'
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+LIB_HEADER = os.path.join(SCRIPT_DIR, '..', 'edk2-rockchip', 'Platform', 'Rockchip',
+                          'Rk356x', 'Include', 'Library', 'BootTraceLib.h')
+
+def load_event_names(path):
+    names = {}
+    value = 0
+    with open(path) as f:
+        for line in f:
+            m = re.match(r'\s*BootTraceId(\w+)\s*(?:=\s*(\d+))?\s*,', line)
+            if m:
+                value = int(m.group(2)) if m.group(2) else value + 1
+                names[value] = m.group(1)
+    return names
+
+def load_module_names(dirs):
+    names = {}
+    for top in dirs:
+        for root, _, files in os.walk(top):
+            for name in files:
+                if not name.endswith('.inf'):
+                    continue
+                base = guid = None
+                with open(os.path.join(root, name), errors='replace') as f:
+                    for line in f:
+                        m = re.match(r'\s*(BASE_NAME|FILE_GUID)\s*=\s*(\S+)', line)
+                        if m and m.group(1) == 'BASE_NAME':
+                            base = m.group(2)
+                        elif m:
+                            guid = m.group(2).lower()
+                if base and guid:
+                    names[guid] = base
+    return names
+
+def read_entries(data):
+    sig, version, entry_size, num_entries, boot, head, freq = HEADER.unpack_from(data)
+    if sig != SIGNATURE or entry_size != ENTRY.size:
+        raise SystemExit('not a boot trace')
+    count = min(head, num_entries)
+    entries = []
+    for index in range(head - count, head):
+        offset = HEADER.size + (index % num_entries) * entry_size
+        entries.append(ENTRY.unpack_from(data, offset))
+    return freq, entries
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('trace')
+    parser.add_argument('-s', '--source', nargs='*', default=[],
+                        help='source trees to look up driver GUIDs in')
+    parser.add_argument('-n', '--top', type=int, default=10,
+                        help='number of slowest drivers to list per boot')
+    args = parser.parse_args()
+
+    events = load_event_names(LIB_HEADER)
+    modules = load_module_names(args.source)
+    with open(args.trace, 'rb') as f:
+        freq, entries = read_entries(f.read())
+
+    boots = {}
+    for entry in entries:
+        boots.setdefault(entry[1], []).append(entry)
+
+    for boot, entries in sorted(boots.items()):
+        print('Boot %u' % boot)
+        print('%12s %10s  %s' % ('ms', '+ms', 'event'))
+        last = None
+        started = {}
+        durations = []
+        for timestamp, _, event, _, arg0, arg1 in entries:
+            ms = timestamp * 1000.0 / freq
+            name = events.get(event, str(event))
+            if name in ('DriverStart', 'DriverEnd'):
+                guid = str(uuid.UUID(bytes_le=struct.pack('<QQ', arg0, arg1)))
+                module = modules.get(guid, guid)
+                detail = module
+                if name == 'DriverStart':
+                    started[guid] = ms
+                elif guid in started:
+                    durations.append((ms - started.pop(guid), module))
+            else:
+                detail = '0x%x 0x%x' % (arg0, arg1)
+            print('%12.3f %10.3f  %-16s %s' % (ms, ms - last if last is not None else 0, name, detail))
+            last = ms
+
+        if durations:
+            print('\nSlowest driver entry points:')
+            for ms, module in sorted(durations, reverse=True)[:args.top]:
+                print('%10.3f ms  %s' % (ms, module))
+        print()
+
+main()
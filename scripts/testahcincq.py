@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+#
+# Run the AhciNcqDxe host test, e.g.
+#
+#   scripts/testahcincq.py
+#
+# Builds the driver's AhciPort.c, AhciQueue.c and AhciBlockIo.c for the build
+# host, against the MdePkg headers in the edk2 submodule, together with
+# AhciNcqHost/, which simulates a single port AHCI controller and disk
+# behind a fake PciIo. Exits non-zero if any test fails.
+#
+# This exercises the queueing and recovery logic only. Link bring-up,
+# timing and real device behaviour still need testing on a board.
+
+import os
+import platform
+import shlex
+import subprocess
+import sys
+import tempfile
+
+TOP = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HOST_SRC = os.path.join(TOP, 'scripts', 'AhciNcqHost')
+DRIVER = os.path.join(TOP, 'edk2-rockchip', 'Silicon', 'Rockchip', 'Rk356x', 'Drivers', 'AhciNcqDxe')
+RK356X_INCLUDE = os.path.join(TOP, 'edk2-rockchip', 'Silicon', 'Rockchip', 'Rk356x', 'Include')
+MDEPKG = os.path.join(TOP, 'edk2', 'MdePkg', 'Include')
+ARCH = {'x86_64': 'X64', 'amd64': 'X64', 'aarch64': 'AArch64', 'arm64': 'AArch64'}
+
+def main():
+    arch = ARCH.get(platform.machine().lower())
+    if arch is None:
+        sys.exit('no MdePkg ProcessorBind.h for %s' % platform.machine())
+    if not os.path.isdir(MDEPKG):
+        sys.exit('%s not found, run git submodule update --init' % MDEPKG)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        tool = os.path.join(tmp, 'AhciNcqHostTest')
+        subprocess.run(shlex.split(os.environ.get('CC', 'cc')) + ['-O1', '-g', '-Wall',
+                        '-Wno-unused-function', '-fshort-wchar', '-fno-strict-aliasing',
+                        # Stands in for AutoGen.h, which the build force-includes
+                        '-DMDEPKG_NDEBUG', '-include', 'Uefi.h',
+                        '-I', HOST_SRC, '-I', DRIVER, '-I', RK356X_INCLUDE,
+                        '-I', MDEPKG, '-I', os.path.join(MDEPKG, arch), '-o', tool,
+                        os.path.join(HOST_SRC, 'AhciNcqHostTest.c'),
+                        os.path.join(HOST_SRC, 'FakeHba.c'),
+                        os.path.join(DRIVER, 'AhciPort.c'),
+                        os.path.join(DRIVER, 'AhciQueue.c'),
+                        os.path.join(DRIVER, 'AhciBlockIo.c')], check=True)
+        sys.exit(subprocess.run([tool]).returncode)
+
+if __name__ == '__main__':
+    main()